@@ -203,6 +203,7 @@ public:
 		FTM_STATESORT,
 		FTM_STATESORT_DRAWABLE,
 		FTM_STATESORT_POSTSORT,
+		FTM_STATESORT_SORT_DRAWS,
 		FTM_REBUILD_PRIORITY_GROUPS,
 		FTM_REBUILD_MESH,
 		FTM_REBUILD_VBO,
@@ -298,6 +299,7 @@ public:
 		FTM_TEXTURE_MEMORY_CHECK,
 		FTM_IMAGE_UPDATE_BUMP,
 		FTM_IMAGE_UPDATE_LIST,
+		FTM_PREFETCH_PREDICTOR,
 		FTM_IMAGE_CALLBACKS,
 		FTM_BUMP_SOURCE_STANDARD_LOADED,
 		FTM_BUMP_GEN_NORMAL,
@@ -314,6 +316,8 @@ public:
 		FTM_FAST_CACHE_IMAGE_FETCH,
 #endif
 		FTM_IMAGE_UPDATE_PRIO,
+		FTM_IMAGE_PRIORITIES,
+		FTM_IMAGE_RESIDENCY,
 		FTM_IMAGE_FETCH,
 		FTM_IMAGE_MARK_DIRTY,
 		FTM_IMAGE_STATS,
@@ -0,0 +1,175 @@
+/**
+ * @file llthreadpool.cpp
+ * @brief Fork/join pool of worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llthreadpool.h"
+
+LLThreadPool* gThreadPoolp = NULL;
+
+LLThreadPool::Worker::Worker(const std::string& name, LLThreadPool* poolp)
+:	LLThread(name),
+	mPool(poolp)
+{
+}
+
+//virtual
+void LLThreadPool::Worker::run()
+{
+	U32 generation = 0;
+	while (true)
+	{
+		{
+			LL_UNIQ_LOCK_TYPE lock(mPool->mMutex);
+			while (!mPool->mQuitting && mPool->mGeneration == generation)
+			{
+				mPool->mWorkCondition.wait(lock);
+			}
+			if (mPool->mQuitting)
+			{
+				break;
+			}
+			generation = mPool->mGeneration;
+			++mPool->mActiveWorkers;
+		}
+
+		mPool->doJobs();
+
+		LL_UNIQ_LOCK_TYPE lock(mPool->mMutex);
+		if (--mPool->mActiveWorkers == 0)
+		{
+			mPool->mDoneCondition.notify_all();
+		}
+	}
+}
+
+LLThreadPool::LLThreadPool(const std::string& name, U32 size)
+:	mJob(NULL),
+	mJobsCount(0),
+	mGeneration(0),
+	mActiveWorkers(0),
+	mNextJob(0),
+	mPendingJobs(0),
+	mQuitting(false)
+{
+	if (!size)
+	{
+		size = boost::thread::hardware_concurrency();
+		// Keep one thread for the main loop (which also takes part in the
+		// jobs), and do not go overboard with the number of workers, since
+		// the jobs are typically short.
+		size = size > 1 ? llmin(size - 1, 16U) : 0;
+	}
+	mWorkers.reserve(size);
+	for (U32 i = 0; i < size; ++i)
+	{
+		Worker* workerp = new Worker(llformat("%s %d", name.c_str(), i),
+									 this);
+		mWorkers.push_back(workerp);
+		workerp->start();
+	}
+	llinfos << "Started " << size << " worker threads for pool: " << name
+			<< llendl;
+}
+
+LLThreadPool::~LLThreadPool()
+{
+	{
+		LL_UNIQ_LOCK_TYPE lock(mMutex);
+		mQuitting = true;
+	}
+	mWorkCondition.notify_all();
+	for (U32 i = 0, count = mWorkers.size(); i < count; ++i)
+	{
+		Worker* workerp = mWorkers[i];
+		workerp->shutdown();
+		delete workerp;
+	}
+	mWorkers.clear();
+}
+
+U32 LLThreadPool::doJobs()
+{
+	U32 done = 0;
+	U32 i;
+	while ((i = mNextJob.fetch_add(1)) < mJobsCount)
+	{
+		(*mJob)(i);
+		++done;
+		if (mPendingJobs.fetch_sub(1) == 1)
+		{
+			// Last job done: wake up the caller.
+			LL_UNIQ_LOCK_TYPE lock(mMutex);
+			mDoneCondition.notify_all();
+		}
+	}
+	return done;
+}
+
+void LLThreadPool::parallelFor(U32 count, const job_func_t& job)
+{
+	if (mWorkers.empty() || count < 2)
+	{
+		for (U32 i = 0; i < count; ++i)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	{
+		LL_UNIQ_LOCK_TYPE lock(mMutex);
+		// Make sure no worker is still busy with the previous batch (i.e.
+		// still about to check mNextJob against mJobsCount) before
+		// replacing it.
+		while (mActiveWorkers)
+		{
+			mDoneCondition.wait(lock);
+		}
+		mJob = &job;
+		mJobsCount = count;
+		mPendingJobs = count;
+		mNextJob = 0;
+		++mGeneration;
+	}
+	mWorkCondition.notify_all();
+
+	// Take part in the work
+	doJobs();
+
+	LL_UNIQ_LOCK_TYPE lock(mMutex);
+	while (mPendingJobs || mActiveWorkers)
+	{
+		mDoneCondition.wait(lock);
+	}
+}
@@ -0,0 +1,113 @@
+/**
+ * @file llthreadpool.h
+ * @brief Fork/join pool of worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLTHREADPOOL_H
+#define LL_LLTHREADPOOL_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "llmutex.h"
+#include "llthread.h"
+
+// Pool of worker threads used to split CPU-bound work made of independent
+// jobs (e.g. one job per spatial partition) across the available cores. The
+// calling thread takes part in the work, and parallelFor() only returns once
+// all the jobs are done, so that the jobs may safely reference the caller's
+// data. The jobs must of course be thread-safe: they must not touch the GL
+// state nor any data shared with other jobs without proper locking.
+// Note: parallelFor() is not re-entrant and is meant to be called from the
+// main thread only.
+
+class LL_COMMON_API LLThreadPool
+{
+protected:
+	LOG_CLASS(LLThreadPool);
+
+public:
+	typedef std::function<void(U32)> job_func_t;
+
+	// 'size' is the number of worker threads to launch; when 0, this number
+	// is determined automatically depending on the available threading
+	// concurrency.
+	LLThreadPool(const std::string& name, U32 size = 0);
+	~LLThreadPool();
+
+	// Calls job(i) for each i in [0, count[ and returns when all calls are
+	// done.
+	void parallelFor(U32 count, const job_func_t& job);
+
+	// Number of worker threads, not counting the calling thread.
+	LL_INLINE U32 getSize() const					{ return mWorkers.size(); }
+
+private:
+	class Worker final : public LLThread
+	{
+	public:
+		Worker(const std::string& name, LLThreadPool* poolp);
+
+		void run() override;
+
+	private:
+		LLThreadPool*	mPool;
+	};
+
+	// Runs jobs until none is left. Returns the number of jobs ran.
+	U32 doJobs();
+
+private:
+	std::vector<Worker*>	mWorkers;
+
+	LL_MUTEX_TYPE			mMutex;
+	LL_COND_TYPE			mWorkCondition;
+	LL_COND_TYPE			mDoneCondition;
+
+	// Current batch of jobs; only modified with mMutex locked and while no
+	// worker is running jobs.
+	const job_func_t*		mJob;
+	U32						mJobsCount;
+	U32						mGeneration;
+	// Number of workers currently running jobs (protected by mMutex).
+	U32						mActiveWorkers;
+
+	std::atomic<U32>		mNextJob;
+	std::atomic<U32>		mPendingJobs;
+
+	bool					mQuitting;
+};
+
+// Shared pool, used by the renderer. NULL when not (yet) created.
+extern LL_COMMON_API LLThreadPool* gThreadPoolp;
+
+#endif	// LL_LLTHREADPOOL_H
@@ -20,6 +20,8 @@
  *  - Proper and threaded auto-purging of the cache when it exceeds 150% of
  *    its nominal size.
  *  - Multiple threads and multiple viewer instances deconfliction.
+ *  - Journal of the cache files sizes and access times, avoiding directory
+ *    scans on startup and when purging.
  *
  * Second Life Viewer Source Code
  * The source code in this file ("Source Code") is provided by Linden Lab
@@ -47,6 +49,8 @@
 
 #include "linden_common.h"
 
+#include <list>
+
 #include "boost/filesystem.hpp"
 
 #include "lldiskcache.h"
@@ -54,6 +58,9 @@
 #include "llcallbacklist.h"
 #include "lldir.h"
 #include "lldiriterator.h"
+#include "llfastmap.h"
+#include "llmutex.h"
+#include "llpackstore.h"
 #include "llrand.h"
 #include "llthread.h"
 #include "lltimer.h"
@@ -73,6 +80,9 @@ constexpr time_t TIME_THRESHOLD_PURGE = 60;
 // thread (1 second).
 constexpr F32 INTERVAL_BETWEEN_CHECKS = 1.f;
 
+constexpr U32 JOURNAL_MAGIC = 0x4c4e524a;	// "JRNL"
+constexpr U32 JOURNAL_VERSION = 1;
+
 // Static variable members
 LLCachePurgeThread* LLDiskCache::sPurgeThread = NULL;
 std::string LLDiskCache::sCacheDir;
@@ -85,6 +95,92 @@ bool LLDiskCache::sCacheValid = false;
 // Subdirectory names 0...9a...f, concatenated in a string
 static std::string sDigits = "0123456789abcdef";
 
+///////////////////////////////////////////////////////////////////////////////
+// Cache journal data
+///////////////////////////////////////////////////////////////////////////////
+
+// The journal keeps track of the size and last access time of each cache file
+// (keyed on its name, without the path), in LRU order, so that the cache can
+// be purged without scanning and sorting all the files, and so that the cache
+// size is known on startup without scanning the cache directory either. It is
+// saved on shutdown and reloaded on the next session. It is only used by the
+// first running viewer instance, and it is invalidated (via a flag file) by
+// any file write from another instance, since it would then miss files. HB
+
+typedef std::list<std::string> journal_lru_t;
+
+struct LLCacheFileInfo
+{
+	journal_lru_t::iterator	mLRUIter;
+	time_t					mAccessTime;
+	// Last time we updated the file time stamp (0 when unknown).
+	time_t					mTouchTime;
+	U32						mSize;
+};
+
+typedef fast_hmap<std::string, LLCacheFileInfo> journal_map_t;
+
+// Protects all the journal data below.
+static LLMutex sJournalMutex;
+static journal_map_t sJournal;
+// Most recently used files first.
+static journal_lru_t sJournalLRU;
+// Total size of the files in the journal.
+static U64 sJournalBytes = 0;
+// true when the journal is in use (first viewer instance, without the pack
+// store).
+static bool sUseJournal = false;
+// true once the journal accounts for all the files in the cache.
+static bool sJournalValid = false;
+// true for the sibling viewer instances.
+static bool sSecondInstance = false;
+// Per-asset files last written or touched before this time are not used by
+// any running viewer instance, when in pack store mode.
+static time_t sStaleFilesTime = 0;
+
+static std::string journal_name(const std::string& file_path)
+{
+	size_t i = file_path.rfind(LL_DIR_DELIM_CHR);
+	return i == std::string::npos ? file_path : file_path.substr(i + 1);
+}
+
+// Must be called with sJournalMutex locked.
+static LLCacheFileInfo& journal_add(const std::string& name, U32 size,
+									time_t time, bool most_recent = true)
+{
+	if (most_recent)
+	{
+		sJournalLRU.emplace_front(name);
+	}
+	else
+	{
+		sJournalLRU.emplace_back(name);
+	}
+	LLCacheFileInfo& info = sJournal[name];
+	info.mLRUIter = most_recent ? sJournalLRU.begin() : --sJournalLRU.end();
+	info.mAccessTime = time;
+	info.mTouchTime = 0;
+	info.mSize = size;
+	sJournalBytes += size;
+	return info;
+}
+
+// Must be called with sJournalMutex locked.
+static void journal_erase(journal_map_t::iterator it)
+{
+	sJournalBytes -= it->second.mSize;
+	sJournalLRU.erase(it->second.mLRUIter);
+	sJournal.erase(it);
+}
+
+// Must be called with sJournalMutex locked.
+static void journal_clear()
+{
+	sJournal.clear();
+	sJournalLRU.clear();
+	sJournalBytes = 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // LLCachePurgeThread class
 ///////////////////////////////////////////////////////////////////////////////
@@ -112,10 +208,13 @@ public:
 ///////////////////////////////////////////////////////////////////////////////
 
 //static
-void LLDiskCache::init(U64 nominal_size_bytes, bool second_instance)
+void LLDiskCache::init(U64 nominal_size_bytes, bool second_instance,
+					   bool use_pack_store)
 {
 	llinfos << "Initializing cache..." << llendl;
 
+	sSecondInstance = second_instance;
+
 	sNominalSizeBytes = nominal_size_bytes;
 	sMaxSizeBytes = 15UL * sNominalSizeBytes / 10UL;
 	if (second_instance)
@@ -148,6 +247,40 @@ void LLDiskCache::init(U64 nominal_size_bytes, bool second_instance)
 			sCacheValid &= LLFile::mkdir(sCacheDir + sDigits[i]);
 		}
 	}
+	if (sCacheValid && use_pack_store && !second_instance)
+	{
+		// No need to scan the cache directory: the pack store index already
+		// knows the size of its segments. HB
+		if (LLPackStore::init(sCacheDir + "packs"))
+		{
+			// Sibling instances touch the files they use when older than
+			// TIME_THRESHOLD: any older file is a left-over. HB
+			sStaleFilesTime = computer_time() - TIME_THRESHOLD;
+			sCurrentSizeBytes = LLPackStore::getDiskSize();
+			llinfos << "Nominal cache size: " << sNominalSizeBytes
+					<< " bytes. Maximal cache size: " << sMaxSizeBytes
+					<< " bytes. Current pack store size: "
+					<< sCurrentSizeBytes << " bytes. Cache directory: "
+					<< sCacheDir << llendl;
+			return;
+		}
+		llwarns << "Could not initialize the pack store; using per-asset files instead."
+				<< llendl;
+	}
+	if (sCacheValid && !second_instance)
+	{
+		sUseJournal = true;
+		if (loadJournal())
+		{
+			sCurrentSizeBytes = sJournalBytes;
+			llinfos << "Nominal cache size: " << sNominalSizeBytes
+					<< " bytes. Maximal cache size: " << sMaxSizeBytes
+					<< " bytes. Current cache size (from journal): "
+					<< sCurrentSizeBytes << " bytes. Cache directory: "
+					<< sCacheDir << llendl;
+			return;
+		}
+	}
 	if (sCacheValid)
 	{
 #if LL_WINDOWS
@@ -186,6 +319,10 @@ void LLDiskCache::shutdown()
 	// Stop changing the cache now !
 	sCacheValid = false;
 
+	// Note: this also aborts any compaction in progress in the purge thread.
+	LLPackStore::shutdown();
+
+	bool purge_stopped = true;
 	if (sPurgeThread)
 	{
 		U32 loops = 0;
@@ -201,11 +338,20 @@ void LLDiskCache::shutdown()
 		{
 			llwarns << "Timeout waiting for the cache purging thread to stop. Force-removing it."
 					<< llendl;
+			purge_stopped = false;
 		}
 		delete sPurgeThread;
 		sPurgeThread = NULL;
 		sPurging = false;
 	}
+
+	// Do not save a journal which could have been left in an inconsistent
+	// state by the purging thread.
+	if (sUseJournal && purge_stopped)
+	{
+		saveJournal();
+	}
+	sUseJournal = false;
 }
 
 //static
@@ -247,6 +393,17 @@ void LLDiskCache::clear()
 	{
 		llinfos << "No cache directory: nothing to clear." << llendl;
 	}
+	if (LLPackStore::isEnabled())
+	{
+		LLPackStore::clear();
+	}
+	if (sUseJournal)
+	{
+		LLMutexLock lock(sJournalMutex);
+		journal_clear();
+		// The cache is now empty, so the journal is accurate.
+		sJournalValid = true;
+	}
 	sCurrentSizeBytes = 0;
 }
 
@@ -261,6 +418,37 @@ void LLDiskCache::purge()
 
 	sPurging = true;
 
+	U64 files_budget = sNominalSizeBytes;
+	bool packed = LLPackStore::isEnabled();
+	if (packed)
+	{
+		// Per-asset files are only written in pack store mode by sibling
+		// viewer instances. They are purged below in LRU order, like in the
+		// per-asset files mode, but may only take up to half the nominal
+		// cache size, the pack store getting the rest. The files left over
+		// from a former session without the pack store, and not used by any
+		// sibling since, are never read by us: they are removed. HB
+		files_budget /= 2;
+	}
+	else if (sUseJournal)
+	{
+		bool valid;
+		{
+			LLMutexLock lock(sJournalMutex);
+			valid = sJournalValid;
+		}
+		if (valid)
+		{
+			purgeWithJournal();
+			sPurging = false;
+			return;
+		}
+		// The journal will be rebuilt from the files we are going to scan:
+		// any write from another viewer instance from now on will have to
+		// invalidate it again.
+		LLFile::remove(sCacheDir + "journal.invalid");
+	}
+
 	typedef std::pair<time_t, std::pair<U64, std::string> > file_info_t;
 	std::vector<file_info_t> file_info;
 
@@ -308,7 +496,20 @@ void LLDiskCache::purge()
 	{
 		const file_info_t& entry = file_info[i];
 		files_size_total += entry.second.first;
-		bool removed = files_size_total > sNominalSizeBytes;
+		bool removed = files_size_total > files_budget ||
+					   (packed && entry.first < sStaleFilesTime);
+		if (removed && sUseJournal)
+		{
+			// Since we do not touch the files any more when using the journal,
+			// check the latter for any access since we scanned the file. HB
+			LLMutexLock lock(sJournalMutex);
+			journal_map_t::iterator it =
+				sJournal.find(journal_name(entry.second.second));
+			if (it != sJournal.end() && it->second.mAccessTime > entry.first)
+			{
+				removed = false;
+			}
+		}
 		if (removed)
 		{
 			try
@@ -339,6 +540,44 @@ void LLDiskCache::purge()
 							   << entry.second.second << LL_ENDL;
 	}
 
+	if (sUseJournal)
+	{
+		// Rebuild the journal from the files we found and kept. The files
+		// accessed or written during the scan are already in the journal and
+		// are more recent than the scanned ones. HB
+		LLMutexLock lock(sJournalMutex);
+		U64 bytes_total = 0;
+		for (U32 i = 0; i < count; ++i)
+		{
+			const file_info_t& entry = file_info[i];
+			bytes_total += entry.second.first;
+			if (bytes_total > sNominalSizeBytes &&
+				!LLFile::exists(entry.second.second))
+			{
+				continue;	// Purged file
+			}
+			std::string name = journal_name(entry.second.second);
+			if (!sJournal.count(name))
+			{
+				journal_add(name, entry.second.first, entry.first, false);
+			}
+		}
+		sJournalValid = true;
+		llinfos << "Cache journal rebuilt with " << sJournal.size()
+				<< " entries." << llendl;
+	}
+
+	U64 pack_bytes = 0;
+	if (packed)
+	{
+		// The pack store keeps its entries in LRU order: no need to scan and
+		// sort anything for it. HB
+		U64 files_bytes = files_size_total - removed_bytes;
+		LLPackStore::purge(sNominalSizeBytes > files_bytes ?
+							sNominalSizeBytes - files_bytes : 0);
+		pack_bytes = LLPackStore::getDiskSize();
+	}
+
 	sPurging = false;
 
 #if 0	// This would be more accurate for a single running viewer instance (no
@@ -352,7 +591,7 @@ void LLDiskCache::purge()
 		// init()).
 	sCurrentSizeBytes -= removed_bytes;
 #else
-	sCurrentSizeBytes = files_size_total - removed_bytes;
+	sCurrentSizeBytes = files_size_total - removed_bytes + pack_bytes;
 #endif
 
 	U32 ms = (U32)(purge_timer.getElapsedTimeF32() * 1000.f);
@@ -372,6 +611,269 @@ void LLDiskCache::purge()
 						   << " bytes." << LL_ENDL;
 }
 
+//static
+void LLDiskCache::purgeWithJournal()
+{
+	LLTimer purge_timer;
+	purge_timer.reset();
+
+	// Pick the victims from the end of the LRU list: this is O(purged files)
+	// and involves no directory scan. HB
+	typedef std::pair<std::string, LLCacheFileInfo> victim_t;
+	std::vector<victim_t> victims;
+	{
+		LLMutexLock lock(sJournalMutex);
+		while (sJournalBytes > sNominalSizeBytes && !sJournalLRU.empty())
+		{
+			journal_map_t::iterator it = sJournal.find(sJournalLRU.back());
+			if (it == sJournal.end())	// Should never happen...
+			{
+				sJournalLRU.pop_back();
+				continue;
+			}
+			victims.emplace_back(it->first, it->second);
+			journal_erase(it);
+		}
+	}
+
+	U64 removed_bytes = 0;
+	U32 purged_files = 0;
+	std::string filename;
+	for (U32 i = 0, count = victims.size(); i < count; ++i)
+	{
+		const victim_t& victim = victims[i];
+		filename = (sCacheDir + victim.first[0]) + LL_DIR_DELIM_STR +
+				   victim.first;
+		// Verify that the file did not get touched by another viewer instance
+		// since we last accessed it.
+		time_t last_write = LLFile::lastModidied(filename);
+		if (last_write > victim.second.mAccessTime)
+		{
+			LL_DEBUGS("DiskCache") << "Skipped updated file: " << filename
+								   << LL_ENDL;
+			LLMutexLock lock(sJournalMutex);
+			if (!sJournal.count(victim.first))
+			{
+				journal_add(victim.first, victim.second.mSize, last_write);
+			}
+			continue;
+		}
+		if (LLFile::remove(filename))
+		{
+			++purged_files;
+			removed_bytes += victim.second.mSize;
+			LL_DEBUGS("DiskCache") << "Removed " << filename << LL_ENDL;
+		}
+	}
+
+	{
+		LLMutexLock lock(sJournalMutex);
+		sCurrentSizeBytes = sJournalBytes;
+	}
+
+	U32 ms = (U32)(purge_timer.getElapsedTimeF32() * 1000.f);
+	llinfos << "Cache purge (from journal) took " << ms << "ms to execute. "
+			<< purged_files << " purged files and " << removed_bytes
+			<< " bytes removed. " << sCurrentSizeBytes
+			<< " bytes now in cache." << llendl;
+}
+
+//static
+bool LLDiskCache::loadJournal()
+{
+	std::string journal = sCacheDir + "journal.dat";
+	std::string flag = sCacheDir + "journal.invalid";
+	if (LLFile::exists(flag))
+	{
+		llinfos << "Cache journal invalidated by another viewer instance."
+				<< llendl;
+		LLFile::remove(journal);
+		return false;
+	}
+	LLFILE* file = LLFile::open(journal, "rb");
+	if (!file)
+	{
+		return false;
+	}
+
+	LLMutexLock lock(sJournalMutex);
+	journal_clear();
+
+	bool success = false;
+	U32 header[3];
+	if (fread(header, sizeof(U32), 3, file) == 3 &&
+		header[0] == JOURNAL_MAGIC && header[1] == JOURNAL_VERSION)
+	{
+		success = true;
+		// The entries are saved in LRU order.
+		U32 size;
+		S64 time;
+		U8 length;
+		char name[256];
+		for (U32 i = 0, count = header[2]; i < count; ++i)
+		{
+			if (fread(&size, sizeof(U32), 1, file) != 1 ||
+				fread(&time, sizeof(S64), 1, file) != 1 ||
+				fread(&length, 1, 1, file) != 1 || !length ||
+				fread(name, 1, length, file) != length)
+			{
+				success = false;
+				break;
+			}
+			journal_add(std::string(name, length), size, (time_t)time, false);
+		}
+	}
+	LLFile::close(file);
+
+	// The journal is only valid until the cache files get modified: remove it
+	// now, so that the cache gets scanned again should we crash. It will be
+	// saved again on shutdown.
+	LLFile::remove(journal);
+
+	if (!success)
+	{
+		llwarns << "Invalid cache journal; the cache will be scanned."
+				<< llendl;
+		journal_clear();
+		return false;
+	}
+	sJournalValid = true;
+	llinfos << "Cache journal loaded with " << sJournal.size() << " entries."
+			<< llendl;
+	return true;
+}
+
+//static
+void LLDiskCache::saveJournal()
+{
+	LLMutexLock lock(sJournalMutex);
+	if (!sJournalValid)
+	{
+		return;
+	}
+	if (LLFile::exists(sCacheDir + "journal.invalid"))
+	{
+		llinfos << "Cache journal invalidated by another viewer instance: not saving it."
+				<< llendl;
+		return;
+	}
+
+	std::string journal = sCacheDir + "journal.dat";
+	LLFILE* file = LLFile::open(journal, "wb");
+	if (!file)
+	{
+		llwarns << "Could not save the cache journal: " << journal << llendl;
+		return;
+	}
+
+	bool success = true;
+	U32 header[3] = { JOURNAL_MAGIC, JOURNAL_VERSION,
+					  (U32)sJournalLRU.size() };
+	success &= fwrite(header, sizeof(U32), 3, file) == 3;
+	for (journal_lru_t::const_iterator it = sJournalLRU.begin(),
+									   end = sJournalLRU.end();
+		 success && it != end; ++it)
+	{
+		const LLCacheFileInfo& info = sJournal[*it];
+		S64 time = info.mAccessTime;
+		U8 length = (U8)llmin(it->size(), (size_t)255);
+		success &= fwrite(&info.mSize, sizeof(U32), 1, file) == 1 &&
+				   fwrite(&time, sizeof(S64), 1, file) == 1 &&
+				   fwrite(&length, 1, 1, file) == 1 &&
+				   fwrite(it->data(), 1, length, file) == length;
+	}
+	LLFile::close(file);
+
+	if (success)
+	{
+		llinfos << "Cache journal saved with " << sJournalLRU.size()
+				<< " entries." << llendl;
+	}
+	else
+	{
+		llwarns << "Failure to write the cache journal: " << journal
+				<< llendl;
+		LLFile::remove(journal);
+	}
+}
+
+//static
+bool LLDiskCache::updateJournal(const std::string& file_path, S32 bytes)
+{
+	std::string name = journal_name(file_path);
+	time_t now = computer_time();
+
+	LLMutexLock lock(sJournalMutex);
+	journal_map_t::iterator it = sJournal.find(name);
+	if (it == sJournal.end())
+	{
+		// Not yet known file: get its actual size.
+		U32 size = LLFile::getFileSize(file_path);
+		if (!size)
+		{
+			return false;
+		}
+		LLCacheFileInfo& info = journal_add(name, size, now);
+		if (bytes)
+		{
+			// Just written: its time stamp is up to date.
+			info.mTouchTime = now;
+			return false;
+		}
+		return true;
+	}
+
+	LLCacheFileInfo& info = it->second;
+	S64 size = (S64)info.mSize + bytes;
+	if (size <= 0 && bytes < 0)
+	{
+		// Removed file
+		journal_erase(it);
+		return false;
+	}
+	sJournalBytes += size - (S64)info.mSize;
+	info.mSize = size;
+	info.mAccessTime = now;
+	sJournalLRU.splice(sJournalLRU.begin(), sJournalLRU, info.mLRUIter);
+
+	if (bytes)
+	{
+		info.mTouchTime = now;
+		return false;
+	}
+	if (now - info.mTouchTime <= TIME_THRESHOLD)
+	{
+		return false;
+	}
+	info.mTouchTime = now;
+	return true;
+}
+
+//static
+void LLDiskCache::fileRenamed(const std::string& old_path,
+							  const std::string& new_path)
+{
+	if (!sUseJournal)
+	{
+		return;
+	}
+
+	std::string new_name = journal_name(new_path);
+	LLMutexLock lock(sJournalMutex);
+	journal_map_t::iterator it = sJournal.find(new_name);
+	if (it != sJournal.end())
+	{
+		journal_erase(it);
+	}
+	it = sJournal.find(journal_name(old_path));
+	if (it != sJournal.end())
+	{
+		U32 size = it->second.mSize;
+		journal_erase(it);
+		journal_add(new_name, size, computer_time());
+	}
+}
+
 // Must be called from the main thread only !
 //static
 void LLDiskCache::threadedPurge()
@@ -421,10 +923,29 @@ std::string LLDiskCache::getFilePath(const LLUUID& id, const char* extra_info)
 }
 
 //static
-void LLDiskCache::addBytesWritten(S32 bytes)
+void LLDiskCache::addBytesWritten(S32 bytes, const std::string& file_path)
 {
 	LL_TRACY_TIMER(TRC_DISKCACHE_UPDSIZE);
 
+	if (sUseJournal && !file_path.empty())
+	{
+		updateJournal(file_path, bytes);
+	}
+	else if (sSecondInstance && bytes > 0)
+	{
+		// Invalidate the journal of the first viewer instance, since it will
+		// not know about the files we write. HB
+		std::string flag = sCacheDir + "journal.invalid";
+		if (!LLFile::exists(flag))
+		{
+			LLFILE* file = LLFile::open(flag, "wb");
+			if (file)
+			{
+				LLFile::close(file);
+			}
+		}
+	}
+
 	sCurrentSizeBytes += bytes;
 
 	// If not called by the main thread, or a threaded purging is in progress,
@@ -452,24 +973,41 @@ void LLDiskCache::updateFileAccessTime(const std::string& filename)
 	// Current time
 	const time_t cur_time = computer_time();
 
-	// Last write time
-	time_t last_write = LLFile::lastModidied(filename);
-
-	// We only write the new value if 'threshold' has elapsed since the last
-	// write.
-	time_t threshold = sPurging ? TIME_THRESHOLD_PURGE : TIME_THRESHOLD;
-	if (cur_time - last_write > threshold)
+	if (sUseJournal)
+	{
+		// Update the journal entry, and only touch the file when it was not
+		// touched in the last TIME_THRESHOLD seconds: the journal is only
+		// saved on clean shutdowns, and the access times would otherwise be
+		// lost on a crash (the cache would then get scanned and the journal
+		// rebuilt from the files time stamps). HB
+		if (!updateJournal(filename, 0))
+		{
+			return;
+		}
+	}
+	else
 	{
-		boost::system::error_code ec;
+		// Last write time
+		time_t last_write = LLFile::lastModidied(filename);
+
+		// We only write the new value if 'threshold' has elapsed since the
+		// last write.
+		time_t threshold = sPurging ? TIME_THRESHOLD_PURGE : TIME_THRESHOLD;
+		if (cur_time - last_write <= threshold)
+		{
+			return;
+		}
+	}
+
+	boost::system::error_code ec;
 #if LL_WINDOWS
-		last_write_time(ll_convert_string_to_wide(filename), cur_time, ec);
+	last_write_time(ll_convert_string_to_wide(filename), cur_time, ec);
 #else
-		last_write_time(filename, cur_time, ec);
+	last_write_time(filename, cur_time, ec);
 #endif
-		if (ec.failed())
-		{
-			llwarns << "Failure to touch \"" << filename
-					<< "\". Reason: " << ec.message() << llendl;
-		}
+	if (ec.failed())
+	{
+		llwarns << "Failure to touch \"" << filename
+				<< "\". Reason: " << ec.message() << llendl;
 	}
 }
@@ -20,6 +20,8 @@
  *  - Proper and threaded auto-purging of the cache when it exceeds 150% of
  *    its nominal size.
  *  - Multiple threads and multiple viewer instances deconfliction.
+ *  - Journal of the cache files sizes and access times, avoiding directory
+ *    scans on startup and when purging.
  *
  * Second Life Viewer Source Code
  * The source code in this file ("Source Code") is provided by Linden Lab
@@ -74,7 +76,11 @@ public:
 	// vanish, the remaining instances will still fight over the cache purging,
 	// but there is an additionnal randomization of the max cache size for
 	// these instances...
-	static void init(U64 nominal_size_bytes, bool second_instance);
+	// When 'use_pack_store' is true, the assets are stored in the LLPackStore
+	// segments instead of in individual files. Since the pack store cannot be
+	// shared between viewer instances, it is only used by the first instance.
+	static void init(U64 nominal_size_bytes, bool second_instance,
+					 bool use_pack_store = false);
 
 	// Clears the cache by removing all the files in the specified cache
 	// directory individually.
@@ -108,18 +114,38 @@ public:
 	// or writes, since we must guard against a possibly ongoing purge before
 	// an actual read/write would happen) so that the last time the file was
 	// accessed is up to date; this time stamp is used in the mechanism for
-	// purging the cache.
+	// purging the cache. When the journal is in use, the latter gets updated
+	// and the file is only touched every TIME_THRESHOLD seconds, so that the
+	// access times are not lost should the viewer crash before it could save
+	// the journal.
 	static void updateFileAccessTime(const std::string& file_path);
 
 	// Used to update the disk cache about file writes ('bytes' may be negative
-	// when removing or truncating a file).
-	static void addBytesWritten(S32 bytes);
+	// when removing or truncating a file). When 'file_path' is not empty, the
+	// journal entry for that file is updated as well.
+	static void addBytesWritten(S32 bytes,
+								const std::string& file_path =
+									LLStringUtil::null);
+
+	// Used to update the journal after a file got renamed.
+	static void fileRenamed(const std::string& old_path,
+							const std::string& new_path);
 
 private:
 	// Utility method to gather the total size (in bytes) occupied by the cache
 	// files.
 	static U64 cacheDirSize();
 
+	// Purges the cache using the journal entries, when valid.
+	static void purgeWithJournal();
+
+	// Updates the journal entry for 'file_path', adding 'bytes' to its size.
+	// Returns true when the file time stamp should be updated as well.
+	static bool updateJournal(const std::string& file_path, S32 bytes);
+
+	static bool loadJournal();
+	static void saveJournal();
+
 private:
 	// Contains the pointer to the cache purging thread.
 	static LLCachePurgeThread*	sPurgeThread;
@@ -23,6 +23,8 @@
  *    people perverted enough to run a Windows build under Wine under Linux
  *    instead of a Linux native build: yes, I'm perverted since I do it to test
  *    Windows builds under Linux... :-P
+ *  - Added support for the LLPackStore.
+ *  - Added asynchronous reads via the LLLFSThread.
  *
  * Second Life Viewer Source Code
  * The source code in this file ("Source Code") is provided by Linden Lab
@@ -53,6 +55,33 @@
 #include "llfilesystem.h"
 
 #include "lldiskcache.h"
+#include "lllfsthread.h"
+#include "llpackstore.h"
+
+// Forwards the result of a LLLFSThread read to the LLFileSystem responder. HB
+class LLFSAsyncResponder final : public LLLFSThread::Responder
+{
+protected:
+	LOG_CLASS(LLFSAsyncResponder);
+
+public:
+	LLFSAsyncResponder(LLFileSystem::Responder* responder)
+	:	mResponder(responder)
+	{
+	}
+
+	void completed(S32 bytes) override
+	{
+		if (mResponder.notNull())
+		{
+			mResponder->completed(bytes);
+			mResponder = NULL;
+		}
+	}
+
+private:
+	LLPointer<LLFileSystem::Responder>	mResponder;
+};
 
 LLFileSystem::LLFileSystem(const LLUUID& id, S32 mode, const char* extra_info)
 :	mFileID(id),
@@ -61,13 +90,30 @@ LLFileSystem::LLFileSystem(const LLUUID& id, S32 mode, const char* extra_info)
 	mBytesRead(0),
 	mTotalBytesWritten(0),
 	mFilename(LLDiskCache::getFilePath(id, extra_info)),
-	mValid(LLDiskCache::isValid())
+	mValid(LLDiskCache::isValid()),
+	mBufferLoaded(false),
+	mDirty(false)
 {
 	if (extra_info && *extra_info)
 	{
 		mExtraInfo.assign(extra_info);
 	}
 
+	mPacked = mValid && LLPackStore::isEnabled();
+	if (mPacked)
+	{
+		mPackKey = LLPackStore::getKey(id, extra_info);
+		// Getting the size also makes this entry the most recently used one,
+		// which replaces the file access time update. HB
+		S32 size = LLPackStore::getSize(mPackKey, true);
+		mExists = size >= 0;
+		if (mExists && mMode == APPEND)
+		{
+			mPosition = size;
+		}
+		return;
+	}
+
 	mExists = mValid && LLFile::exists(mFilename);
 	if (mExists)
 	{
@@ -92,10 +138,36 @@ LLFileSystem::LLFileSystem(const LLUUID& id, S32 mode, const char* extra_info)
 
 LLFileSystem::~LLFileSystem()
 {
+	if (mDirty)
+	{
+		S32 bytes = LLPackStore::store(mPackKey, mBuffer.data(),
+									   mBuffer.size());
+		if (bytes > 0)
+		{
+			mTotalBytesWritten += bytes;
+		}
+	}
 	if (mTotalBytesWritten)
 	{
 		// Inform the disk cache about how much bytes we added or removed. HB
-		LLDiskCache::addBytesWritten(mTotalBytesWritten);
+		LLDiskCache::addBytesWritten(mTotalBytesWritten, mFilename);
+	}
+}
+
+void LLFileSystem::loadBuffer()
+{
+	if (mBufferLoaded)
+	{
+		return;
+	}
+	mBufferLoaded = true;
+	mBuffer.clear();
+	S32 size = LLPackStore::getSize(mPackKey);
+	if (size > 0)
+	{
+		mBuffer.resize(size);
+		size = LLPackStore::read(mPackKey, mBuffer.data(), 0, size);
+		mBuffer.resize(llmax(size, 0));
 	}
 }
 
@@ -105,6 +177,35 @@ bool LLFileSystem::read(U8* buffer, S32 bytes)
 	{
 		return false;
 	}
+	if (mPacked)
+	{
+		if (mBufferLoaded)
+		{
+			S32 size = mBuffer.size();
+			mBytesRead = llclamp(size - mPosition, 0, bytes);
+			if (mBytesRead)
+			{
+				memcpy((void*)buffer, (void*)(mBuffer.data() + mPosition),
+					   mBytesRead);
+			}
+		}
+		else
+		{
+			mBytesRead = LLPackStore::read(mPackKey, buffer, mPosition, bytes);
+			mExists = mBytesRead >= 0;
+			if (!mExists)
+			{
+				mBytesRead = 0;
+				return false;
+			}
+		}
+		if (!bytes)
+		{
+			return mExists;
+		}
+		mPosition += mBytesRead;
+		return mBytesRead > 0;
+	}
 	if (!bytes)
 	{
 		mExists = LLFile::isfile(mFilename);
@@ -143,6 +244,46 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
 	{
 		return false;
 	}
+	if (mPacked && mMode != READ)
+	{
+		if (bytes < 0 || (bytes && !buffer))
+		{
+			return false;
+		}
+		if (mMode == WRITE && !mBufferLoaded && bytes &&
+			LLPackStore::patch(mPackKey, buffer, mPosition, bytes))
+		{
+			// Written in place in the stored record.
+			mPosition += bytes;
+			mExists = true;
+			return true;
+		}
+		if (mMode == OVERWRITE)
+		{
+			// Discard any existing contents
+			mBuffer.clear();
+			mBufferLoaded = true;
+		}
+		else
+		{
+			loadBuffer();
+		}
+		if (mMode != WRITE)
+		{
+			mPosition = mBuffer.size();
+		}
+		if (mPosition + bytes > (S32)mBuffer.size())
+		{
+			mBuffer.resize(mPosition + bytes);
+		}
+		if (bytes)
+		{
+			memcpy((void*)(mBuffer.data() + mPosition), (void*)buffer, bytes);
+			mPosition += bytes;
+		}
+		mDirty = mExists = true;
+		return true;
+	}
 	if (mMode == APPEND)
 	{
 		// Write to file, appending to it if it already exists.
@@ -233,7 +374,7 @@ bool LLFileSystem::seek(S32 offset, S32 origin)
 		origin = mPosition;
 	}
 	S32 new_pos = origin + offset;
-	S32 size = LLFile::getFileSize(mFilename);
+	S32 size = getSize();
 	if (new_pos > size)
 	{
 		if (mMode == READ)
@@ -243,6 +384,14 @@ bool LLFileSystem::seek(S32 offset, S32 origin)
 			mPosition = size;
 			return false;
 		}
+		else if (mPacked)
+		{
+			loadBuffer();
+			mBuffer.resize(new_pos);	// Note: pads with zeros
+			mPosition = new_pos;
+			mDirty = mExists = true;
+			return true;
+		}
 		else	// Append zeros to the file up to the new position. HB
 		{
 			mPosition = size;
@@ -297,7 +446,19 @@ bool LLFileSystem::seek(S32 offset, S32 origin)
 
 S32 LLFileSystem::getSize() const
 {
-	return mValid ? (S32)LLFile::getFileSize(mFilename) : 0;
+	if (!mValid)
+	{
+		return 0;
+	}
+	if (mPacked)
+	{
+		if (mBufferLoaded)
+		{
+			return mBuffer.size();
+		}
+		return llmax(LLPackStore::getSize(mPackKey), 0);
+	}
+	return (S32)LLFile::getFileSize(mFilename);
 }
 
 bool LLFileSystem::remove()
@@ -307,6 +468,17 @@ bool LLFileSystem::remove()
 		return false;
 	}
 	mExists = false;
+	if (mPacked)
+	{
+		mBuffer.clear();
+		mBufferLoaded = mDirty = false;
+		S32 bytes = LLPackStore::remove(mPackKey);
+		if (bytes > 0)
+		{
+			mTotalBytesWritten += bytes;
+		}
+		return bytes >= 0;
+	}
 	llstat st;
 	if (LLFile::stat(mFilename, &st))
 	{
@@ -326,15 +498,43 @@ bool LLFileSystem::rename(const LLUUID& new_id)
 	}
 	std::string newfname = LLDiskCache::getFilePath(new_id,
 													mExtraInfo.c_str());
+	if (mPacked)
+	{
+		mFilename = newfname;
+		LLUUID new_key = LLPackStore::getKey(new_id, mExtraInfo.c_str());
+		S32 bytes;
+		if (mDirty)
+		{
+			// The pending data will get stored with the new key on
+			// destruction; just remove the old entry.
+			bytes = LLPackStore::remove(mPackKey);
+		}
+		else
+		{
+			bytes = LLPackStore::rename(mPackKey, new_key);
+			mExists = bytes >= 0;
+		}
+		mPackKey = new_key;
+		if (bytes > 0)
+		{
+			mTotalBytesWritten += bytes;
+		}
+		return mExists;
+	}
 	// First remove the new file when it exists
 	llstat st;
 	if (LLFile::stat(newfname, &st) == 0)
 	{
-		mTotalBytesWritten -= st.st_size;
+		// Account for it now, since mTotalBytesWritten is for our file. HB
+		LLDiskCache::addBytesWritten(-st.st_size, newfname);
 		LLFile::remove(newfname);
 	}
 	// Note: this call may fail and will appropriately warn in the log...
 	mExists = LLFile::rename(mFilename, newfname);
+	if (mExists)
+	{
+		LLDiskCache::fileRenamed(mFilename, newfname);
+	}
 	mFilename = newfname;
 	return mExists;
 }
@@ -346,6 +546,11 @@ bool LLFileSystem::getExists(const LLUUID& id, const char* extra_info)
 	{
 		return false;
 	}
+	if (LLPackStore::isEnabled())
+	{
+		LLUUID key = LLPackStore::getKey(id, extra_info);
+		return LLPackStore::getSize(key) >= 0;
+	}
 	return LLFile::isfile(LLDiskCache::getFilePath(id, extra_info));
 }
 
@@ -356,6 +561,11 @@ S32 LLFileSystem::getFileSize(const LLUUID& id, const char* extra_info)
 	{
 		return 0;
 	}
+	if (LLPackStore::isEnabled())
+	{
+		LLUUID key = LLPackStore::getKey(id, extra_info);
+		return llmax(LLPackStore::getSize(key), 0);
+	}
 	return LLFile::getFileSize(LLDiskCache::getFilePath(id, extra_info));
 }
 
@@ -366,6 +576,15 @@ bool LLFileSystem::removeFile(const LLUUID& id, const char* extra_info)
 	{
 		return false;
 	}
+	if (LLPackStore::isEnabled())
+	{
+		S32 bytes = LLPackStore::remove(LLPackStore::getKey(id, extra_info));
+		if (bytes > 0)
+		{
+			LLDiskCache::addBytesWritten(bytes);
+		}
+		return bytes >= 0;
+	}
 	std::string filename = LLDiskCache::getFilePath(id, extra_info);
 	llstat st;
 	if (LLFile::stat(filename, &st))
@@ -375,7 +594,7 @@ bool LLFileSystem::removeFile(const LLUUID& id, const char* extra_info)
 	}
 	if (st.st_size)
 	{
-		LLDiskCache::addBytesWritten(-st.st_size);
+		LLDiskCache::addBytesWritten(-st.st_size, filename);
 	}
 	return LLFile::remove(filename);
 }
@@ -388,20 +607,108 @@ bool LLFileSystem::renameFile(const LLUUID& old_id, const LLUUID& new_id,
 	{
 		return false;
 	}
+	if (LLPackStore::isEnabled())
+	{
+		S32 bytes =
+			LLPackStore::rename(LLPackStore::getKey(old_id, extra_info),
+								LLPackStore::getKey(new_id, extra_info));
+		if (bytes > 0)
+		{
+			LLDiskCache::addBytesWritten(bytes);
+		}
+		return bytes >= 0;
+	}
 
 	std::string old_filename = LLDiskCache::getFilePath(old_id, extra_info);
 	std::string new_filename = LLDiskCache::getFilePath(new_id, extra_info);
 	// First remove the new file when it exists
 	llstat st;
-	if (LLFile::stat(old_filename, &st) == 0)
+	if (LLFile::isfile(old_filename) && LLFile::stat(new_filename, &st) == 0)
 	{
 		if (st.st_size)
 		{
-			LLDiskCache::addBytesWritten(-st.st_size);
+			LLDiskCache::addBytesWritten(-st.st_size, new_filename);
 		}
 		LLFile::remove(new_filename);
 	}
 
 	// Note: this call may fail and will appropriately warn in the log...
-	return LLFile::rename(old_filename, new_filename);
+	if (!LLFile::rename(old_filename, new_filename))
+	{
+		return false;
+	}
+	LLDiskCache::fileRenamed(old_filename, new_filename);
+	return true;
+}
+
+//static
+void LLFileSystem::readAsync(const LLUUID& id, U8* buffer, S32 offset,
+							 S32 bytes, Responder* responder,
+							 const char* extra_info)
+{
+	// Keep a reference, so that the responder gets deleted on early returns
+	// when the caller did not keep one.
+	LLPointer<Responder> responderp = responder;
+
+	if (!LLDiskCache::isValid() || !buffer || bytes <= 0 || offset < 0)
+	{
+		if (responderp.notNull())
+		{
+			responderp->completed(0);
+		}
+		return;
+	}
+
+	if (!LLLFSThread::sLocal)
+	{
+		// Synchronous operation.
+		LLFileSystem file(id, READ, extra_info);
+		S32 read = 0;
+		if (file.exists() && file.seek(offset, 0) && file.read(buffer, bytes))
+		{
+			read = file.getLastBytesRead();
+		}
+		if (responderp.notNull())
+		{
+			responderp->completed(read);
+		}
+		return;
+	}
+
+	if (LLPackStore::isEnabled())
+	{
+		// Read the record data directly from its segment, keeping the latter
+		// open for the next reads.
+		std::string filename;
+		S32 data_offset, size;
+		if (!LLPackStore::locate(LLPackStore::getKey(id, extra_info),
+								 filename, data_offset, size) ||
+			offset >= size)
+		{
+			if (responderp.notNull())
+			{
+				responderp->completed(0);
+			}
+			return;
+		}
+		LLLFSThread::sLocal->read(filename, buffer, data_offset + offset,
+								  llmin(bytes, size - offset),
+								  new LLFSAsyncResponder(responder), 0, true);
+		return;
+	}
+
+	std::string filename = LLDiskCache::getFilePath(id, extra_info);
+	if (!LLFile::isfile(filename))
+	{
+		// Do not bother the LFS thread with a cache miss.
+		if (responderp.notNull())
+		{
+			responderp->completed(0);
+		}
+		return;
+	}
+	LLDiskCache::updateFileAccessTime(filename);
+
+	LLLFSThread::sLocal->read(filename, buffer, offset, bytes,
+							  new LLFSAsyncResponder(responder));
 }
@@ -23,6 +23,8 @@
  *    people perverted enough to run a Windows build under Wine under Linux
  *    instead of a Linux native build: yes, I'm perverted since I do it to test
  *    Windows builds under Linux... :-P
+ *  - Added support for the LLPackStore.
+ *  - Added asynchronous reads and writes via the LLLFSThread.
  *
  * Second Life Viewer Source Code
  * The source code in this file ("Source Code") is provided by Linden Lab
@@ -51,10 +53,17 @@
 #ifndef LL_FILESYSTEM_H
 #define LL_FILESYSTEM_H
 
+#include <vector>
+
+#include "llrefcount.h"
 #include "lluuid.h"
 
 // NOTE: this class supports only 2GB or smaller files (way more than what we
 // do need).
+// When the LLPackStore is in use, the data to write is accumulated in memory
+// and only stored on destruction of the LLFileSystem instance (since the pack
+// store segments are append-only), save for writes in WRITE mode within the
+// stored data size, which are done in place. HB
 
 class LLFileSystem
 {
@@ -85,6 +94,8 @@ public:
 	LL_INLINE S32 tell() const						{ return mPosition; }
 	LL_INLINE bool eof() const						{ return mPosition >= getSize(); }
 	LL_INLINE S32 getLastBytesRead() const			{ return mBytesRead; }
+	// true when the data is stored in the LLPackStore
+	LL_INLINE bool isPacked() const					{ return mPacked; }
 	S32 getSize() const;
 
 	// WARNING: mExists is cached and this method can therefore return a wrong
@@ -102,16 +113,50 @@ public:
 						   const char* extra_info = NULL);
 	static S32 getFileSize(const LLUUID& id, const char* extra_info = NULL);
 
+	// Responder for the asynchronous operations below.
+	class Responder : public LLThreadSafeRefCount
+	{
+	protected:
+		LOG_CLASS(LLFileSystem::Responder);
+
+		~Responder() override = default;
+
+	public:
+		// 'bytes' is the number of bytes read (0 on failure).
+		virtual void completed(S32 bytes) = 0;
+	};
+
+	// Asynchronous reads, queued to the LLLFSThread, which submits them in
+	// batches to io_uring when in use, so that many cache accesses may
+	// overlap. The responder is called from the LFS thread once done, or from
+	// the calling thread when the read gets performed synchronously (which is
+	// the case for cache misses, or when there is no LFS thread). With the
+	// LLPackStore, reads are done directly from the segment files, which the
+	// LFS thread keeps open. 'buffer' must stay valid until the responder got
+	// called.
+	static void readAsync(const LLUUID& id, U8* buffer, S32 offset,
+						  S32 bytes, Responder* responder,
+						  const char* extra_info = NULL);
+
+private:
+	// Loads the stored data into mBuffer, for writing in LLPackStore mode.
+	void loadBuffer();
+
 protected:
-	LLUUID		mFileID;
-	std::string	mFilename;
-	std::string	mExtraInfo;
-	S32			mMode;
-	S32			mPosition;
-	S32			mBytesRead;
-	S32			mTotalBytesWritten;
-	bool		mExists;			// true when the file exists
-	bool		mValid;				// true when the disk cache is valid
+	LLUUID			mFileID;
+	LLUUID			mPackKey;		// Key in the LLPackStore
+	std::string		mFilename;
+	std::string		mExtraInfo;
+	std::vector<U8>	mBuffer;		// Data to write in LLPackStore mode
+	S32				mMode;
+	S32				mPosition;
+	S32				mBytesRead;
+	S32				mTotalBytesWritten;
+	bool			mExists;		// true when the file exists
+	bool			mValid;			// true when the disk cache is valid
+	bool			mPacked;		// true when using the LLPackStore
+	bool			mBufferLoaded;	// true when mBuffer holds the data
+	bool			mDirty;			// true when mBuffer must be stored
 };
 
 #endif	// LL_FILESYSTEM_H
@@ -34,10 +34,28 @@
 
 #include "lllfsthread.h"
 
+#include "llmemory.h"
 #include "llstl.h"
 
 #if LL_LINUX
 # define INVALID_HANDLE_VALUE -1
+
+// Maximum number of prepared io_uring requests before they get submitted, even
+// when more requests are queued. HB
+constexpr U32 MAX_SUBMIT_BATCH = 32;
+
+// Registered buffers pool: 1MB in total, so to fit in the default memlock
+// limit. Only requests for up to FIXED_BUFFER_SIZE bytes may use them. HB
+constexpr U32 FIXED_BUFFERS = 16;
+constexpr U32 FIXED_BUFFER_SIZE = 65536;
+
+// Size of the registered files table, which is also the maximum number of
+// files kept open. HB
+constexpr U32 FIXED_FILES = 256;
+
+// Files to close, as requested via LLLFSThread::closeFile(). HB
+static LLMutex sFilesToCloseMutex;
+static std::vector<std::string> sFilesToClose;
 #endif
 
 // Static members
@@ -77,7 +95,13 @@ void LLLFSThread::cleanupClass()
 #if LL_LINUX
 	if (sUseIoUring)
 	{
+		sLocal->closeKeptOpenFiles();
 		io_uring_queue_exit(&(sLocal->mRing));
+		if (sLocal->mFixedBuffers)
+		{
+			ll_aligned_free(sLocal->mFixedBuffers);
+			sLocal->mFixedBuffers = NULL;
+		}
 	}
 #elif LL_WINDOWS
 	if (sUseIoUring && sLocal->mIOCPPort != INVALID_HANDLE_VALUE)
@@ -95,6 +119,10 @@ LLLFSThread::LLLFSThread(bool threaded)
 :	LLQueuedThread("LFS", threaded),
 #if LL_LINUX || LL_WINDOWS
 	mPendingResults(0),
+#endif
+#if LL_LINUX
+	mPreparedRequests(0),
+	mFixedBuffers(NULL),
 #endif
 	mPriorityCounter(PRIORITY_LOWBITS)
 {
@@ -117,6 +145,7 @@ LLLFSThread::LLLFSThread(bool threaded)
 			// Make sure it does not get inherited by sub-processes
 			io_uring_ring_dontfork(&mRing);
 			sRingInitialized = true;
+			registerFixedResources();
 		}
 # elif LL_WINDOWS
 		mIOCPPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, NULL,
@@ -129,7 +158,8 @@ LLLFSThread::LLLFSThread(bool threaded)
 
 LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,
 										U8* buffer, S32 offset, S32 numbytes,
-										Responder* responder, U32 priority)
+										Responder* responder, U32 priority,
+										bool keep_open)
 {
 	handle_t handle = generateHandle();
 
@@ -144,7 +174,8 @@ LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,
 	}
 
 	Request* req = new Request(this, handle, priority, FILE_READ, filename,
-							   buffer, offset, numbytes, responder);
+							   buffer, offset, numbytes, responder,
+							   keep_open);
 
 	bool res = addRequest(req);
 	if (!res)
@@ -178,6 +209,18 @@ LLLFSThread::handle_t LLLFSThread::write(const std::string& filename,
 	return handle;
 }
 
+//static
+void LLLFSThread::closeFile(const std::string& filename)
+{
+#if LL_LINUX
+	if (sRingInitialized)
+	{
+		LLMutexLock lock(sFilesToCloseMutex);
+		sFilesToClose.emplace_back(filename);
+	}
+#endif
+}
+
 #if LL_LINUX || LL_WINDOWS
 // Lets have some fun with overlapped I/O and io_uring ;-)
 // (c)2021 Kathrine Jansma
@@ -201,6 +244,21 @@ void LLLFSThread::threadedUpdate()
 	}
 
 # if LL_LINUX
+	closePendingFiles();
+
+	// Submit the prepared requests once there are no more queued requests to
+	// prepare, so that they get submitted together. HB
+	if (mPreparedRequests)
+	{
+		lockData();
+		bool queue_empty = mRequestQueue.empty();
+		unlockData();
+		if (queue_empty)
+		{
+			submitPrepared();
+		}
+	}
+
 	struct io_uring_cqe* cqe;
 # elif LL_WINDOWS
 	DWORD bytes_processed = 0;
@@ -233,14 +291,8 @@ void LLLFSThread::threadedUpdate()
 				io_uring_cqe_seen(&mRing, cqe);
 				break;
 			}
-			if (bytes_handled >= 0)
-			{
-				req->setBytesRead(bytes_handled);
-			}
-			else	// An I/O error occurred: mark as such.
-			{
-				req->setBytesRead(0);
-			}
+			// On I/O error, mark as such with 0 bytes.
+			req->ringCompleted(bytes_handled >= 0 ? bytes_handled : 0);
 			// true = resquest is over and must auto-complete (self-destruct)
 			setRequestResult(req, true);
 			io_uring_cqe_seen(&mRing, cqe);
@@ -300,13 +352,199 @@ void LLLFSThread::threadedUpdate()
 }
 #endif	// LL_LINUX || LL_WINDOWS
 
+#if LL_LINUX
+//virtual
+void LLLFSThread::endThread()
+{
+	// Do not leave any prepared request behind.
+	submitPrepared();
+}
+
+void LLLFSThread::addPrepared()
+{
+	++mPendingResults;
+	if (++mPreparedRequests >= MAX_SUBMIT_BATCH)
+	{
+		submitPrepared();
+	}
+}
+
+void LLLFSThread::submitPrepared()
+{
+	if (mPreparedRequests && sRingInitialized)
+	{
+		S32 ret = io_uring_submit(&mRing);
+		if (ret < 0)
+		{
+			llwarns << "io_uring submission failed. Error code: " << ret
+					<< llendl;
+		}
+		mPreparedRequests = 0;
+	}
+}
+
+void LLLFSThread::registerFixedResources()
+{
+	// Registered buffers spare the kernel the mapping and pinning of the
+	// requests buffer pages for each operation, at the cost of a memcpy() of
+	// the data. When their registration fails (e.g. because of a too low
+	// memlock limit), we simply do without them. HB
+	mFixedBuffers = (U8*)ll_aligned_malloc(FIXED_BUFFERS * FIXED_BUFFER_SIZE,
+										   4096);
+	if (mFixedBuffers)
+	{
+		struct iovec iovecs[FIXED_BUFFERS];
+		for (U32 i = 0; i < FIXED_BUFFERS; ++i)
+		{
+			iovecs[i].iov_base = mFixedBuffers + i * FIXED_BUFFER_SIZE;
+			iovecs[i].iov_len = FIXED_BUFFER_SIZE;
+		}
+		S32 ret = io_uring_register_buffers(&mRing, iovecs, FIXED_BUFFERS);
+		if (ret)
+		{
+			llwarns << "Failed to register io_uring buffers. Error code: "
+					<< ret << llendl;
+			ll_aligned_free(mFixedBuffers);
+			mFixedBuffers = NULL;
+		}
+		else
+		{
+			mFreeBuffers.reserve(FIXED_BUFFERS);
+			for (U32 i = 0; i < FIXED_BUFFERS; ++i)
+			{
+				mFreeBuffers.push_back(i);
+			}
+		}
+	}
+
+	// Sparse registered files table, which slots get filled with the files
+	// kept open, sparing the kernel the file descriptor lookup for each of
+	// their reads. HB
+	std::vector<int> files(FIXED_FILES, -1);
+	S32 ret = io_uring_register_files(&mRing, files.data(), FIXED_FILES);
+	if (ret)
+	{
+		llwarns << "Failed to register io_uring files. Error code: " << ret
+				<< llendl;
+	}
+	else
+	{
+		mFreeFileSlots.reserve(FIXED_FILES);
+		for (U32 i = FIXED_FILES; i > 0; )
+		{
+			mFreeFileSlots.push_back(--i);
+		}
+	}
+}
+
+S32 LLLFSThread::getFixedBuffer(S32 bytes)
+{
+	if (mFreeBuffers.empty() || bytes <= 0 || bytes > (S32)FIXED_BUFFER_SIZE)
+	{
+		return -1;
+	}
+	S32 index = mFreeBuffers.back();
+	mFreeBuffers.pop_back();
+	return index;
+}
+
+U8* LLLFSThread::getFixedBufferData(S32 index)
+{
+	return mFixedBuffers + (size_t)index * FIXED_BUFFER_SIZE;
+}
+
+void LLLFSThread::getKeptOpenFile(const std::string& filename, S32& fd,
+								  S32& slot)
+{
+	// Process any pending close request first, so that we do not reuse a
+	// stale descriptor for a file which got deleted and recreated since.
+	closePendingFiles();
+
+	kept_files_map_t::iterator it = mKeptOpenFiles.find(filename);
+	if (it != mKeptOpenFiles.end())
+	{
+		fd = it->second.first;
+		slot = it->second.second;
+		return;
+	}
+
+	slot = -1;
+	if (mKeptOpenFiles.size() >= FIXED_FILES)
+	{
+		fd = -1;
+		return;
+	}
+	fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return;
+	}
+	if (!mFreeFileSlots.empty() &&
+		io_uring_register_files_update(&mRing, mFreeFileSlots.back(), &fd,
+									   1) == 1)
+	{
+		slot = mFreeFileSlots.back();
+		mFreeFileSlots.pop_back();
+	}
+	mKeptOpenFiles.emplace(filename, std::make_pair(fd, slot));
+}
+
+void LLLFSThread::closePendingFiles()
+{
+	std::vector<std::string> files;
+	{
+		LLMutexLock lock(sFilesToCloseMutex);
+		if (sFilesToClose.empty())
+		{
+			return;
+		}
+		files.swap(sFilesToClose);
+	}
+
+	// Prepared requests could use the registered file slots we are about to
+	// free, so submit them first.
+	submitPrepared();
+
+	for (U32 i = 0, count = files.size(); i < count; ++i)
+	{
+		kept_files_map_t::iterator it = mKeptOpenFiles.find(files[i]);
+		if (it == mKeptOpenFiles.end())
+		{
+			continue;
+		}
+		S32 slot = it->second.second;
+		if (slot >= 0)
+		{
+			// The kernel keeps its own reference to the file for the
+			// requests in flight.
+			int none = -1;
+			io_uring_register_files_update(&mRing, slot, &none, 1);
+			mFreeFileSlots.push_back(slot);
+		}
+		close(it->second.first);
+		mKeptOpenFiles.erase(it);
+	}
+}
+
+void LLLFSThread::closeKeptOpenFiles()
+{
+	for (kept_files_map_t::iterator it = mKeptOpenFiles.begin(),
+									end = mKeptOpenFiles.end();
+		 it != end; ++it)
+	{
+		close(it->second.first);
+	}
+	mKeptOpenFiles.clear();
+}
+#endif
+
 //============================================================================
 
 LLLFSThread::Request::Request(LLLFSThread* thread,
 							  handle_t handle, U32 priority,
 							  operation_t op, const std::string& filename,
 							  U8* buffer, S32 offset, S32 numbytes,
-							  Responder* responder)
+							  Responder* responder, bool keep_open)
 :	QueuedRequest(handle, priority,
 				  sUseIoUring ? FLAG_AUTO_COMPLETE | FLAG_ASYNC
 							  : FLAG_AUTO_COMPLETE),
@@ -316,6 +554,10 @@ LLLFSThread::Request::Request(LLLFSThread* thread,
 	mFile(INVALID_HANDLE_VALUE),
 	mThread(thread),
 #endif
+#if LL_LINUX
+	mFixedBuffer(-1),
+#endif
+	mKeepOpen(keep_open),
 	mBuffer(buffer),
 	mOffset(offset),
 	mBytes(numbytes),
@@ -328,6 +570,23 @@ LLLFSThread::Request::Request(LLLFSThread* thread,
 	}
 }
 
+#if LL_LINUX
+// Called from own thread
+void LLLFSThread::Request::ringCompleted(S32 bytes)
+{
+	mBytesRead = bytes;
+	if (mFixedBuffer >= 0)
+	{
+		if (mOperation == FILE_READ && bytes > 0)
+		{
+			memcpy(mBuffer, mThread->getFixedBufferData(mFixedBuffer), bytes);
+		}
+		mThread->releaseFixedBuffer(mFixedBuffer);
+		mFixedBuffer = -1;
+	}
+}
+#endif
+
 // virtual, called from own thread
 void LLLFSThread::Request::finishRequest(bool completed)
 {
@@ -395,30 +654,41 @@ bool LLLFSThread::Request::processRequest()
 		if (sUseIoUring)
 		{
 # if LL_LINUX
-			S32 infile = open(mFileName.c_str(), O_RDONLY);
-			if (infile < 0)
+			// Kept open files descriptors belong to the thread, so they are
+			// not stored in mFile, which gets closed with the request. HB
+			S32 fd = -1;
+			S32 slot = -1;
+			S32 off = mOffset;
+			if (mKeepOpen && mOffset >= 0)
 			{
-				llwarns << "Unable to read file: " << mFileName << llendl;
-				mBytesRead = 0;		// Failed
-				return true;
+				mThread->getKeptOpenFile(mFileName, fd, slot);
 			}
-			mFile = infile;
-
-			S32 off;
-			if (mOffset < 0)
+			if (fd < 0)
 			{
-				off = lseek(mFile, 0, SEEK_END);
-			}
-			else
-			{
-				off = lseek(mFile, mOffset, SEEK_SET);
-			}
-			if (off < 0)
-			{
-				llwarns << "Unable to read file (seek failed): " << mFileName
-						<< llendl;
-				mBytesRead = 0;		// Failed
-				return true;
+				S32 infile = open(mFileName.c_str(), O_RDONLY);
+				if (infile < 0)
+				{
+					llwarns << "Unable to read file: " << mFileName << llendl;
+					mBytesRead = 0;		// Failed
+					return true;
+				}
+				mFile = fd = infile;
+
+				if (mOffset < 0)
+				{
+					off = lseek(mFile, 0, SEEK_END);
+				}
+				else
+				{
+					off = lseek(mFile, mOffset, SEEK_SET);
+				}
+				if (off < 0)
+				{
+					llwarns << "Unable to read file (seek failed): "
+							<< mFileName << llendl;
+					mBytesRead = 0;		// Failed
+					return true;
+				}
 			}
 
 			// Attach the file handle to the io_uring
@@ -429,14 +699,37 @@ bool LLLFSThread::Request::processRequest()
 				mBytesRead = 0;		// Failed
 				return true;
 			}
-			io_uring_prep_read(sqe, mFile, mBuffer, mBytes, off);
+			if (slot >= 0)
+			{
+				fd = slot;
+			}
+			mFixedBuffer = mThread->getFixedBuffer(mBytes);
+			if (mFixedBuffer >= 0)
+			{
+				U8* data = mThread->getFixedBufferData(mFixedBuffer);
+				io_uring_prep_read_fixed(sqe, fd, data, mBytes, off,
+										 mFixedBuffer);
+			}
+			else
+			{
+				io_uring_prep_read(sqe, fd, mBuffer, mBytes, off);
+			}
+			if (slot >= 0)
+			{
+				io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+			}
 			io_uring_sqe_set_data(sqe, this);
-			io_uring_submit(&(mThread->mRing));
-			++mThread->mPendingResults;
+			mThread->addPrepared();
 # elif LL_WINDOWS
+			// Share all accesses: the pack store segments are opened for
+			// writing by the main thread while we read them, and the files
+			// may get removed or purged while a read is in flight.
 			HANDLE infile =
 				CreateFile(ll_convert_string_to_wide(mFileName).c_str(),
-						   GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+						   GENERIC_READ,
+						   FILE_SHARE_READ | FILE_SHARE_WRITE |
+						   FILE_SHARE_DELETE,
+						   NULL, OPEN_EXISTING,
 						   FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN,
 						   NULL);
 			if (infile == INVALID_HANDLE_VALUE)
@@ -504,8 +797,15 @@ bool LLLFSThread::Request::processRequest()
 		if (sUseIoUring)
 		{
 # if LL_LINUX
-			S32 outfile = open(mFileName.c_str(), O_CREAT | O_WRONLY,
-							   S_IRUSR | S_IWUSR);
+			S32 flags = O_CREAT | O_WRONLY;
+			if (mOffset < 0)
+			{
+				// Since several writes to the same file may be in flight in
+				// the same batch, let the kernel append atomically (it then
+				// ignores the write offset).
+				flags |= O_APPEND;
+			}
+			S32 outfile = open(mFileName.c_str(), flags, S_IRUSR | S_IWUSR);
 			if (outfile < 0)
 			{
 				llwarns << "Unable to write file: " << mFileName << llendl;
@@ -514,12 +814,8 @@ bool LLLFSThread::Request::processRequest()
 			}
 			mFile = outfile;
 
-			S32 off;
-			if (mOffset < 0)
-			{
-				off = lseek(mFile, 0, SEEK_END);
-			}
-			else
+			S32 off = 0;
+			if (mOffset >= 0)
 			{
 				off = lseek(mFile, mOffset, SEEK_SET);
 			}
@@ -539,14 +835,26 @@ bool LLLFSThread::Request::processRequest()
 				mBytesRead = 0;		// Failed
 				return true;
 			}
-			io_uring_prep_write(sqe, mFile, mBuffer, mBytes, off);
+			mFixedBuffer = mThread->getFixedBuffer(mBytes);
+			if (mFixedBuffer >= 0)
+			{
+				U8* data = mThread->getFixedBufferData(mFixedBuffer);
+				memcpy(data, mBuffer, mBytes);
+				io_uring_prep_write_fixed(sqe, mFile, data, mBytes, off,
+										  mFixedBuffer);
+			}
+			else
+			{
+				io_uring_prep_write(sqe, mFile, mBuffer, mBytes, off);
+			}
 			io_uring_sqe_set_data(sqe, this);
-			io_uring_submit(&(mThread->mRing));
-			++mThread->mPendingResults;
+			mThread->addPrepared();
 # elif LL_WINDOWS
 			HANDLE outfile =
 				CreateFile(ll_convert_string_to_wide(mFileName).c_str(),
-						   GENERIC_WRITE, FILE_SHARE_WRITE | FILE_SHARE_READ,
+						   GENERIC_WRITE,
+						   FILE_SHARE_READ | FILE_SHARE_WRITE |
+						   FILE_SHARE_DELETE,
 						   NULL, OPEN_ALWAYS, FILE_FLAG_OVERLAPPED, NULL);
 			if (outfile == INVALID_HANDLE_VALUE)
 			{
@@ -558,11 +866,10 @@ bool LLLFSThread::Request::processRequest()
 
 			if (mOffset < 0)
 			{
-				// Append mode
-				ULARGE_INTEGER FileSize;
-				FileSize.LowPart = GetFileSize(outfile, &FileSize.HighPart);
-				mOverlapped.Offset = FileSize.LowPart;
-				mOverlapped.OffsetHigh = FileSize.HighPart;
+				// Append mode: since several writes to the same file may be
+				// in flight at once, let the system append atomically.
+				mOverlapped.Offset = 0xFFFFFFFF;
+				mOverlapped.OffsetHigh = 0xFFFFFFFF;
 			}
 			else
 			{
@@ -34,11 +34,13 @@
 #define LL_LLLFSTHREAD_H
 
 #include <string>
+#include <vector>
 
 // For io_uring/IOCP support
 #if LL_LINUX
 # include <fcntl.h>
 # include <liburing.h>
+# include "llfastmap.h"
 #elif LL_WINDOWS
 # include "llwin32headerslean.h"
 #endif
@@ -84,7 +86,8 @@ public:
 	public:
 		Request(LLLFSThread* thread, handle_t handle, U32 priority,
 				operation_t op, const std::string& filename, U8* buffer,
-				S32 offset, S32 numbytes, Responder* responder);
+				S32 offset, S32 numbytes, Responder* responder,
+				bool keep_open = false);
 
 		LL_INLINE S32 getBytes()					{ return mBytes; }
 		LL_INLINE S32 getBytesRead()				{ return mBytesRead; }
@@ -92,6 +95,12 @@ public:
 		// We need to set bytes from the manager thread
 		LL_INLINE void setBytesRead(S32 val)		{ mBytesRead = val; }
 #endif
+#if LL_LINUX
+		// Called from the LFS thread when the io_uring operation completed:
+		// sets the bytes read and copies the data from the registered buffer
+		// (if one was used) for reads.
+		void ringCompleted(S32 bytes);
+#endif
 
 		LL_INLINE S32 getOperation()				{ return mOperation; }
 		LL_INLINE U8* getBuffer()					{ return mBuffer; }
@@ -119,8 +128,13 @@ public:
 
 		operation_t				mOperation;
 
+		// When true, the file is kept open by the LFS thread after the read.
+		bool					mKeepOpen;
+
 #if LL_LINUX
 		S32						mFile;
+		// Index of the registered buffer in use, or -1
+		S32						mFixedBuffer;
 #elif LL_WINDOWS
 		HANDLE					mFile;
 		// OVERLAPPED for the read/write operation
@@ -131,8 +145,14 @@ public:
 	LLLFSThread(bool threaded = true);
 
 	// Return a Request handle
+	// When 'keep_open' is true, the file is kept open after the read (and,
+	// with io_uring, registered to the ring whenever possible), so that it
+	// does not need to get reopened for the next reads. Only use this for
+	// long-lived files which are read many times (e.g. the LLPackStore
+	// segments), and call closeFile() before they get deleted or replaced.
 	handle_t read(const std::string& filename, U8* buffer, S32 offset,
-				  S32 numbytes, Responder* responder, U32 pri=0);
+				  S32 numbytes, Responder* responder, U32 pri = 0,
+				  bool keep_open = false);
 	handle_t write(const std::string& filename, U8* buffer, S32 offset,
 				   S32 numbytes, Responder* responder, U32 pri=0);
 
@@ -146,16 +166,60 @@ public:
 	// Deletes sLocal
 	static void cleanupClass();
 
+	// Closes 'filename' when it was kept open by a former read. May be called
+	// from any thread.
+	static void closeFile(const std::string& filename);
+
 #if LL_LINUX || LL_WINDOWS
 protected:
 	// LLQueuedThread overrides
 	bool runCondition() override;
 	void threadedUpdate() override;
 #endif
+#if LL_LINUX
+	void endThread() override;
+
+private:
+	// Called by requests after they prepared their io_uring submission queue
+	// entry. The entries are submitted in batches, with a single system call.
+	void addPrepared();
+	void submitPrepared();
+
+	// Registers a pool of buffers and a sparse files table to the io_uring.
+	void registerFixedResources();
+
+	// Returns the index of a free registered buffer able to hold 'bytes', or
+	// -1 when none is available.
+	S32 getFixedBuffer(S32 bytes);
+	U8* getFixedBufferData(S32 index);
+	LL_INLINE void releaseFixedBuffer(S32 index)	{ mFreeBuffers.push_back(index); }
+
+	// Sets 'fd' to the descriptor of 'filename', opening it and keeping it
+	// open when needed and possible, or to -1. Sets 'slot' to its index in
+	// the registered files table, or to -1 when it is not registered.
+	void getKeptOpenFile(const std::string& filename, S32& fd, S32& slot);
+	// Closes the kept open files for which closeFile() got called.
+	void closePendingFiles();
+	void closeKeptOpenFiles();
+#endif
 
 private:
 #if LL_LINUX || LL_WINDOWS
 	LLAtomicS32			mPendingResults;
+#endif
+#if LL_LINUX
+	// Number of prepared but not yet submitted io_uring requests.
+	U32					mPreparedRequests;
+
+	// Registered buffers, or NULL when they could not be registered.
+	U8*					mFixedBuffers;
+	std::vector<S32>	mFreeBuffers;
+
+	// Files kept open, with their descriptor and registered files table slot.
+	typedef flat_hmap<std::string, std::pair<S32, S32> > kept_files_map_t;
+	kept_files_map_t	mKeptOpenFiles;
+	// Free slots in the registered files table.
+	std::vector<S32>	mFreeFileSlots;
 #endif
 	U32					mPriorityCounter;
 
@@ -0,0 +1,1075 @@
+/**
+ * @file llpackstore.cpp
+ * @brief Pack-file based storage for the assets cache implementation.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <list>
+#include <map>
+
+#include "boost/filesystem.hpp"
+
+#include "llpackstore.h"
+
+#include "lldir.h"
+#include "lldiriterator.h"
+#include "llfastmap.h"
+#include "lllfsthread.h"
+#include "llmutex.h"
+#include "lltimer.h"
+
+constexpr U32 PACK_RECORD_MAGIC = 0x4b435041;	// "APCK"
+// Record size value used for removal records (which got no data).
+constexpr U32 PACK_REMOVED = 0xffffffff;
+constexpr U32 PACK_INDEX_MAGIC = 0x58444950;	// "PIDX"
+constexpr U32 PACK_INDEX_VERSION = 1;
+// When the active segment grows past that size, a new one is started.
+constexpr U32 MAX_SEGMENT_SIZE = 64 * 1048576;
+// Non-active segments with more dead data than this ratio get compacted. This
+// ensures that, once purged, the segments cannot grow past about 143% of the
+// nominal cache size, i.e. under the 150% threshold for the next purge.
+constexpr F32 COMPACTION_DEAD_RATIO = 0.3f;
+
+struct LLPackRecordHeader
+{
+	U32		mMagic;
+	U32		mSize;
+	LLUUID	mKey;
+};
+
+constexpr U32 RECORD_HEADER_SIZE = sizeof(LLPackRecordHeader);
+
+typedef std::list<LLUUID> lru_list_t;
+
+struct LLPackEntry
+{
+	lru_list_t::iterator	mLRUIter;
+	U32						mSegment;
+	U32						mOffset;	// Offset of the record header
+	U32						mSize;		// Size of the data
+};
+
+struct LLPackSegment
+{
+	LLFILE*					mFile;
+	U32						mSize;
+	U32						mLiveBytes;
+	U32						mLiveCount;
+};
+
+typedef fast_hmap<LLUUID, LLPackEntry> entries_map_t;
+typedef std::map<U32, LLPackSegment> segments_map_t;
+
+// All the store data below is protected by sPackMutex.
+static LLMutex sPackMutex;
+static entries_map_t sEntries;
+// Most recently used keys first.
+static lru_list_t sLRU;
+static segments_map_t sSegments;
+// Number of in-place record patches so far.
+static U32 sPatchCount = 0;
+
+// Static variable members
+std::string LLPackStore::sDir;
+LLAtomic<U64> LLPackStore::sDiskBytes(0);
+LLAtomic<U64> LLPackStore::sLiveBytes(0);
+LLAtomicBool LLPackStore::sEnabled(false);
+
+///////////////////////////////////////////////////////////////////////////////
+// Helper functions. They all expect sPackMutex to be locked by the caller,
+// save for segment_filename(), and read_at() when used on a private handle.
+///////////////////////////////////////////////////////////////////////////////
+
+static std::string segment_filename(const std::string& dir, U32 id)
+{
+	return dir + llformat("%08x.pack", id);
+}
+
+static bool read_at(LLFILE* file, U32 offset, void* buffer, U32 bytes)
+{
+	return !fseek(file, offset, SEEK_SET) &&
+		   fread(buffer, 1, bytes, file) == bytes;
+}
+
+static bool write_at(LLFILE* file, U32 offset, const void* buffer, U32 bytes)
+{
+	return !fseek(file, offset, SEEK_SET) &&
+		   fwrite(buffer, 1, bytes, file) == bytes;
+}
+
+static void add_live(U32 segment, U32 data_size)
+{
+	segments_map_t::iterator it = sSegments.find(segment);
+	if (it != sSegments.end())
+	{
+		it->second.mLiveBytes += RECORD_HEADER_SIZE + data_size;
+		++it->second.mLiveCount;
+	}
+}
+
+static void mark_dead(const LLPackEntry& entry)
+{
+	segments_map_t::iterator it = sSegments.find(entry.mSegment);
+	if (it != sSegments.end())
+	{
+		LLPackSegment& segment = it->second;
+		segment.mLiveBytes -= RECORD_HEADER_SIZE + entry.mSize;
+		--segment.mLiveCount;
+	}
+}
+
+// Appends a record to the active segment, starting a new one when needed.
+// Returns false on failure, or true with the segment and offset of the new
+// record.
+static bool append_record(const std::string& dir, const LLUUID& key,
+						  const U8* data, U32 size, U32& segment_id,
+						  U32& offset)
+{
+	U32 record_size = RECORD_HEADER_SIZE;
+	if (size != PACK_REMOVED)
+	{
+		record_size += size;
+	}
+
+	segments_map_t::reverse_iterator rit = sSegments.rbegin();
+	if (rit == sSegments.rend() ||
+		(rit->second.mSize &&
+		 rit->second.mSize + record_size > MAX_SEGMENT_SIZE))
+	{
+		segment_id = rit == sSegments.rend() ? 1 : rit->first + 1;
+		std::string filename = segment_filename(dir, segment_id);
+		LLFILE* file = LLFile::open(filename, "w+b");
+		if (!file)
+		{
+			llwarns << "Could not create segment file: " << filename
+					<< llendl;
+			return false;
+		}
+		LLPackSegment& segment = sSegments[segment_id];
+		segment.mFile = file;
+		segment.mSize = segment.mLiveBytes = segment.mLiveCount = 0;
+		rit = sSegments.rbegin();
+	}
+	segment_id = rit->first;
+	LLPackSegment& segment = rit->second;
+
+	LLPackRecordHeader header;
+	header.mMagic = PACK_RECORD_MAGIC;
+	header.mSize = size;
+	header.mKey = key;
+	offset = segment.mSize;
+	if (!write_at(segment.mFile, offset, &header, RECORD_HEADER_SIZE) ||
+		(size && size != PACK_REMOVED &&
+		 fwrite(data, 1, size, segment.mFile) != size))
+	{
+		llwarns << "Failure to write in segment " << segment_id << llendl;
+		// Whatever got written will be overwritten by the next record.
+		return false;
+	}
+	// Always flush, since the readers use their own file handles.
+	fflush(segment.mFile);
+	segment.mSize += record_size;
+	return true;
+}
+
+// Sets the entry for 'key', superseding any former one, and makes it the most
+// recently used.
+static void set_entry(const LLUUID& key, U32 segment, U32 offset, U32 size)
+{
+	entries_map_t::iterator it = sEntries.find(key);
+	if (it == sEntries.end())
+	{
+		sLRU.emplace_front(key);
+		it = sEntries.emplace(key, LLPackEntry()).first;
+	}
+	else
+	{
+		mark_dead(it->second);
+		sLRU.splice(sLRU.begin(), sLRU, it->second.mLRUIter);
+	}
+	LLPackEntry& entry = it->second;
+	entry.mLRUIter = sLRU.begin();
+	entry.mSegment = segment;
+	entry.mOffset = offset;
+	entry.mSize = size;
+	add_live(segment, size);
+}
+
+// Removes the entry for 'key', if any, returning its data size or -1.
+static S32 remove_entry(const LLUUID& key)
+{
+	entries_map_t::iterator it = sEntries.find(key);
+	if (it == sEntries.end())
+	{
+		return -1;
+	}
+	S32 size = it->second.mSize;
+	mark_dead(it->second);
+	sLRU.erase(it->second.mLRUIter);
+	sEntries.erase(it);
+	return size;
+}
+
+static void delete_segment(const std::string& dir,
+						   segments_map_t::iterator it)
+{
+	LLFile::close(it->second.mFile);
+	std::string filename = segment_filename(dir, it->first);
+	// The LFS thread may keep it open for the direct reads: since segment
+	// numbers get reused after a clear(), it must let go of it.
+	LLLFSThread::closeFile(filename);
+	LLFile::remove(filename);
+	sSegments.erase(it);
+}
+
+static U64 total_segments_size()
+{
+	U64 total = 0;
+	for (segments_map_t::const_iterator it = sSegments.begin(),
+										end = sSegments.end();
+		 it != end; ++it)
+	{
+		total += it->second.mSize;
+	}
+	return total;
+}
+
+static U64 total_live_size()
+{
+	U64 total = 0;
+	for (segments_map_t::const_iterator it = sSegments.begin(),
+										end = sSegments.end();
+		 it != end; ++it)
+	{
+		total += it->second.mLiveBytes;
+	}
+	return total;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LLPackStore class
+///////////////////////////////////////////////////////////////////////////////
+
+//static
+bool LLPackStore::init(const std::string& dir)
+{
+	LLMutexLock lock(sPackMutex);
+
+	sDir = dir;
+	if (!LLFile::mkdir(sDir))
+	{
+		llwarns << "Could not create the pack store directory: " << sDir
+				<< llendl;
+		return false;
+	}
+	sDir += LL_DIR_DELIM_CHR;
+
+	LLTimer timer;
+	std::string filename;
+	LLDirIterator iter(sDir, "*.pack", DI_SIZE);
+	while (iter.next(filename))
+	{
+		U32 id = strtoul(filename.c_str(), NULL, 16);
+		if (!id)
+		{
+			continue;
+		}
+		LLFILE* file = LLFile::open(sDir + filename, "r+b");
+		if (!file)
+		{
+			llwarns << "Could not open segment file: " << filename << llendl;
+			continue;
+		}
+		LLPackSegment& segment = sSegments[id];
+		segment.mFile = file;
+		segment.mSize = iter.getSize();
+		segment.mLiveBytes = segment.mLiveCount = 0;
+	}
+
+	if (!loadIndex())
+	{
+		rebuildIndex();
+	}
+	// The index is only valid until the segments get modified: remove it now,
+	// so that it gets rebuilt from the segments should we crash. It will be
+	// saved again on shutdown.
+	LLFile::remove(sDir + "index.dat");
+
+	sDiskBytes = total_segments_size();
+	sLiveBytes = total_live_size();
+	sEnabled = true;
+
+	llinfos << "Pack store initialized in "
+			<< (U32)(timer.getElapsedTimeF32() * 1000.f) << "ms, with "
+			<< sSegments.size() << " segments and " << sEntries.size()
+			<< " entries. Disk usage: " << sDiskBytes << " bytes, of which "
+			<< sLiveBytes << " bytes are live data." << llendl;
+	return true;
+}
+
+//static
+void LLPackStore::shutdown()
+{
+	if (!sEnabled)
+	{
+		return;
+	}
+	// Reset first, so that a compaction in progress in the purge thread will
+	// abort as soon as it gets the lock.
+	sEnabled = false;
+
+	LLMutexLock lock(sPackMutex);
+	saveIndex();
+	for (segments_map_t::iterator it = sSegments.begin(),
+								  end = sSegments.end();
+		 it != end; ++it)
+	{
+		LLFile::close(it->second.mFile);
+	}
+	sSegments.clear();
+	sEntries.clear();
+	sLRU.clear();
+	sDiskBytes = sLiveBytes = 0;
+	llinfos << "Pack store shut down." << llendl;
+}
+
+//static
+void LLPackStore::clear()
+{
+	LLMutexLock lock(sPackMutex);
+	while (!sSegments.empty())
+	{
+		delete_segment(sDir, sSegments.begin());
+	}
+	sEntries.clear();
+	sLRU.clear();
+	sDiskBytes = sLiveBytes = 0;
+}
+
+//static
+LLUUID LLPackStore::getKey(const LLUUID& id, const char* extra_info)
+{
+	if (!extra_info || !*extra_info)
+	{
+		return id;
+	}
+	LLUUID extra_id;
+	extra_id.generate(std::string(extra_info));
+	return id.combine(extra_id);
+}
+
+//static
+S32 LLPackStore::getSize(const LLUUID& key, bool touch)
+{
+	LLMutexLock lock(sPackMutex);
+	if (!sEnabled)
+	{
+		return -1;
+	}
+	entries_map_t::iterator it = sEntries.find(key);
+	if (it == sEntries.end())
+	{
+		return -1;
+	}
+	if (touch)
+	{
+		sLRU.splice(sLRU.begin(), sLRU, it->second.mLRUIter);
+	}
+	return it->second.mSize;
+}
+
+//static
+S32 LLPackStore::read(const LLUUID& key, U8* buffer, S32 offset, S32 bytes)
+{
+	// Only copy the index entry while holding the lock, and read the data
+	// with our own file handle, so that other threads do not get stalled by
+	// our disk accesses. Should the record get moved by a compaction in the
+	// meantime, its segment may get deleted before we could open it: retry
+	// with the new entry when this happens.
+	LLPackRecordHeader header;
+	for (U32 attempt = 0; attempt < 2; ++attempt)
+	{
+		U32 segment, record_offset, size;
+		{
+			LLMutexLock lock(sPackMutex);
+			if (!sEnabled)
+			{
+				return -1;
+			}
+			entries_map_t::iterator it = sEntries.find(key);
+			if (it == sEntries.end())
+			{
+				return -1;
+			}
+			const LLPackEntry& entry = it->second;
+			segment = entry.mSegment;
+			record_offset = entry.mOffset;
+			size = entry.mSize;
+		}
+		if (offset < 0 || offset >= (S32)size)
+		{
+			return 0;
+		}
+		LLFILE* file = LLFile::open(segment_filename(sDir, segment), "rb");
+		if (!file)
+		{
+			continue;
+		}
+		bytes = llmin(bytes, (S32)size - offset);
+		S32 read = 0;
+		// Verify that the record is still the one we expect.
+		if (read_at(file, record_offset, &header, RECORD_HEADER_SIZE) &&
+			header.mMagic == PACK_RECORD_MAGIC && header.mKey == key &&
+			header.mSize == size &&
+			!fseek(file, record_offset + RECORD_HEADER_SIZE + offset,
+				   SEEK_SET))
+		{
+			read = fread(buffer, 1, bytes, file);
+		}
+		LLFile::close(file);
+		return read;
+	}
+	return 0;
+}
+
+//static
+bool LLPackStore::locate(const LLUUID& key, std::string& filename,
+						 S32& offset, S32& size)
+{
+	LLMutexLock lock(sPackMutex);
+	if (!sEnabled)
+	{
+		return false;
+	}
+	entries_map_t::iterator it = sEntries.find(key);
+	if (it == sEntries.end())
+	{
+		return false;
+	}
+	const LLPackEntry& entry = it->second;
+	sLRU.splice(sLRU.begin(), sLRU, entry.mLRUIter);
+	filename = segment_filename(sDir, entry.mSegment);
+	offset = entry.mOffset + RECORD_HEADER_SIZE;
+	size = entry.mSize;
+	return true;
+}
+
+//static
+S32 LLPackStore::store(const LLUUID& key, const U8* data, S32 size)
+{
+	if (size < 0)
+	{
+		return -1;
+	}
+	LLMutexLock lock(sPackMutex);
+	if (!sEnabled)
+	{
+		return -1;
+	}
+	U32 segment, offset;
+	if (!append_record(sDir, key, data, size, segment, offset))
+	{
+		return -1;
+	}
+	set_entry(key, segment, offset, size);
+	sLiveBytes = total_live_size();
+	S32 bytes = RECORD_HEADER_SIZE + size;
+	sDiskBytes += bytes;
+	return bytes;
+}
+
+//static
+bool LLPackStore::patch(const LLUUID& key, const U8* data, S32 offset,
+						S32 bytes)
+{
+	if (!data || offset < 0 || bytes <= 0)
+	{
+		return false;
+	}
+	LLMutexLock lock(sPackMutex);
+	if (!sEnabled)
+	{
+		return false;
+	}
+	entries_map_t::iterator it = sEntries.find(key);
+	if (it == sEntries.end() || offset + bytes > (S32)it->second.mSize)
+	{
+		return false;
+	}
+	const LLPackEntry& entry = it->second;
+	segments_map_t::iterator sit = sSegments.find(entry.mSegment);
+	if (sit == sSegments.end())
+	{
+		return false;
+	}
+	LLFILE* file = sit->second.mFile;
+	if (!write_at(file, entry.mOffset + RECORD_HEADER_SIZE + offset, data,
+				  bytes))
+	{
+		llwarns << "Failure to write in segment " << entry.mSegment
+				<< llendl;
+		return false;
+	}
+	// Always flush, since the readers use their own file handles.
+	fflush(file);
+	++sPatchCount;
+	sLRU.splice(sLRU.begin(), sLRU, entry.mLRUIter);
+	return true;
+}
+
+//static
+S32 LLPackStore::remove(const LLUUID& key)
+{
+	LLMutexLock lock(sPackMutex);
+	if (!sEnabled)
+	{
+		return -1;
+	}
+	if (remove_entry(key) < 0)
+	{
+		return 0;
+	}
+	sLiveBytes = total_live_size();
+	// Append a removal record, so that the removal is not undone when the
+	// index gets rebuilt from the segments.
+	U32 segment, offset;
+	if (!append_record(sDir, key, NULL, PACK_REMOVED, segment, offset))
+	{
+		return -1;
+	}
+	sDiskBytes += RECORD_HEADER_SIZE;
+	return RECORD_HEADER_SIZE;
+}
+
+//static
+S32 LLPackStore::rename(const LLUUID& old_key, const LLUUID& new_key)
+{
+	if (old_key == new_key)
+	{
+		return 0;
+	}
+
+	// Read the data outside of the lock, with our own file handle.
+	U32 old_segment, old_offset, size, patches;
+	{
+		LLMutexLock lock(sPackMutex);
+		if (!sEnabled)
+		{
+			return -1;
+		}
+		entries_map_t::iterator it = sEntries.find(old_key);
+		if (it == sEntries.end())
+		{
+			return -1;
+		}
+		const LLPackEntry& entry = it->second;
+		old_segment = entry.mSegment;
+		old_offset = entry.mOffset;
+		size = entry.mSize;
+		patches = sPatchCount;
+	}
+	std::vector<U8> buffer(size);
+	if (size)
+	{
+		LLFILE* file = LLFile::open(segment_filename(sDir, old_segment),
+									"rb");
+		if (!file)
+		{
+			return -1;
+		}
+		bool success = read_at(file, old_offset + RECORD_HEADER_SIZE,
+							   buffer.data(), size);
+		LLFile::close(file);
+		if (!success)
+		{
+			return -1;
+		}
+	}
+
+	LLMutexLock lock(sPackMutex);
+	if (!sEnabled)
+	{
+		return -1;
+	}
+	entries_map_t::iterator it = sEntries.find(old_key);
+	if (it == sEntries.end() || it->second.mSize != size)
+	{
+		return -1;
+	}
+	// Should the record have been moved or patched meanwhile, read it again,
+	// under the lock this time (this should be very rare).
+	const LLPackEntry& entry = it->second;
+	if (entry.mSegment != old_segment || entry.mOffset != old_offset ||
+		patches != sPatchCount)
+	{
+		segments_map_t::iterator sit = sSegments.find(entry.mSegment);
+		if (sit == sSegments.end() ||
+			(size &&
+			 !read_at(sit->second.mFile, entry.mOffset + RECORD_HEADER_SIZE,
+					  buffer.data(), size)))
+		{
+			return -1;
+		}
+	}
+
+	U32 segment, offset;
+	if (!append_record(sDir, new_key, buffer.data(), size, segment, offset))
+	{
+		return -1;
+	}
+	set_entry(new_key, segment, offset, size);
+	S32 bytes = RECORD_HEADER_SIZE + size;
+	remove_entry(old_key);
+	if (append_record(sDir, old_key, NULL, PACK_REMOVED, segment, offset))
+	{
+		bytes += RECORD_HEADER_SIZE;
+	}
+	sLiveBytes = total_live_size();
+	sDiskBytes += bytes;
+	return bytes;
+}
+
+//static
+void LLPackStore::purge(U64 nominal_size)
+{
+	LLTimer timer;
+
+	U32 evicted = 0;
+	{
+		LLMutexLock lock(sPackMutex);
+		if (!sEnabled)
+		{
+			return;
+		}
+		// Since the LRU list is ordered, this is O(evicted entries). The
+		// records of the evicted entries simply become dead data; no removal
+		// record is needed since, should they resurrect on an index rebuild,
+		// they would still be valid data.
+		U64 live_bytes = sLiveBytes;
+		while (live_bytes > nominal_size && !sLRU.empty())
+		{
+			S32 size = remove_entry(sLRU.back());
+			if (size >= 0)
+			{
+				live_bytes -= RECORD_HEADER_SIZE + size;
+			}
+			++evicted;
+		}
+		sLiveBytes = total_live_size();
+	}
+
+	U64 disk_bytes = sDiskBytes;
+	compact();
+
+	llinfos << "Pack store purge took "
+			<< (U32)(timer.getElapsedTimeF32() * 1000.f) << "ms. "
+			<< evicted << " evicted entries and "
+			<< (S64)(disk_bytes - (U64)sDiskBytes)
+			<< " bytes reclaimed by compaction. " << sDiskBytes
+			<< " bytes now in store." << llendl;
+}
+
+//static
+void LLPackStore::compact()
+{
+	// Find the segments to compact; never compact the active (last) segment.
+	std::vector<U32> segments;
+	{
+		LLMutexLock lock(sPackMutex);
+		if (sSegments.size() < 2)
+		{
+			return;
+		}
+		U32 active = sSegments.rbegin()->first;
+		for (segments_map_t::const_iterator it = sSegments.begin(),
+											end = sSegments.end();
+			 it != end; ++it)
+		{
+			const LLPackSegment& segment = it->second;
+			if (it->first != active &&
+				(!segment.mLiveCount ||
+				 segment.mSize - segment.mLiveBytes >
+					(U32)(COMPACTION_DEAD_RATIO * (F32)segment.mSize)))
+			{
+				segments.push_back(it->first);
+			}
+		}
+	}
+
+	LLPackRecordHeader header;
+	std::vector<U8> buffer;
+	for (U32 i = 0, count = segments.size(); i < count; ++i)
+	{
+		U32 id = segments[i];
+		// The records are read with our own file handle and without holding
+		// the lock, which is only held while updating the index and appending
+		// the moved records, one at a time, so that the other threads do not
+		// get stalled for long. Since records are only ever appended to the
+		// active segment, the records of this segment cannot change meanwhile,
+		// save for in-place patches, which we detect via sPatchCount.
+		LLFILE* file = LLFile::open(segment_filename(sDir, id), "rb");
+		if (!file)
+		{
+			llwarns << "Could not open segment " << id << " for compaction."
+					<< llendl;
+			continue;
+		}
+		U32 offset = 0;
+		bool compacted = false;
+		while (true)
+		{
+			bool oldest;
+			U32 patches;
+			{
+				LLMutexLock lock(sPackMutex);
+				if (!sEnabled)
+				{
+					LLFile::close(file);
+					return;
+				}
+				segments_map_t::iterator sit = sSegments.find(id);
+				if (sit == sSegments.end())
+				{
+					break;
+				}
+				const LLPackSegment& segment = sit->second;
+				// Removal records must be kept as long as an older segment
+				// may still hold a record for their key, or the latter would
+				// get resurrected on the next index rebuild. So, unless this
+				// is the oldest segment, we must scan it to its end.
+				oldest = sit == sSegments.begin();
+				if (offset >= segment.mSize ||
+					(oldest && !segment.mLiveCount))
+				{
+					compacted = true;
+					break;
+				}
+				patches = sPatchCount;
+			}
+
+			if (!read_at(file, offset, &header, RECORD_HEADER_SIZE) ||
+				header.mMagic != PACK_RECORD_MAGIC)
+			{
+				llwarns << "Could not compact segment " << id
+						<< ": live records not found." << llendl;
+				break;
+			}
+			bool removal = header.mSize == PACK_REMOVED;
+			U32 data_size = removal ? 0 : header.mSize;
+			U32 data_offset = offset + RECORD_HEADER_SIZE;
+			buffer.resize(data_size);
+			if (data_size &&
+				!read_at(file, data_offset, buffer.data(), data_size))
+			{
+				llwarns << "Failure to read a record while compacting segment "
+						<< id << llendl;
+				break;
+			}
+
+			LLMutexLock lock(sPackMutex);
+			if (!sEnabled)
+			{
+				LLFile::close(file);
+				return;
+			}
+			entries_map_t::iterator it = sEntries.find(header.mKey);
+			U32 new_segment, new_offset;
+			if (removal)
+			{
+				// Move the removal record unless the key got stored again
+				// since (the new record then supersedes any older one).
+				if (!oldest && it == sEntries.end())
+				{
+					if (!append_record(sDir, header.mKey, NULL, PACK_REMOVED,
+									   new_segment, new_offset))
+					{
+						llwarns << "Failure to move a removal record while compacting segment "
+								<< id << llendl;
+						break;
+					}
+					sDiskBytes += RECORD_HEADER_SIZE;
+				}
+			}
+			else if (it != sEntries.end() && it->second.mSegment == id &&
+					 it->second.mOffset == offset)
+			{
+				// Re-read the data, should it have been patched meanwhile.
+				if (patches != sPatchCount && data_size &&
+					!read_at(file, data_offset, buffer.data(), data_size))
+				{
+					llwarns << "Failure to read a record while compacting segment "
+							<< id << llendl;
+					break;
+				}
+				if (!append_record(sDir, header.mKey, buffer.data(),
+								   data_size, new_segment, new_offset))
+				{
+					llwarns << "Failure to move a record while compacting segment "
+							<< id << llendl;
+					break;
+				}
+				sDiskBytes += RECORD_HEADER_SIZE + data_size;
+				// Move the entry, keeping its position in the LRU list.
+				LLPackEntry& entry = it->second;
+				mark_dead(entry);
+				entry.mSegment = new_segment;
+				entry.mOffset = new_offset;
+				add_live(new_segment, data_size);
+			}
+			offset = data_offset + data_size;
+		}
+		// Close our handle before deleting the segment file (needed under
+		// Windows).
+		LLFile::close(file);
+		if (compacted)
+		{
+			LLMutexLock lock(sPackMutex);
+			segments_map_t::iterator sit = sSegments.find(id);
+			if (sEnabled && sit != sSegments.end())
+			{
+				sDiskBytes -= sit->second.mSize;
+				delete_segment(sDir, sit);
+			}
+		}
+	}
+}
+
+//static
+bool LLPackStore::loadIndex()
+{
+	std::string filename = sDir + "index.dat";
+	LLFILE* file = LLFile::open(filename, "rb");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool success = false;
+	U32 header[3];
+	if (fread(header, sizeof(U32), 3, file) == 3 &&
+		header[0] == PACK_INDEX_MAGIC && header[1] == PACK_INDEX_VERSION &&
+		header[2] == sSegments.size())
+	{
+		success = true;
+		// Verify that the segments did not change since the index was saved.
+		U32 segment_info[2];
+		for (U32 i = 0, count = header[2]; i < count; ++i)
+		{
+			if (fread(segment_info, sizeof(U32), 2, file) != 2)
+			{
+				success = false;
+				break;
+			}
+			segments_map_t::iterator it = sSegments.find(segment_info[0]);
+			if (it == sSegments.end() || it->second.mSize != segment_info[1])
+			{
+				success = false;
+				break;
+			}
+		}
+		U32 count = 0;
+		if (success && fread(&count, sizeof(U32), 1, file) != 1)
+		{
+			success = false;
+		}
+		// The entries are saved in LRU order.
+		LLUUID key;
+		U32 entry_info[3];
+		for (U32 i = 0; success && i < count; ++i)
+		{
+			if (fread(key.mData, 1, UUID_BYTES, file) != UUID_BYTES ||
+				fread(entry_info, sizeof(U32), 3, file) != 3)
+			{
+				success = false;
+				break;
+			}
+			segments_map_t::iterator it = sSegments.find(entry_info[0]);
+			if (it == sSegments.end() ||
+				entry_info[1] + RECORD_HEADER_SIZE + entry_info[2] >
+					it->second.mSize)
+			{
+				success = false;
+				break;
+			}
+			sLRU.emplace_back(key);
+			LLPackEntry& entry = sEntries[key];
+			entry.mLRUIter = --sLRU.end();
+			entry.mSegment = entry_info[0];
+			entry.mOffset = entry_info[1];
+			entry.mSize = entry_info[2];
+			add_live(entry.mSegment, entry.mSize);
+		}
+	}
+	LLFile::close(file);
+
+	if (!success)
+	{
+		llwarns << "Invalid or outdated pack store index; rebuilding it."
+				<< llendl;
+		sEntries.clear();
+		sLRU.clear();
+		for (segments_map_t::iterator it = sSegments.begin(),
+									  end = sSegments.end();
+			 it != end; ++it)
+		{
+			it->second.mLiveBytes = it->second.mLiveCount = 0;
+		}
+	}
+	return success;
+}
+
+//static
+void LLPackStore::rebuildIndex()
+{
+	llinfos << "Rebuilding the pack store index from the segments..."
+			<< llendl;
+
+	LLPackRecordHeader header;
+	for (segments_map_t::iterator it = sSegments.begin(),
+								  end = sSegments.end();
+		 it != end; ++it)
+	{
+		U32 id = it->first;
+		LLPackSegment& segment = it->second;
+		U32 offset = 0;
+		while (offset + RECORD_HEADER_SIZE <= segment.mSize)
+		{
+			if (!read_at(segment.mFile, offset, &header, RECORD_HEADER_SIZE) ||
+				header.mMagic != PACK_RECORD_MAGIC ||
+				(header.mSize != PACK_REMOVED &&
+				 offset + RECORD_HEADER_SIZE + header.mSize > segment.mSize))
+			{
+				break;
+			}
+			if (header.mSize == PACK_REMOVED)
+			{
+				remove_entry(header.mKey);
+				offset += RECORD_HEADER_SIZE;
+			}
+			else
+			{
+				// Later records are more recent, and supersede former ones.
+				set_entry(header.mKey, id, offset, header.mSize);
+				offset += RECORD_HEADER_SIZE + header.mSize;
+			}
+		}
+		if (offset < segment.mSize)
+		{
+			// Truncated or corrupted record (e.g. after a crash while
+			// writing): drop the end of the segment.
+			llwarns << "Truncating segment " << id << " at offset " << offset
+					<< llendl;
+			LLFile::close(segment.mFile);
+			std::string filename = segment_filename(sDir, id);
+			boost::system::error_code ec;
+#if LL_WINDOWS
+			boost::filesystem::resize_file(ll_convert_string_to_wide(filename),
+										   offset, ec);
+#else
+			boost::filesystem::resize_file(filename, offset, ec);
+#endif
+			if (ec.failed())
+			{
+				llwarns << "Failure to truncate \"" << filename
+						<< "\". Reason: " << ec.message() << llendl;
+			}
+			segment.mFile = LLFile::open(filename, "r+b");
+			segment.mSize = offset;
+		}
+	}
+
+	// Remove any segment we could not reopen.
+	for (segments_map_t::iterator it = sSegments.begin();
+		 it != sSegments.end(); )
+	{
+		if (it->second.mFile)
+		{
+			++it;
+		}
+		else
+		{
+			sSegments.erase(it++);
+		}
+	}
+}
+
+//static
+void LLPackStore::saveIndex()
+{
+	std::string filename = sDir + "index.dat";
+	LLFILE* file = LLFile::open(filename, "wb");
+	if (!file)
+	{
+		llwarns << "Could not save the pack store index: " << filename
+				<< llendl;
+		return;
+	}
+
+	bool success = true;
+	U32 header[3] = { PACK_INDEX_MAGIC, PACK_INDEX_VERSION,
+					  (U32)sSegments.size() };
+	success &= fwrite(header, sizeof(U32), 3, file) == 3;
+	U32 segment_info[2];
+	for (segments_map_t::const_iterator it = sSegments.begin(),
+										end = sSegments.end();
+		 success && it != end; ++it)
+	{
+		segment_info[0] = it->first;
+		segment_info[1] = it->second.mSize;
+		success &= fwrite(segment_info, sizeof(U32), 2, file) == 2;
+	}
+	U32 count = sLRU.size();
+	success &= fwrite(&count, sizeof(U32), 1, file) == 1;
+	U32 entry_info[3];
+	for (lru_list_t::const_iterator it = sLRU.begin(), end = sLRU.end();
+		 success && it != end; ++it)
+	{
+		const LLPackEntry& entry = sEntries[*it];
+		entry_info[0] = entry.mSegment;
+		entry_info[1] = entry.mOffset;
+		entry_info[2] = entry.mSize;
+		success &= fwrite(it->mData, 1, UUID_BYTES, file) == UUID_BYTES &&
+				   fwrite(entry_info, sizeof(U32), 3, file) == 3;
+	}
+	LLFile::close(file);
+
+	if (success)
+	{
+		llinfos << "Pack store index saved with " << count << " entries."
+				<< llendl;
+	}
+	else
+	{
+		llwarns << "Failure to write the pack store index: " << filename
+				<< llendl;
+		LLFile::remove(filename);
+	}
+}
@@ -0,0 +1,149 @@
+/**
+ * @file llpackstore.h
+ * @brief Pack-file based storage for the assets cache.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLPACKSTORE_H
+#define LL_LLPACKSTORE_H
+
+#include "llatomic.h"
+#include "lluuid.h"
+
+// Pack-file based storage for the assets cache. Instead of one file per cached
+// asset, the assets data are appended as records to a few large segment files,
+// and an in-memory index, keyed on the asset UUID (combined with the extra
+// info, when any), gives the segment, offset and size of the latest record for
+// each asset, together with its position in a LRU list. This saves the per-
+// asset inode, stat() and utime() overhead, and allows to purge the cache by
+// simply evicting the least recently used entries, without any directory scan.
+// The space taken by evicted, removed or superseded records is reclaimed by
+// compacting the segments (i.e. copying their live records to the active
+// segment, then deleting them), which is done by LLDiskCache on its purging
+// thread.
+// The index is saved on shutdown and reloaded on startup; should it be missing
+// (e.g. after a crash), it is rebuilt by reading the records headers in each
+// segment. HB
+
+// Purely static class
+class LLPackStore
+{
+protected:
+	LOG_CLASS(LLPackStore);
+
+	LLPackStore() = delete;
+	~LLPackStore() = delete;
+
+public:
+	// 'dir' is the directory holding the segment files and the index. Returns
+	// true on success.
+	static bool init(const std::string& dir);
+
+	// Saves the index and closes the segments. After this call, all the
+	// methods below fail (or return an empty result).
+	static void shutdown();
+
+	// Removes all the segments and empties the index.
+	static void clear();
+
+	LL_INLINE static bool isEnabled()				{ return sEnabled; }
+
+	// IMPORTANT: all the methods below are thread-safe and may be called from
+	// any thread.
+
+	// Returns the key under which the asset 'id' is stored.
+	static LLUUID getKey(const LLUUID& id, const char* extra_info = NULL);
+
+	// Returns the size of the data stored for 'key', or -1 when not stored.
+	// When 'touch' is true, the entry becomes the most recently used one.
+	static S32 getSize(const LLUUID& key, bool touch = false);
+
+	// Reads up to 'bytes' of the data stored for 'key', starting at 'offset'.
+	// Returns the number of bytes actually read, or -1 when 'key' is not
+	// stored.
+	static S32 read(const LLUUID& key, U8* buffer, S32 offset, S32 bytes);
+
+	// Sets 'filename' to the segment file holding the data stored for 'key',
+	// 'offset' to the position of the data in that file, and 'size' to its
+	// size, so that it may be read directly (e.g. by the LLLFSThread). Returns
+	// false when 'key' is not stored. The entry becomes the most recently used
+	// one. Note that unlike read(), the caller cannot verify that the record
+	// did not get moved by a compaction in the meantime: the segment is then
+	// deleted (after LLLFSThread::closeFile() got called for it), and the
+	// direct read fails, unless the file was already kept open, in which case
+	// it still returns the former (and still valid) data.
+	static bool locate(const LLUUID& key, std::string& filename, S32& offset,
+					   S32& size);
+
+	// Stores 'size' bytes of data for 'key', superseding any former data.
+	// Returns the number of bytes added to the segments, or -1 on failure.
+	static S32 store(const LLUUID& key, const U8* data, S32 size);
+
+	// Overwrites in place 'bytes' of the data stored for 'key', starting at
+	// 'offset', which avoids rewriting the whole record for small updates.
+	// Returns false when 'key' is not stored, when the data would grow, or on
+	// write failure.
+	static bool patch(const LLUUID& key, const U8* data, S32 offset,
+					  S32 bytes);
+
+	// Removes 'key' from the store. Returns the number of bytes added to the
+	// segments (for the removal record), 0 when 'key' was not stored, or -1
+	// on failure.
+	static S32 remove(const LLUUID& key);
+
+	// Moves the data stored for 'old_key' to 'new_key', superseding any data
+	// stored for the latter. Returns the number of bytes added to the
+	// segments, or -1 on failure (or when 'old_key' is not stored).
+	static S32 rename(const LLUUID& old_key, const LLUUID& new_key);
+
+	// Evicts the least recently used entries until the live data fits in
+	// 'nominal_size' bytes, then compacts the segments holding too much dead
+	// data. Called from the cache purging thread.
+	static void purge(U64 nominal_size);
+
+	// Total size of the segments on disk.
+	LL_INLINE static U64 getDiskSize()				{ return sDiskBytes; }
+	// Total size of the live records in the segments.
+	LL_INLINE static U64 getLiveSize()				{ return sLiveBytes; }
+
+private:
+	static void compact();
+
+	static bool loadIndex();
+	static void rebuildIndex();
+	static void saveIndex();
+
+private:
+	static std::string		sDir;
+	static LLAtomic<U64>	sDiskBytes;
+	static LLAtomic<U64>	sLiveBytes;
+	static LLAtomicBool		sEnabled;
+};
+
+#endif	// LL_LLPACKSTORE_H
@@ -590,6 +590,316 @@ static void bilinear_scale(const U8* src, U32 srcW, U32 srcH, U32 srcCh,
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// SIMD kernels. They all give bit-identical results to the scalar code they
+// replace. Like for the rest of the maths in the viewer, SSE2 (or its NEON
+// translation) is always available and the AVX2 paths are selected at compile
+// time.
+///////////////////////////////////////////////////////////////////////////////
+
+// 2x2 box filter of a 4 components image: 'width' and 'height' are the sizes
+// of the output mip.
+static void box_filter_mip4(const U8* in, U8* out, S32 width, S32 height)
+{
+	const S32 in_row_size = width * 8;
+	const __m128i zero = _mm_setzero_si128();
+	for (S32 h = 0; h < height; ++h)
+	{
+		const U8* row0 = in + 2 * h * in_row_size;
+		const U8* row1 = row0 + in_row_size;
+		U8* dst = out + h * width * 4;
+		S32 w = 0;
+#if defined(__AVX2__)
+		const __m256i zero256 = _mm256_setzero_si256();
+		for ( ; w + 8 <= width; w += 8)
+		{
+			__m256i sums[2];
+			for (S32 i = 0; i < 2; ++i)
+			{
+				__m256i a =
+					_mm256_loadu_si256((const __m256i*)(row0 + w * 8 + i * 32));
+				__m256i b =
+					_mm256_loadu_si256((const __m256i*)(row1 + w * 8 + i * 32));
+				__m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero256),
+											  _mm256_unpacklo_epi8(b, zero256));
+				__m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero256),
+											  _mm256_unpackhi_epi8(b, zero256));
+				sums[i] = _mm256_srli_epi16(_mm256_add_epi16(
+												_mm256_unpacklo_epi64(lo, hi),
+												_mm256_unpackhi_epi64(lo, hi)),
+											2);
+			}
+			// Packing is done per 128 bits lane: restore the pixels order.
+			__m256i res = _mm256_permute4x64_epi64(_mm256_packus_epi16(sums[0],
+																	   sums[1]),
+												   _MM_SHUFFLE(3, 1, 2, 0));
+			_mm256_storeu_si256((__m256i*)(dst + w * 4), res);
+		}
+#endif
+		for ( ; w + 4 <= width; w += 4)
+		{
+			__m128i sums[2];
+			for (S32 i = 0; i < 2; ++i)
+			{
+				__m128i a =
+					_mm_loadu_si128((const __m128i*)(row0 + w * 8 + i * 16));
+				__m128i b =
+					_mm_loadu_si128((const __m128i*)(row1 + w * 8 + i * 16));
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+										   _mm_unpacklo_epi8(b, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+										   _mm_unpackhi_epi8(b, zero));
+				sums[i] = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi),
+													   _mm_unpackhi_epi64(lo, hi)),
+										 2);
+			}
+			_mm_storeu_si128((__m128i*)(dst + w * 4),
+							 _mm_packus_epi16(sums[0], sums[1]));
+		}
+		for ( ; w < width; ++w)
+		{
+			const U8* a = row0 + w * 8;
+			const U8* b = row1 + w * 8;
+			for (S32 c = 0; c < 4; ++c)
+			{
+				dst[w * 4 + c] = (U8)(((U32)a[c] + a[c + 4] + b[c] +
+									   b[c + 4]) >> 2);
+			}
+		}
+	}
+}
+
+// Sums the pairs of adjacent bytes of 'v' into 16 bits lanes.
+LL_INLINE static __m128i sum_byte_pairs(__m128i v)
+{
+	return _mm_add_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00ff)),
+						 _mm_srli_epi16(v, 8));
+}
+
+// 2x2 box filter of a single component image.
+static void box_filter_mip1(const U8* in, U8* out, S32 width, S32 height)
+{
+	const S32 in_row_size = width * 2;
+	for (S32 h = 0; h < height; ++h)
+	{
+		const U8* row0 = in + 2 * h * in_row_size;
+		const U8* row1 = row0 + in_row_size;
+		U8* dst = out + h * width;
+		S32 w = 0;
+		for ( ; w + 16 <= width; w += 16)
+		{
+			__m128i sums[2];
+			for (S32 i = 0; i < 2; ++i)
+			{
+				__m128i a =
+					_mm_loadu_si128((const __m128i*)(row0 + w * 2 + i * 16));
+				__m128i b =
+					_mm_loadu_si128((const __m128i*)(row1 + w * 2 + i * 16));
+				sums[i] = _mm_srli_epi16(_mm_add_epi16(sum_byte_pairs(a),
+													   sum_byte_pairs(b)),
+										 2);
+			}
+			_mm_storeu_si128((__m128i*)(dst + w),
+							 _mm_packus_epi16(sums[0], sums[1]));
+		}
+		for ( ; w < width; ++w)
+		{
+			dst[w] = (U8)(((U32)row0[w * 2] + row0[w * 2 + 1] + row1[w * 2] +
+						   row1[w * 2 + 1]) >> 2);
+		}
+	}
+}
+
+// 2x2 box filter for 2 and 3 components images.
+template<S32 ch>
+static void box_filter_mip(const U8* in, U8* out, S32 width, S32 height)
+{
+	const S32 in_row_size = width * 2 * ch;
+	for (S32 h = 0; h < height; ++h)
+	{
+		const U8* a = in + 2 * h * in_row_size;
+		const U8* b = a + in_row_size;
+		for (S32 w = 0; w < width; ++w)
+		{
+			for (S32 c = 0; c < ch; ++c)
+			{
+				*out++ = (U8)(((U32)a[c] + a[c + ch] + b[c] + b[c + ch]) >> 2);
+			}
+			a += 2 * ch;
+			b += 2 * ch;
+		}
+	}
+}
+
+// Same as LLImageRaw::fastFractionalMult(), on 16 bits lanes.
+LL_INLINE static __m128i fractional_mult(__m128i a, __m128i b)
+{
+	__m128i i = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(i, _mm_srli_epi16(i, 8)), 8);
+}
+
+// Composites two RGBA pixels (unpacked to 16 bits lanes) in 's' onto two RGBX
+// pixels in 'd'.
+LL_INLINE static __m128i composite_pixels(__m128i s, __m128i d)
+{
+	__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+	__m128i transparency = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+	// Like in the scalar code, the sum is truncated to 8 bits.
+	return _mm_and_si128(_mm_add_epi16(fractional_mult(d, transparency),
+									   fractional_mult(s, alpha)),
+						 _mm_set1_epi16(0x00ff));
+}
+
+// Composites 'pixels' RGBA source pixels onto RGB destination pixels. Returns
+// the number of processed pixels: the last pixels are left to the caller.
+static S32 composite_4onto3(const U8* src, U8* dst, S32 pixels)
+{
+	const __m128i zero = _mm_setzero_si128();
+	S32 i = 0;
+	for ( ; i + 4 <= pixels; i += 4)
+	{
+		// Expand the 4 destination pixels to RGBX
+		alignas(16) U8 d[16];
+		for (S32 k = 0; k < 4; ++k)
+		{
+			memcpy(d + k * 4, dst + k * 3, 3);
+		}
+		__m128i dv = _mm_load_si128((const __m128i*)d);
+		__m128i sv = _mm_loadu_si128((const __m128i*)src);
+		__m128i lo = composite_pixels(_mm_unpacklo_epi8(sv, zero),
+									  _mm_unpacklo_epi8(dv, zero));
+		__m128i hi = composite_pixels(_mm_unpackhi_epi8(sv, zero),
+									  _mm_unpackhi_epi8(dv, zero));
+		_mm_store_si128((__m128i*)d, _mm_packus_epi16(lo, hi));
+		for (S32 k = 0; k < 4; ++k)
+		{
+			memcpy(dst + k * 3, d + k * 4, 3);
+		}
+		src += 16;
+		dst += 12;
+	}
+	return i;
+}
+
+// Swaps the contents of two non-overlapping memory blocks of 'size' bytes.
+static void swap_memory(U8* a, U8* b, S32 size)
+{
+	S32 i = 0;
+#if defined(__AVX2__)
+	for ( ; i + 32 <= size; i += 32)
+	{
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+		_mm256_storeu_si256((__m256i*)(a + i), vb);
+		_mm256_storeu_si256((__m256i*)(b + i), va);
+	}
+#endif
+	for ( ; i + 16 <= size; i += 16)
+	{
+		__m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+		_mm_storeu_si128((__m128i*)(a + i), vb);
+		_mm_storeu_si128((__m128i*)(b + i), va);
+	}
+	for ( ; i < size; ++i)
+	{
+		std::swap(a[i], b[i]);
+	}
+}
+
+// Alpha histogram bins counts, as used by LLImageAlphaInfo::analyze(), which
+// replicates LLImageGL::analyzeAlpha().
+struct AlphaBins
+{
+	AlphaBins()
+	:	mid(0),
+		lower(0),
+		total(0)
+	{
+	}
+
+	U32 mid;	// Samples in the [32, 207] range (bins 2 to 12)
+	U32 lower;	// Samples below 128 (bins 0 to 7)
+	U32 total;
+};
+
+// Analyzes the alpha of a pair of rows of a 4 components image, 8 pixels at
+// a time ('width' must be a multiple of 8), and fills the corresponding bits
+// of the pick mask (starting at bit 'pick_bit', a multiple of 4).
+static void analyze_alpha_rows4(const U8* row0, const U8* row1, U32 width,
+								AlphaBins& bins, U8* pick_mask, U32 pick_bit)
+{
+	const __m128i ones = _mm_set1_epi16(1);
+	const __m128i s31 = _mm_set1_epi16(31);
+	const __m128i s32 = _mm_set1_epi16(32);
+	const __m128i s128 = _mm_set1_epi16(128);
+	const __m128i s208 = _mm_set1_epi16(208);
+	const __m128i q127 = _mm_set1_epi32(127);
+	const __m128i q512 = _mm_set1_epi32(512);
+	const __m128i q832 = _mm_set1_epi32(832);
+	// Negated counts for single samples and 2x2 quads, and alpha sums.
+	__m128i mid = _mm_setzero_si128();
+	__m128i lower = _mm_setzero_si128();
+	__m128i qmid = _mm_setzero_si128();
+	__m128i qlower = _mm_setzero_si128();
+	__m128i total = _mm_setzero_si128();
+	for (U32 x = 0; x < width; x += 8)
+	{
+		const __m128i* p0 = (const __m128i*)(row0 + x * 4);
+		const __m128i* p1 = (const __m128i*)(row1 + x * 4);
+		// 8 alpha values per row, as 16 bits integers.
+		__m128i a0 = _mm_packs_epi32(_mm_srli_epi32(_mm_loadu_si128(p0), 24),
+									 _mm_srli_epi32(_mm_loadu_si128(p0 + 1),
+													24));
+		__m128i a1 = _mm_packs_epi32(_mm_srli_epi32(_mm_loadu_si128(p1), 24),
+									 _mm_srli_epi32(_mm_loadu_si128(p1 + 1),
+													24));
+
+		__m128i m = _mm_add_epi16(_mm_and_si128(_mm_cmpgt_epi16(a0, s31),
+												_mm_cmplt_epi16(a0, s208)),
+								  _mm_and_si128(_mm_cmpgt_epi16(a1, s31),
+												_mm_cmplt_epi16(a1, s208)));
+		mid = _mm_add_epi32(mid, _mm_madd_epi16(m, ones));
+		m = _mm_add_epi16(_mm_cmplt_epi16(a0, s128),
+						  _mm_cmplt_epi16(a1, s128));
+		lower = _mm_add_epi32(lower, _mm_madd_epi16(m, ones));
+
+		// Sums of the 2x2 quads
+		__m128i q = _mm_madd_epi16(_mm_add_epi16(a0, a1), ones);
+		total = _mm_add_epi32(total, q);
+		qmid = _mm_add_epi32(qmid,
+							 _mm_and_si128(_mm_cmpgt_epi32(q, q127),
+										   _mm_cmplt_epi32(q, q832)));
+		qlower = _mm_add_epi32(qlower, _mm_cmplt_epi32(q, q512));
+
+		// Pick mask bits, for the even pixels of the first row: the sign bits
+		// of the 16 bits lanes 0, 2, 4 and 6 are bits 0, 4, 8 and 12 of the
+		// bytes mask.
+		U32 bits = _mm_movemask_epi8(_mm_cmpgt_epi16(a0, s32));
+		bits = (bits & 1) | ((bits >> 3) & 2) | ((bits >> 6) & 4) |
+			   ((bits >> 9) & 8);
+		if (bits)
+		{
+			pick_mask[pick_bit / 8] |= bits << (pick_bit % 8);
+		}
+		pick_bit += 4;
+	}
+
+	alignas(16) U32 res[4];
+	// Single samples are counted once, and the quads four times.
+	__m128i count = _mm_sub_epi32(_mm_setzero_si128(),
+								  _mm_add_epi32(mid, _mm_slli_epi32(qmid, 2)));
+	_mm_store_si128((__m128i*)res, count);
+	bins.mid += res[0] + res[1] + res[2] + res[3];
+	count = _mm_sub_epi32(_mm_setzero_si128(),
+						  _mm_add_epi32(lower, _mm_slli_epi32(qlower, 2)));
+	_mm_store_si128((__m128i*)res, count);
+	bins.lower += res[0] + res[1] + res[2] + res[3];
+	_mm_store_si128((__m128i*)res, total);
+	// Each sample is accounted for twice (once alone and once in its quad).
+	bins.total += 2 * (res[0] + res[1] + res[2] + res[3]);
+}
+
 //---------------------------------------------------------------------------
 // LLImage
 //---------------------------------------------------------------------------
@@ -1080,23 +1390,19 @@ void LLImageRaw::clear(U8 r, U8 g, U8 b, U8 a)
 // Reverses the order of the rows in the image
 void LLImageRaw::verticalFlip()
 {
-	S32 row_bytes = getWidth() * getComponents();
-	U8* line_buffer = getTempBuffer(row_bytes);
-	if (!line_buffer || !getData())
+	if (!getData())
 	{
 		llwarns << "Out of memory. Flipping aborted !" << llendl;
 		return;
 	}
+	S32 row_bytes = getWidth() * getComponents();
 	S32 mid_row = getHeight() / 2;
 	for (S32 row = 0; row < mid_row; ++row)
 	{
 		U8* row_a_data = getData() + row * row_bytes;
 		U8* row_b_data = getData() + (getHeight() - 1 - row) * row_bytes;
-		memcpy(line_buffer, row_a_data, row_bytes);
-		memcpy(row_a_data, row_b_data, row_bytes);
-		memcpy(row_b_data, line_buffer, row_bytes);
+		swap_memory(row_a_data, row_b_data, row_bytes);
 	}
-	freeTempBuffer(line_buffer);
 }
 
 void LLImageRaw::expandToPowerOfTwo(S32 max_dim, bool scale_image)
@@ -1265,6 +1571,10 @@ void LLImageRaw::compositeUnscaled4onto3(LLImageRaw* src)
 	}
 
 	S32 pixels = getWidth() * getHeight();
+	S32 done = composite_4onto3(src_data, dst_data, pixels);
+	src_data += 4 * done;
+	dst_data += 3 * done;
+	pixels -= done;
 	while (pixels--)
 	{
 		U8 alpha = src_data[3];
@@ -1500,14 +1810,19 @@ void LLImageRaw::copyUnscaled4onto3(LLImageRaw* src)
 		return;
 	}
 
-	for (S32 i = 0; i < pixels; ++i)
+	// Each 32 bits store overwrites the first byte of the next pixel with the
+	// alpha value, which gets fixed by the next store: the last pixel must
+	// therefore be copied byte by byte.
+	for (S32 i = 0; i < pixels - 1; ++i)
 	{
-		dst_data[0] = src_data[0];
-		dst_data[1] = src_data[1];
-		dst_data[2] = src_data[2];
+		memcpy(dst_data, src_data, 4);
 		src_data += 4;
 		dst_data += 3;
 	}
+	if (pixels > 0)
+	{
+		memcpy(dst_data, src_data, 3);
+	}
 }
 
 // Src and dst are same size.  Src has 3 components.  Dst has 4 components.
@@ -1527,14 +1842,26 @@ void LLImageRaw::copyUnscaled3onto4(LLImageRaw* src)
 		return;
 	}
 
-	for (S32 i = 0; i < pixels; ++i)
+	// 32 bits loads (overlapping the next pixel, thus not for the last one)
+	// with the alpha byte forced to 255.
+	alignas(4) U8 opaque[4] = { 0, 0, 0, 255 };
+	U32 alpha_mask;
+	memcpy(&alpha_mask, opaque, 4);
+	for (S32 i = 0; i < pixels - 1; ++i)
+	{
+		U32 pixel;
+		memcpy(&pixel, src_data, 4);
+		pixel |= alpha_mask;
+		memcpy(dst_data, &pixel, 4);
+		src_data += 3;
+		dst_data += 4;
+	}
+	if (pixels > 0)
 	{
 		dst_data[0] = src_data[0];
 		dst_data[1] = src_data[1];
 		dst_data[2] = src_data[2];
 		dst_data[3] = 255;
-		src_data += 3;
-		dst_data += 4;
 	}
 }
 
@@ -2171,6 +2498,135 @@ bool LLImageRaw::createFromFile(const std::string& filename,
 	return true;
 }
 
+//---------------------------------------------------------------------------
+// LLImageAlphaInfo
+//---------------------------------------------------------------------------
+
+//static
+LLPointer<LLImageAlphaInfo> LLImageAlphaInfo::analyze(const LLImageRaw* raw)
+{
+	if (!raw)
+	{
+		return NULL;
+	}
+	const U8* data = raw->getData();
+	const S8 comps = raw->getComponents();
+	const U32 width = raw->getWidth();
+	const U32 height = raw->getHeight();
+	if (!data || !width || !height || comps == 3 || comps > 4 ||
+		width > 65535 || height > 65535)
+	{
+		return NULL;
+	}
+	const bool quads = width >= 2 && height >= 2;
+	if (quads && (width % 2 || height % 2))
+	{
+		// LLImageGL::analyzeAlpha() does not support this case either.
+		return NULL;
+	}
+
+	LL_TRACY_TIMER(TRC_IMG_ANALYZE_ALPHA);
+
+	LLPointer<LLImageAlphaInfo> info = new LLImageAlphaInfo(width, height,
+															comps);
+	U8* pick_mask = NULL;
+	if (comps == 4)
+	{
+		info->mPickMask.resize(pickMaskSize(width, height), 0);
+		pick_mask = info->mPickMask.data();
+	}
+
+	// Same histogram as in LLImageGL::analyzeAlpha(), but only the counts of
+	// the bins it actually uses are kept.
+	AlphaBins bins;
+	U32 length = width * height;
+	const U8* alpha = data + comps - 1;
+	if (quads)
+	{
+		const U32 row_size = width * comps;
+		const bool use_simd = comps == 4 && width % 8 == 0;
+		U32 pick_bit = 0;
+		for (U32 y = 0; y < height; y += 2)
+		{
+			if (use_simd)
+			{
+				const U8* row = data + y * row_size;
+				analyze_alpha_rows4(row, row + row_size, width, bins,
+									pick_mask, pick_bit);
+				pick_bit += width / 2;
+				continue;
+			}
+			const U8* row0 = alpha + y * row_size;
+			const U8* row1 = row0 + row_size;
+			for (U32 x = 0; x < width; x += 2)
+			{
+				const U32 s1 = row0[x * comps];
+				const U32 s2 = row1[x * comps];
+				const U32 s3 = row0[(x + 1) * comps];
+				const U32 s4 = row1[(x + 1) * comps];
+				bins.mid += (s1 >= 32 && s1 < 208) + (s2 >= 32 && s2 < 208) +
+							(s3 >= 32 && s3 < 208) + (s4 >= 32 && s4 < 208);
+				bins.lower += (s1 < 128) + (s2 < 128) + (s3 < 128) +
+							  (s4 < 128);
+				const U32 asum = s1 + s2 + s3 + s4;
+				bins.total += 2 * asum;
+				if (asum >= 128 && asum < 832)
+				{
+					bins.mid += 4;
+				}
+				if (asum < 512)
+				{
+					bins.lower += 4;
+				}
+				if (pick_mask && s1 > 32)
+				{
+					pick_mask[pick_bit / 8] |= 1 << (pick_bit % 8);
+				}
+				++pick_bit;
+			}
+		}
+		length *= 2; // We sampled everything twice, essentially
+	}
+	else
+	{
+		for (U32 i = 0; i < length; ++i)
+		{
+			const U32 s = alpha[i * comps];
+			bins.total += s;
+			bins.mid += s >= 32 && s < 208;
+			bins.lower += s < 128;
+		}
+		if (pick_mask)
+		{
+			// Only the first pixel of each 2x2 block is used, i.e. one pixel
+			// out of two on the first row (there is only one row or column).
+			U32 pick_bit = 0;
+			for (U32 y = 0; y < height; y += 2)
+			{
+				for (U32 x = 0; x < width; x += 2)
+				{
+					if (alpha[(y * width + x) * 4] > 32)
+					{
+						pick_mask[pick_bit / 8] |= 1 << (pick_bit % 8);
+					}
+					++pick_bit;
+				}
+			}
+		}
+	}
+
+	const U32 upper = length - bins.lower;
+	info->mIsMask =
+		// Not lots of midrange, and
+		bins.mid <= length / 48 &&
+		// not all close to transparent without being totally transparent,
+		(bins.lower != length || !bins.total) &&
+		// and not all close to opaque without being totally opaque.
+		(upper != length || bins.total == 255 * length);
+
+	return info;
+}
+
 //---------------------------------------------------------------------------
 // LLImageFormatted
 //---------------------------------------------------------------------------
@@ -2465,30 +2921,6 @@ S8 LLImageFormatted::getCodec() const
 	return mCodec;
 }
 
-static void avg4_colors4(const U8* a, const U8* b, const U8* c,
-						 const U8* d, U8* dst)
-{
-	dst[0] = (U8)(((U32)(a[0]) + b[0] + c[0] + d[0])>>2);
-	dst[1] = (U8)(((U32)(a[1]) + b[1] + c[1] + d[1])>>2);
-	dst[2] = (U8)(((U32)(a[2]) + b[2] + c[2] + d[2])>>2);
-	dst[3] = (U8)(((U32)(a[3]) + b[3] + c[3] + d[3])>>2);
-}
-
-static void avg4_colors3(const U8* a, const U8* b, const U8* c,
-						 const U8* d, U8* dst)
-{
-	dst[0] = (U8)(((U32)(a[0]) + b[0] + c[0] + d[0])>>2);
-	dst[1] = (U8)(((U32)(a[1]) + b[1] + c[1] + d[1])>>2);
-	dst[2] = (U8)(((U32)(a[2]) + b[2] + c[2] + d[2])>>2);
-}
-
-static void avg4_colors2(const U8* a, const U8* b, const U8* c,
-						 const U8* d, U8* dst)
-{
-	dst[0] = (U8)(((U32)(a[0]) + b[0] + c[0] + d[0])>>2);
-	dst[1] = (U8)(((U32)(a[1]) + b[1] + c[1] + d[1])>>2);
-}
-
 void LLImageBase::setDataAndSize(U8* data, S32 size)
 {
 	mData = data;
@@ -2500,38 +2932,26 @@ void LLImageBase::generateMip(const U8* indata, U8* mipdata,
 							  S32 width, S32 height, S32 nchannels)
 {
 	llassert(width > 0 && height > 0);
-	U8* data = mipdata;
-	S32 in_width = width * 2;
-	for (S32 h = 0; h < height; ++h)
+	switch (nchannels)
 	{
-		for (S32 w = 0; w < width; ++w)
-		{
-			switch (nchannels)
-			{
-				case 4:
-					avg4_colors4(indata, indata + 4, indata + 4 * in_width,
-								 indata + 4 * in_width + 4, data);
-				break;
-				case 3:
-					avg4_colors3(indata, indata + 3, indata + 3 * in_width,
-								 indata + 3 * in_width + 3, data);
-				break;
-				case 2:
-					avg4_colors2(indata, indata + 2, indata + 2 * in_width,
-								 indata + 2 * in_width + 2, data);
-				break;
-				case 1:
-					*(U8*)data = (U8)(((U32)(indata[0]) + indata[1] +
-									   indata[in_width] +
-									   indata[in_width + 1]) >> 2);
-				break;
-					default:
-					llerrs << "Bad number of channels" << llendl;
-			}
-			indata += nchannels * 2;
-			data += nchannels;
-		}
-		indata += nchannels * in_width; // skip odd lines
+		case 4:
+			box_filter_mip4(indata, mipdata, width, height);
+			break;
+
+		case 3:
+			box_filter_mip<3>(indata, mipdata, width, height);
+			break;
+
+		case 2:
+			box_filter_mip<2>(indata, mipdata, width, height);
+			break;
+
+		case 1:
+			box_filter_mip1(indata, mipdata, width, height);
+			break;
+
+		default:
+			llerrs << "Bad number of channels" << llendl;
 	}
 }
 
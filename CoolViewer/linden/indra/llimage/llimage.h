@@ -37,6 +37,8 @@
 # include "jemalloc/jemalloc.h"
 #endif
 
+#include <vector>
+
 #include "llatomic.h"
 #include "llmemory.h"
 #include "llpointer.h"
@@ -327,6 +329,61 @@ public:
 	static LLAtomicS32 sRawImageCount;
 };
 
+// Results of the alpha channel analysis of a decoded image: this is done by
+// the image decode threads, so that LLImageGL does not have to scan all the
+// pixels on the main thread when creating the GL texture. HB
+class LLImageAlphaInfo final : public LLThreadSafeRefCount
+{
+protected:
+	LOG_CLASS(LLImageAlphaInfo);
+
+	~LLImageAlphaInfo() override = default;
+
+public:
+	// Analyzes the last component of 'raw', like LLImageGL does for 1, 2 and
+	// 4 components images. Returns NULL for images without alpha channel.
+	static LLPointer<LLImageAlphaInfo> analyze(const LLImageRaw* raw);
+
+	LL_INLINE U16 getWidth() const					{ return mWidth; }
+	LL_INLINE U16 getHeight() const					{ return mHeight; }
+	LL_INLINE S8 getComponents() const				{ return mComponents; }
+
+	// true when the alpha channel is suitable for alpha masking.
+	LL_INLINE bool isMask() const					{ return mIsMask; }
+
+	// The pick mask (one bit per 2x2 pixels, set when the alpha of the top
+	// left pixel is above 32, with the same layout and size as the one of
+	// LLImageGL), only computed for 4 components images.
+	LL_INLINE const U8* getPickMask() const
+	{
+		return mPickMask.empty() ? NULL : mPickMask.data();
+	}
+
+	LL_INLINE U32 getPickMaskSize() const			{ return mPickMask.size(); }
+
+	// Size in bytes of the pick mask for a 'width' x 'height' image.
+	static LL_INLINE U32 pickMaskSize(U32 width, U32 height)
+	{
+		return ((width / 2 + 1) * (height / 2 + 1) + 7) / 8;
+	}
+
+private:
+	LLImageAlphaInfo(U16 width, U16 height, S8 components)
+	:	mWidth(width),
+		mHeight(height),
+		mComponents(components),
+		mIsMask(false)
+	{
+	}
+
+private:
+	std::vector<U8>	mPickMask;
+	U16				mWidth;
+	U16				mHeight;
+	S8				mComponents;
+	bool			mIsMask;
+};
+
 // Compressed representation of image.
 // Subclass from this class for the different representations (J2C, bmp)
 class LLImageFormatted : public LLImageBase
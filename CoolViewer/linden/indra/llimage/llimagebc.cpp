@@ -0,0 +1,548 @@
+/**
+ * @file llimagebc.cpp
+ * @brief Block-compressed (BC1/BC3) images, encoded on the CPU.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <vector>
+
+#include "llimagebc.h"
+
+#include "llfilesystem.h"
+#include "llmath.h"
+
+//static
+bool LLImageBC::sEnabled = false;
+LLAtomicU32 LLImageBC::sEncodedCount(0);
+LLAtomicU32 LLImageBC::sCacheHits(0);
+
+// Header of the disk cache files. Since these are only meant to be read back
+// by the same viewer build on the same machine, the fields are stored in the
+// native byte order.
+struct BCCacheHeader
+{
+	U32	mMagic;
+	U8	mVersion;
+	U8	mFormat;
+	U8	mLevels;
+	U8	mPadding;
+	U16	mWidth;
+	U16	mHeight;
+};
+static_assert(sizeof(BCCacheHeader) == 12, "Unexpected BCCacheHeader size");
+
+constexpr U32 BC_CACHE_MAGIC = 0x4342434c;	// "LCBC"
+constexpr U8 BC_CACHE_VERSION = 1;
+
+///////////////////////////////////////////////////////////////////////////////
+// BC1/BC3 blocks encoder. The colors end points are found along the principal
+// axis of the block colors, then refined once by least squares fitting for
+// the chosen indices; this is close in quality to the "high quality" mode of
+// the usual real time encoders, at a fraction of the cost of an exhaustive
+// search.
+///////////////////////////////////////////////////////////////////////////////
+
+// Fetches the 4x4 block at (x0, y0) of a 'width' x 'height' RGBA image into
+// 'block', replicating the edge pixels for the levels smaller than 4 pixels.
+static void fetch_block(const U8* rgba, U32 width, U32 height, U32 x0, U32 y0,
+						U8* block)
+{
+	for (U32 y = 0; y < 4; ++y)
+	{
+		const U8* row = rgba + llmin(y0 + y, height - 1) * width * 4;
+		for (U32 x = 0; x < 4; ++x)
+		{
+			memcpy(block + (y * 4 + x) * 4, row + llmin(x0 + x, width - 1) * 4,
+				   4);
+		}
+	}
+}
+
+LL_INLINE U16 pack_565(S32 r, S32 g, S32 b)
+{
+	return (U16)((((r * 31 + 127) / 255) << 11) |
+				 (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+LL_INLINE void unpack_565(U16 color, S32* rgb)
+{
+	S32 r = (color >> 11) & 31;
+	S32 g = (color >> 5) & 63;
+	S32 b = color & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Returns the indices of the nearest palette colors for the block pixels,
+// with 'c0' > 'c1' (four colors mode), and the total squared error in 'error'.
+static U32 match_colors(const U8* block, U16 c0, U16 c1, U32& error)
+{
+	S32 palette[4][3];
+	unpack_565(c0, palette[0]);
+	unpack_565(c1, palette[1]);
+	for (U32 i = 0; i < 3; ++i)
+	{
+		palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+		palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+	}
+
+	U32 indices = 0;
+	error = 0;
+	for (U32 i = 0; i < 16; ++i)
+	{
+		const U8* pixel = block + i * 4;
+		U32 best = 0;
+		U32 best_dist = U32_MAX;
+		for (U32 j = 0; j < 4; ++j)
+		{
+			S32 dr = (S32)pixel[0] - palette[j][0];
+			S32 dg = (S32)pixel[1] - palette[j][1];
+			S32 db = (S32)pixel[2] - palette[j][2];
+			U32 dist = dr * dr + dg * dg + db * db;
+			if (dist < best_dist)
+			{
+				best_dist = dist;
+				best = j;
+			}
+		}
+		error += best_dist;
+		indices |= best << (2 * i);
+	}
+	return indices;
+}
+
+// Least squares fit of the end points for the given indices. Returns false
+// when the system is degenerate (all pixels on the same palette entry).
+static bool refine_end_points(const U8* block, U32 indices, U16& c0, U16& c1)
+{
+	// Weight of the first end point for each palette index
+	constexpr F32 weights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+
+	F32 alpha2 = 0.f, beta2 = 0.f, alphabeta = 0.f;
+	F32 alphax[3] = { 0.f, 0.f, 0.f };
+	F32 betax[3] = { 0.f, 0.f, 0.f };
+	for (U32 i = 0; i < 16; ++i)
+	{
+		F32 a = weights[(indices >> (2 * i)) & 3];
+		F32 b = 1.f - a;
+		alpha2 += a * a;
+		beta2 += b * b;
+		alphabeta += a * b;
+		for (U32 j = 0; j < 3; ++j)
+		{
+			F32 x = (F32)block[i * 4 + j];
+			alphax[j] += a * x;
+			betax[j] += b * x;
+		}
+	}
+	F32 det = alpha2 * beta2 - alphabeta * alphabeta;
+	if (fabsf(det) < 1e-4f)
+	{
+		return false;
+	}
+	F32 inv_det = 1.f / det;
+
+	S32 e0[3], e1[3];
+	for (U32 j = 0; j < 3; ++j)
+	{
+		F32 v0 = (alphax[j] * beta2 - betax[j] * alphabeta) * inv_det;
+		F32 v1 = (betax[j] * alpha2 - alphax[j] * alphabeta) * inv_det;
+		e0[j] = llclamp(ll_round(v0), 0, 255);
+		e1[j] = llclamp(ll_round(v1), 0, 255);
+	}
+	c0 = pack_565(e0[0], e0[1], e0[2]);
+	c1 = pack_565(e1[0], e1[1], e1[2]);
+	if (c0 < c1)
+	{
+		std::swap(c0, c1);
+	}
+	return c0 != c1;
+}
+
+static void encode_color_block(const U8* block, U8* out)
+{
+	// Mean and bounding box of the block colors
+	S32 min_c[3] = { 255, 255, 255 };
+	S32 max_c[3] = { 0, 0, 0 };
+	F32 mean[3] = { 0.f, 0.f, 0.f };
+	for (U32 i = 0; i < 16; ++i)
+	{
+		for (U32 j = 0; j < 3; ++j)
+		{
+			S32 v = block[i * 4 + j];
+			min_c[j] = llmin(min_c[j], v);
+			max_c[j] = llmax(max_c[j], v);
+			mean[j] += (F32)v;
+		}
+	}
+	for (U32 j = 0; j < 3; ++j)
+	{
+		mean[j] *= 1.f / 16.f;
+	}
+
+	// Covariance matrix (xx, xy, xz, yy, yz, zz)
+	F32 cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+	for (U32 i = 0; i < 16; ++i)
+	{
+		F32 r = (F32)block[i * 4] - mean[0];
+		F32 g = (F32)block[i * 4 + 1] - mean[1];
+		F32 b = (F32)block[i * 4 + 2] - mean[2];
+		cov[0] += r * r;
+		cov[1] += r * g;
+		cov[2] += r * b;
+		cov[3] += g * g;
+		cov[4] += g * b;
+		cov[5] += b * b;
+	}
+
+	// Principal axis by power iteration, starting from the bounding box
+	// diagonal.
+	F32 axis[3] = { (F32)(max_c[0] - min_c[0]), (F32)(max_c[1] - min_c[1]),
+					(F32)(max_c[2] - min_c[2]) };
+	for (U32 iter = 0; iter < 4; ++iter)
+	{
+		F32 x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		F32 y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		F32 z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+		F32 norm = llmax(fabsf(x), llmax(fabsf(y), fabsf(z)));
+		if (norm < 1e-6f)
+		{
+			break;
+		}
+		norm = 1.f / norm;
+		axis[0] = x * norm;
+		axis[1] = y * norm;
+		axis[2] = z * norm;
+	}
+
+	// Extreme colors along the axis
+	const U8* min_p = block;
+	const U8* max_p = block;
+	F32 min_dot = F32_MAX;
+	F32 max_dot = -F32_MAX;
+	for (U32 i = 0; i < 16; ++i)
+	{
+		const U8* pixel = block + i * 4;
+		F32 dot = pixel[0] * axis[0] + pixel[1] * axis[1] +
+				  pixel[2] * axis[2];
+		if (dot < min_dot)
+		{
+			min_dot = dot;
+			min_p = pixel;
+		}
+		if (dot > max_dot)
+		{
+			max_dot = dot;
+			max_p = pixel;
+		}
+	}
+
+	// Inset the end points by 1/16th of their range, which lowers the error
+	// on the interpolated colors.
+	S32 e0[3], e1[3];
+	for (U32 j = 0; j < 3; ++j)
+	{
+		S32 inset = ((S32)max_p[j] - (S32)min_p[j]) / 16;
+		e0[j] = llclamp((S32)max_p[j] - inset, 0, 255);
+		e1[j] = llclamp((S32)min_p[j] + inset, 0, 255);
+	}
+	U16 c0 = pack_565(e0[0], e0[1], e0[2]);
+	U16 c1 = pack_565(e1[0], e1[1], e1[2]);
+	if (c0 < c1)
+	{
+		std::swap(c0, c1);
+	}
+
+	U32 indices = 0;
+	if (c0 != c1)
+	{
+		U32 error;
+		indices = match_colors(block, c0, c1, error);
+		U16 r0, r1;
+		if (error && refine_end_points(block, indices, r0, r1))
+		{
+			U32 r_error;
+			U32 r_indices = match_colors(block, r0, r1, r_error);
+			if (r_error < error)
+			{
+				c0 = r0;
+				c1 = r1;
+				indices = r_indices;
+			}
+		}
+	}
+	// else: single color block; all indices at 0 select c0.
+
+	out[0] = c0 & 0xff;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 0xff;
+	out[3] = c1 >> 8;
+	out[4] = indices & 0xff;
+	out[5] = (indices >> 8) & 0xff;
+	out[6] = (indices >> 16) & 0xff;
+	out[7] = indices >> 24;
+}
+
+// BC3 alpha block, in the eight alpha values mode (a0 > a1).
+static void encode_alpha_block(const U8* block, U8* out)
+{
+	S32 min_a = 255;
+	S32 max_a = 0;
+	for (U32 i = 0; i < 16; ++i)
+	{
+		S32 a = block[i * 4 + 3];
+		min_a = llmin(min_a, a);
+		max_a = llmax(max_a, a);
+	}
+	out[0] = (U8)max_a;
+	out[1] = (U8)min_a;
+	if (max_a == min_a)
+	{
+		memset(out + 2, 0, 6);
+		return;
+	}
+
+	// Index 0 is a0 (max), index 1 is a1 (min), and indices 2 to 7 are the
+	// interpolated values from a0 to a1.
+	S32 range = max_a - min_a;
+	U64 bits = 0;
+	for (U32 i = 0; i < 16; ++i)
+	{
+		S32 t = ((S32)block[i * 4 + 3] - min_a) * 7;
+		t = (t + range / 2) / range;
+		U64 index = t == 7 ? 0 : (t == 0 ? 1 : 8 - t);
+		bits |= index << (3 * i);
+	}
+	for (U32 i = 0; i < 6; ++i)
+	{
+		out[2 + i] = (U8)(bits >> (8 * i));
+	}
+}
+
+static void encode_level(const U8* rgba, U32 width, U32 height,
+						 LLImageBC::EFormat format, U8* out)
+{
+	U8 block[64];
+	for (U32 y = 0; y < height; y += 4)
+	{
+		for (U32 x = 0; x < width; x += 4)
+		{
+			fetch_block(rgba, width, height, x, y, block);
+			if (format == LLImageBC::BC3)
+			{
+				encode_alpha_block(block, out);
+				out += 8;
+			}
+			encode_color_block(block, out);
+			out += 8;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LLImageBC class
+///////////////////////////////////////////////////////////////////////////////
+
+LLImageBC::LLImageBC(EFormat format, U16 width, U16 height, U32 levels)
+:	mDataSize(0),
+	mLevels(levels),
+	mWidth(width),
+	mHeight(height),
+	mFormat(format)
+{
+	for (U32 i = 0; i < levels; ++i)
+	{
+		mDataSize += getLevelSize(format, llmax(width >> i, 1),
+								  llmax(height >> i, 1));
+	}
+	mData = (U8*)allocate_texture_mem(mDataSize);
+}
+
+//virtual
+LLImageBC::~LLImageBC()
+{
+	if (mData)
+	{
+		free_texture_mem(mData);
+	}
+}
+
+//static
+U32 LLImageBC::getLevelSize(EFormat format, U32 width, U32 height)
+{
+	U32 blocks = ((width + 3) / 4) * ((height + 3) / 4);
+	return blocks * (format == BC1 ? 8 : 16);
+}
+
+//static
+LLPointer<LLImageBC> LLImageBC::encode(const LLImageRaw* raw)
+{
+	if (!raw || !raw->getData())
+	{
+		return NULL;
+	}
+	S32 components = raw->getComponents();
+	U32 width = raw->getWidth();
+	U32 height = raw->getHeight();
+	if ((components != 3 && components != 4) || !width || !height ||
+		(width & (width - 1)) || (height & (height - 1)))
+	{
+		return NULL;
+	}
+
+	// Work on RGBA pixels, and check whether the alpha channel is actually
+	// used, in which case BC3 is needed.
+	const U32 pixels = width * height;
+	const U8* src = raw->getData();
+	bool has_alpha = false;
+	std::vector<U8> level(pixels * 4);
+	if (components == 4)
+	{
+		memcpy(level.data(), src, pixels * 4);
+		for (U32 i = 0; i < pixels && !has_alpha; ++i)
+		{
+			has_alpha = src[i * 4 + 3] != 255;
+		}
+	}
+	else
+	{
+		U8* dst = level.data();
+		for (U32 i = 0; i < pixels; ++i)
+		{
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst[3] = 255;
+			src += 3;
+			dst += 4;
+		}
+	}
+	EFormat format = has_alpha ? BC3 : BC1;
+
+	// This matches the mips range LLImageGL may need for this image, whatever
+	// the discard level it was decoded at.
+	U32 levels = 1;
+	for (U32 w = width, h = height; w > 1 && h > 1 &&
+									levels <= (U32)MAX_DISCARD_LEVEL;
+		 w >>= 1, h >>= 1)
+	{
+		++levels;
+	}
+
+	LLPointer<LLImageBC> imagep = new LLImageBC(format, width, height, levels);
+	if (!imagep->mData)
+	{
+		return NULL;
+	}
+
+	// The full size level is stored last, the smaller ones before it.
+	U8* out = imagep->mData + imagep->mDataSize;
+	std::vector<U8> mip;
+	for (U32 i = 0; i < levels; ++i)
+	{
+		out -= getLevelSize(format, width, height);
+		encode_level(level.data(), width, height, format, out);
+		if (i + 1 < levels)
+		{
+			width >>= 1;
+			height >>= 1;
+			mip.resize(width * height * 4);
+			LLImageBase::generateMip(level.data(), mip.data(), width, height,
+									 4);
+			level.swap(mip);
+		}
+	}
+
+	++sEncodedCount;
+	return imagep;
+}
+
+// Name suffix for the disk cache files.
+static std::string cache_extra_info(S32 discard)
+{
+	return llformat("bc%d", discard);
+}
+
+//static
+LLPointer<LLImageBC> LLImageBC::loadCached(const LLUUID& id, S32 discard,
+										   U16 width, U16 height)
+{
+	std::string extra_info = cache_extra_info(discard);
+	LLFileSystem file(id, LLFileSystem::READ, extra_info.c_str());
+	if (!file.exists() || file.getSize() < (S32)sizeof(BCCacheHeader))
+	{
+		return NULL;
+	}
+
+	BCCacheHeader header;
+	if (!file.read((U8*)&header, sizeof(BCCacheHeader)) ||
+		header.mMagic != BC_CACHE_MAGIC ||
+		header.mVersion != BC_CACHE_VERSION ||
+		(header.mFormat != BC1 && header.mFormat != BC3) ||
+		!header.mLevels || header.mLevels > MAX_DISCARD_LEVEL + 1 ||
+		header.mWidth != width || header.mHeight != height)
+	{
+		return NULL;
+	}
+
+	LLPointer<LLImageBC> imagep = new LLImageBC((EFormat)header.mFormat,
+												width, height, header.mLevels);
+	if (!imagep->mData ||
+		file.getSize() != (S32)(sizeof(BCCacheHeader) + imagep->mDataSize) ||
+		!file.read(imagep->mData, imagep->mDataSize))
+	{
+		return NULL;
+	}
+
+	++sCacheHits;
+	return imagep;
+}
+
+bool LLImageBC::saveToCache(const LLUUID& id, S32 discard) const
+{
+	// Build the whole cache file contents in a single buffer, since each
+	// LLFileSystem::write() call in OVERWRITE mode truncates the file.
+	std::vector<U8> buffer(sizeof(BCCacheHeader) + mDataSize);
+	BCCacheHeader* header = (BCCacheHeader*)buffer.data();
+	header->mMagic = BC_CACHE_MAGIC;
+	header->mVersion = BC_CACHE_VERSION;
+	header->mFormat = mFormat;
+	header->mLevels = mLevels;
+	header->mPadding = 0;
+	header->mWidth = mWidth;
+	header->mHeight = mHeight;
+	memcpy(buffer.data() + sizeof(BCCacheHeader), mData, mDataSize);
+
+	std::string extra_info = cache_extra_info(discard);
+	LLFileSystem file(id, LLFileSystem::OVERWRITE, extra_info.c_str());
+	return file.write(buffer.data(), (S32)buffer.size());
+}
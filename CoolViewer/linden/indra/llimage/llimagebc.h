@@ -0,0 +1,111 @@
+/**
+ * @file llimagebc.h
+ * @brief Block-compressed (BC1/BC3) images, encoded on the CPU.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEBC_H
+#define LL_LLIMAGEBC_H
+
+#include "llatomic.h"
+#include "llimage.h"
+#include "lluuid.h"
+
+// Block-compressed image (BC1 for opaque images, BC3 for images with alpha;
+// also known as DXT1 and DXT5), with its mip chain. It is encoded on the image
+// decode threads from the decoded LLImageRaw, and kept in the disk cache, so
+// that the GL texture may be created with glCompressedTexImage2D(), using 4
+// (BC3) to 8 (BC1) times less VRAM than an uncompressed RGB(A) texture.
+// The mips are stored from the smallest to the largest, which is the layout
+// LLImageGL::setImage() expects for data with mips. HB
+
+class LLImageBC final : public LLThreadSafeRefCount
+{
+protected:
+	LOG_CLASS(LLImageBC);
+
+	~LLImageBC() override;
+
+public:
+	enum EFormat : U8
+	{
+		BC1 = 1,
+		BC3 = 3
+	};
+
+	// Encodes 'raw' (3 or 4 components, power of two sizes) and its mips.
+	// Returns NULL when the raw image is not suitable.
+	static LLPointer<LLImageBC> encode(const LLImageRaw* raw);
+
+	// Disk cache, keyed on the texture UUID and its discard level. loadCached
+	// returns NULL when there is no valid cached image matching the sizes
+	// of the decoded raw image.
+	static LLPointer<LLImageBC> loadCached(const LLUUID& id, S32 discard,
+										   U16 width, U16 height);
+	bool saveToCache(const LLUUID& id, S32 discard) const;
+
+	LL_INLINE EFormat getFormat() const				{ return mFormat; }
+	LL_INLINE U16 getWidth() const					{ return mWidth; }
+	LL_INLINE U16 getHeight() const					{ return mHeight; }
+	// Number of mip levels, including the full size one.
+	LL_INLINE U32 getLevels() const					{ return mLevels; }
+	LL_INLINE U32 getDataSize() const				{ return mDataSize; }
+
+	// Returns a pointer on the data for the full size level (level 0), the
+	// smaller levels being stored before it.
+	LL_INLINE const U8* getData() const
+	{
+		return mData + mDataSize - getLevelSize(mFormat, mWidth, mHeight);
+	}
+
+	// Size in bytes of a 'width' x 'height' level.
+	static U32 getLevelSize(EFormat format, U32 width, U32 height);
+
+private:
+	LLImageBC(EFormat format, U16 width, U16 height, U32 levels);
+
+public:
+	// Set from the main thread, depending on the user settings and GL
+	// capabilities.
+	static bool			sEnabled;
+
+	// Statistics
+	static LLAtomicU32	sEncodedCount;
+	static LLAtomicU32	sCacheHits;
+
+private:
+	U8*					mData;
+	U32					mDataSize;
+	U32					mLevels;
+	U16					mWidth;
+	U16					mHeight;
+	EFormat				mFormat;
+};
+
+#endif	// LL_LLIMAGEBC_H
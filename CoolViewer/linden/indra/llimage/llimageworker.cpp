@@ -125,8 +125,8 @@ S32 LLImageDecodeThread::update(F32 max_time_ms)
 		CreationInfo& info = *iter;
 		ImageRequest* req = new ImageRequest(info.handle, info.image,
 											 info.priority, info.discard,
-											 info.needs_aux, info.responder,
-			                                 this);
+											 info.needs_aux, info.compress_id,
+											 info.responder, this);
 		bool res = addRequest(req);
 		if (!res)
 		{
@@ -167,13 +167,14 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(LLImageFormatted*
 															   U32 priority,
 															   S32 discard,
 															   bool needs_aux,
-															   Responder* responder)
+															   Responder* responder,
+															   const LLUUID& compress_id)
 {
 	mCreationMutex.lock();
 
 	handle_t handle = generateHandle();
 	mCreationList.push_back(CreationInfo(handle, image, priority, discard,
-										 needs_aux, responder));
+										 needs_aux, responder, compress_id));
 
 	mCreationMutex.unlock();
 
@@ -184,10 +185,12 @@ LLImageDecodeThread::ImageRequest::ImageRequest(handle_t handle,
 												LLImageFormatted* image,
 												U32 priority, S32 discard,
 												bool needs_aux,
+												const LLUUID& compress_id,
 												Responder* responder,
 												LLImageDecodeThread* queue)
 :	LLQueuedThread::QueuedRequest(handle, priority, FLAG_AUTO_COMPLETE),
 	mFormattedImage(image),
+	mCompressID(compress_id),
 	mDiscardLevel(discard),
 	mNeedsAux(needs_aux),
 	mDecodedRaw(false),
@@ -206,6 +209,8 @@ LLImageDecodeThread::ImageRequest::~ImageRequest()
 {
 	mDecodedImageRaw = NULL;
 	mDecodedImageAux = NULL;
+	mCompressedImage = NULL;
+	mAlphaInfo = NULL;
 	mFormattedImage = NULL;
 }
 
@@ -273,6 +278,16 @@ bool LLImageDecodeThread::ImageRequest::processRequestIntern()
 				llwarns_once << "Failed to allocate raw image !" << llendl;
 			}
 		}
+		if (done && mDecodedRaw)
+		{
+			// Spare this full scan of the pixels to the main thread, when it
+			// will create the GL texture for this image.
+			mAlphaInfo = LLImageAlphaInfo::analyze(mDecodedImageRaw);
+			if (mCompressID.notNull() && LLImageBC::sEnabled)
+			{
+				compressImage();
+			}
+		}
 		break;
 	}
 
@@ -287,6 +302,27 @@ bool LLImageDecodeThread::ImageRequest::processRequestIntern()
 	return done;
 }
 
+void LLImageDecodeThread::ImageRequest::compressImage()
+{
+	LL_TRACY_TIMER(TRC_IMG_COMPRESS);
+
+	// A texture asset never changes for a given UUID, so the cached image is
+	// valid as long as it matches the sizes of the decoded image.
+	S32 discard = mFormattedImage->getDiscardLevel();
+	mCompressedImage =
+		LLImageBC::loadCached(mCompressID, discard,
+							  mDecodedImageRaw->getWidth(),
+							  mDecodedImageRaw->getHeight());
+	if (mCompressedImage.isNull())
+	{
+		mCompressedImage = LLImageBC::encode(mDecodedImageRaw);
+		if (mCompressedImage.notNull())
+		{
+			mCompressedImage->saveToCache(mCompressID, discard);
+		}
+	}
+}
+
 // Returns true when done, whether or not decode was successful.
 bool LLImageDecodeThread::ImageRequest::processRequest()
 {
@@ -310,7 +346,9 @@ void LLImageDecodeThread::ImageRequest::finishRequest(bool completed)
 		bool success = completed && mDecodedRaw &&
 					   mDecodedImageRaw && mDecodedImageRaw->getDataSize() &&
 					   (!mNeedsAux || mDecodedAux);
-		mResponder->completed(success, mDecodedImageRaw, mDecodedImageAux);
+		mResponder->completed(success, mDecodedImageRaw, mDecodedImageAux,
+							  success ? mCompressedImage.get() : NULL,
+							  success ? mAlphaInfo.get() : NULL);
 	}
 	// Will automatically be deleted
 }
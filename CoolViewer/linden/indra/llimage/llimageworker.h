@@ -37,8 +37,10 @@
 
 #include "llerror.h"
 #include "llimage.h"
+#include "llimagebc.h"
 #include "llpointer.h"
 #include "llqueuedthread.h"
+#include "lluuid.h"
 
 class LLImageDecodeThread final : public LLQueuedThread
 {
@@ -54,8 +56,12 @@ public:
 		~Responder() override = default;
 
 	public:
+		// 'bc' is the block-compressed version of 'raw' when it was
+		// requested (and possible), or NULL. 'alpha' holds the results of the
+		// alpha channel analysis of 'raw', or is NULL when it got no alpha.
 		virtual void completed(bool success, LLImageRaw* raw,
-							   LLImageRaw* aux) = 0;
+							   LLImageRaw* aux, LLImageBC* bc,
+							   LLImageAlphaInfo* alpha) = 0;
 	};
 
 	class ImageRequest final : public LLQueuedThread::QueuedRequest
@@ -68,19 +74,27 @@ public:
 	public:
 		ImageRequest(handle_t handle, LLImageFormatted* image,
 					 U32 priority, S32 discard, bool needs_aux,
-					 Responder* responder,
+					 const LLUUID& compress_id, Responder* responder,
 			         LLImageDecodeThread* queue);
 
 		bool processRequest() override;
 		bool processRequestIntern();
 		void finishRequest(bool completed) override;
 
+	private:
+		// Fetches the block-compressed image from the disk cache, or encodes
+		// and caches it.
+		void compressImage();
+
 	private:
 		// Input
 		LLPointer<LLImageFormatted>					mFormattedImage;
 		LLPointer<LLImageRaw>						mDecodedImageRaw;
 		LLPointer<LLImageRaw>						mDecodedImageAux;
+		LLPointer<LLImageBC>						mCompressedImage;
+		LLPointer<LLImageAlphaInfo>					mAlphaInfo;
 		LLPointer<LLImageDecodeThread::Responder>	mResponder;
+		LLUUID										mCompressID;
 		LLImageDecodeThread*						mQueue;
 		S32											mDiscardLevel;
 		bool										mNeedsAux;
@@ -132,8 +146,12 @@ public:
 
 	~LLImageDecodeThread() override;
 
+	// When 'compress_id' is not null and LLImageBC::sEnabled is true, the
+	// decoded image also gets block-compressed, with the result cached
+	// on disk under that (texture) UUID.
 	handle_t decodeImage(LLImageFormatted* image, U32 priority, S32 discard,
-						 bool needs_aux, Responder* responder);
+						 bool needs_aux, Responder* responder,
+						 const LLUUID& compress_id = LLUUID::null);
 	S32 update(F32 max_time_ms) override;
 
 	bool sendToPool(ImageRequest* req);
@@ -150,6 +168,7 @@ private:
 	struct CreationInfo
 	{
 		LLPointer<Responder>	responder;
+		LLUUID					compress_id;
 		handle_t				handle;
 		LLImageFormatted*		image;
 		U32						priority;
@@ -157,8 +176,9 @@ private:
 		bool					needs_aux;
 
 		CreationInfo(handle_t h, LLImageFormatted* i, U32 p, S32 d, bool aux,
-					 Responder* r)
-		:	handle(h),
+					 Responder* r, const LLUUID& id)
+		:	compress_id(id),
+			handle(h),
 			image(i),
 			priority(p),
 			discard(d),
@@ -237,6 +237,117 @@ S32 LLCamera::AABBInFrustum(const LLVector4a& center, const LLVector4a& radius,
 	return result ? 1 : 2;
 }
 
+// Note: for a plane with normal n and distance d, and a box of center c and
+// radius r, the box is fully outside when its nearest corner is, i.e. when
+// n.c + d > |n|.r, and it intersects the plane when its farthest corner is
+// outside, i.e. when n.c + d > -|n|.r. This is what the non-batched methods
+// compute via sFrustumScaler[] and the plane masks, and which we can compute
+// here for 8 (AVX2) or 4 (SSE2) boxes at once.
+void LLCamera::AABBsInFrustum(const F32* const* soa, U32 count, S8* results,
+							  bool no_far_clip) const
+{
+	// Gather the active planes: normal components, their absolute values,
+	// and distance.
+	F32 planes[AGENT_PLANE_USER_CLIP_NUM][7];
+	U32 active = 0;
+	U32 max_planes = llmin(mPlaneCount, (U32)AGENT_PLANE_USER_CLIP_NUM);
+	for (U32 i = 0; i < max_planes; ++i)
+	{
+		if (mPlaneMask[i] >= PLANE_MASK_NUM ||
+			(no_far_clip && i == AGENT_PLANE_FAR))
+		{
+			continue;
+		}
+		const LLPlane& p = mAgentPlanes[i];
+		F32* plane = planes[active++];
+		for (U32 j = 0; j < 3; ++j)
+		{
+			plane[j] = p[j];
+			plane[j + 3] = fabsf(p[j]);
+		}
+		plane[6] = p[3];
+	}
+
+	const F32* cx = soa[0];
+	const F32* cy = soa[1];
+	const F32* cz = soa[2];
+	const F32* rx = soa[3];
+	const F32* ry = soa[4];
+	const F32* rz = soa[5];
+#if defined(__AVX2__)
+	constexpr U32 LANES = 8;
+#else
+	constexpr U32 LANES = 4;
+#endif
+	for (U32 i = 0; i < count; i += LANES)
+	{
+		U32 outside, partial;
+#if defined(__AVX2__)
+		__m256 vcx = _mm256_loadu_ps(cx + i);
+		__m256 vcy = _mm256_loadu_ps(cy + i);
+		__m256 vcz = _mm256_loadu_ps(cz + i);
+		__m256 vrx = _mm256_loadu_ps(rx + i);
+		__m256 vry = _mm256_loadu_ps(ry + i);
+		__m256 vrz = _mm256_loadu_ps(rz + i);
+		__m256 vout = _mm256_setzero_ps();
+		__m256 vpart = _mm256_setzero_ps();
+		for (U32 j = 0; j < active; ++j)
+		{
+			const F32* plane = planes[j];
+			__m256 s = _mm256_add_ps(_mm256_mul_ps(vcx,
+												   _mm256_set1_ps(plane[0])),
+									 _mm256_mul_ps(vcy,
+												   _mm256_set1_ps(plane[1])));
+			s = _mm256_add_ps(s, _mm256_mul_ps(vcz, _mm256_set1_ps(plane[2])));
+			s = _mm256_add_ps(s, _mm256_set1_ps(plane[6]));
+			__m256 e = _mm256_add_ps(_mm256_mul_ps(vrx,
+												   _mm256_set1_ps(plane[3])),
+									 _mm256_mul_ps(vry,
+												   _mm256_set1_ps(plane[4])));
+			e = _mm256_add_ps(e, _mm256_mul_ps(vrz, _mm256_set1_ps(plane[5])));
+			vout = _mm256_or_ps(vout, _mm256_cmp_ps(s, e, _CMP_GT_OQ));
+			vpart = _mm256_or_ps(vpart,
+								 _mm256_cmp_ps(s,
+											   _mm256_sub_ps(_mm256_setzero_ps(),
+															 e),
+											   _CMP_GT_OQ));
+		}
+		outside = _mm256_movemask_ps(vout);
+		partial = _mm256_movemask_ps(vpart);
+#else
+		__m128 vcx = _mm_loadu_ps(cx + i);
+		__m128 vcy = _mm_loadu_ps(cy + i);
+		__m128 vcz = _mm_loadu_ps(cz + i);
+		__m128 vrx = _mm_loadu_ps(rx + i);
+		__m128 vry = _mm_loadu_ps(ry + i);
+		__m128 vrz = _mm_loadu_ps(rz + i);
+		__m128 vout = _mm_setzero_ps();
+		__m128 vpart = _mm_setzero_ps();
+		for (U32 j = 0; j < active; ++j)
+		{
+			const F32* plane = planes[j];
+			__m128 s = _mm_add_ps(_mm_mul_ps(vcx, _mm_set1_ps(plane[0])),
+								  _mm_mul_ps(vcy, _mm_set1_ps(plane[1])));
+			s = _mm_add_ps(s, _mm_mul_ps(vcz, _mm_set1_ps(plane[2])));
+			s = _mm_add_ps(s, _mm_set1_ps(plane[6]));
+			__m128 e = _mm_add_ps(_mm_mul_ps(vrx, _mm_set1_ps(plane[3])),
+								  _mm_mul_ps(vry, _mm_set1_ps(plane[4])));
+			e = _mm_add_ps(e, _mm_mul_ps(vrz, _mm_set1_ps(plane[5])));
+			vout = _mm_or_ps(vout, _mm_cmpgt_ps(s, e));
+			vpart = _mm_or_ps(vpart,
+							  _mm_cmpgt_ps(s, _mm_sub_ps(_mm_setzero_ps(), e)));
+		}
+		outside = _mm_movemask_ps(vout);
+		partial = _mm_movemask_ps(vpart);
+#endif
+		for (U32 j = 0, end = llmin(LANES, count - i); j < end; ++j)
+		{
+			U32 bit = 1 << j;
+			results[i + j] = (outside & bit) ? 0 : ((partial & bit) ? 1 : 2);
+		}
+	}
+}
+
 // Exactly same as the function AABBInFrustum(...), except uses mRegionPlanes
 // instead of mAgentPlanes.
 S32 LLCamera::AABBInRegionFrustum(const LLVector4a& center,
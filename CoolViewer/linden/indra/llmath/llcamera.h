@@ -214,6 +214,18 @@ public:
 	S32 AABBInRegionFrustumNoFarClip(const LLVector4a& center,
 									 const LLVector4a& radius);
 
+	// Batched versions of AABBInFrustum() and AABBInFrustumNoFarClip(), using
+	// agent space planes, for 'count' boxes passed in structure-of-arrays
+	// form: soa[0] to soa[2] point on the centers x, y and z components arrays
+	// and soa[3] to soa[5] on the radii ones. The arrays must be padded to a
+	// multiple of 8 elements. For each box, results[] receives 0 = outside,
+	// 1 = partially in or 2 = fully in. Note that the results match the ones
+	// of the non-batched methods only up to float rounding: the plane tests
+	// are computed in a different order, so boxes exactly touching a plane
+	// (within an ULP or so) may get classified differently.
+	void AABBsInFrustum(const F32* const* soa, U32 count, S8* results,
+						bool no_far_clip = false) const;
+
 	// Does a quick'n dirty sphere-sphere check
 	S32 sphereInFrustumQuick(const LLVector3& sphere_center, F32 radius);
 
@@ -119,3 +119,154 @@ void LLMatrix4a::matMulBoundBox(const LLVector4a* in_extents,
 		out_extents[1].setMax(out_extents[1], tv[i]);
 	}
 }
+
+#if defined(__AVX2__)
+// Returns an AVX register holding 'v' in both its 128 bits lanes.
+static LL_INLINE __m256 splat_lanes(const LLVector4a& v)
+{
+	return _mm256_broadcast_ps((const __m128*)v.getF32ptr());
+}
+#endif
+
+// Note: the batched transforms below use the same operations, in the same
+// order, as the corresponding per-vector methods (no FMA in particular), so
+// that their results are bit-identical.
+
+void LLMatrix4a::affineTransformBatch(const LLVector4a* src, LLVector4a* dst,
+									  U32 count, const LLVector4a& w) const
+{
+	U32 i = 0;
+#if defined(__AVX2__)
+	const __m256 c0 = splat_lanes(mMatrix[0]);
+	const __m256 c1 = splat_lanes(mMatrix[1]);
+	const __m256 c2 = splat_lanes(mMatrix[2]);
+	const __m256 c3 = splat_lanes(mMatrix[3]);
+	const __m256 w8 = splat_lanes(w);
+	for ( ; i + 8 <= count; i += 8)
+	{
+		// Two vectors per AVX register, four registers per iteration.
+		for (U32 j = 0; j < 8; j += 2)
+		{
+			__m256 v = _mm256_loadu_ps(src[i + j].getF32ptr());
+			__m256 x = _mm256_mul_ps(_mm256_permute_ps(v, 0x00), c0);
+			__m256 y = _mm256_mul_ps(_mm256_permute_ps(v, 0x55), c1);
+			__m256 z = _mm256_mul_ps(_mm256_permute_ps(v, 0xaa), c2);
+			x = _mm256_add_ps(x, y);
+			z = _mm256_add_ps(z, c3);
+			v = _mm256_blend_ps(_mm256_add_ps(x, z), w8, 0x88);
+			_mm256_storeu_ps(dst[i + j].getF32ptr(), v);
+		}
+	}
+#endif
+	LLVector4Logical mask;
+	mask.clear();
+	mask.setElement<3>();
+	LLVector4a res[4];
+	for ( ; i + 4 <= count; i += 4)
+	{
+		affineTransform(src[i], res[0]);
+		affineTransform(src[i + 1], res[1]);
+		affineTransform(src[i + 2], res[2]);
+		affineTransform(src[i + 3], res[3]);
+		dst[i].setSelectWithMask(mask, w, res[0]);
+		dst[i + 1].setSelectWithMask(mask, w, res[1]);
+		dst[i + 2].setSelectWithMask(mask, w, res[2]);
+		dst[i + 3].setSelectWithMask(mask, w, res[3]);
+	}
+	for ( ; i < count; ++i)
+	{
+		affineTransform(src[i], res[0]);
+		dst[i].setSelectWithMask(mask, w, res[0]);
+	}
+}
+
+void LLMatrix4a::rotateBatch(const LLVector4a* src, LLVector4a* dst,
+							 U32 count) const
+{
+	U32 i = 0;
+#if defined(__AVX2__)
+	const __m256 c0 = splat_lanes(mMatrix[0]);
+	const __m256 c1 = splat_lanes(mMatrix[1]);
+	const __m256 c2 = splat_lanes(mMatrix[2]);
+	for ( ; i + 8 <= count; i += 8)
+	{
+		for (U32 j = 0; j < 8; j += 2)
+		{
+			__m256 v = _mm256_loadu_ps(src[i + j].getF32ptr());
+			__m256 x = _mm256_mul_ps(_mm256_permute_ps(v, 0x00), c0);
+			__m256 y = _mm256_mul_ps(_mm256_permute_ps(v, 0x55), c1);
+			__m256 z = _mm256_mul_ps(_mm256_permute_ps(v, 0xaa), c2);
+			_mm256_storeu_ps(dst[i + j].getF32ptr(),
+							 _mm256_add_ps(_mm256_add_ps(x, y), z));
+		}
+	}
+#endif
+	LLVector4a res[4];
+	for ( ; i + 4 <= count; i += 4)
+	{
+		rotate(src[i], res[0]);
+		rotate(src[i + 1], res[1]);
+		rotate(src[i + 2], res[2]);
+		rotate(src[i + 3], res[3]);
+		dst[i] = res[0];
+		dst[i + 1] = res[1];
+		dst[i + 2] = res[2];
+		dst[i + 3] = res[3];
+	}
+	for ( ; i < count; ++i)
+	{
+		rotate(src[i], dst[i]);
+	}
+}
+
+void LLMatrix4a::rotateNormalizeBatch(const LLVector4a* src, LLVector4a* dst,
+									  U32 count) const
+{
+	U32 i = 0;
+#if defined(__AVX2__)
+	const __m256 c0 = splat_lanes(mMatrix[0]);
+	const __m256 c1 = splat_lanes(mMatrix[1]);
+	const __m256 c2 = splat_lanes(mMatrix[2]);
+	for ( ; i + 8 <= count; i += 8)
+	{
+		for (U32 j = 0; j < 8; j += 2)
+		{
+			const __m256 v = _mm256_loadu_ps(src[i + j].getF32ptr());
+			__m256 x = _mm256_mul_ps(_mm256_permute_ps(v, 0x00), c0);
+			__m256 y = _mm256_mul_ps(_mm256_permute_ps(v, 0x55), c1);
+			__m256 z = _mm256_mul_ps(_mm256_permute_ps(v, 0xaa), c2);
+			__m256 r = _mm256_add_ps(_mm256_add_ps(x, y), z);
+			// Same as normalize3fast() with SSE4.1 (which is implied by
+			// AVX2), for each 128 bits lane.
+			r = _mm256_mul_ps(r, _mm256_rsqrt_ps(_mm256_dp_ps(r, r, 0x7f)));
+			_mm256_storeu_ps(dst[i + j].getF32ptr(),
+							 _mm256_blend_ps(r, v, 0x88));
+		}
+	}
+#endif
+	LLVector4Logical mask;
+	mask.clear();
+	mask.setElement<3>();
+	LLVector4a res[4];
+	for ( ; i + 4 <= count; i += 4)
+	{
+		rotate(src[i], res[0]);
+		rotate(src[i + 1], res[1]);
+		rotate(src[i + 2], res[2]);
+		rotate(src[i + 3], res[3]);
+		res[0].normalize3fast();
+		res[1].normalize3fast();
+		res[2].normalize3fast();
+		res[3].normalize3fast();
+		dst[i].setSelectWithMask(mask, src[i], res[0]);
+		dst[i + 1].setSelectWithMask(mask, src[i + 1], res[1]);
+		dst[i + 2].setSelectWithMask(mask, src[i + 2], res[2]);
+		dst[i + 3].setSelectWithMask(mask, src[i + 3], res[3]);
+	}
+	for ( ; i < count; ++i)
+	{
+		rotate(src[i], res[0]);
+		res[0].normalize3fast();
+		dst[i].setSelectWithMask(mask, src[i], res[0]);
+	}
+}
@@ -376,6 +376,19 @@ public:
 		res.setAdd(x, z);
 	}
 
+	// Batched versions of the above, transforming 'count' vectors from 'src'
+	// into 'dst' (which may be the same array), 8 (AVX2) or 4 (SSE2) vectors
+	// per loop iteration. They give the exact same results as the per-vector
+	// methods. affineTransformBatch() replaces the W component of the results
+	// with the one of 'w', while rotateNormalizeBatch() normalizes the results
+	// with normalize3fast() and keeps the W component of the source vectors
+	// (as needed for tangents).
+	void affineTransformBatch(const LLVector4a* src, LLVector4a* dst,
+							  U32 count, const LLVector4a& w) const;
+	void rotateBatch(const LLVector4a* src, LLVector4a* dst, U32 count) const;
+	void rotateNormalizeBatch(const LLVector4a* src, LLVector4a* dst,
+							  U32 count) const;
+
 	LL_INLINE const LLVector4a& getTranslation() const	{ return mMatrix[3]; }
 
 	LL_INLINE void perspectiveTransform(const LLVector4a& v,
@@ -33,9 +33,11 @@
 #ifndef LL_LLOCTREE_H
 #define LL_LLOCTREE_H
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
-
+#include "llatomic.h"
 #include "llpointer.h"
 #include "llrefcount.h"
 #include "llvector3.h"
@@ -43,6 +45,11 @@
 
 #define LL_OCTREE_PARANOIA_CHECK 0
 #define NO_CHILD_NODES 255
+// Number of elements stored inline in each node; nodes holding more elements
+// than this store them in a heap-allocated array instead.
+#define LL_OCTREE_INLINE_ELEMENTS 8
+// Number of nodes per slab in the octree nodes pools
+#define LL_OCTREE_POOL_SLAB_NODES 64
 
 extern U32 gOctreeMaxCapacity;
 extern F32 gOctreeMinSize;
@@ -53,6 +60,91 @@ template <class T> class LLTreeNode;
 template <class T> class LLTreeTraveler;
 template <class T> class LLTreeListener;
 
+// Slab allocator for the nodes of an octree, owned by its root node, so that
+// the nodes creation and destruction which happen each time objects move do
+// not churn the general heap, and so that the nodes of a same octree are kept
+// close to each other in memory. Freed nodes are recycled via a free list and
+// the slabs are only released with the pool (i.e. when the octree root is
+// destroyed). Note: not thread-safe; like for the octree itself, only one
+// thread at a time may create or destroy nodes.
+template <class T>
+class LLOctreeNodePool
+{
+protected:
+	LOG_CLASS(LLOctreeNodePool<T>);
+
+public:
+	LLOctreeNodePool(size_t node_size, const void* owner)
+	:	mNodeSize((node_size + 15) & ~15),
+		mFreeList(NULL),
+		mOwner(owner)
+	{
+	}
+
+	~LLOctreeNodePool()
+	{
+		for (U32 i = 0, count = mSlabs.size(); i < count; ++i)
+		{
+			ll_aligned_free_16(mSlabs[i]);
+		}
+		sSlabs -= (U32)mSlabs.size();
+	}
+
+	LL_INLINE const void* getOwner() const			{ return mOwner; }
+
+	void* allocate()
+	{
+		if (!mFreeList)
+		{
+			addSlab();
+		}
+		void* ptr = mFreeList;
+		mFreeList = *(void**)ptr;
+		++sNodes;
+		return ptr;
+	}
+
+	LL_INLINE void release(void* ptr)
+	{
+		*(void**)ptr = mFreeList;
+		mFreeList = ptr;
+		--sNodes;
+	}
+
+private:
+	void addSlab()
+	{
+		char* slab =
+			(char*)ll_aligned_malloc_16(mNodeSize * LL_OCTREE_POOL_SLAB_NODES);
+		mSlabs.push_back(slab);
+		++sSlabs;
+		// Chain the nodes in reverse order, so that they get allocated in
+		// increasing addresses order.
+		for (S32 i = LL_OCTREE_POOL_SLAB_NODES - 1; i >= 0; --i)
+		{
+			void* ptr = slab + i * mNodeSize;
+			*(void**)ptr = mFreeList;
+			mFreeList = ptr;
+		}
+	}
+
+public:
+	// Statistics for all the pools of this octree type. Atomic, since
+	// octrees of a same type may be built by several threads at once (e.g.
+	// the volume faces octrees).
+	static LLAtomicU32	sNodes;
+	static LLAtomicU32	sSlabs;
+
+private:
+	std::vector<char*>	mSlabs;
+	size_t				mNodeSize;
+	void*				mFreeList;
+	const void*			mOwner;
+};
+
+template <class T> LLAtomicU32 LLOctreeNodePool<T>::sNodes(0);
+template <class T> LLAtomicU32 LLOctreeNodePool<T>::sSlabs(0);
+
 template <class T>
 class LLTreeListener: public LLRefCount
 {
@@ -205,16 +297,16 @@ protected:
 public:
 	typedef LLOctreeTraveler<T>									oct_traveler;
 	typedef LLTreeTraveler<T>									tree_traveler;
-	typedef std::vector<LLPointer<T> >							element_list;
 	typedef LLPointer<T>*										element_iter;
 	typedef const LLPointer<T>*									const_element_iter;
 	typedef typename std::vector<LLTreeListener<T>*>::iterator	tree_listener_iter;
 	typedef LLOctreeNode<T>**									child_list;
 	typedef LLOctreeNode<T>**									child_iter;
 
-	typedef LLTreeNode<T>		BaseType;
-	typedef LLOctreeNode<T>		oct_node;
-	typedef LLOctreeListener<T>	oct_listener;
+	typedef LLTreeNode<T>			BaseType;
+	typedef LLOctreeNode<T>			oct_node;
+	typedef LLOctreeListener<T>		oct_listener;
+	typedef LLOctreeNodePool<T>		node_pool;
 
 	LL_INLINE void* operator new(size_t size)
 	{
@@ -238,14 +330,13 @@ public:
 
 	LLOctreeNode(const LLVector4a& center, const LLVector4a& size,
 				 BaseType* parent, U8 octant = NO_CHILD_NODES)
-	:	mParent((oct_node*)parent),
+	:	mData(mInlineData),
+		mDataCapacity(LL_OCTREE_INLINE_ELEMENTS),
+		mParent((oct_node*)parent),
+		mPool(parent ? ((oct_node*)parent)->mPool : NULL),
 		mOctant(octant)
 	{
 		llassert(size[0] >= gOctreeMinSize * 0.5f);
-		// Always keep a NULL terminated list to avoid out of bounds exceptions
-		// in debug builds
-		mData.push_back(NULL);
-		mDataEnd = &mData[0];
 
 		mCenter = center;
 		mSize = size;
@@ -277,13 +368,46 @@ public:
 				llwarns << "NULL mData[i] found for i = " << i << llendl;
 			}
 		}
-		mData.clear();
-		mData.push_back(NULL);
-		mDataEnd = &mData[0];
+		mElementCount = 0;
+		freeData();
 
 		for (U32 i = 0; i < getChildCount(); ++i)
 		{
-			delete getChild(i);
+			deleteNode(getChild(i));
+		}
+
+		if (mPool && mPool->getOwner() == this)
+		{
+			delete mPool;
+		}
+	}
+
+	// Creates a child node, allocated from the octree nodes pool when there
+	// is one. Note that the child is not added to this node: addChild() must
+	// be called for this.
+	oct_node* createNode(const LLVector4a& center, const LLVector4a& size)
+	{
+		if (mPool)
+		{
+			// Note: '::new' since our class-specific operator new() hides the
+			// placement new operator.
+			return ::new (mPool->allocate()) oct_node(center, size, this);
+		}
+		return new oct_node(center, size, this);
+	}
+
+	// Destroys a node created with createNode()
+	static void deleteNode(oct_node* node)
+	{
+		node_pool* pool = node->mPool;
+		if (pool && pool->getOwner() != node)
+		{
+			node->~oct_node();
+			pool->release(node);
+		}
+		else
+		{
+			delete node;
 		}
 	}
 
@@ -375,12 +499,10 @@ public:
 
 	U32 getElementCount() const						{ return mElementCount; }
 	bool isEmpty() const							{ return mElementCount == 0; }
-	element_list& getData()							{ return mData; }
-	const element_list& getData() const				{ return mData; }
-	element_iter getDataBegin()						{ return &mData[0]; }
-	element_iter getDataEnd()						{ return mDataEnd; }
-	const_element_iter getDataBegin() const			{ return &mData[0]; }
-	const_element_iter getDataEnd() const			{ return mDataEnd; }
+	element_iter getDataBegin()						{ return mData; }
+	element_iter getDataEnd()						{ return mData + mElementCount; }
+	const_element_iter getDataBegin() const			{ return mData; }
+	const_element_iter getDataEnd() const			{ return mData + mElementCount; }
 
 	U32 getChildCount()	const						{ return mChildCount; }
 	oct_node* getChild(U32 index)					{ return mChild[index]; }
@@ -466,10 +588,7 @@ public:
 				 parent->getElementCount() >= gOctreeMaxCapacity))
 			{
 				// It belongs here
-				mData.push_back(NULL);
-				mData[mElementCount] = data;
-				mDataEnd = &mData[++mElementCount];
-				data->setBinIndex(mElementCount - 1);
+				pushElement(data);
 				return BaseType::insert(data);
 			}
 
@@ -500,10 +619,7 @@ public:
 			LLVector4a min_diff(gOctreeMinSize);
 			if ((val.lessThan(min_diff).getGatheredBits() & 0x7) == 0x7)
 			{
-				mData.push_back(NULL);
-				mData[mElementCount] = data;
-				mDataEnd = &mData[++mElementCount];
-				data->setBinIndex(mElementCount - 1);
+				pushElement(data);
 				return BaseType::insert(data);
 			}
 
@@ -529,7 +645,7 @@ public:
 #endif
 			llassert(size[0] >= gOctreeMinSize * 0.5f);
 			// Make the new child
-			child = new LLOctreeNode<T>(center, size, this);
+			child = createNode(center, size);
 			addChild(child);
 			return child->insert(data);
 		}
@@ -576,19 +692,18 @@ public:
 			if ((S32)mElementCount != i)
 			{
 				// Might unref data, do not access data after this point
-				mData[i] = mData[mElementCount];
+				mData[i] = std::move(mData[mElementCount]);
 				mData[i]->setBinIndex(i);
 			}
-
-			mData[mElementCount] = NULL;
-			mData.pop_back();
-			mDataEnd = &mData[mElementCount];
+			else
+			{
+				mData[mElementCount] = NULL;
+			}
 		}
 		else
 		{
-			mData.clear();
-			mData.push_back(NULL);
-			mDataEnd = &mData[0];
+			mData[0] = NULL;
+			freeData();
 		}
 
 		this->notifyRemoval(data);
@@ -689,8 +804,10 @@ public:
 		for (U32 i = 0; i < getChildCount(); ++i)
 		{
 			mChild[i]->destroy();
-			delete mChild[i];
+			deleteNode(mChild[i]);
 		}
+		// Do not let the destructor destroy the children a second time
+		clearChildren();
 	}
 
 	void addChild(oct_node* child, bool silent = false)
@@ -760,7 +877,7 @@ public:
 		if (destroy)
 		{
 			mChild[index]->destroy();
-			delete mChild[index];
+			deleteNode(mChild[index]);
 		}
 
 		mChild[index] = mChild[--mChildCount];
@@ -802,6 +919,40 @@ public:
 		llwarns << "Octree failed to delete requested child." << llendl;
 	}
 
+protected:
+	void pushElement(T* data)
+	{
+		if (mElementCount == mDataCapacity)
+		{
+			// Switch to (or grow) the heap-allocated array
+			U32 capacity = mDataCapacity * 2;
+			LLPointer<T>* new_data = new LLPointer<T>[capacity];
+			for (U32 i = 0; i < mElementCount; ++i)
+			{
+				new_data[i] = std::move(mData[i]);
+			}
+			if (mData != mInlineData)
+			{
+				delete[] mData;
+			}
+			mData = new_data;
+			mDataCapacity = capacity;
+		}
+		mData[mElementCount] = data;
+		data->setBinIndex(mElementCount++);
+	}
+
+	// Reverts to the inline storage. Must only be called when empty.
+	void freeData()
+	{
+		if (mData != mInlineData)
+		{
+			delete[] mData;
+			mData = mInlineData;
+			mDataCapacity = LL_OCTREE_INLINE_ELEMENTS;
+		}
+	}
+
 protected:
 	typedef enum
 	{
@@ -821,10 +972,13 @@ protected:
 	U32					mChildCount;
 
 	U32					mElementCount;
-	element_list		mData;
-	element_iter		mDataEnd;
+	// Points either on mInlineData or on a heap-allocated array
+	LLPointer<T>*		mData;
+	U32					mDataCapacity;
+	LLPointer<T>		mInlineData[LL_OCTREE_INLINE_ELEMENTS];
 
 	oct_node*			mParent;
+	node_pool*			mPool;
 	U8					mOctant;
 };
 
@@ -844,6 +998,9 @@ public:
 				 BaseType* parent)
 	:	BaseType(center, size, parent)
 	{
+		// The pool is destroyed by our base class destructor, once all the
+		// child nodes are gone.
+		this->mPool = new LLOctreeNodePool<T>(sizeof(oct_node), this);
 	}
 
 	bool balance()
@@ -872,7 +1029,7 @@ public:
 
 			// Destroy child
 			child->clearChildren();
-			delete child;
+			BaseType::deleteNode(child);
 
 			return false;
 		}
@@ -964,7 +1121,7 @@ public:
 			llassert(size[0] >= gOctreeMinSize);
 
 			// Copy our children to a new branch
-			LLOctreeNode<T>* newnode = new LLOctreeNode<T>(center, size, this);
+			LLOctreeNode<T>* newnode = this->createNode(center, size);
 
 			for (U32 i = 0; i < this->getChildCount(); ++i)
 			{
@@ -980,6 +1137,77 @@ public:
 		// Insert the data
 		return insert(data);
 	}
+
+	// Bulk insertion, for building a whole octree at once: the elements are
+	// inserted in the Morton order of their position, so that consecutive
+	// insertions walk down the same, cache-hot branches and the nodes of a
+	// same branch get allocated close to each other in the pool. Each element
+	// is still inserted from the root, so the resulting octree is the same as
+	// when inserting the elements one by one in that order. Returns the number
+	// of elements which got successfully inserted.
+	U32 insertBulk(const LLPointer<T>* data, U32 count)
+	{
+		if (!count)
+		{
+			return 0;
+		}
+
+		// Quantize the positions into a 1024^3 grid over their bounding box
+		LLVector4a min = data[0]->getPositionGroup();
+		LLVector4a max = min;
+		for (U32 i = 1; i < count; ++i)
+		{
+			const LLVector4a& pos = data[i]->getPositionGroup();
+			min.setMin(min, pos);
+			max.setMax(max, pos);
+		}
+		LLVector4a extent;
+		extent.setSub(max, min);
+		F32 scale[3];
+		for (U32 i = 0; i < 3; ++i)
+		{
+			scale[i] = extent[i] > 0.f ? 1023.f / extent[i] : 0.f;
+		}
+
+		std::vector<std::pair<U32, U32> > order;
+		order.reserve(count);
+		for (U32 i = 0; i < count; ++i)
+		{
+			LLVector4a rel;
+			rel.setSub(data[i]->getPositionGroup(), min);
+			U32 code = 0;
+			for (U32 j = 0; j < 3; ++j)
+			{
+				code |= spreadBits((U32)(rel[j] * scale[j])) << j;
+			}
+			order.emplace_back(code, i);
+		}
+		std::sort(order.begin(), order.end());
+
+		U32 inserted = 0;
+		for (U32 i = 0; i < count; ++i)
+		{
+			if (insert(data[order[i].second].get()))
+			{
+				++inserted;
+			}
+		}
+
+		return inserted;
+	}
+
+private:
+	// Spreads the 10 lower bits of 'v' so that there are two 0 bits between
+	// each of them.
+	static U32 spreadBits(U32 v)
+	{
+		v &= 0x3ff;
+		v = (v | (v << 16)) & 0x030000ff;
+		v = (v | (v << 8)) & 0x0300f00f;
+		v = (v | (v << 4)) & 0x030c30c3;
+		v = (v | (v << 2)) & 0x09249249;
+		return v;
+	}
 };
 
 #endif
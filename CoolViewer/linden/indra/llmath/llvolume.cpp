@@ -5893,14 +5893,20 @@ void LLVolumeFace::createOctree(F32 scaler, const LLVector4a& center0,
 		return;
 	}
 
-	mOctree = new LLOctreeRoot<LLVolumeTriangle>(center0, size0, NULL);
+	LLOctreeRoot<LLVolumeTriangle>* root =
+		new LLOctreeRoot<LLVolumeTriangle>(center0, size0, NULL);
+	mOctree = root;
 	new LLVolumeOctreeListener(mOctree);
 
+	std::vector<LLPointer<LLVolumeTriangle> > triangles;
+	triangles.reserve(mNumIndices / 3);
+
 	LLVector4a min, max, center, size;
 	for (S32 i = 0; i < mNumIndices; i += 3)
 	{
 		// For each triangle
-		LLPointer<LLVolumeTriangle> tri = new LLVolumeTriangle();
+		LLVolumeTriangle* tri = new LLVolumeTriangle();
+		triangles.emplace_back(tri);
 
 		const LLVector4a& v0 = mPositions[mIndices[i]];
 		const LLVector4a& v1 = mPositions[mIndices[i + 1]];
@@ -5936,11 +5942,11 @@ void LLVolumeFace::createOctree(F32 scaler, const LLVector4a& center0,
 		size.setSub(max, min);
 
 		tri->mRadius = size.getLength3().getF32() * scaler;
-
-		// Insert
-		mOctree->insert(tri);
 	}
 
+	// Insert all the triangles at once
+	root->insertBulk(triangles.data(), triangles.size());
+
 	// Remove unneeded octree layers
 	while (!mOctree->balance()) ;
 
@@ -5955,6 +5961,15 @@ void LLVolumeFace::createOctree(F32 scaler, const LLVector4a& center0,
 	}
 }
 
+void LLVolumeFace::refitOctree()
+{
+	if (mOctree)
+	{
+		LLVolumeOctreeRebound rebound(this);
+		rebound.traverse(mOctree);
+	}
+}
+
 void LLVolumeFace::swapData(LLVolumeFace& rhs)
 {
 	llswap(rhs.mPositions, mPositions);
@@ -1069,6 +1069,12 @@ public:
 					  const LLVector4a& center = LLVector4a(0, 0, 0),
 					  const LLVector4a& size = LLVector4a(0.5f, 0.5f, 0.5f));
 
+	// Recomputes the bounding boxes of the existing octree nodes after the
+	// vertices positions changed (the triangles being left in their current
+	// nodes). Much cheaper than a full rebuild, but the resulting tree gets
+	// less efficient as the geometry deforms.
+	void refitOctree();
+
 	enum
 	{
 		SINGLE_MASK =	0x0001,
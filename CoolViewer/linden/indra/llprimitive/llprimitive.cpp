@@ -1137,6 +1137,43 @@ S32 LLPrimitive::unpackTEMessage(LLDataPacker& dp)
 	return retval;
 }
 
+//static
+bool LLPrimitive::unpackTEImageIDs(LLDataPacker& dp, uuid_list_t& ids)
+{
+	U8 packed_buffer[MAX_TE_BUFFER];
+	S32 size;
+	if (!dp.unpackBinaryData(packed_buffer, size, "TextureEntry"))
+	{
+		return false;
+	}
+	if (size <= 0)
+	{
+		return true;
+	}
+	if ((U32)size >= MAX_TE_BUFFER)
+	{
+		size = MAX_TE_BUFFER - 1;
+	}
+	// See the comment in unpackTEMessage() about the missing null byte.
+	packed_buffer[size++] = 0x00;
+
+	LLUUID image_ids[MAX_TES];
+	U8* cur_ptr = packed_buffer;
+	if (!LLTEField::unpack<LLUUID>(image_ids, MAX_TES, cur_ptr,
+								   packed_buffer + size, MVT_LLUUID))
+	{
+		return false;
+	}
+	for (U32 i = 0; i < MAX_TES; ++i)
+	{
+		if (image_ids[i].notNull())
+		{
+			ids.emplace(image_ids[i]);
+		}
+	}
+	return true;
+}
+
 U8 LLPrimitive::getExpectedNumTEs() const
 {
 	U8 expected_face_count = 0;
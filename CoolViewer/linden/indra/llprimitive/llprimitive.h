@@ -381,6 +381,9 @@ public:
 	S32 unpackTEMessage(LLMessageSystem* mesgsys, char const* block_name,
 						S32 block_num); // Variable num of blocks
 	S32 unpackTEMessage(LLDataPacker& dp);
+	// Extracts the (non-null) texture Ids from a packed TE message, without
+	// applying it to any primitive. Returns false on malformed data.
+	static bool unpackTEImageIDs(LLDataPacker& dp, uuid_list_t& ids);
 	S32 parseTEMessage(LLMessageSystem* mesgsys, char const* block_name,
 					   S32 block_num, LLTEContents& tec);
 	S32 applyParsedTEMessage(LLTEContents& tec);
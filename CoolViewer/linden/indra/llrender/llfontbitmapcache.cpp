@@ -44,7 +44,8 @@ LLFontBitmapCache::LLFontBitmapCache()
 	mBitmapHeight(0),
 	mCurrentOffsetX(1),
 	mCurrentOffsetY(1),
-	mCurrentBitmapNum(-1)
+	mBitmapNum(-1),
+	mGeneration(0)
 {
 }
 
@@ -53,7 +54,8 @@ void LLFontBitmapCache::reset()
 	mImageRawVec.clear();
 	mImageGLVec.clear();
 	mBitmapWidth = mBitmapHeight = mCurrentOffsetX = mCurrentOffsetY = 0,
-	mCurrentBitmapNum = -1;
+	mBitmapNum = -1;
+	++mGeneration;
 }
 
 void LLFontBitmapCache::init(S32 num_components, S32 max_char_width,
@@ -83,15 +85,24 @@ void LLFontBitmapCache::nextOpenPos(S32 width, S32& pos_x, S32& pos_y,
 			mImageGLVec.emplace_back(new LLImageGL(false));
 			LLImageGL* image_gl = getImageGL(mBitmapNum);
 
-			S32 image_width = mMaxCharWidth * 20;
+			S32 image_width = mMaxCharWidth * 40;
 			S32 pow_iw = 2;
 			while (pow_iw < image_width)
 			{
 				pow_iw *= 2;
 			}
 			image_width = pow_iw;
-			// Do not make bigger than 512x512, ever.
-			image_width = llmin(512, image_width);
+			// Use large enough bitmaps to hold many glyphs (typically all the
+			// Latin ones with their accented variants for UI fonts), so that
+			// rendering a text rarely requires to switch textures in the
+			// middle of a string (which breaks the draw calls batching).
+			// Do not make bigger than 1024x1024 (or GL max texture size) ever.
+			S32 max_size = 1024;
+			if (gGLManager.mGLMaxTextureSize > 0)
+			{
+				max_size = llmin(max_size, gGLManager.mGLMaxTextureSize);
+			}
+			image_width = llmin(max_size, image_width);
 			S32 image_height = image_width;
 
 			image_raw->resize(image_width, image_height, mNumComponents);
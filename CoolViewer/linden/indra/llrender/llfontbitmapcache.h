@@ -70,6 +70,10 @@ public:
 	LL_INLINE S32 getBitmapWidth() const			{ return mBitmapWidth; }
 	LL_INLINE S32 getBitmapHeight() const			{ return mBitmapHeight; }
 
+	// Incremented each time the cache is reset, i.e. each time the glyphs
+	// positions in the bitmaps get invalidated.
+	LL_INLINE U32 getGeneration() const				{ return mGeneration; }
+
 private:
 	std::vector<LLPointer<LLImageRaw> >	mImageRawVec;
 	std::vector<LLPointer<LLImageGL> >	mImageGLVec;
@@ -81,7 +85,7 @@ private:
 	S32									mMaxCharHeight;
 	S32									mCurrentOffsetX;
 	S32									mCurrentOffsetY;
-	S32									mCurrentBitmapNum;
+	U32									mGeneration;
 };
 
 #endif //LL_LLFONTBITMAPCACHE_H
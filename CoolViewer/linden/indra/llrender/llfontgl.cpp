@@ -72,6 +72,9 @@ F32 LLFontGL::sCurDepth;
 std::vector<std::pair<LLCoordGL, F32> > LLFontGL::sOriginStack;
 
 bool LLFontGL::sUseBatchedRender =  false;
+bool LLFontGL::sUseTextRunsCache = true;
+U32 LLFontGL::sTextRunsHits = 0;
+U32 LLFontGL::sTextRunsMisses = 0;
 
 constexpr F32 EXT_X_BEARING = 1.f;
 constexpr F32 EXT_Y_BEARING = 0.f;
@@ -80,7 +83,32 @@ constexpr F32 EXT_KERNING = 1.f;
 constexpr F32 PAD_UVY = 0.5f;
 constexpr F32 DROP_SHADOW_SOFT_STRENGTH = 0.3f;
 
+// Longest text (in characters) for which the laid out runs get cached
+constexpr S32 MAX_CACHED_RUN_LENGTH = 256;
+// Maximum number of cached text runs per font; the cache is flushed when
+// full.
+constexpr U32 MAX_CACHED_RUNS = 2048;
+// Maximum number of vertices passed to gGL at once when replaying a cached
+// run; gGL.end() flushes above 2048 vertices and the immediate mode buffer
+// holds 4096 of them.
+constexpr U32 MAX_RUN_VERTICES_BATCH = 1020;
+
+static LLVector3 sGlyphVertices[GLYPH_BATCH_SIZE * MAX_VERT_PER_GLYPH];
+static LLVector2 sGlyphUVs[GLYPH_BATCH_SIZE * MAX_VERT_PER_GLYPH];
+static LLColor4U sGlyphColors[GLYPH_BATCH_SIZE * MAX_VERT_PER_GLYPH];
+
+// FNV-1a hashing of the text runs parameters
+LL_INLINE static void hash_run_data(U64& hash, const void* data, size_t size)
+{
+	const U8* bytes = (const U8*)data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+}
+
 LLFontGL::LLFontGL()
+:	mTextRunsGeneration(0)
 {
 }
 
@@ -184,188 +212,302 @@ S32 LLFontGL::newrender(const LLWString& wstr, S32 begin_offset, F32 x, F32 y,
 	F32 cur_x = (F32)x * sScaleX + origin_x;
 	F32 cur_y = (F32)y * sScaleY + origin_y;
 
-	// Offset y by vertical alignment; use unscaled font metrics here
-	switch (valign)
-	{
-		case BASELINE:	// Baseline, do nothing.
-			break;
-
-		case TOP:
-			cur_y -= llceil(mFontFreetype->getAscenderHeight());
-			break;
+	const LLFontBitmapCache* font_bitmap_cache =
+		mFontFreetype->getFontBitmapCache();
 
-		case BOTTOM:
-			cur_y += llceil(mFontFreetype->getDescenderHeight());
-			break;
+	LLColor4U text_color = LLColor4U(color);
 
-		case VCENTER:
-			cur_y -= llceil((llceil(mFontFreetype->getAscenderHeight()) -
-							 llceil(mFontFreetype->getDescenderHeight())) *
-							0.5f);
-			break;
+	// Since all the glyphs positions are rounded to whole pixels, a laid out
+	// run may only be translated by a whole number of pixels: only use the
+	// cache when the render origin is pixel-aligned (which is the case for
+	// most UI texts). Also, since the alignment and ellipsis widths below are
+	// measured from the start of the string and not from begin_offset, only
+	// cache the runs starting at the start of the string.
+	text_run_t* runp = NULL;
+	bool cached_run = false;
+	const LLVector3 run_origin(cur_x, cur_y, 0.f);
+	if (sUseTextRunsCache && begin_offset == 0 && length > 0 &&
+		length <= MAX_CACHED_RUN_LENGTH &&
+		cur_x == floorf(cur_x) && cur_y == floorf(cur_y))
+	{
+		if (mTextRunsGeneration != font_bitmap_cache->getGeneration())
+		{
+			// Glyphs got re-rasterized: the cached runs UVs are now invalid.
+			mTextRuns.clear();
+			mTextRunsGeneration = font_bitmap_cache->getGeneration();
+		}
 
-		default:
-			break;
+		const llwchar* text = wstr.c_str() + begin_offset;
+		llwchar next_char = wstr[begin_offset + length];
+		U8 params[4] = { style, (U8)halign, (U8)valign, (U8)use_ellipses };
+		U64 hash = 14695981039346656037ULL;
+		hash_run_data(hash, text, length * sizeof(llwchar));
+		hash_run_data(hash, &next_char, sizeof(llwchar));
+		hash_run_data(hash, &sScaleX, sizeof(F32));
+		hash_run_data(hash, &sScaleY, sizeof(F32));
+		hash_run_data(hash, &max_pixels, sizeof(S32));
+		hash_run_data(hash, params, sizeof(params));
+
+		text_runs_map_t::iterator it = mTextRuns.find(hash);
+		if (it != mTextRuns.end())
+		{
+			runp = &it->second;
+			cached_run = runp->mStyle == style &&
+						 runp->mHAlign == (U8)halign &&
+						 runp->mVAlign == (U8)valign &&
+						 runp->mUseEllipses == use_ellipses &&
+						 runp->mMaxPixels == max_pixels &&
+						 runp->mNextChar == next_char &&
+						 runp->mScaleX == sScaleX &&
+						 runp->mScaleY == sScaleY &&
+						 runp->mText.compare(0, LLWString::npos, text,
+											 length) == 0;
+			if (!cached_run)
+			{
+				// Hash collision: do not record this run
+				runp = NULL;
+			}
+		}
+		else
+		{
+			if (mTextRuns.size() >= MAX_CACHED_RUNS)
+			{
+				mTextRuns.clear();
+			}
+			runp = &mTextRuns[hash];
+			runp->mText.assign(text, length);
+			runp->mNextChar = next_char;
+			runp->mColor = text_color;
+			runp->mScaleX = sScaleX;
+			runp->mScaleY = sScaleY;
+			runp->mMaxPixels = max_pixels;
+			runp->mStyle = style;
+			runp->mHAlign = (U8)halign;
+			runp->mVAlign = (U8)valign;
+			runp->mUseEllipses = use_ellipses;
+		}
 	}
 
-	switch (halign)
+	F32 start_x;
+	S32 chars_drawn = 0;
+	bool draw_ellipses = false;
+
+	if (cached_run)
 	{
-		case LEFT:
-			break;
+		++sTextRunsHits;
 
-		case RIGHT:
-	  		cur_x -= llmin(scaled_max_pixels,
-						   ll_roundp(getWidthF32(wstr.c_str(), 0, length) *
-									 sScaleX));
-			break;
+		if (runp->mColor != text_color)
+		{
+			recolorRun(runp, text_color, style, drop_shadow_strength);
+		}
 
-		case HCENTER:
-	    	cur_x -= llmin(scaled_max_pixels,
-						   ll_roundp(getWidthF32(wstr.c_str(), 0, length) *
-									 sScaleX)) / 2;
-			break;
+		U32 first = 0;
+		for (U32 i = 0, count = runp->mBatches.size(); i < count; ++i)
+		{
+			unit0->bind(font_bitmap_cache->getImageGL(runp->mBatches[i].first));
+			U32 last = first + runp->mBatches[i].second;
+			while (first < last)
+			{
+				U32 vert_count = llmin(last - first, MAX_RUN_VERTICES_BATCH);
+				gGL.begin(LLRender::TRIANGLES);
+				gGL.vertexBatchPreTransformed(&runp->mVertices[first],
+											  &runp->mUVs[first],
+											  &runp->mColors[first],
+											  vert_count, run_origin);
+				gGL.end();
+				first += vert_count;
+			}
+		}
 
-		default:
-			break;
+		start_x = cur_x + runp->mStartX;
+		cur_y += runp->mEndY;
+		cur_x += runp->mEndX;
+		chars_drawn = runp->mCharsDrawn;
+		draw_ellipses = runp->mDrawEllipses;
 	}
+	else
+	{
+		if (runp)
+		{
+			++sTextRunsMisses;
+		}
 
-	F32 cur_render_y = cur_y;
-	F32 cur_render_x = cur_x;
+		// Offset y by vertical alignment; use unscaled font metrics here
+		switch (valign)
+		{
+			case BASELINE:	// Baseline, do nothing.
+				break;
 
-	F32 start_x = ll_round(cur_x);
+			case TOP:
+				cur_y -= llceil(mFontFreetype->getAscenderHeight());
+				break;
 
-	const LLFontBitmapCache* font_bitmap_cache =
-		mFontFreetype->getFontBitmapCache();
+			case BOTTOM:
+				cur_y += llceil(mFontFreetype->getDescenderHeight());
+				break;
 
-	F32 inv_width = 1.f / font_bitmap_cache->getBitmapWidth();
-	F32 inv_height = 1.f / font_bitmap_cache->getBitmapHeight();
+			case VCENTER:
+				cur_y -= llceil((llceil(mFontFreetype->getAscenderHeight()) -
+								 llceil(mFontFreetype->getDescenderHeight())) *
+								0.5f);
+				break;
 
-	constexpr S32 LAST_CHARACTER = LLFontFreetype::LAST_CHAR_FULL;
+			default:
+				break;
+		}
 
-	bool draw_ellipses = false;
-	if (use_ellipses && halign == LEFT)
-	{
-		// Check for too long of a string
-		if (getWidthF32(wstr.c_str(), 0, max_chars) * sScaleX > scaled_max_pixels)
+		switch (halign)
 		{
-			// Use four dots for ellipsis width to generate padding
-			const LLWString dots(utf8str_to_wstring(std::string("....")));
-			scaled_max_pixels = scaled_max_pixels -
-								ll_roundp(getWidthF32(dots.c_str()));
-			if (scaled_max_pixels < 0)
-			{
-				scaled_max_pixels = 0;
-			}
-			draw_ellipses = true;
+			case LEFT:
+				break;
+
+			case RIGHT:
+		  		cur_x -= llmin(scaled_max_pixels,
+							   ll_roundp(getWidthF32(wstr.c_str(), 0, length) *
+										 sScaleX));
+				break;
+
+			case HCENTER:
+		    	cur_x -= llmin(scaled_max_pixels,
+							   ll_roundp(getWidthF32(wstr.c_str(), 0, length) *
+										 sScaleX)) / 2;
+				break;
+
+			default:
+				break;
 		}
-	}
 
-	const LLFontGlyphInfo* next_glyph = NULL;
+		F32 cur_render_y = cur_y;
+		F32 cur_render_x = cur_x;
 
-	static LLVector3 vertices[GLYPH_BATCH_SIZE * MAX_VERT_PER_GLYPH];
-	static LLVector2 uvs[GLYPH_BATCH_SIZE * MAX_VERT_PER_GLYPH];
-	static LLColor4U colors[GLYPH_BATCH_SIZE * MAX_VERT_PER_GLYPH];
+		start_x = ll_round(cur_x);
 
-	LLColor4U text_color = LLColor4U(color);
+		F32 inv_width = 1.f / font_bitmap_cache->getBitmapWidth();
+		F32 inv_height = 1.f / font_bitmap_cache->getBitmapHeight();
 
-	S32 bitmap_num = -1;
-	S32 glyph_count = 0;
-	S32 chars_drawn = 0;
-	for (S32 i = begin_offset; i < begin_offset + length; ++i)
-	{
-		llwchar wch = wstr[i];
+		constexpr S32 LAST_CHARACTER = LLFontFreetype::LAST_CHAR_FULL;
 
-		const LLFontGlyphInfo* fgi = next_glyph;
-		next_glyph = NULL;
-		if (!fgi)
+		if (use_ellipses && halign == LEFT)
 		{
-			fgi = mFontFreetype->getGlyphInfo(wch);
-		}
-		if (!fgi)
-		{
-			llerrs << "Missing Glyph Info" << llendl;
-			break;
+			// Check for too long of a string
+			if (getWidthF32(wstr.c_str(), 0, max_chars) * sScaleX >
+					scaled_max_pixels)
+			{
+				// Use four dots for ellipsis width to generate padding
+				const LLWString dots(utf8str_to_wstring(std::string("....")));
+				scaled_max_pixels = scaled_max_pixels -
+									ll_roundp(getWidthF32(dots.c_str()));
+				if (scaled_max_pixels < 0)
+				{
+					scaled_max_pixels = 0;
+				}
+				draw_ellipses = true;
+			}
 		}
-		// Per-glyph bitmap texture.
-		S32 next_bitmap_num = fgi->mBitmapNum;
-		if (next_bitmap_num != bitmap_num)
+
+		const LLFontGlyphInfo* next_glyph = NULL;
+
+		S32 bitmap_num = -1;
+		S32 glyph_count = 0;
+		for (S32 i = begin_offset; i < begin_offset + length; ++i)
 		{
-			// Actually draw the queued glyphs before switching their texture;
-			// otherwise the queued glyphs will be taken from wrong textures.
-			if (glyph_count > 0)
+			llwchar wch = wstr[i];
+
+			const LLFontGlyphInfo* fgi = next_glyph;
+			next_glyph = NULL;
+			if (!fgi)
 			{
-				gGL.begin(LLRender::TRIANGLES);
-				gGL.vertexBatchPreTransformed(vertices, uvs, colors,
-											  glyph_count * 6);
-				gGL.end();
-				glyph_count = 0;
+				fgi = mFontFreetype->getGlyphInfo(wch);
 			}
+			if (!fgi)
+			{
+				llerrs << "Missing Glyph Info" << llendl;
+				break;
+			}
+			// Per-glyph bitmap texture.
+			S32 next_bitmap_num = fgi->mBitmapNum;
+			if (next_bitmap_num != bitmap_num)
+			{
+				// Actually draw the queued glyphs before switching their
+				// texture; otherwise the queued glyphs will be taken from
+				// wrong textures.
+				if (glyph_count > 0)
+				{
+					renderGlyphs(glyph_count, bitmap_num, runp, run_origin);
+				}
 
-			bitmap_num = next_bitmap_num;
-			LLImageGL* font_image = font_bitmap_cache->getImageGL(bitmap_num);
-			unit0->bind(font_image);
-		}
-	
-		if (start_x + scaled_max_pixels < cur_x + fgi->mXBearing + fgi->mWidth)
-		{
-			// Not enough room for this character.
-			break;
-		}
+				bitmap_num = next_bitmap_num;
+				LLImageGL* font_image =
+					font_bitmap_cache->getImageGL(bitmap_num);
+				unit0->bind(font_image);
+			}
+		
+			if (start_x + scaled_max_pixels <
+					cur_x + fgi->mXBearing + fgi->mWidth)
+			{
+				// Not enough room for this character.
+				break;
+			}
 
-		// Draw the text at the appropriate location
-		//Specify vertices and texture coordinates
-		LLRectf uv_rect((fgi->mXBitmapOffset) * inv_width,
-						(fgi->mYBitmapOffset + fgi->mHeight + PAD_UVY) *
-						inv_height,
-						(fgi->mXBitmapOffset + fgi->mWidth) * inv_width,
-						(fgi->mYBitmapOffset - PAD_UVY) * inv_height);
-		// Snap glyph origin to whole screen pixel
-		LLRectf screen_rect(ll_round(cur_render_x + (F32)fgi->mXBearing),
-						    ll_round(cur_render_y + (F32)fgi->mYBearing),
-				 		    ll_round(cur_render_x + (F32)fgi->mXBearing) +
-							fgi->mWidth,
-						    ll_round(cur_render_y + (F32)fgi->mYBearing) -
-							fgi->mHeight);
+			// Draw the text at the appropriate location
+			//Specify vertices and texture coordinates
+			LLRectf uv_rect((fgi->mXBitmapOffset) * inv_width,
+							(fgi->mYBitmapOffset + fgi->mHeight + PAD_UVY) *
+							inv_height,
+							(fgi->mXBitmapOffset + fgi->mWidth) * inv_width,
+							(fgi->mYBitmapOffset - PAD_UVY) * inv_height);
+			// Snap glyph origin to whole screen pixel
+			LLRectf screen_rect(ll_round(cur_render_x + (F32)fgi->mXBearing),
+							    ll_round(cur_render_y + (F32)fgi->mYBearing),
+					 		    ll_round(cur_render_x + (F32)fgi->mXBearing) +
+								fgi->mWidth,
+							    ll_round(cur_render_y + (F32)fgi->mYBearing) -
+								fgi->mHeight);
 		
-		if (glyph_count >= GLYPH_BATCH_SIZE)
-		{
-			gGL.begin(LLRender::TRIANGLES);
-			gGL.vertexBatchPreTransformed(vertices, uvs, colors,
-										  glyph_count * 6);
-			gGL.end();
-			glyph_count = 0;
-		}
+			if (glyph_count >= GLYPH_BATCH_SIZE)
+			{
+				renderGlyphs(glyph_count, bitmap_num, runp, run_origin);
+			}
 
-		drawGlyph(glyph_count, vertices, uvs, colors, screen_rect, uv_rect,
-				  text_color, style, drop_shadow_strength);
+			drawGlyph(glyph_count, sGlyphVertices, sGlyphUVs, sGlyphColors,
+					  screen_rect, uv_rect, text_color, style,
+					  drop_shadow_strength);
 
-		++chars_drawn;
-		cur_x += fgi->mXAdvance;
-		cur_y += fgi->mYAdvance;
+			++chars_drawn;
+			cur_x += fgi->mXAdvance;
+			cur_y += fgi->mYAdvance;
 
-		llwchar next_char = wstr[i + 1];
-		if (next_char && next_char < LAST_CHARACTER)
-		{
-			// Kern this puppy.
-			next_glyph = mFontFreetype->getGlyphInfo(next_char);
-			cur_x += mFontFreetype->getXKerning(fgi, next_glyph);
-		}
+			llwchar next_char = wstr[i + 1];
+			if (next_char && next_char < LAST_CHARACTER)
+			{
+				// Kern this puppy.
+				next_glyph = mFontFreetype->getGlyphInfo(next_char);
+				cur_x += mFontFreetype->getXKerning(fgi, next_glyph);
+			}
 
-		// Round after kerning. Must do this to cur_x, not just to
-		// cur_render_x, otherwise you will squish sub-pixel kerned characters
-		// too close together. For example, "CCCCC" looks bad.
-		cur_x = ll_round(cur_x);
+			// Round after kerning. Must do this to cur_x, not just to
+			// cur_render_x, otherwise you will squish sub-pixel kerned
+			// characters too close together. For example, "CCCCC" looks bad.
+			cur_x = ll_round(cur_x);
 #if 0
-		cur_y = ll_round(cur_y);
+			cur_y = ll_round(cur_y);
 #endif
 
-		cur_render_x = cur_x;
-		cur_render_y = cur_y;
-	}
+			cur_render_x = cur_x;
+			cur_render_y = cur_y;
+		}
 
-	gGL.begin(LLRender::TRIANGLES);
-	gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 6);
-	gGL.end();
+		renderGlyphs(glyph_count, bitmap_num, runp, run_origin);
+
+		if (runp)
+		{
+			runp->mStartX = start_x - run_origin.mV[VX];
+			runp->mEndX = cur_x - run_origin.mV[VX];
+			runp->mEndY = cur_y - run_origin.mV[VY];
+			runp->mCharsDrawn = chars_drawn;
+			runp->mDrawEllipses = draw_ellipses;
+		}
+	}
 
 	if (right_x)
 	{
@@ -395,11 +537,79 @@ S32 LLFontGL::newrender(const LLWString& wstr, S32 begin_offset, F32 x, F32 y,
 	}
 
 	gGL.popUIMatrix();
-	gGL.flush();
+	// The glyphs vertices are pre-transformed, so there is no need to flush
+	// them now when batching the UI draws.
+	if (!gGL.getUIBatching())
+	{
+		gGL.flush();
+	}
 
 	return chars_drawn;
 }
 
+void LLFontGL::renderGlyphs(S32& glyph_count, S32 bitmap_num,
+							text_run_t* runp, const LLVector3& origin) const
+{
+	S32 vert_count = glyph_count * 6;
+	gGL.begin(LLRender::TRIANGLES);
+	gGL.vertexBatchPreTransformed(sGlyphVertices, sGlyphUVs, sGlyphColors,
+								  vert_count);
+	gGL.end();
+	glyph_count = 0;
+
+	if (!runp || !vert_count)
+	{
+		return;
+	}
+
+	if (runp->mBatches.empty() || runp->mBatches.back().first != bitmap_num)
+	{
+		runp->mBatches.emplace_back(bitmap_num, 0);
+	}
+	runp->mBatches.back().second += vert_count;
+	for (S32 i = 0; i < vert_count; ++i)
+	{
+		runp->mVertices.emplace_back(sGlyphVertices[i] - origin);
+	}
+	runp->mUVs.insert(runp->mUVs.end(), sGlyphUVs, sGlyphUVs + vert_count);
+	runp->mColors.insert(runp->mColors.end(), sGlyphColors,
+						 sGlyphColors + vert_count);
+}
+
+void LLFontGL::recolorRun(text_run_t* runp, const LLColor4U& color, U8 style,
+						  F32 drop_shadow_strength) const
+{
+	// Number of quads per glyph, and among them, number of shadow quads
+	// (which are drawn first), as laid out by drawGlyph().
+	U32 glyph_quads = 1;
+	U32 shadow_quads = 0;
+	LLColor4U shadow_color = sShadowColorU;
+	if (style & BOLD)
+	{
+		glyph_quads = 2;
+	}
+	else if (style & DROP_SHADOW_SOFT)
+	{
+		glyph_quads = 6;
+		shadow_quads = 5;
+		shadow_color.mV[VALPHA] = U8(color.mV[VALPHA] * drop_shadow_strength *
+									 DROP_SHADOW_SOFT_STRENGTH);
+	}
+	else if (style & DROP_SHADOW)
+	{
+		glyph_quads = 2;
+		shadow_quads = 1;
+		shadow_color.mV[VALPHA] = U8(color.mV[VALPHA] * drop_shadow_strength);
+	}
+
+	for (U32 i = 0, count = runp->mColors.size(); i < count; ++i)
+	{
+		runp->mColors[i] = (i / 6) % glyph_quads < shadow_quads ? shadow_color
+																: color;
+	}
+	runp->mColor = color;
+}
+
 S32 LLFontGL::oldrender(const LLWString& wstr, S32 begin_offset, F32 x, F32 y,
 						const LLColor4& color, HAlign halign, VAlign valign,
 						U8 style, S32 max_chars, S32 max_pixels, F32* right_x,
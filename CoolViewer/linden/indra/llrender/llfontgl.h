@@ -34,10 +34,13 @@
 #ifndef LL_LLFONTGL_H
 #define LL_LLFONTGL_H
 
+#include "llcolor4u.h"
 #include "llcoord.h"
 #include "llfastmap.h"
 #include "llfontregistry.h"
 #include "llimagegl.h"
+#include "llvector2.h"
+#include "llvector3.h"
 
 class LLColor4;
 class LLFontDescriptor;
@@ -233,6 +236,7 @@ public:
 	LL_INLINE static LLFontGL* getFontDefault()			{ return getFontSansSerif(); }
 
 	static void setUseBatchedRender(bool enable)		{ sUseBatchedRender = enable; }
+	static void setUseTextRunsCache(bool enable)		{ sUseTextRunsCache = enable; }
 
 private:
 	struct embedded_data_t
@@ -247,6 +251,48 @@ private:
 		LLWString			 mLabel;
 	};
 
+	// Laid out text run, as rendered by newrender(), with its vertices
+	// relative to the (pixel-aligned) render origin, so that redrawing the
+	// same text with the same parameters does not need any glyph lookup. The
+	// color is not part of the layout: the vertices colors get recomputed
+	// when the run is redrawn with another color (e.g. for fading texts).
+	struct text_run_t
+	{
+		// Color of the recorded vertices
+		LLColor4U						mColor;
+		// Render parameters, used to validate the cache hits
+		LLWString						mText;
+		llwchar							mNextChar;	// Used for kerning
+		F32								mScaleX;
+		F32								mScaleY;
+		S32								mMaxPixels;
+		U8								mStyle;
+		U8								mHAlign;
+		U8								mVAlign;
+		bool							mUseEllipses;
+		// Laid out text
+		std::vector<LLVector3>			mVertices;
+		std::vector<LLVector2>			mUVs;
+		std::vector<LLColor4U>			mColors;
+		// Bitmap number and number of vertices of each glyphs batch
+		std::vector<std::pair<S32, U32> > mBatches;
+		F32								mStartX;
+		F32								mEndX;
+		F32								mEndY;
+		S32								mCharsDrawn;
+		bool							mDrawEllipses;
+	};
+
+	// Draws the glyphs queued in the static vertex buffers, recording them in
+	// runp when not NULL.
+	void renderGlyphs(S32& glyph_count, S32 bitmap_num,
+					  text_run_t* runp, const LLVector3& origin) const;
+
+	// Recomputes the vertices colors of a cached run for 'color', following
+	// the glyph quads layout used by drawGlyph() for 'style'.
+	void recolorRun(text_run_t* runp, const LLColor4U& color, U8 style,
+					F32 drop_shadow_strength) const;
+
 	// New, optimized routines for texts without embedded data:
 	S32 newrender(const LLWString& wstr, S32 begin_offset, F32 x, F32 y,
 				  const LLColor4& color, HAlign halign, VAlign valign,
@@ -290,6 +336,10 @@ public:
 	static F32					sScaleY;
 	static bool					sDisplayFont;
 
+	// Text runs cache statistics
+	static U32					sTextRunsHits;
+	static U32					sTextRunsMisses;
+
 	static std::vector<std::pair<LLCoordGL, F32> > sOriginStack;
 
 private:
@@ -299,10 +349,16 @@ private:
 	typedef fast_hmap<llwchar, embedded_data_t> embedded_map_t;
 	mutable embedded_map_t		mEmbeddedChars;
 
+	typedef fast_hmap<U64, text_run_t> text_runs_map_t;
+	mutable text_runs_map_t		mTextRuns;
+	// Generation of the bitmap cache the text runs were laid out with
+	mutable U32					mTextRunsGeneration;
+
 	// Registry holds all instantiated fonts:
 	static LLFontRegistry*		sFontRegistry;
 
 	static bool					sUseBatchedRender;
+	static bool					sUseTextRunsCache;
 };
 
 #endif
@@ -99,6 +99,12 @@ PFNGLISVERTEXARRAYPROC glIsVertexArray = NULL;
 PFNGLMAPBUFFERRANGEPROC glMapBufferRange = NULL;
 PFNGLFLUSHMAPPEDBUFFERRANGEPROC glFlushMappedBufferRange = NULL;
 
+// GL_ARB_buffer_storage
+PFNGLBUFFERSTORAGEPROC glBufferStorage = NULL;
+
+// GL v1.4
+PFNGLMULTIDRAWELEMENTSPROC glMultiDrawElements = NULL;
+
 // GL_ARB_sync
 PFNGLFENCESYNCPROC glFenceSync = NULL;
 PFNGLISSYNCPROC glIsSync = NULL;
@@ -558,6 +564,7 @@ LLGLManager::LLGLManager()
 	mNumTextureUnits(1),
 	mHasMipMapGeneration(false),
 	mHasCompressedTextures(false),
+	mHasTextureCompressionS3TC(false),
 	mHasFramebufferObject(false),
 	mMaxSamples(0),
 	mHasBlendFuncSeparate(false),
@@ -566,6 +573,8 @@ LLGLManager::LLGLManager()
 	mHasVertexArrayObject(false),
 	mHasMapBufferRange(false),
 	mHasFlushBufferRange(false),
+	mHasBufferStorage(false),
+	mHasMultiDrawElements(false),
 	mHasPBuffer(false),
 	mNumTextureImageUnits(0),
 	mHasOcclusionQuery(false),
@@ -1047,6 +1056,7 @@ void LLGLManager::asLLSD(LLSD& info)
 	info["num_texture_units"] = mNumTextureUnits;
 	info["has_mip_map_generation"] = mHasMipMapGeneration;
 	info["has_compressed_textures"] = mHasCompressedTextures;
+	info["has_texture_compression_s3tc"] = mHasTextureCompressionS3TC;
 	info["has_framebuffer_object"] = mHasFramebufferObject;
 	info["max_samples"] = mMaxSamples;
 	info["has_blend_func_separate"] = mHasBlendFuncSeparate;
@@ -1057,6 +1067,8 @@ void LLGLManager::asLLSD(LLSD& info)
 	info["has_sync"] = mHasSync;
 	info["has_map_buffer_range"] = mHasMapBufferRange;
 	info["has_flush_buffer_range"] = mHasFlushBufferRange;
+	info["has_buffer_storage"] = mHasBufferStorage;
+	info["has_multi_draw_elements"] = mHasMultiDrawElements;
 	info["has_pbuffer"] = mHasPBuffer;
 	info["has_shader_objects"] = std::string("Assumed TRUE");
 	info["has_vertex_shader"] = std::string("Assumed TRUE");
@@ -1133,6 +1145,8 @@ void LLGLManager::initExtensions()
 	mHasCubeMap = ExtensionExists("GL_ARB_texture_cube_map", gGLHExts.mSysExts);
 	mHasARBEnvCombine = ExtensionExists("GL_ARB_texture_env_combine", gGLHExts.mSysExts);
 	mHasCompressedTextures = glh_init_extensions("GL_ARB_texture_compression");
+	mHasTextureCompressionS3TC =
+		ExtensionExists("GL_EXT_texture_compression_s3tc", gGLHExts.mSysExts);
 	mHasOcclusionQuery = ExtensionExists("GL_ARB_occlusion_query", gGLHExts.mSysExts);
 	mHasOcclusionQuery2 = ExtensionExists("GL_ARB_occlusion_query2", gGLHExts.mSysExts);
 	mHasTimerQuery = ExtensionExists("GL_ARB_timer_query", gGLHExts.mSysExts);
@@ -1141,6 +1155,7 @@ void LLGLManager::initExtensions()
 	mHasSync = ExtensionExists("GL_ARB_sync", gGLHExts.mSysExts);
 	mHasMapBufferRange = ExtensionExists("GL_ARB_map_buffer_range", gGLHExts.mSysExts);
 	mHasFlushBufferRange = ExtensionExists("GL_APPLE_flush_buffer_range", gGLHExts.mSysExts);
+	mHasBufferStorage = ExtensionExists("GL_ARB_buffer_storage", gGLHExts.mSysExts);
 	mHasDepthClamp = ExtensionExists("GL_ARB_depth_clamp", gGLHExts.mSysExts) ||
 					 ExtensionExists("GL_NV_depth_clamp", gGLHExts.mSysExts);
 	if (!mHasDepthClamp)
@@ -1293,6 +1308,14 @@ void LLGLManager::initExtensions()
 		glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC) GLH_EXT_GET_PROC_ADDRESS("glMapBufferRange");
 		glFlushMappedBufferRange = (PFNGLFLUSHMAPPEDBUFFERRANGEPROC) GLH_EXT_GET_PROC_ADDRESS("glFlushMappedBufferRange");
 	}
+	if (mHasBufferStorage)
+	{
+		glBufferStorage = (PFNGLBUFFERSTORAGEPROC) GLH_EXT_GET_PROC_ADDRESS("glBufferStorage");
+		mHasBufferStorage = glBufferStorage != NULL;
+	}
+	// This is core in OpenGL v1.4, but not exported by all libGL versions
+	glMultiDrawElements = (PFNGLMULTIDRAWELEMENTSPROC) GLH_EXT_GET_PROC_ADDRESS("glMultiDrawElements");
+	mHasMultiDrawElements = glMultiDrawElements != NULL;
 	if (mHasFramebufferObject)
 	{
 		llinfos << "FramebufferObject-related procs..." << llendl;
@@ -95,6 +95,7 @@ public:
 	bool mHasNVXMemInfo;
 	bool mHasMipMapGeneration;
 	bool mHasCompressedTextures;
+	bool mHasTextureCompressionS3TC;
 	bool mHasFramebufferObject;
 	bool mHasBlendFuncSeparate;
 
@@ -104,6 +105,8 @@ public:
 	bool mHasSync;
 	bool mHasMapBufferRange;
 	bool mHasFlushBufferRange;
+	bool mHasBufferStorage;
+	bool mHasMultiDrawElements;
 	bool mHasPBuffer;
 	bool mHasOcclusionQuery;
 	bool mHasOcclusionQuery2;
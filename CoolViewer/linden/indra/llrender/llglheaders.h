@@ -102,6 +102,12 @@ extern PFNGLFLUSHMAPPEDBUFFERRANGEAPPLEPROC	glFlushMappedBufferRangeAPPLE;
 extern PFNGLMAPBUFFERRANGEPROC				glMapBufferRange;
 extern PFNGLFLUSHMAPPEDBUFFERRANGEPROC		glFlushMappedBufferRange;
 
+// GL_ARB_buffer_storage
+extern PFNGLBUFFERSTORAGEPROC				glBufferStorage;
+
+// GL v1.4
+extern PFNGLMULTIDRAWELEMENTSPROC			glMultiDrawElements;
+
 // GL_ARB_occlusion_query
 extern PFNGLGENQUERIESARBPROC				glGenQueriesARB;
 extern PFNGLDELETEQUERIESARBPROC			glDeleteQueriesARB;
@@ -322,6 +328,12 @@ extern PFNGLFLUSHMAPPEDBUFFERRANGEAPPLEPROC	glFlushMappedBufferRangeAPPLE;
 extern PFNGLMAPBUFFERRANGEPROC				glMapBufferRange;
 extern PFNGLFLUSHMAPPEDBUFFERRANGEPROC		glFlushMappedBufferRange;
 
+// GL_ARB_buffer_storage
+extern PFNGLBUFFERSTORAGEPROC				glBufferStorage;
+
+// GL v1.4
+extern PFNGLMULTIDRAWELEMENTSPROC			glMultiDrawElements;
+
 extern PFNWGLGETGPUIDSAMDPROC				wglGetGPUIDsAMD;
 extern PFNWGLGETGPUINFOAMDPROC				wglGetGPUInfoAMD;
 extern PFNWGLSWAPINTERVALEXTPROC			wglSwapIntervalEXT;
@@ -53,6 +53,7 @@
 bool gUseNewShaders = false;
 
 GLhandleARB LLGLSLShader::sCurBoundShader = 0;
+U32 LLGLSLShader::sBindCount = 0;
 LLGLSLShader* LLGLSLShader::sCurBoundShaderPtr = NULL;
 S32 LLGLSLShader::sIndexedTextureChannels = 0;
 bool LLGLSLShader::sProfileEnabled = false;
@@ -1025,6 +1026,7 @@ void LLGLSLShader::bind()
 	glUseProgramObjectARB(mProgramObject);
 	sCurBoundShader = mProgramObject;
 	sCurBoundShaderPtr = this;
+	++sBindCount;
 	if (mUniformsDirty)
 	{
 		LLShaderMgr::getInstance()->updateShaderUniforms(this);
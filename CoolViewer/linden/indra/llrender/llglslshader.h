@@ -289,6 +289,8 @@ public:
 	static LLGLSLShader*			sCurBoundShaderPtr;
 	static S32						sIndexedTextureChannels;
 	static GLhandleARB				sCurBoundShader;
+	// Number of shader binds since last reset (for the stats).
+	static U32						sBindCount;
 	static bool						sProfileEnabled;
 
 	// Statistcis for profiling shader performance
@@ -36,7 +36,9 @@
 
 #include "llglslshader.h"
 #include "llimage.h"
+#include "llimagebc.h"
 #include "llmath.h"
+#include "llvertexbuffer.h"		// For LLStreamRing
 #include "hbtracy.h"
 
 #define FIX_MASKS 1
@@ -55,12 +57,48 @@ bool LLImageGL::sGlobalUseAnisotropic = false;
 bool LLImageGL::sPreserveDiscard = false;
 bool LLImageGL::sCompressTextures = false;
 U32 LLImageGL::sCompressThreshold = 262144U;
+bool LLImageGL::sUsePBOUploads = true;
+U64 LLImageGL::sUploadedBytes = 0;
 F32 LLImageGL::sLastFrameTime = 0.f;
 LLImageGL* LLImageGL::sDefaultGLImagep = NULL;
 LLImageGL::glimage_list_t LLImageGL::sImageList;
 
 constexpr S8 INVALID_OFFSET = -99;
 
+// Pixel unpack buffers ring for the textures uploads: 32MB, with up to 8MB
+// (i.e. a segment) per texture level.
+constexpr U32 UPLOAD_RING_SIZE = 32 * 1024 * 1024;
+static LLStreamRing sUploadRing(GL_PIXEL_UNPACK_BUFFER_ARB);
+static bool sUploadRingFailed = false;
+
+// Returns the size in bytes of an uncompressed pixel with the 'pixformat'
+// GL format and an unsigned byte type per component, or 0 when unknown.
+static U32 unpacked_pixel_bytes(U32 pixformat)
+{
+	switch (pixformat)
+	{
+		case GL_RED:
+		case GL_ALPHA:
+		case GL_LUMINANCE:
+			return 1;
+
+		case GL_RG:
+		case GL_LUMINANCE_ALPHA:
+			return 2;
+
+		case GL_RGB:
+		case GL_BGR:
+			return 3;
+
+		case GL_RGBA:
+		case GL_BGRA:
+			return 4;
+
+		default:
+			return 0;
+	}
+}
+
 // Helper function used to check the size of a texture image. So dim should be
 // a positive number
 static bool check_power_of_two(S32 dim)
@@ -194,6 +232,9 @@ void LLImageGL::destroyGL(bool save_state)
 		gGL.getTexUnit(stage)->unbind(LLTexUnit::TT_TEXTURE);
 	}
 
+	sUploadRing.cleanup();
+	sUploadRingFailed = false;
+
 	for (glimage_list_t::iterator iter = sImageList.begin(),
 								  end = sImageList.end();
 		 iter != end; ++iter)
@@ -236,9 +277,13 @@ void LLImageGL::restoreGL()
 			if (glimage->getComponents() &&
 				glimage->mSaveData->getComponents())
 			{
+				// The saved data is what was last uploaded, so the alpha
+				// analysis results and pick mask are still valid for it.
+				glimage->mSkipAlphaAnalysis = true;
 				glimage->createGLTexture(glimage->mCurrentDiscardLevel,
 										 glimage->mSaveData, 0, true,
 										 glimage->getCategory());
+				glimage->mSkipAlphaAnalysis = false;
 				stop_glerror();
 			}
 		}
@@ -368,6 +413,7 @@ void LLImageGL::init(bool usemipmaps)
 	mAlphaOffset = 0;
 #endif
 	mAlphaStride = 0;
+	mSkipAlphaAnalysis = false;
 
 	mGLTextureCreated = false;
 	mTexName = 0;
@@ -1091,8 +1137,46 @@ void LLImageGL::setManualImage(U32 target, S32 miplevel, S32 intformat,
 		}
 	}
 
-	glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat,
-				 pixtype, pixels);
+	U32 bytes = 0;
+	if (pixels && pixtype == GL_UNSIGNED_BYTE)
+	{
+		bytes = pixels_count * unpacked_pixel_bytes(pixformat);
+		sUploadedBytes += bytes;
+	}
+
+	S64 ring_pos = -1;
+	if (bytes && sUsePBOUploads)
+	{
+		if (!sUploadRing.isActive() && !sUploadRingFailed)
+		{
+			sUploadRingFailed = !sUploadRing.init(UPLOAD_RING_SIZE, 1);
+			if (sUploadRingFailed)
+			{
+				llinfos << "Pixel buffer objects ring not available: using synchronous texture uploads."
+						<< llendl;
+			}
+		}
+		// Never stall on the GPU here: when the ring is full (i.e. its next
+		// segment is still in use), just upload synchronously from the
+		// client memory.
+		ring_pos = sUploadRing.allocate(bytes, false);
+	}
+	if (ring_pos >= 0)
+	{
+		// Copy the data into the ring and let the driver upload it from there
+		// asynchronously.
+		memcpy(sUploadRing.getPointer(ring_pos), pixels, bytes);
+		LLStreamRing::sBytesStreamed += bytes;
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, sUploadRing.getGLName());
+		glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat,
+					 pixtype, (GLvoid*)(uintptr_t)sUploadRing.getOffset(ring_pos));
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+	}
+	else
+	{
+		glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat,
+					 pixtype, pixels);
+	}
 	stop_glerror();
 
 	if (scratch)
@@ -1136,7 +1220,9 @@ bool LLImageGL::createGLTexture()
 }
 
 bool LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw,
-								S32 usename, bool to_create, S32 category)
+								S32 usename, bool to_create, S32 category,
+								const LLImageBC* bcimage,
+								const LLImageAlphaInfo* alphainfo)
 {
 	LL_TRACY_TIMER(TRC_CREATE_GL_TEXTURE2);
 	if (gGLManager.mIsDisabled)
@@ -1252,8 +1338,104 @@ bool LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw,
 	}
 
 	setCategory(category);
- 	const U8* rawdata = imageraw->getData();
-	return createGLTexture(discard_level, rawdata, false, usename);
+
+	if (alphainfo && useAlphaInfo(imageraw, alphainfo))
+	{
+		mSkipAlphaAnalysis = true;
+	}
+
+	bool res;
+	if (bcimage && useBCImage(discard_level, imageraw, bcimage))
+	{
+		sUploadedBytes += bcimage->getDataSize();
+		res = createGLTexture(discard_level, bcimage->getData(), true,
+							  usename);
+	}
+	else
+	{
+		res = createGLTexture(discard_level, imageraw->getData(), false,
+							  usename);
+	}
+	mSkipAlphaAnalysis = false;
+	return res;
+}
+
+bool LLImageGL::useAlphaInfo(const LLImageRaw* imageraw,
+							 const LLImageAlphaInfo* alphainfo)
+{
+	S32 comps = imageraw->getComponents();
+	if (!mNeedsAlphaAndPickMask || mFormatType != GL_UNSIGNED_BYTE ||
+		mAlphaStride != comps || mAlphaOffset != comps - 1 ||
+		alphainfo->getComponents() != comps ||
+		alphainfo->getWidth() != imageraw->getWidth() ||
+		alphainfo->getHeight() != imageraw->getHeight())
+	{
+		return false;
+	}
+
+	mIsMask = alphainfo->isMask();
+
+	// Same as what updatePickMask() does.
+	freePickMask();
+	if (alphainfo->getPickMask() &&
+		(mFormatPrimary == GL_RGBA || mFormatPrimary == GL_SRGB_ALPHA))
+	{
+		U32 size = createPickMask(alphainfo->getWidth(),
+								  alphainfo->getHeight());
+		if (size == alphainfo->getPickMaskSize())
+		{
+			memcpy(mPickMask, alphainfo->getPickMask(), size);
+		}
+	}
+
+	return true;
+}
+
+bool LLImageGL::useBCImage(S32 discard_level, const LLImageRaw* imageraw,
+						   const LLImageBC* bcimage)
+{
+	if (mHasExplicitFormat || !mAllowCompression ||
+		!gGLManager.mHasTextureCompressionS3TC ||
+		bcimage->getWidth() != imageraw->getWidth() ||
+		bcimage->getHeight() != imageraw->getHeight())
+	{
+		return false;
+	}
+
+	// The compressed mips cannot be generated by the driver, so they must
+	// all be present.
+	S32 levels = 1;
+	if (mUseMipMaps)
+	{
+		levels += (S32)mMaxDiscardLevel - discard_level;
+	}
+	if (levels > (S32)bcimage->getLevels())
+	{
+		return false;
+	}
+
+	// setImage() does not analyze the alpha channel of compressed data, so
+	// do it now, on the raw data.
+	S32 width = imageraw->getWidth();
+	S32 height = imageraw->getHeight();
+	const U8* rawdata = imageraw->getData();
+	analyzeAlpha(rawdata, width, height);
+	updatePickMask(width, height, rawdata);
+
+	bool srgb = mFormatInternal == GL_SRGB8 ||
+				mFormatInternal == GL_SRGB8_ALPHA8;
+	if (bcimage->getFormat() == LLImageBC::BC3)
+	{
+		mFormatPrimary = srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+							  : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	}
+	else
+	{
+		mFormatPrimary = srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+							  : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	}
+	mFormatInternal = mFormatPrimary;
+	return true;
 }
 
 bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in,
@@ -1447,7 +1629,23 @@ bool LLImageGL::readBackRaw(S32 discard_level, LLImageRaw* imageraw,
 			return false;
 		}
 
-		glGetTexImage(GL_TEXTURE_2D, gl_discard, mFormatPrimary, mFormatType,
+		GLenum format = mFormatPrimary;
+		GLenum type = mFormatType;
+		if (format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ||
+			format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT ||
+			format == GL_COMPRESSED_RGBA_S3TC_DXT3_EXT ||
+			format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT ||
+			format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ||
+			format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT)
+		{
+			// Texture uploaded from a BC image (see useBCImage()): compressed
+			// formats are not valid for glGetTexImage(), so have the driver
+			// decompress it into the uncompressed format createGLTexture()
+			// would have used for this raw image.
+			format = ncomponents == 4 ? GL_RGBA : GL_RGB;
+			type = GL_UNSIGNED_BYTE;
+		}
+		glGetTexImage(GL_TEXTURE_2D, gl_discard, format, type,
 					  (GLvoid*)(imageraw->getData()));
 	}
 
@@ -1715,7 +1913,7 @@ void LLImageGL::calcAlphaChannelOffsetAndStride()
 
 void LLImageGL::analyzeAlpha(const void* data_in, U32 w, U32 h)
 {
-	if (!mNeedsAlphaAndPickMask)
+	if (!mNeedsAlphaAndPickMask || mSkipAlphaAnalysis)
 	{
 		return;
 	}
@@ -1851,7 +2049,7 @@ void LLImageGL::freePickMask()
 
 void LLImageGL::updatePickMask(S32 width, S32 height, const U8* data_in)
 {
-	if (!mNeedsAlphaAndPickMask)
+	if (!mNeedsAlphaAndPickMask || mSkipAlphaAnalysis)
 	{
 		return;
 	}
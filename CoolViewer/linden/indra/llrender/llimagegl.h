@@ -38,6 +38,8 @@
 #include "llrefcount.h"
 #include "llrender.h"
 
+class LLImageBC;
+
 class LLImageGL : public LLRefCount
 {
 	friend class LLTexUnit;
@@ -131,9 +133,14 @@ public:
 							   bool allow_compression = true);
 
 	bool createGLTexture();
+	// When 'bcimage' is not NULL, it must be the block-compressed version of
+	// 'imageraw', and it is then used to create the texture whenever
+	// possible. When 'alphainfo' is not NULL, it must be the alpha analysis
+	// of 'imageraw', and it then replaces the one done on the main thread.
 	bool createGLTexture(S32 discard_level, const LLImageRaw* imageraw,
 						 S32 usename = 0, bool to_create = true,
-						 S32 category = 0);
+						 S32 category = 0, const LLImageBC* bcimage = NULL,
+						 const LLImageAlphaInfo* alphainfo = NULL);
 	bool createGLTexture(S32 discard_level, const U8* data,
 						 bool data_hasmips = false, S32 usename = 0);
 	void setImage(const LLImageRaw* imageraw);
@@ -242,6 +249,18 @@ private:
 	U32 createPickMask(S32 width, S32 height);
 	void freePickMask();
 
+	// Returns true when 'bcimage' may be used to create the texture, in
+	// which case the alpha analysis and pick mask get computed from the raw
+	// image and the texture format is switched to the matching compressed
+	// format.
+	bool useBCImage(S32 discard_level, const LLImageRaw* imageraw,
+					const LLImageBC* bcimage);
+
+	// Returns true when 'alphainfo' matches 'imageraw' and the texture
+	// format, in which case the mask flag and pick mask are set from it.
+	bool useAlphaInfo(const LLImageRaw* imageraw,
+					  const LLImageAlphaInfo* alphainfo);
+
 private:
 	LLPointer<LLImageRaw> mSaveData;	// used for destroyGL/restoreGL
 
@@ -268,6 +287,9 @@ private:
 
 	bool		mIsMask;
 	bool		mNeedsAlphaAndPickMask;
+	// When true, the alpha analysis and pick mask are already up to date for
+	// the texture data being uploaded.
+	bool		mSkipAlphaAnalysis;
 	S8			mAlphaStride;
 	S8			mAlphaOffset;
 
@@ -346,6 +368,14 @@ public:
 	static bool				sCompressTextures;
 	static U32				sCompressThreshold;
 
+	// When true and supported, the textures data get copied into a
+	// persistently mapped pixel unpack buffers ring, from which the driver
+	// uploads them asynchronously.
+	static bool				sUsePBOUploads;
+	// Total amount of texture data uploaded (used for the per-frame upload
+	// budget and for the stats).
+	static U64				sUploadedBytes;
+
 private:
 	typedef fast_hset<LLImageGL*> glimage_list_t;
 	static glimage_list_t	sImageList;
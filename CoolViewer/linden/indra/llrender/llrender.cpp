@@ -84,6 +84,7 @@ S32	gGLViewport[4];
 
 U32 LLRender::sUICalls = 0;
 U32 LLRender::sUIVerts = 0;
+U32 LLRender::sUIBatchedCalls = 0;
 U32 LLRender::sDummyVAO = 0;
 U32 LLTexUnit::sWhiteTexture = 0;
 bool LLRender::sGLCoreProfile = false;
@@ -394,6 +395,22 @@ void LLTexUnit::unbind(eTextureType type)
 
 	if (mIndex < 0) return;
 
+	// While batching the UI draws, avoid flushing on redundant unbinds (no
+	// texture bound, same texture type and this unit already active) so that
+	// consecutive untextured UI elements get rendered in a single draw call.
+	// Whenever the bound texture actually changes, the pending vertices are
+	// always flushed below, before the binding change.
+	bool redundant = mCurrTexture == 0 && mCurrTexType == type &&
+					 gGL.mCurrTextureUnitIndex == (U32)mIndex;
+	if (redundant && gGL.mUIBatching && !gGL.mDirty)
+	{
+		if (gGL.mCount)
+		{
+			++LLRender::sUIBatchedCalls;
+		}
+		return;
+	}
+
 #if 0	// Always flush and activate for consistency since some code paths
 		// assume unbind always flushes and sets the active texture.
 	if (gGL.mCurrTextureUnitIndex != (U32)mIndex || gGL.mDirty)
@@ -818,6 +835,7 @@ void LLLightState::setSpotDirection(const LLVector3& direction)
 
 LLRender::LLRender()
 :	mDirty(false),
+	mUIBatching(false),
 	mCount(0),
 	mMode(TRIANGLES),
     mCurrTextureUnitIndex(0),
@@ -891,6 +909,10 @@ void LLRender::init()
 	llassert_always(mBuffer.isNull());
 	stop_glerror();
 	mBuffer = new LLVertexBuffer(immediate_mask, 0);
+	// Note: with the core GL profile, the buffer gets a GL_STREAM_DRAW usage
+	// and, when available, its drawn vertices are then streamed via the
+	// persistently mapped ring buffer.
+	mBuffer->setTransient(true);
 	mBuffer->allocateBuffer(4096, 0, true);
 	mBuffer->getVertexStrider(mVerticesp);
 	mBuffer->getTexCoord0Strider(mTexcoordsp);
@@ -1695,6 +1717,12 @@ void LLRender::clearErrors()
 	}
 }
 
+void LLRender::setUIBatching(bool enable)
+{
+	flush();
+	mUIBatching = enable;
+}
+
 void LLRender::begin(U32 mode)
 {
 	if (mode != mMode)
@@ -1939,6 +1967,39 @@ void LLRender::vertexBatchPreTransformed(LLVector3* verts, LLVector2* uvs,
 	}
 }
 
+void LLRender::vertexBatchPreTransformed(const LLVector3* verts,
+										 const LLVector2* uvs,
+										 const LLColor4U* colors,
+										 S32 vert_count,
+										 const LLVector3& offset)
+{
+	if (mCount + vert_count > 4094)
+	{
+		if (gDebugGL)
+		{
+			llwarns_once << "GL immediate mode overflow. Some geometry not drawn."
+						 << llendl;
+			llassert(false);
+		}
+		return;
+	}
+
+	S32 i = 0;
+	while (i < vert_count)
+	{
+		mVerticesp[mCount] = verts[i] + offset;
+		mTexcoordsp[mCount] = uvs[i];
+		mColorsp[mCount++] = colors[i++];
+	}
+
+	if (mCount > 0)
+	{
+		mVerticesp[mCount] = mVerticesp[mCount - 1];
+		mTexcoordsp[mCount] = mTexcoordsp[mCount - 1];
+		mColorsp[mCount] = mColorsp[mCount - 1];
+	}
+}
+
 void LLRender::color4ub(U8 r, U8 g, U8 b, U8 a)
 {
 	if (!LLGLSLShader::sCurBoundShaderPtr ||
@@ -393,6 +393,14 @@ public:
 
 	void flush();
 
+	// When enabled, state changes which do not actually change anything do
+	// not cause a flush, so that consecutive UI elements sharing the same
+	// state get rendered in a single draw call. Only meant to be enabled
+	// while drawing the UI views tree, which does not rely on unbind() calls
+	// for flushing.
+	void setUIBatching(bool enable);
+	LL_INLINE bool getUIBatching() const			{ return mUIBatching; }
+
 	void begin(U32 mode);
 	void end(bool force_flush = false);
 
@@ -477,6 +485,11 @@ public:
 								   S32 vert_count);
 	void vertexBatchPreTransformed(LLVector3* verts, LLVector2* uvs,
 								   LLColor4U*, S32 vert_count);
+	// Same as above, but with an offset added to all vertices.
+	void vertexBatchPreTransformed(const LLVector3* verts,
+								   const LLVector2* uvs,
+								   const LLColor4U* colors, S32 vert_count,
+								   const LLVector3& offset);
 
 	void setColorMask(bool write_color, bool write_alpha);
 	void setColorMask(bool write_red, bool write_green, bool write_blue,
@@ -505,6 +518,8 @@ public:
 public:
 	static U32					sUICalls;
 	static U32					sUIVerts;
+	// Number of UI draw calls avoided thanks to UI batching
+	static U32					sUIBatchedCalls;
 	static bool					sGLCoreProfile;
 
 private:
@@ -541,6 +556,7 @@ private:
 
 	bool						mCurrColorMask[4];
 	bool						mDirty;
+	bool						mUIBatching;
 
 	static U32					sDummyVAO;
 };
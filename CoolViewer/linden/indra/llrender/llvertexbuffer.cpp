@@ -375,6 +375,171 @@ void LLVBOPool::cleanup()
 	deleteReleasedBuffers();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// LLStreamRing class
+///////////////////////////////////////////////////////////////////////////////
+
+U64 LLStreamRing::sBytesStreamed = 0;
+
+LLStreamRing::LLStreamRing(U32 type)
+:	mMaxBlockSize(0),
+	mType(type),
+	mGLName(0),
+	mSegmentSize(0),
+	mMask(0),
+	mHead(0),
+	mCurSegment(0),
+	mData(NULL)
+{
+#ifdef GL_ARB_sync
+	for (U32 i = 0; i < NUM_SEGMENTS; ++i)
+	{
+		mFences[i] = 0;
+	}
+#endif
+}
+
+// 'size' MUST be a power of 2
+bool LLStreamRing::init(U32 size, U32 max_block_divisor)
+{
+	cleanup();
+
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+	if (!gGLManager.mHasBufferStorage || !gGLManager.mHasSync ||
+		!gGLManager.mHasMapBufferRange)
+	{
+		return false;
+	}
+
+	llassert(nhpo2(size) == size);
+
+	// Make sure we do not alter the bindings of a VAO
+	LLVertexBuffer::unbind();
+
+	glGenBuffersARB(1, &mGLName);
+	glBindBufferARB(mType, mGLName);
+	constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+								 GL_MAP_COHERENT_BIT;
+	glBufferStorage(mType, size, NULL, flags);
+	mData = (U8*)glMapBufferRange(mType, 0, size, flags);
+	glBindBufferARB(mType, 0);
+	stop_glerror();
+
+	if (!mData)
+	{
+		llwarns << "Failed to map the streaming ring buffer for type: "
+				<< mType << llendl;
+		glDeleteBuffersARB(1, &mGLName);
+		mGLName = 0;
+		return false;
+	}
+
+	mSegmentSize = size / NUM_SEGMENTS;
+	mMaxBlockSize = mSegmentSize / llmax(max_block_divisor, 1U);
+	mMask = size - 1;
+	// Do not restart from zero, so that any position in a former ring gets
+	// invalidated.
+	mCurSegment += 2;
+	mHead = mCurSegment * mSegmentSize;
+	return true;
+#else
+	return false;
+#endif
+}
+
+void LLStreamRing::cleanup()
+{
+	if (!mData)
+	{
+		return;
+	}
+
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+	for (U32 i = 0; i < NUM_SEGMENTS; ++i)
+	{
+		if (mFences[i])
+		{
+			glDeleteSync(mFences[i]);
+			mFences[i] = 0;
+		}
+	}
+
+	LLVertexBuffer::unbind();
+	glBindBufferARB(mType, mGLName);
+	glUnmapBufferARB(mType);
+	glBindBufferARB(mType, 0);
+	glDeleteBuffersARB(1, &mGLName);
+	stop_glerror();
+#endif
+
+	mGLName = 0;
+	mData = NULL;
+	mMaxBlockSize = 0;
+}
+
+S64 LLStreamRing::allocate(U32 size, bool wait)
+{
+	if (!mData || size > mMaxBlockSize)
+	{
+		return -1;
+	}
+
+	// Keep all blocks 64 bytes aligned
+	size = (size + 63) & ~63;
+
+	// Blocks never straddle two segments
+	U64 head = mHead;
+	U64 segment = head / mSegmentSize;
+	U64 end_segment = (head + size - 1) / mSegmentSize;
+	if (end_segment != segment)
+	{
+		head = end_segment * mSegmentSize;
+		segment = end_segment;
+	}
+	if (segment != mCurSegment && !enterSegment(segment, wait))
+	{
+		return -1;
+	}
+
+	mHead = head + size;
+	return head;
+}
+
+bool LLStreamRing::enterSegment(U64 segment, bool wait)
+{
+#ifdef GL_ARB_sync
+	// The data written into a segment may be drawn till the ring moves past
+	// the next segment, i.e. till the fence placed on entering the segment
+	// after next: wait for the latter before overwriting the segment.
+	U32 slot = (segment + 2) % NUM_SEGMENTS;
+	if (mFences[slot])
+	{
+		if (!wait)
+		{
+			// Just poll the fence
+			if (glClientWaitSync(mFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT,
+								 0) == GL_TIMEOUT_EXPIRED)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			constexpr GLuint64 timeout = 1000000;	// 1ms, in nanoseconds
+			while (glClientWaitSync(mFences[slot],
+									GL_SYNC_FLUSH_COMMANDS_BIT,
+									timeout) == GL_TIMEOUT_EXPIRED) ;
+		}
+		glDeleteSync(mFences[slot]);
+		mFences[slot] = 0;
+	}
+	mFences[segment % NUM_SEGMENTS] =
+		glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+	mCurSegment = segment;
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // LLVertexBuffer class
 ///////////////////////////////////////////////////////////////////////////////
@@ -383,6 +548,8 @@ std::list<U32> LLVertexBuffer::sAvailableVAOName;
 U32 LLVertexBuffer::sCurVAOName = 1;
 
 LLVertexBuffer* LLVertexBuffer::sUtilityBuffer = NULL;
+LLStreamRing LLVertexBuffer::sVertexRing(GL_ARRAY_BUFFER_ARB);
+LLStreamRing LLVertexBuffer::sIndexRing(GL_ELEMENT_ARRAY_BUFFER_ARB);
 
 #if LL_JEMALLOC
 // Initialize with a sane value, in case our allocator gets called before the
@@ -411,6 +578,7 @@ bool LLVertexBuffer::sMapped = false;
 bool LLVertexBuffer::sUseStreamDraw = true;
 bool LLVertexBuffer::sUseVAO = false;
 bool LLVertexBuffer::sPreferStreamDraw = false;
+bool LLVertexBuffer::sUseStreamRing = true;
 
 // NOTE: each component must be AT LEAST 4 bytes in size to avoid a performance
 // penalty on AMD hardware
@@ -481,6 +649,23 @@ void LLVertexBuffer::initClass(bool use_vbo, bool no_vbo_mapping)
 		delete sUtilityBuffer;
 		sUtilityBuffer = NULL;
 	}
+
+	// 16MB for vertices and 4MB for indices
+	if (sEnableVBOs && sUseStreamRing && sVertexRing.init(16 * 1024 * 1024) &&
+		sIndexRing.init(4 * 1024 * 1024))
+	{
+		llinfos << "Using persistent mapped streaming ring buffers." << llendl;
+	}
+	else
+	{
+		sVertexRing.cleanup();
+		sIndexRing.cleanup();
+		if (sUseStreamRing)
+		{
+			llinfos << "Streaming ring buffers not available." << llendl;
+		}
+	}
+
 	if (!sDisableVBOMapping)
 	{
 		sUtilityBuffer = new LLVertexBuffer(MAP_VERTEX | MAP_NORMAL |
@@ -547,10 +732,17 @@ void LLVertexBuffer::cleanupClass()
 		delete sUtilityBuffer;
 		sUtilityBuffer = NULL;
 	}
+
+	sVertexRing.cleanup();
+	sIndexRing.cleanup();
 }
 
 LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage)
 :	LLRefCount(),
+	mRingPos(-1),
+	mRingIndexPos(-1),
+	mRingVertexCount(0),
+	mRingIndexCount(0),
 	mNumVerts(0),
 	mNumIndices(0),
 	mAlignedOffset(0),
@@ -574,14 +766,15 @@ LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage)
 	mIndexLocked(false),
 	mFinal(false),
 	mEmpty(true),
-	mMappable(false)
+	mMappable(false),
+	mTransient(false)
 {
 	mMappable = mUsage == GL_DYNAMIC_DRAW_ARB && !sDisableVBOMapping;
 
 	// Zero out offsets
 	for (U32 i = 0; i < TYPE_MAX; ++i)
 	{
-		mOffsets[i] = 0;
+		mOffsets[i] = mRingOffsets[i] = 0;
 	}
 
 	++sCount;
@@ -1013,11 +1206,11 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count,
 	}
 	else
 	{
-		if (mGLIndices != sGLRenderIndices)
+		if (getDrawGLIndices() != sGLRenderIndices)
 		{
 			llerrs << "Wrong index buffer bound." << llendl;
 		}
-		if (mGLBuffer != sGLRenderBuffer)
+		if (getDrawGLBuffer() != sGLRenderBuffer)
 		{
 			llerrs << "Wrong vertex buffer bound." << llendl;
 		}
@@ -1027,7 +1220,7 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count,
 	{
 		GLint elem = 0;
 		glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING_ARB, &elem);
-		if ((U32)elem != mGLIndices)
+		if ((U32)elem != getDrawGLIndices())
 		{
 			llwarns_once << "Wrong index buffer bound." << llendl;
 		}
@@ -1050,6 +1243,79 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count,
 	placeFence();
 }
 
+void LLVertexBuffer::drawMultiRange(U32 mode, U32 start, U32 end,
+									const S32* counts,
+									const U32* indices_offsets,
+									U32 draws) const
+{
+	if (!gGLManager.mHasMultiDrawElements)
+	{
+		for (U32 i = 0; i < draws; ++i)
+		{
+			drawRange(mode, start, end, counts[i], indices_offsets[i]);
+		}
+		return;
+	}
+
+	U32 total = 0;
+	for (U32 i = 0; i < draws; ++i)
+	{
+		if (!validateRange(start, end, counts[i], indices_offsets[i]))
+		{
+			llwarns << "Invalid range. Aborted." << llendl;
+			return;
+		}
+		total += counts[i];
+	}
+
+	mMappable = false;
+	gGL.syncMatrices();
+
+	llassert(!gDebugGL || !gNoFixedFunction ||
+			 !LLGLSLShader::sCurBoundShaderPtr);
+
+	if (mGLArray)
+	{
+		if (mGLArray != sGLRenderArray)
+		{
+			llerrs << "Wrong vertex array bound." << llendl;
+		}
+	}
+	else
+	{
+		if (getDrawGLIndices() != sGLRenderIndices)
+		{
+			llerrs << "Wrong index buffer bound." << llendl;
+		}
+		if (getDrawGLBuffer() != sGLRenderBuffer)
+		{
+			llerrs << "Wrong vertex buffer bound." << llendl;
+		}
+	}
+
+	if (mode >= LLRender::NUM_MODES)
+	{
+		llerrs << "Invalid draw mode: " << mode << llendl;
+	}
+
+	static std::vector<const GLvoid*> indices;
+	indices.resize(draws);
+	U16* idx = (U16*)getIndicesPointer();
+	for (U32 i = 0; i < draws; ++i)
+	{
+		indices[i] = (const GLvoid*)(idx + indices_offsets[i]);
+	}
+
+	stop_glerror();
+	LLGLSLShader::startProfile();
+	glMultiDrawElements(sGLMode[mode], counts, GL_UNSIGNED_SHORT,
+						(const GLvoid**)indices.data(), draws);
+	LLGLSLShader::stopProfile(total, mode);
+	stop_glerror();
+
+	placeFence();
+}
+
 void LLVertexBuffer::draw(U32 mode, U32 count, U32 indices_offset) const
 {
 	llassert(!gDebugGL || !gNoFixedFunction ||
@@ -1077,11 +1343,11 @@ void LLVertexBuffer::draw(U32 mode, U32 count, U32 indices_offset) const
 	}
 	else
 	{
-		if (mGLIndices != sGLRenderIndices)
+		if (getDrawGLIndices() != sGLRenderIndices)
 		{
 			llerrs << "Wrong index buffer bound." << llendl;
 		}
-		if (mGLBuffer != sGLRenderBuffer)
+		if (getDrawGLBuffer() != sGLRenderBuffer)
 		{
 			llerrs << "Wrong vertex buffer bound." << llendl;
 		}
@@ -1123,7 +1389,7 @@ void LLVertexBuffer::drawArrays(U32 mode, U32 first, U32 count) const
 			llerrs << "Wrong vertex array bound." << llendl;
 		}
 	}
-	else if (mGLBuffer != sGLRenderBuffer || useVBOs() != sVBOActive)
+	else if (getDrawGLBuffer() != sGLRenderBuffer || useVBOs() != sVBOActive)
 	{
 			llerrs << "Wrong vertex buffer bound." << llendl;
 	}
@@ -1443,6 +1709,7 @@ void LLVertexBuffer::destroyGLBuffer()
 	}
 
 	mGLBuffer = 0;
+	mRingPos = -1;
 #if 0
 	unbind();
 #endif
@@ -1465,6 +1732,7 @@ void LLVertexBuffer::destroyGLIndices()
 	}
 
 	mGLIndices = 0;
+	mRingIndexPos = -1;
 #if 0
 	unbind();
 #endif
@@ -2084,9 +2352,34 @@ void LLVertexBuffer::flush()
 
 	bool updated_all = false;
 
+	if (canUseStreamRing())
+	{
+		if (mMappedData && mVertexLocked && copyToStreamRing(false, false))
+		{
+			// Both vertex and index buffers done updating
+			updated_all = mIndexLocked;
+			mMappedVertexRegions.clear();
+			mVertexLocked = false;
+			--sMappedCount;
+		}
+		if (mMappedIndexData && mIndexLocked && copyToStreamRing(true, false))
+		{
+			mMappedIndexRegions.clear();
+			mIndexLocked = false;
+			--sMappedCount;
+		}
+	}
+
 	if (mMappedData && mVertexLocked)
 	{
 		LL_TRACY_TIMER(TRC_VBO_UNMAP);
+		if (mRingPos >= 0)
+		{
+			// The data was last copied into the streaming ring, so our own
+			// VBO must be entirely refreshed.
+			mRingPos = -1;
+			mMappedVertexRegions.clear();
+		}
 		bindGLBuffer(true);
 		// Both vertex and index buffers done updating
 		updated_all = mIndexLocked;
@@ -2188,6 +2481,11 @@ void LLVertexBuffer::flush()
 	if (mMappedIndexData && mIndexLocked)
 	{
 		LL_TRACY_TIMER(TRC_IBO_UNMAP);
+		if (mRingIndexPos >= 0)
+		{
+			mRingIndexPos = -1;
+			mMappedIndexRegions.clear();
+		}
 		bindGLIndices();
 		if (mMappable)
 		{
@@ -2284,6 +2582,109 @@ void LLVertexBuffer::flush()
 	}
 }
 
+bool LLVertexBuffer::copyToStreamRing(bool indices, bool refresh)
+{
+	const U8* src = indices ? mMappedIndexData : mMappedData;
+	if (!src)
+	{
+		return false;
+	}
+
+	// Number of vertices or indices to copy: when refreshing a recycled ring
+	// block, the same as for the last copy. Else, for transient buffers, only
+	// up to the end of the regions mapped since the last copy, and the whole
+	// buffer otherwise.
+	U32 count;
+	if (refresh)
+	{
+		count = indices ? mRingIndexCount : mRingVertexCount;
+	}
+	else
+	{
+		count = indices ? mNumIndices : mNumVerts;
+		const region_map_t& regions = indices ? mMappedIndexRegions
+											  : mMappedVertexRegions;
+		if (mTransient && !regions.empty())
+		{
+			U32 end = 0;
+			for (U32 i = 0, rcount = regions.size(); i < rcount; ++i)
+			{
+				const MappedRegion& region = regions[i];
+				if (region.mIndex < 0)
+				{
+					end = count;
+					break;
+				}
+				end = llmax(end, (U32)(region.mIndex + region.mCount));
+			}
+			count = llmin(end, count);
+		}
+	}
+	if (!count)
+	{
+		return false;
+	}
+
+	LLStreamRing& ring = indices ? sIndexRing : sVertexRing;
+	if (indices)
+	{
+		U32 size = count * sizeof(U16);
+		S64 pos = ring.allocate(size);
+		if (pos < 0)
+		{
+			return false;
+		}
+		memcpy(ring.getPointer(pos), src, size);
+		LLStreamRing::sBytesStreamed += size;
+		mRingIndexPos = pos;
+		mRingIndexCount = count;
+		return true;
+	}
+
+	// Vertex attributes are stored one after the other in the buffer, so the
+	// ring block gets its own, compact layout for 'count' vertices only.
+	U32 size = calcOffsets(mTypeMask, mRingOffsets, count);
+	S64 pos = ring.allocate(size);
+	if (pos < 0)
+	{
+		return false;
+	}
+	U8* dst = ring.getPointer(pos);
+	for (S32 i = 0; i < TYPE_TEXTURE_INDEX; ++i)
+	{
+		if ((mTypeMask & (1 << i)) && sTypeSize[i])
+		{
+			U32 bytes = sTypeSize[i] * count;
+			memcpy(dst + mRingOffsets[i], src + mOffsets[i], bytes);
+			LLStreamRing::sBytesStreamed += bytes;
+		}
+	}
+	mRingPos = pos;
+	mRingVertexCount = count;
+	return true;
+}
+
+// Makes sure the data copied into the streaming rings is still usable. When
+// not, copy it again, or fall back to our own VBO/IBO.
+void LLVertexBuffer::validateStreamRing()
+{
+	if (mRingPos >= 0 && !sVertexRing.isValid(mRingPos) &&
+		(!canUseStreamRing() || !copyToStreamRing(false, true)))
+	{
+		mRingPos = -1;
+		bindGLBuffer(true);
+		glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, getSize(), mMappedData);
+	}
+	if (mRingIndexPos >= 0 && !sIndexRing.isValid(mRingIndexPos) &&
+		(!canUseStreamRing() || !copyToStreamRing(true, true)))
+	{
+		mRingIndexPos = -1;
+		bindGLIndices(true);
+		glBufferSubDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0, getIndicesSize(),
+						   mMappedIndexData);
+	}
+}
+
 template <class T, S32 type>
 struct VertexBufferStrider
 {
@@ -2463,14 +2864,14 @@ bool LLVertexBuffer::bindGLBuffer(bool force_bind)
 {
 	bindGLArray();
 
+	U32 name = getDrawGLBuffer();
 	if (useVBOs() &&
-		(force_bind ||
-		 (mGLBuffer && (mGLBuffer != sGLRenderBuffer || !sVBOActive))))
+		(force_bind || (name && (name != sGLRenderBuffer || !sVBOActive))))
 	{
 		LL_TRACY_TIMER(TRC_BIND_GL_BUFFER);
 
-		glBindBufferARB(GL_ARRAY_BUFFER_ARB, mGLBuffer);
-		sGLRenderBuffer = mGLBuffer;
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, name);
+		sGLRenderBuffer = name;
 		++sBindCount;
 		sVBOActive = true;
 
@@ -2486,9 +2887,9 @@ bool LLVertexBuffer::bindGLIndices(bool force_bind)
 {
 	bindGLArray();
 
+	U32 name = getDrawGLIndices();
 	if (useVBOs() &&
-		(force_bind ||
-		 (mGLIndices && (mGLIndices != sGLRenderIndices || !sIBOActive))))
+		(force_bind || (name && (name != sGLRenderIndices || !sIBOActive))))
 	{
 		LL_TRACY_TIMER(TRC_BIND_GL_INDICES);
 #if 0
@@ -2497,8 +2898,8 @@ bool LLVertexBuffer::bindGLIndices(bool force_bind)
 			llerrs << "VBO bound while another VBO mapped !" << llendl;
 		}
 #endif
-		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, mGLIndices);
-		sGLRenderIndices = mGLIndices;
+		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, name);
+		sGLRenderIndices = name;
 		stop_glerror();
 		++sBindCount;
 		sIBOActive = true;
@@ -2610,6 +3011,13 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 		}
 	}
 
+	if (mRingPos >= 0 || mRingIndexPos >= 0)
+	{
+		validateStreamRing();
+		// The offset in the ring changes with each copy
+		setup = true;
+	}
+
 	if (useVBOs())
 	{
 		if (mGLArray)
@@ -2628,16 +3036,17 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 		{
 			GLint buff;
 			glGetIntegerv(GL_ARRAY_BUFFER_BINDING_ARB, &buff);
-			if ((U32)buff != mGLBuffer)
+			if ((U32)buff != getDrawGLBuffer())
 			{
 				llwarns_once << "Invalid GL vertex buffer bound: " << buff
-							 << " - Expected: " << mGLBuffer << llendl;
+							 << " - Expected: " << getDrawGLBuffer()
+							 << llendl;
 			}
 
 			if (mGLIndices)
 			{
 				glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING_ARB, &buff);
-				if ((U32)buff != mGLIndices)
+				if ((U32)buff != getDrawGLIndices())
 				{
 					llerrs << "Invalid GL index buffer bound: " << buff
 						   << llendl;
@@ -2703,6 +3112,13 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 	data_mask &= ~mTypeMaskMask;
 	stop_glerror();
 	U8* base = useVBOs() ? (U8*)mAlignedOffset : mMappedData;
+	// The data copied into the streaming ring uses its own layout
+	const S32* offsets = mOffsets;
+	if (mRingPos >= 0)
+	{
+		base += sVertexRing.getOffset(mRingPos);
+		offsets = mRingOffsets;
+	}
 
 	if (gDebugGL && (data_mask & mTypeMask) != data_mask)
 	{
@@ -2730,42 +3146,42 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_NORMAL)
 		{
 			loc = TYPE_NORMAL;
-			ptr = (void*)(base + mOffsets[TYPE_NORMAL]);
+			ptr = (void*)(base + offsets[TYPE_NORMAL]);
 			glVertexAttribPointerARB(loc, 3, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_NORMAL], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD3)
 		{
 			loc = TYPE_TEXCOORD3;
-			ptr = (void*)(base + mOffsets[TYPE_TEXCOORD3]);
+			ptr = (void*)(base + offsets[TYPE_TEXCOORD3]);
 			glVertexAttribPointerARB(loc, 2, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_TEXCOORD3], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD2)
 		{
 			loc = TYPE_TEXCOORD2;
-			ptr = (void*)(base + mOffsets[TYPE_TEXCOORD2]);
+			ptr = (void*)(base + offsets[TYPE_TEXCOORD2]);
 			glVertexAttribPointerARB(loc, 2, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_TEXCOORD2], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD1)
 		{
 			loc = TYPE_TEXCOORD1;
-			ptr = (void*)(base + mOffsets[TYPE_TEXCOORD1]);
+			ptr = (void*)(base + offsets[TYPE_TEXCOORD1]);
 			glVertexAttribPointerARB(loc, 2, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_TEXCOORD1], ptr);
 		}
 		if (data_mask & MAP_TANGENT)
 		{
 			loc = TYPE_TANGENT;
-			ptr = (void*)(base + mOffsets[TYPE_TANGENT]);
+			ptr = (void*)(base + offsets[TYPE_TANGENT]);
 			glVertexAttribPointerARB(loc, 4, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_TANGENT], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD0)
 		{
 			loc = TYPE_TEXCOORD0;
-			ptr = (void*)(base + mOffsets[TYPE_TEXCOORD0]);
+			ptr = (void*)(base + offsets[TYPE_TEXCOORD0]);
 			glVertexAttribPointerARB(loc, 2, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_TEXCOORD0], ptr);
 		}
@@ -2775,11 +3191,11 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 			// Bind emissive instead of color pointer if emissive is present
 			if (data_mask & MAP_EMISSIVE)
 			{
-				ptr = (void*)(base + mOffsets[TYPE_EMISSIVE]);
+				ptr = (void*)(base + offsets[TYPE_EMISSIVE]);
 			}
 			else
 			{
-				ptr = (void*)(base + mOffsets[TYPE_COLOR]);
+				ptr = (void*)(base + offsets[TYPE_COLOR]);
 			}
 			glVertexAttribPointerARB(loc, 4, GL_UNSIGNED_BYTE, GL_TRUE,
 									 sTypeSize[TYPE_COLOR], ptr);
@@ -2787,7 +3203,7 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_EMISSIVE)
 		{
 			loc = TYPE_EMISSIVE;
-			ptr = (void*)(base + mOffsets[TYPE_EMISSIVE]);
+			ptr = (void*)(base + offsets[TYPE_EMISSIVE]);
 			glVertexAttribPointerARB(loc, 4, GL_UNSIGNED_BYTE, GL_TRUE,
 									 sTypeSize[TYPE_EMISSIVE], ptr);
 			if (!(data_mask & MAP_COLOR))
@@ -2802,21 +3218,21 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_WEIGHT)
 		{
 			loc = TYPE_WEIGHT;
-			ptr = (void*)(base + mOffsets[TYPE_WEIGHT]);
+			ptr = (void*)(base + offsets[TYPE_WEIGHT]);
 			glVertexAttribPointerARB(loc, 1, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_WEIGHT], ptr);
 		}
 		if (data_mask & MAP_WEIGHT4)
 		{
 			loc = TYPE_WEIGHT4;
-			ptr = (void*)(base + mOffsets[TYPE_WEIGHT4]);
+			ptr = (void*)(base + offsets[TYPE_WEIGHT4]);
 			glVertexAttribPointerARB(loc, 4, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_WEIGHT4], ptr);
 		}
 		if (data_mask & MAP_CLOTHWEIGHT)
 		{
 			loc = TYPE_CLOTHWEIGHT;
-			ptr = (void*)(base + mOffsets[TYPE_CLOTHWEIGHT]);
+			ptr = (void*)(base + offsets[TYPE_CLOTHWEIGHT]);
 			glVertexAttribPointerARB(loc, 4, GL_FLOAT, GL_TRUE,
 									 sTypeSize[TYPE_CLOTHWEIGHT], ptr);
 		}
@@ -2825,7 +3241,7 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 			gGLManager.mHasVertexAttribIPointer)
 		{
 			loc = TYPE_TEXTURE_INDEX;
-			ptr = (void*)(base + mOffsets[TYPE_VERTEX] + 12);
+			ptr = (void*)(base + offsets[TYPE_VERTEX] + 12);
 			glVertexAttribIPointer(loc, 1, GL_UNSIGNED_INT,
 								   sTypeSize[TYPE_VERTEX], ptr);
 		}
@@ -2833,7 +3249,7 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_VERTEX)
 		{
 			loc = TYPE_VERTEX;
-			ptr = (void*)(base + mOffsets[TYPE_VERTEX]);
+			ptr = (void*)(base + offsets[TYPE_VERTEX]);
 			glVertexAttribPointerARB(loc, 3, GL_FLOAT, GL_FALSE,
 									 sTypeSize[TYPE_VERTEX], ptr);
 		}
@@ -2843,45 +3259,45 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_NORMAL)
 		{
 			glNormalPointer(GL_FLOAT, sTypeSize[TYPE_NORMAL],
-							(void*)(base + mOffsets[TYPE_NORMAL]));
+							(void*)(base + offsets[TYPE_NORMAL]));
 		}
 		if (data_mask & MAP_TEXCOORD3)
 		{
 			glClientActiveTextureARB(GL_TEXTURE3_ARB);
 			glTexCoordPointer(2, GL_FLOAT, sTypeSize[TYPE_TEXCOORD3],
-							  (void*)(base + mOffsets[TYPE_TEXCOORD3]));
+							  (void*)(base + offsets[TYPE_TEXCOORD3]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TEXCOORD2)
 		{
 			glClientActiveTextureARB(GL_TEXTURE2_ARB);
 			glTexCoordPointer(2, GL_FLOAT, sTypeSize[TYPE_TEXCOORD2],
-							  (void*)(base + mOffsets[TYPE_TEXCOORD2]));
+							  (void*)(base + offsets[TYPE_TEXCOORD2]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TEXCOORD1)
 		{
 			glClientActiveTextureARB(GL_TEXTURE1_ARB);
 			glTexCoordPointer(2, GL_FLOAT, sTypeSize[TYPE_TEXCOORD1],
-							  (void*)(base + mOffsets[TYPE_TEXCOORD1]));
+							  (void*)(base + offsets[TYPE_TEXCOORD1]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TANGENT)
 		{
 			glClientActiveTextureARB(GL_TEXTURE2_ARB);
 			glTexCoordPointer(4, GL_FLOAT, sTypeSize[TYPE_TANGENT],
-							  (void*)(base + mOffsets[TYPE_TANGENT]));
+							  (void*)(base + offsets[TYPE_TANGENT]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TEXCOORD0)
 		{
 			glTexCoordPointer(2, GL_FLOAT, sTypeSize[TYPE_TEXCOORD0],
-							  (void*)(base + mOffsets[TYPE_TEXCOORD0]));
+							  (void*)(base + offsets[TYPE_TEXCOORD0]));
 		}
 		if (data_mask & MAP_COLOR)
 		{
 			glColorPointer(4, GL_UNSIGNED_BYTE, sTypeSize[TYPE_COLOR],
-						   (void*)(base + mOffsets[TYPE_COLOR]));
+						   (void*)(base + offsets[TYPE_COLOR]));
 		}
 		if (data_mask & MAP_VERTEX)
 		{
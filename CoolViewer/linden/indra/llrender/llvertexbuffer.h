@@ -114,6 +114,73 @@ public:
 	static U32					sNameIdx;
 };
 
+//============================================================================
+// Streaming ring buffer, using a persistent and coherent mapping (needs the
+// GL_ARB_buffer_storage and GL_ARB_sync extensions). Stream draw buffers get
+// their data copied into it on flush(), instead of calling glBufferSubData()
+// on their own VBO for each update. The ring is split into segments, and a
+// fence is placed each time a new segment is entered, so that no data still
+// in use by the GPU may get overwritten; for this to hold true, the data
+// written into a segment may only be drawn till the ring moves past the next
+// segment (see isValid()), after which it must be copied again.
+// It is also used as a pixel unpack buffer (PBO) ring by LLImageGL, for the
+// textures uploads.
+
+class LLStreamRing
+{
+public:
+	LLStreamRing(U32 type);
+
+	// The largest block allocate() accepts is a segment size divided by
+	// 'max_block_divisor'.
+	bool init(U32 size, U32 max_block_divisor = 4);
+	void cleanup();
+
+	LL_INLINE bool isActive() const					{ return mData != NULL; }
+	LL_INLINE U32 getGLName() const					{ return mGLName; }
+
+	// Reserves 'size' bytes in the ring, waiting for the GPU to be done with
+	// them when needed and 'wait' is true. Returns the position of the
+	// reserved block, or -1 when the block is too large for the ring or when
+	// 'wait' is false and the GPU is still using the needed ring segment.
+	S64 allocate(U32 size, bool wait = true);
+
+	LL_INLINE U32 getOffset(S64 pos) const			{ return (U32)(pos & mMask); }
+	LL_INLINE U8* getPointer(S64 pos) const			{ return mData + getOffset(pos); }
+
+	// Returns true when the data stored at 'pos' may still be used for
+	// drawing.
+	LL_INLINE bool isValid(S64 pos) const
+	{
+		return mData && pos >= 0 &&
+			   mCurSegment - (U64)pos / mSegmentSize <= 1;
+	}
+
+private:
+	// Returns false when 'wait' is false and the segment is still in use.
+	bool enterSegment(U64 segment, bool wait);
+
+public:
+	// Largest block allocate() accepts (larger buffers just keep using
+	// glBufferSubData()).
+	U32						mMaxBlockSize;
+	// Bytes copied into the rings since the last reset (for the stats).
+	static U64				sBytesStreamed;
+
+private:
+	const U32				mType;
+	U32						mGLName;
+	U32						mSegmentSize;
+	U64						mMask;
+	U64						mHead;
+	U64						mCurSegment;
+	U8*						mData;
+#ifdef GL_ARB_sync
+	static constexpr U32	NUM_SEGMENTS = 4;
+	GLsync					mFences[NUM_SEGMENTS];
+#endif
+};
+
 // Base class
 class LLVertexBuffer final : public LLRefCount
 {
@@ -288,7 +355,16 @@ public:
 
 	LL_INLINE U8* getIndicesPointer() const
 	{
-		return useVBOs() ? (U8*)mAlignedIndexOffset : mMappedIndexData;
+		if (!useVBOs())
+		{
+			return mMappedIndexData;
+		}
+		if (mRingIndexPos >= 0)
+		{
+			return (U8*)(mAlignedIndexOffset +
+						 sIndexRing.getOffset(mRingIndexPos));
+		}
+		return (U8*)mAlignedIndexOffset;
 	}
 
 	LL_INLINE U8* getVerticesPointer() const
@@ -311,10 +387,22 @@ public:
 	LL_INLINE S32 getUsage() const					{ return mUsage; }
 	LL_INLINE bool isWriteable() const				{ return mMappable || mUsage == GL_STREAM_DRAW_ARB; }
 
+	// When true, the buffer is expected to be entirely drawn from the regions
+	// mapped since its last flush() (e.g. the immediate mode buffer used by
+	// LLRender), so that only these regions need copying into the streaming
+	// ring.
+	LL_INLINE void setTransient(bool b)				{ mTransient = b; }
+
+	LL_INLINE static bool hasStreamRing()			{ return sVertexRing.isActive(); }
+
 	void draw(U32 mode, U32 count, U32 indices_offset) const;
 	void drawArrays(U32 mode, U32 offset, U32 count) const;
 	void drawRange(U32 mode, U32 start, U32 end, U32 count,
 				   U32 indices_offset) const;
+	// Draws 'draws' index ranges of this buffer, whose vertices all lie in
+	// [start, end], with a single glMultiDrawElements() call when available.
+	void drawMultiRange(U32 mode, U32 start, U32 end, const S32* counts,
+						const U32* indices_offsets, U32 draws) const;
 
 	// For debugging, checks range validity and validates data in given range
 	bool validateRange(U32 start, U32 end, U32 count, U32 offset) const;
@@ -350,6 +438,32 @@ protected:
 	void placeFence() const;
 	void waitFence() const;
 
+	// Returns the name of the GL buffer to bind for drawing, which is the
+	// streaming ring one when the data got copied into it.
+	LL_INLINE U32 getDrawGLBuffer() const
+	{
+		return mRingPos >= 0 ? sVertexRing.getGLName() : mGLBuffer;
+	}
+
+	LL_INLINE U32 getDrawGLIndices() const
+	{
+		return mRingIndexPos >= 0 ? sIndexRing.getGLName() : mGLIndices;
+	}
+
+	LL_INLINE bool canUseStreamRing() const
+	{
+		return mUsage == GL_STREAM_DRAW_ARB && !mGLArray &&
+			   sVertexRing.isActive();
+	}
+
+	// Copies the vertex (when 'indices' is false) or index data into the
+	// streaming ring; only the vertices or indices up to the end of the
+	// mapped regions get copied for transient buffers. When 'refresh' is
+	// true, the same range as for the last copy is copied again. Returns
+	// false when the data is too large for the ring.
+	bool copyToStreamRing(bool indices, bool refresh);
+	void validateStreamRing();
+
 public:
 	struct MappedRegion
 	{
@@ -399,12 +513,22 @@ public:
 	static bool				sUseVAO;
 	static bool				sUseStreamDraw;
 	static bool				sPreferStreamDraw;
+	// When true, use the streaming rings, if supported by the GL driver
+	static bool				sUseStreamRing;
 
 protected:
 	typedef std::vector<MappedRegion> region_map_t;
 	region_map_t			mMappedVertexRegions;
 	region_map_t			mMappedIndexRegions;
 
+	// Positions in the streaming rings of the last copied vertex and index
+	// data, or -1 when the buffer own VBO/IBO is used.
+	S64						mRingPos;
+	S64						mRingIndexPos;
+	// Number of vertices and indices last copied into the streaming rings
+	U32						mRingVertexCount;
+	U32						mRingIndexCount;
+
 	S32						mNumVerts;		// Number of vertices allocated
 	S32						mNumIndices;	// Number of indices allocated
 
@@ -424,6 +548,9 @@ protected:
 	U32						mGLArray;		// GL VAO handle
 
 	S32						mOffsets[TYPE_MAX];
+	// Offsets of the vertex attributes in the streaming ring block, which
+	// only holds mRingVertexCount vertices.
+	S32						mRingOffsets[TYPE_MAX];
 
 	// Pointer to currently mapped data (NULL if unmapped)
 	U8*						mMappedData;
@@ -450,8 +577,13 @@ protected:
 	// use glBufferSubData)
 	mutable bool			mMappable;
 
+	// See setTransient()
+	bool					mTransient;
+
 private:
 	static LLVertexBuffer*	sUtilityBuffer;
+	static LLStreamRing		sVertexRing;
+	static LLStreamRing		sIndexRing;
 #if LL_JEMALLOC
 	static U32				sMallocxFlags;
 #endif
@@ -3218,6 +3218,16 @@ void LLMenuGL::draw()
 	LLView::draw();
 }
 
+//virtual
+void LLMenuGL::dirtyChildIndex()
+{
+	LLUICtrl::dirtyChildIndex();
+	if (mParentMenuItem)
+	{
+		mParentMenuItem->dirtyChildIndex();
+	}
+}
+
 void LLMenuGL::drawBackground(LLMenuItemGL* itemp, LLColor4& color)
 {
 	gGL.color4fv(color.mV);
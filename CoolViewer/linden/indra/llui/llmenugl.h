@@ -414,6 +414,10 @@ public:
 	void setVisible(bool visible) override;
 	void draw() override;
 
+	// Our parent menu item (if any) searches us in its getChildView() while
+	// we are not its child: let it know about any change in our sub-tree.
+	void dirtyChildIndex() override;
+
 	virtual void drawBackground(LLMenuItemGL* itemp, LLColor4& color);
 
 	virtual bool handleAcceleratorKey(KEY key, MASK mask);
@@ -525,7 +529,12 @@ public:
 	// Whether to drop shadow menu bar
 	LL_INLINE void setDropShadowed(bool b)				{ mDropShadowed = b; }
 
-	LL_INLINE void setParentMenuItem(LLMenuItemGL* p)	{ mParentMenuItem = p; }
+	LL_INLINE void setParentMenuItem(LLMenuItemGL* p)
+	{
+		mParentMenuItem = p;
+		dirtyChildIndex();
+	}
+
 	LL_INLINE LLMenuItemGL* getParentMenuItem() const	{ return mParentMenuItem; }
 
 	LL_INLINE void setTornOff(bool b)					{ mTornOff = b; }
@@ -627,6 +627,11 @@ void LLScreenClipRect::updateScissorRegion()
 	y = llfloor(rect.mBottom * LLUI::sGLScaleFactor.mV[VY]);
 	w = llmax(0, llceil(rect.getWidth() * LLUI::sGLScaleFactor.mV[VX])) + 1;
 	h = llmax(0, llceil(rect.getHeight() * LLUI::sGLScaleFactor.mV[VY])) + 1;
+	// Since the UI draws are batched, render any geometry still pending in
+	// the old clipping region before changing it. Note: we cannot cache the
+	// last scissor region here to skip that flush, since glScissor() is also
+	// called directly by other code.
+	gGL.flush();
 	glScissor(x, y, w, h);
 	stop_glerror();
 }
@@ -41,11 +41,15 @@
 #include "llcolor4.h"
 #include "llcontrol.h"
 #include "lldir.h"
+#include "llmd5.h"
 #include "llmenugl.h"
 
 const char XML_HEADER[] = "<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\" ?>\n";
 
 std::vector<std::string> LLUICtrlFactory::sXUIPaths;
+LLUICtrlFactory::xui_cache_map_t LLUICtrlFactory::sXUICache;
+std::string LLUICtrlFactory::sXUICacheDir;
+bool LLUICtrlFactory::sUseXUICache = true;
 
 static const std::string LL_UI_CTRL_LOCATE_TAG = "locate";
 static const std::string LL_PAD_TAG = "pad";
@@ -107,6 +111,8 @@ void LLUICtrlFactory::setupPaths()
 	LLXMLNodePtr root;
 	bool success  = LLXMLNode::parseFile(filename, root, NULL);
 	sXUIPaths.clear();
+	// The language might have changed: flush the merged XUI trees.
+	clearXUICache();
 
 	if (success)
 	{
@@ -139,6 +145,153 @@ const std::vector<std::string>& LLUICtrlFactory::getXUIPaths()
 	return sXUIPaths;
 }
 
+//static
+bool LLUICtrlFactory::parseLayeredXMLNode(const std::vector<std::string>& layers,
+										  LLXMLNodePtr& root)
+{
+	const std::string& full_filename = layers.front();
+	if (!LLXMLNode::parseFile(full_filename, root, NULL))
+	{
+		llwarns << "Problem reading UI description file: " << full_filename
+				<< llendl;
+		return false;
+	}
+
+	LLXMLNodePtr upd_root;
+	std::string node_name, upd_name;
+	for (size_t i = 1, count = layers.size(); i < count; ++i)
+	{
+		const std::string& layer_filename = layers[i];
+		if (layer_filename.empty())
+		{
+			// No localized version of this file, that's ok, keep looking
+			continue;
+		}
+
+		if (!LLXMLNode::parseFile(layer_filename, upd_root, NULL))
+		{
+			llwarns << "Problem reading localized UI description file: "
+					<< layer_filename << llendl;
+			return false;
+		}
+
+		upd_root->getAttributeString("name", upd_name);
+		root->getAttributeString("name", node_name);
+
+		if (upd_name == node_name)
+		{
+			LLXMLNode::updateNode(root, upd_root);
+		}
+	}
+
+	return true;
+}
+
+//static
+std::string LLUICtrlFactory::getLayersSignature(const std::vector<std::string>& layers)
+{
+	std::string signature;
+	llstat stat_data;
+	for (size_t i = 0, count = layers.size(); i < count; ++i)
+	{
+		const std::string& filename = layers[i];
+		signature += filename;
+		if (!filename.empty() && !LLFile::stat(filename, &stat_data))
+		{
+			signature += llformat("|%lld|%lld\n", (S64)stat_data.st_size,
+								  (S64)stat_data.st_mtime);
+		}
+		else
+		{
+			signature += "|\n";
+		}
+	}
+	return signature;
+}
+
+//static
+bool LLUICtrlFactory::loadXUICacheFile(const std::string& filename,
+									   const std::string& signature,
+									   std::string& data)
+{
+	S64 size = 0;
+	LLFile infile(filename, "rb", &size);
+	if (!infile || size < (S64)sizeof(U32))
+	{
+		return false;
+	}
+
+	U32 sig_len = 0;
+	if (infile.read((U8*)&sig_len, sizeof(U32)) != (S64)sizeof(U32) ||
+		sig_len != signature.size() ||
+		(S64)sig_len > size - (S64)sizeof(U32))
+	{
+		return false;
+	}
+
+	std::string cached_sig(sig_len, '\0');
+	if (infile.read((U8*)&cached_sig[0], sig_len) != (S64)sig_len ||
+		cached_sig != signature)
+	{
+		LL_DEBUGS("XUICache") << "Stale cache file: " << filename << LL_ENDL;
+		return false;
+	}
+
+	S64 data_len = size - (S64)sizeof(U32) - (S64)sig_len;
+	data.resize(data_len);
+	return data_len > 0 && infile.read((U8*)&data[0], data_len) == data_len;
+}
+
+//static
+void LLUICtrlFactory::saveXUICacheFile(const std::string& filename,
+									   const std::string& signature,
+									   const std::string& data)
+{
+	LLFile outfile(filename, "wb");
+	if (!outfile)
+	{
+		llwarns << "Could not write XUI cache file: " << filename << llendl;
+		return;
+	}
+
+	U32 sig_len = signature.size();
+	if (outfile.write((const U8*)&sig_len, sizeof(U32)) != (S64)sizeof(U32) ||
+		outfile.write((const U8*)signature.data(),
+					  sig_len) != (S64)sig_len ||
+		outfile.write((const U8*)data.data(),
+					  data.size()) != (S64)data.size())
+	{
+		llwarns << "Failed to write XUI cache file: " << filename << llendl;
+		outfile = NULL;
+		LLFile::remove(filename);
+	}
+}
+
+//static
+void LLUICtrlFactory::setXUICacheDir(const std::string& dirname)
+{
+	sXUICacheDir.clear();
+	if (dirname.empty())
+	{
+		return;
+	}
+	if (!LLFile::isdir(dirname) && !LLFile::mkdir(dirname))
+	{
+		llwarns << "Could not create the XUI cache directory: " << dirname
+				<< llendl;
+		return;
+	}
+	sXUICacheDir = dirname + LL_DIR_DELIM_STR;
+	llinfos << "Using XUI cache directory: " << dirname << llendl;
+}
+
+//static
+void LLUICtrlFactory::clearXUICache()
+{
+	sXUICache.clear();
+}
+
+//static
 bool LLUICtrlFactory::getLayeredXMLNode(const std::string& xui_filename,
 										LLXMLNodePtr& root)
 {
@@ -161,44 +314,76 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string& xui_filename,
 		}
 	}
 
-	if (!LLXMLNode::parseFile(full_filename, root, NULL))
+	// The first layer is the base file, the others are overrides (possibly
+	// empty strings when there is no override for a given XUI path).
+	std::vector<std::string> layers;
+	layers.reserve(sXUIPaths.size());
+	layers.emplace_back(full_filename);
+	for (size_t i = 1, count = sXUIPaths.size(); i < count; ++i)
 	{
-		llwarns << "Problem reading UI description file: " << full_filename
-				<< llendl;
-		return false;
+		layers.emplace_back(gDirUtilp->findSkinnedFilename(sXUIPaths[i],
+														   xui_filename));
 	}
 
-	LLXMLNodePtr upd_root;
-	std::string layer_filename, node_name, upd_name;
-	for (std::vector<std::string>::const_iterator it = sXUIPaths.begin(),
-												  end = sXUIPaths.end();
-		 it != end; ++it)
+	if (!sUseXUICache)
 	{
-		// Skip the first path to only consider overrides
-		if (it == sXUIPaths.begin()) continue;
+		return parseLayeredXMLNode(layers, root);
+	}
 
-		layer_filename = gDirUtilp->findSkinnedFilename(*it, xui_filename);
-		if (layer_filename.empty())
+	std::string signature = getLayersSignature(layers);
+
+	// Try the memory cache first
+	xui_cache_map_t::iterator it = sXUICache.find(xui_filename);
+	if (it != sXUICache.end())
+	{
+		XUICacheEntry& entry = it->second;
+		if (entry.mSignature == signature &&
+			LLXMLNode::parseBinary((const U8*)entry.mData.data(),
+								   entry.mData.size(), root))
 		{
-			// No localized version of this file, that's ok, keep looking
-			continue;
+			return true;
 		}
-
-		if (!LLXMLNode::parseFile(layer_filename, upd_root, NULL))
+		sXUICache.erase(it);
+	}
+
+	// Then the disk cache, when in use
+	std::string cache_filename;
+	if (!sXUICacheDir.empty())
+	{
+		// Since the signature holds all the layer file names, which depend on
+		// the skin and language, it is a good unique key for the cache file.
+		char digest[33];
+		LLMD5 md5((const unsigned char*)signature.c_str());
+		md5.hex_digest(digest);
+		cache_filename = sXUICacheDir + digest + ".xuib";
+		XUICacheEntry entry;
+		if (loadXUICacheFile(cache_filename, signature, entry.mData) &&
+			LLXMLNode::parseBinary((const U8*)entry.mData.data(),
+								   entry.mData.size(), root))
 		{
-			llwarns << "Problem reading localized UI description file: "
-					<< *it + LL_DIR_DELIM_STR + xui_filename << llendl;
-			return false;
+			LL_DEBUGS("XUICache") << "Loaded " << xui_filename
+								  << " from cache file: " << cache_filename
+								  << LL_ENDL;
+			entry.mSignature = std::move(signature);
+			sXUICache.emplace(xui_filename, std::move(entry));
+			return true;
 		}
+	}
 
-		upd_root->getAttributeString("name", upd_name);
-		root->getAttributeString("name", node_name);
+	// Cache miss: parse and merge the XML files.
+	if (!parseLayeredXMLNode(layers, root))
+	{
+		return false;
+	}
 
-		if (upd_name == node_name)
-		{
-			LLXMLNode::updateNode(root, upd_root);
-		}
+	XUICacheEntry entry;
+	root->writeBinary(entry.mData);
+	if (!cache_filename.empty())
+	{
+		saveXUICacheFile(cache_filename, signature, entry.mData);
 	}
+	entry.mSignature = std::move(signature);
+	sXUICache.emplace(xui_filename, std::move(entry));
 
 	return true;
 }
@@ -38,6 +38,7 @@
 #include <vector>
 
 #include "llcallbackmap.h"
+#include "llfastmap.h"
 #include "llfloater.h"
 
 class LLView;
@@ -88,9 +89,31 @@ public:
 
 	static const std::vector<std::string>& getXUIPaths();
 
+	// The merged (layered) XUI trees are cached in a compact binary form, in
+	// memory and, when a cache directory has been set, on disk, so that they
+	// do not need to be parsed and merged again each time a floater or panel
+	// is built. The cached entries are validated against the size and
+	// modification time of all the XUI files they were built from.
+	LL_INLINE static void setUseXUICache(bool enable)	{ sUseXUICache = enable; }
+	// Pass an empty string to only use the memory cache.
+	static void setXUICacheDir(const std::string& dirname);
+	// Clears the memory cache (the disk cache entries are kept since they get
+	// validated when loaded).
+	static void clearXUICache();
+
 private:
 	bool getLayeredXMLNodeImpl(const std::string& filename, LLXMLNodePtr& root);
 
+	static bool parseLayeredXMLNode(const std::vector<std::string>& layers,
+									LLXMLNodePtr& root);
+	static std::string getLayersSignature(const std::vector<std::string>& layers);
+	static bool loadXUICacheFile(const std::string& filename,
+								 const std::string& signature,
+								 std::string& data);
+	static void saveXUICacheFile(const std::string& filename,
+								 const std::string& signature,
+								 const std::string& data);
+
 	typedef std::map<LLHandle<LLPanel>, std::string> built_panel_t;
 	built_panel_t mBuiltPanels;
 
@@ -101,6 +124,16 @@ private:
 
 	static std::vector<std::string> sXUIPaths;
 
+	struct XUICacheEntry
+	{
+		std::string	mSignature;
+		std::string	mData;
+	};
+	typedef fast_hmap<std::string, XUICacheEntry> xui_cache_map_t;
+	static xui_cache_map_t sXUICache;
+	static std::string sXUICacheDir;
+	static bool sUseXUICache;
+
 	LLPanel* mDummyPanel;
 };
 
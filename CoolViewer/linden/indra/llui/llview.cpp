@@ -74,6 +74,11 @@ bool LLView::sForceReshape = false;
 LLView* LLView::sEditingUIView = NULL;
 S32 LLView::sLastLeftXML = S32_MIN;
 S32 LLView::sLastBottomXML = S32_MIN;
+bool LLView::sUseChildIndex = true;
+U32 LLView::sChildLookups = 0;
+U32 LLView::sChildIndexHits = 0;
+U32 LLView::sChildLookupCost = 0;
+U32 LLView::sChildLookupDepth = 0;
 
 constexpr S32 FLOATER_H_MARGIN = 15;
 constexpr S32 MIN_WIDGET_HEIGHT = 10;
@@ -245,6 +250,15 @@ std::string LLView::getName() const
 	return mName.empty() ? "(no name)" : mName;
 }
 
+void LLView::setName(const std::string& name)
+{
+	mName = name;
+	if (mParentView)
+	{
+		mParentView->dirtyChildIndex();
+	}
+}
+
 void LLView::sendChildToFront(LLView* child)
 {
 	if (child && child->getParent() == this)
@@ -254,6 +268,7 @@ void LLView::sendChildToFront(LLView* child)
 		// Paranoia: in case child was not in mChildList or was listed several
 		// times in it...
 		mChildListSize = mChildList.size();
+		dirtyChildIndex();
 	}
 }
 
@@ -266,6 +281,7 @@ void LLView::sendChildToBack(LLView* child)
 		// Paranoia: in case child was not in mChildList or was listed several
 		// times in it...
 		mChildListSize = mChildList.size();
+		dirtyChildIndex();
 	}
 }
 
@@ -318,6 +334,7 @@ void LLView::addChild(LLView* child, S32 tab_group)
 	}
 
 	child->mParentView = this;
+	dirtyChildIndex();
 	updateBoundingRect();
 }
 
@@ -354,6 +371,7 @@ void LLView::addChildAtEnd(LLView* child, S32 tab_group)
 	}
 
 	child->mParentView = this;
+	dirtyChildIndex();
 	updateBoundingRect();
 }
 
@@ -373,6 +391,7 @@ void LLView::removeChild(LLView* child, bool delete_it)
 		// not in mChildList or was listed several times in it...
 		mChildListSize = mChildList.size();
 		child->mParentView = NULL;
+		dirtyChildIndex();
 		if (child->isCtrl())
 		{
 			removeCtrl((LLUICtrl*)child);
@@ -617,6 +636,7 @@ void LLView::deleteAllChildren()
 		delete viewp; // will remove the child from mChildList
 	}
 	mChildListSize = 0;
+	dirtyChildIndex();
 }
 
 void LLView::setAllChildrenEnabled(bool b)
@@ -1781,19 +1801,58 @@ LLView* LLView::getChildView(const char* name, bool recurse,
 
 	LL_DEBUGS("GetChildCalls") << "Requested child name: " << name << LL_ENDL;
 
+	// Only the outermost recursive lookup is indexed: the nested calls done
+	// on each child while walking the tree would otherwise fill up the index
+	// of every intermediate view with (mostly failed) lookups.
+	bool use_index = recurse && sUseChildIndex && sChildLookupDepth == 0;
+	if (sChildLookupDepth == 0)
+	{
+		++sChildLookups;
+	}
+	if (use_index)
+	{
+		child_index_t::const_iterator it = mChildIndex.find(name);
+		if (it != mChildIndex.end())
+		{
+			if (it->second.isDead())
+			{
+				// A default (null) handle caches a failed lookup
+				if (it->second == LLHandle<LLView>())
+				{
+					++sChildIndexHits;
+					return create_if_missing ? createDummyWidget<LLView>(name)
+											 : NULL;
+				}
+				// The view got destroyed: should not happen since its removal
+				// from our sub-tree flushed the index, but let's be paranoid.
+				mChildIndex.erase(it);
+			}
+			else
+			{
+				++sChildIndexHits;
+				return it->second.get();
+			}
+		}
+	}
+
+	LLView* viewp = NULL;
+
 	// Look for direct children *first*
 	for (child_list_const_iter_t child_it = mChildList.begin(),
 								  end = mChildList.end();
 		 child_it != end; ++child_it)
 	{
 		LLView* childp = *child_it;
+		++sChildLookupCost;
 		if (childp && strcmp(childp->getName().c_str(), name) == 0)
 		{
-			return childp;
+			viewp = childp;
+			break;
 		}
 	}
-	if (recurse)
+	if (!viewp && recurse)
 	{
+		++sChildLookupDepth;
 		// Look inside each child as well.
 		for (child_list_const_iter_t child_it = mChildList.begin(),
 									 end = mChildList.end();
@@ -1802,19 +1861,45 @@ LLView* LLView::getChildView(const char* name, bool recurse,
 			LLView* childp = *child_it;
 			if (!childp) continue;	// Paranoia
 
-			LLView* viewp = childp->getChildView(name, recurse, false);
+			viewp = childp->getChildView(name, recurse, false);
 			if (viewp)
 			{
-				return viewp;
+				break;
 			}
 		}
+		--sChildLookupDepth;
+	}
+
+	if (use_index)
+	{
+		mChildIndex.emplace(name, viewp ? viewp->getHandle()
+										: LLHandle<LLView>());
 	}
 
-	if (create_if_missing)
+	if (!viewp && create_if_missing)
 	{
 		return createDummyWidget<LLView>(name);
 	}
-	return NULL;
+	return viewp;
+}
+
+//virtual
+void LLView::dirtyChildIndex()
+{
+	if (!mChildIndex.empty())
+	{
+		mChildIndex.clear();
+	}
+	if (mParentView)
+	{
+		mParentView->dirtyChildIndex();
+	}
+}
+
+//static
+void LLView::resetChildLookupStats()
+{
+	sChildLookups = sChildIndexHits = sChildLookupCost = 0;
 }
 
 bool LLView::parentPointInView(S32 x, S32 y, EHitTestType type) const
@@ -223,7 +223,7 @@ public:
 	LL_INLINE void setFollowsAll()						{ mReshapeFlags = FOLLOWS_ALL; }
 
 	LL_INLINE void setSoundFlags(U8 flags)				{ mSoundFlags = flags; }
-	LL_INLINE void setName(const std::string& name)		{ mName = name; }
+	void setName(const std::string& name);
 	void setUseBoundingRect(bool use_bounding_rect);
 	LL_INLINE bool getUseBoundingRect()					{ return mUseBoundingRect; }
 
@@ -331,7 +331,11 @@ public:
 
 	LL_INLINE S32 getChildCount() const					{ return mChildListSize; }
 
-	template<class T> void sortChildren(T compare_fn)	{ mChildList.sort(compare_fn); }
+	template<class T> void sortChildren(T compare_fn)
+	{
+		mChildList.sort(compare_fn);
+		dirtyChildIndex();
+	}
 
 	bool hasAncestor(const LLView* parentp) const;
 
@@ -510,6 +514,15 @@ public:
 	virtual LLView* getChildView(const char* name, bool recurse = true,
 								 bool create_if_missing = true) const;
 
+	// Flushes the recursive child lookups cache of this view and of all its
+	// ancestors. Called automatically whenever the children list or a child
+	// name changes; overridden by views whose getChildView() also searches
+	// views which are not their children (e.g. menu branches).
+	virtual void dirtyChildIndex();
+
+	// Resets the child lookups counters; to be called once per frame.
+	static void resetChildLookupStats();
+
 	template<class T> T* createDummyWidget(const char* name) const
 	{
 		T* widget = getDummyWidget<T>(name);
@@ -661,6 +674,11 @@ private:
 	typedef fast_hmap<std::string, LLView*> widget_map_t;
 	mutable widget_map_t mDummyWidgets;
 
+	// Results (including failures, as null handles) of the recursive
+	// getChildView() calls done on this view, indexed by child name.
+	typedef fast_hmap<std::string, LLHandle<LLView> > child_index_t;
+	mutable child_index_t mChildIndex;
+
 	// Location in pixels, relative to surrounding structure, bottom,left=0,0
 	LLRect				mRect;
 	LLRect				mBoundingRect;
@@ -708,6 +726,18 @@ public:
 	static bool			sDebugKeys;
 	static bool			sDebugMouseHandling;
 	static bool			sForceReshape;
+	// When true, recursive getChildView() results get cached in mChildIndex
+	static bool			sUseChildIndex;
+
+	// Child lookups statistics, reset by resetChildLookupStats()
+	static U32			sChildLookups;		// getChildView() calls
+	static U32			sChildIndexHits;	// Lookups served from mChildIndex
+	static U32			sChildLookupCost;	// Child names compared
+
+private:
+	// Depth of the getChildView() calls in progress, so that only the
+	// outermost lookup gets cached.
+	static U32			sChildLookupDepth;
 };
 
 class LLCompareByTabOrder
@@ -39,6 +39,7 @@
 #include "llcontrol.h"
 
 #include "llstl.h"
+#include "llthread.h"
 
 #include "llstring.h"
 #include "llvector3.h"
@@ -347,6 +348,7 @@ LLSD LLControlVariable::getSaveValue(bool user_value) const
 
 LLControlVariablePtr LLControlGroup::getControl(const char* name)
 {
+	countLookup(name);
 	ctrl_name_table_t::iterator iter = mNameTable.find(name);
 	return iter == mNameTable.end() ? LLControlVariablePtr() : iter->second;
 }
@@ -354,7 +356,8 @@ LLControlVariablePtr LLControlGroup::getControl(const char* name)
 ////////////////////////////////////////////////////////////////////////////
 
 LLControlGroup::LLControlGroup(const std::string& name)
-:	LLInstanceTracker<LLControlGroup, std::string>(name)
+:	LLInstanceTracker<LLControlGroup, std::string>(name),
+	mTrackLookups(false)
 {
 	mTypeString[TYPE_U32] = "U32";
 	mTypeString[TYPE_S32] = "S32";
@@ -378,6 +381,63 @@ LLControlGroup::~LLControlGroup()
 void LLControlGroup::cleanup()
 {
 	mNameTable.clear();
+	mLookupCounts.clear();
+}
+
+void LLControlGroup::setTrackLookups(bool enable)
+{
+	if (enable != mTrackLookups)
+	{
+		mTrackLookups = enable;
+		mLookupCounts.clear();
+	}
+}
+
+void LLControlGroup::addLookup(const char* name)
+{
+	if (is_main_thread())
+	{
+		++mLookupCounts[name];
+	}
+}
+
+void LLControlGroup::dumpLookupStats(U32 frames)
+{
+	if (mLookupCounts.empty())
+	{
+		return;
+	}
+
+	typedef std::pair<U32, std::string> count_pair_t;
+	std::vector<count_pair_t> sorted;
+	sorted.reserve(mLookupCounts.size());
+	U32 total = 0;
+	for (lookup_counts_map_t::const_iterator it = mLookupCounts.begin(),
+											 end = mLookupCounts.end();
+		 it != end; ++it)
+	{
+		sorted.emplace_back(it->second, it->first);
+		total += it->second;
+	}
+	mLookupCounts.clear();
+	std::sort(sorted.begin(), sorted.end(),
+			  [](const count_pair_t& a, const count_pair_t& b)
+			  {
+				return a.first > b.first ||
+					   (a.first == b.first && a.second < b.second);
+			  });
+
+	F32 inv_frames = frames ? 1.f / (F32)frames : 1.f;
+	llinfos << "Control group '" << getKey() << "': " << total
+			<< " lookups by name for " << sorted.size() << " controls over "
+			<< frames << " frames (" << (F32)total * inv_frames
+			<< " per frame):";
+	for (size_t i = 0, count = sorted.size(); i < count; ++i)
+	{
+		llcont << "\n" << sorted[i].second << ": " << sorted[i].first
+			   << " (" << (F32)sorted[i].first * inv_frames << "/frame)";
+	}
+	llcont << llendl;
 }
 
 eControlType LLControlGroup::typeStringToEnum(const std::string& typestr)
@@ -600,6 +660,7 @@ LLColor4 LLControlGroup::getColor(const char* name)
 {
 	LL_DEBUGS("GetControlCalls") << "Requested control: " << name << LL_ENDL;
 
+	countLookup(name);
 	ctrl_name_table_t::const_iterator i = mNameTable.find(name);
 
 	if (i != mNameTable.end())
@@ -38,6 +38,7 @@
 #include "boost/bind.hpp"
 #include "boost/signals2.hpp"
 
+#include "llfastmap.h"
 #include "llpointer.h"
 #include "llpreprocessor.h"
 #include "llstring.h"
@@ -344,13 +345,42 @@ public:
 	// Resets all ignorables
 	void resetWarnings();
 
+	// Lookups by name statistics, used to find out what code still calls
+	// getBool() and friends in hot paths, instead of using LLCachedControl.
+	void setTrackLookups(bool enable);
+	LL_INLINE bool getTrackLookups() const			{ return mTrackLookups; }
+	// Logs the controls looked up by name since the last call, sorted by
+	// decreasing number of lookups, with their average per frame over the
+	// passed number of rendered frames, then resets the counters.
+	void dumpLookupStats(U32 frames);
+
+private:
+	LL_INLINE void countLookup(const char* name)
+	{
+		if (mTrackLookups)
+		{
+			addLookup(name);
+		}
+	}
+
+	// Counts the lookup when done from the main thread. Lookups from other
+	// threads are ignored, since mLookupCounts is not thread-safe.
+	void addLookup(const char* name);
+
 protected:
-	typedef std::map<std::string, LLControlVariablePtr> ctrl_name_table_t;
+	// Note: with phmap, this hash map is searched via a transparent hash and
+	// comparator, so lookups by const char* do not need to construct a
+	// temporary std::string.
+	typedef fast_hmap<std::string, LLControlVariablePtr> ctrl_name_table_t;
 	ctrl_name_table_t		mNameTable;
 
 	std::set<std::string>	mWarnings;
 
 	std::string				mTypeString[TYPE_COUNT];
+
+	typedef fast_hmap<std::string, U32> lookup_counts_map_t;
+	lookup_counts_map_t		mLookupCounts;
+	bool					mTrackLookups;
 };
 
 // Publish/Subscribe object to interact with LLControlGroups.
@@ -40,6 +40,7 @@
 #include "llcolor3.h"
 #include "llcolor4.h"
 #include "llcolor4u.h"
+#include "llfastmap.h"
 #include "llvector3.h"
 #include "llvector3d.h"
 #include "llvector4.h"
@@ -926,6 +927,260 @@ bool LLXMLNode::getLayeredXMLNode(LLXMLNodePtr& root,
 	return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Binary serialization
+///////////////////////////////////////////////////////////////////////////////
+
+// Magic number ("LLXB") and format version for the binary trees.
+constexpr U32 XML_BINARY_MAGIC = 0x42584c4c;
+constexpr U32 XML_BINARY_VERSION = 1;
+
+typedef fast_hmap<const LLStringTableEntry*, U32> names_idx_map_t;
+
+static void binary_append_u32(std::string& buffer, U32 value)
+{
+	buffer.append((const char*)&value, sizeof(U32));
+}
+
+static void binary_append_string(std::string& buffer, const std::string& str)
+{
+	binary_append_u32(buffer, (U32)str.size());
+	buffer.append(str);
+}
+
+static U32 binary_name_index(names_idx_map_t& names,
+							 std::vector<const LLStringTableEntry*>& table,
+							 const LLStringTableEntry* name)
+{
+	names_idx_map_t::iterator it = names.find(name);
+	if (it != names.end())
+	{
+		return it->second;
+	}
+	U32 index = table.size();
+	names.emplace(name, index);
+	table.push_back(name);
+	return index;
+}
+
+static void binary_write_node(std::string& buffer, LLXMLNode* node,
+							  names_idx_map_t& names,
+							  std::vector<const LLStringTableEntry*>& table)
+{
+	binary_append_u32(buffer, binary_name_index(names, table,
+												node->getName()));
+	U8 header[3];
+	header[0] = node->mIsAttribute ? 1 : 0;
+	header[1] = (U8)node->mType;
+	header[2] = (U8)node->mEncoding;
+	buffer.append((const char*)header, 3);
+	binary_append_u32(buffer, node->mLength);
+	binary_append_u32(buffer, node->mPrecision);
+	binary_append_u32(buffer, node->mVersionMajor);
+	binary_append_u32(buffer, node->mVersionMinor);
+	binary_append_u32(buffer, (U32)node->mLineNumber);
+	binary_append_string(buffer, node->mID);
+	binary_append_string(buffer, node->getValue());
+
+	binary_append_u32(buffer, node->mAttributes.size());
+	for (LLXMLAttribList::iterator it = node->mAttributes.begin(),
+								   end = node->mAttributes.end();
+		 it != end; ++it)
+	{
+		binary_write_node(buffer, it->second, names, table);
+	}
+
+	binary_append_u32(buffer, node->getChildCount());
+	// Note: we must walk the linked list of children and not the children
+	// map, since the latter is sorted by name entry pointer and would thus
+	// not preserve the children order.
+	for (LLXMLNodePtr child = node->getFirstChild(); child.notNull();
+		 child = child->getNextSibling())
+	{
+		binary_write_node(buffer, child, names, table);
+	}
+}
+
+void LLXMLNode::writeBinary(std::string& buffer)
+{
+	names_idx_map_t names;
+	std::vector<const LLStringTableEntry*> table;
+	std::string nodes;
+	binary_write_node(nodes, this, names, table);
+
+	buffer.clear();
+	buffer.reserve(nodes.size() + 16 * table.size() + 12);
+	binary_append_u32(buffer, XML_BINARY_MAGIC);
+	binary_append_u32(buffer, XML_BINARY_VERSION);
+	binary_append_u32(buffer, table.size());
+	for (size_t i = 0, count = table.size(); i < count; ++i)
+	{
+		const char* str = table[i] ? table[i]->mString : "";
+		U32 len = strlen(str);
+		binary_append_u32(buffer, len);
+		buffer.append(str, len);
+	}
+	buffer.append(nodes);
+}
+
+class LLXMLBinaryReader
+{
+public:
+	LLXMLBinaryReader(const U8* buffer, size_t length)
+	:	mPtr(buffer),
+		mEnd(buffer + length)
+	{
+	}
+
+	LL_INLINE bool readU32(U32& value)
+	{
+		if (mEnd - mPtr < (S64)sizeof(U32))
+		{
+			return false;
+		}
+		memcpy((void*)&value, (const void*)mPtr, sizeof(U32));
+		mPtr += sizeof(U32);
+		return true;
+	}
+
+	LL_INLINE bool readBytes(U8* dest, U32 count)
+	{
+		if ((U64)(mEnd - mPtr) < (U64)count)
+		{
+			return false;
+		}
+		memcpy((void*)dest, (const void*)mPtr, count);
+		mPtr += count;
+		return true;
+	}
+
+	LL_INLINE bool readString(std::string& str)
+	{
+		U32 len;
+		if (!readU32(len) || (U64)(mEnd - mPtr) < (U64)len)
+		{
+			return false;
+		}
+		str.assign((const char*)mPtr, len);
+		mPtr += len;
+		return true;
+	}
+
+	bool readNode(LLXMLNodePtr& node, U32 depth)
+	{
+		// Guard against stack overflows on corrupted data.
+		constexpr U32 MAX_DEPTH = 256;
+		U32 name_idx;
+		U8 header[3];
+		if (depth > MAX_DEPTH || !readU32(name_idx) ||
+			name_idx >= mNames.size() || !readBytes(header, 3))
+		{
+			return false;
+		}
+		node = new LLXMLNode(mNames[name_idx], header[0] != 0);
+		node->mType = (LLXMLNode::ValueType)header[1];
+		node->mEncoding = (LLXMLNode::Encoding)header[2];
+		U32 line;
+		if (!readU32(node->mLength) || !readU32(node->mPrecision) ||
+			!readU32(node->mVersionMajor) || !readU32(node->mVersionMinor) ||
+			!readU32(line) || !readString(node->mID) ||
+			!readString(mValue))
+		{
+			return false;
+		}
+		node->mLineNumber = (S32)line;
+		node->setValue(mValue);
+		// setValue() turns TYPE_CONTAINER into TYPE_UNKNOWN: restore it.
+		node->mType = (LLXMLNode::ValueType)header[1];
+
+		U32 count;
+		if (!readU32(count))
+		{
+			return false;
+		}
+		LLXMLNodePtr child;
+		for (U32 i = 0; i < count; ++i)
+		{
+			if (!readNode(child, depth + 1))
+			{
+				return false;
+			}
+			node->addChild(child);
+		}
+
+		if (!readU32(count))
+		{
+			return false;
+		}
+		for (U32 i = 0; i < count; ++i)
+		{
+			if (!readNode(child, depth + 1))
+			{
+				return false;
+			}
+			node->addChild(child);
+		}
+
+		return true;
+	}
+
+	bool readNames()
+	{
+		U32 count;
+		if (!readU32(count) || (U64)count > (U64)(mEnd - mPtr))
+		{
+			return false;
+		}
+		mNames.reserve(count);
+		std::string name;
+		for (U32 i = 0; i < count; ++i)
+		{
+			if (!readString(name))
+			{
+				return false;
+			}
+			mNames.push_back(gStringTable.addStringEntry(name));
+		}
+		return true;
+	}
+
+private:
+	const U8*							mPtr;
+	const U8*							mEnd;
+	std::vector<LLStringTableEntry*>	mNames;
+	std::string							mValue;
+};
+
+//static
+bool LLXMLNode::parseBinary(const U8* buffer, size_t length,
+							LLXMLNodePtr& node)
+{
+	node = NULL;
+	if (!buffer)
+	{
+		return false;
+	}
+
+	LLXMLBinaryReader reader(buffer, length);
+	U32 magic, version;
+	if (!reader.readU32(magic) || magic != XML_BINARY_MAGIC ||
+		!reader.readU32(version) || version != XML_BINARY_VERSION)
+	{
+		LL_DEBUGS("XMLNode") << "Not a binary XML tree or wrong version"
+							 << LL_ENDL;
+		return false;
+	}
+
+	if (!reader.readNames() || !reader.readNode(node, 0))
+	{
+		llwarns << "Corrupted binary XML tree data" << llendl;
+		node = NULL;
+		return false;
+	}
+
+	return true;
+}
+
 // static
 void LLXMLNode::writeHeaderToFile(LLFILE* out_file)
 {
@@ -152,6 +152,16 @@ public:
 	static bool getLayeredXMLNode(LLXMLNodePtr& root,
 								  const std::vector<std::string>& paths);
 
+	// Compact binary serialization of a whole node tree, used to cache the
+	// result of parsing and merging XML files. Node and attribute names are
+	// stored only once (in a strings table, interned again on load) and the
+	// children order is preserved. Note that the data is written in native
+	// endianness: it is only meant for local caching purposes.
+	void writeBinary(std::string& buffer);
+	// Returns false (and a NULL node) when the data is invalid or truncated.
+	static bool parseBinary(const U8* buffer, size_t length,
+							LLXMLNodePtr& node);
+
 	// Write standard XML file header:
 	// <?xml version="1.0" encoding="utf-8" standalone="yes" ?>
 	static void writeHeaderToFile(LLFILE* out_file);
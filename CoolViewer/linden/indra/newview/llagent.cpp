@@ -62,6 +62,7 @@
 #include "llappviewer.h"
 #include "llavatartracker.h"
 #include "llchatbar.h"
+#include "llcontrolhandles.h"
 #include "lldrawable.h"
 #include "llface.h"
 #include "llfirstuse.h"
@@ -2492,7 +2493,7 @@ void LLAgent::startTyping()
 		}
 	}
 
-	if (gSavedSettings.getBool("PlayTypingAnim"))
+	if (LLCtrl::PlayTypingAnim())
 	{
 		sendAnimationRequest(ANIM_AGENT_TYPE, ANIM_REQUEST_START);
 	}
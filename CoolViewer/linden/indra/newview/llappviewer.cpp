@@ -85,6 +85,7 @@
 #include "llspellcheck.h"
 #include "llsys.h"
 #include "lltexteditor.h"
+#include "llthreadpool.h"
 #include "lltrans.h"
 #include "lluictrlfactory.h"
 #include "lluitrans.h"
@@ -168,6 +169,7 @@
 #include "llviewermenu.h"
 #include "llviewermessage.h"		// For send_agent_update()
 #include "llviewerobjectlist.h"
+#include "llvieweroctree.h"
 #include "llviewerparcelmedia.h"
 #include "llviewerparcelmgr.h"
 #include "llviewerpartsim.h"
@@ -1018,6 +1020,9 @@ LLApp::InitState LLAppViewer::init()
   //mk
 
   LLFontGL::setUseBatchedRender(gSavedSettings.getBool("RenderBatchedGlyphs"));
+  LLFontGL::setUseTextRunsCache(gSavedSettings.getBool("RenderTextRunsCache"));
+  LLViewerOctreeBounds::sUseSnapshots =
+    gSavedSettings.getBool("RenderBatchedFrustumChecks");
 
   // Do any necessary setup for accepting incoming SLURLs and Lua commands
   // from apps
@@ -2081,6 +2086,10 @@ bool LLAppViewer::cleanup()
   llinfos << "Image caching/fetching/decoding threads destroyed."
     << llendl;
 
+  delete gThreadPoolp;
+  gThreadPoolp = NULL;
+  llinfos << "Worker threads pool destroyed." << llendl;
+
   // Note: LLViewerMedia::cleanupClass() has to be put before
   // gTextureList.shutdown() because some new image might be generated
   // during cleaning up media. --bao
@@ -2252,6 +2261,10 @@ void LLAppViewer::initThreads()
   gTextureFetchp = new LLTextureFetch(gTextureCachep, gImageDecodeThreadp);
   LLImage::initClass();
 
+  // Worker threads pool used by the renderer
+  U32 pool_threads = gSavedSettings.getU32("NumWorkerPoolThreads");
+  gThreadPoolp = new LLThreadPool("Worker pool", pool_threads);
+
   // Mesh streaming and caching
   gMeshRepo.init();
 }
@@ -2834,6 +2847,7 @@ bool LLAppViewer::initWindow()
 
   // We can now (potentially) enable this.
   LLView::sDebugRects = gSavedSettings.getBool("DebugViews");
+  LLView::sUseChildIndex = gSavedSettings.getBool("UIChildViewIndex");
 
   llinfos << "Window initialization done." << llendl;
   return true;
@@ -3602,6 +3616,15 @@ bool LLAppViewer::initCache()
   S64 extra = gTextureCachep->initCache(LL_PATH_CACHE, texture_cache_size);
   texture_cache_size -= extra;
 
+  // Binary cache for the merged XUI files
+  bool use_xui_cache = gSavedSettings.getBool("XUIBinaryCache");
+  LLUICtrlFactory::setUseXUICache(use_xui_cache);
+  if (use_xui_cache && !read_only)
+  {
+    LLUICtrlFactory::setXUICacheDir(gDirUtilp->getExpandedFilename(LL_PATH_CACHE,
+                                                                   "xui"));
+  }
+
 #if 0	// We now initialize the object cache after login, so that it can take
   // the grid name into account and keep cached regions on a per-grid
   // basis. HB
@@ -3610,7 +3633,8 @@ bool LLAppViewer::initCache()
 #endif
 
   LLSplashScreen::update("Initializing asset cache...");
-  LLDiskCache::init(assets_cache_size, read_only);
+  LLDiskCache::init(assets_cache_size, read_only,
+                    gSavedSettings.getBool("AssetsCachePackStore"));
   if (!read_only)
   {
     if (gSavedSettings.getBool("ClearAssetsCache"))
@@ -3635,6 +3659,8 @@ void LLAppViewer::purgeCache()
   gTextureCachep->purgeCache(LL_PATH_CACHE);
   LLVOCache::getInstance()->removeCache(LL_PATH_CACHE);
   LLDiskCache::clear();
+  LLDirIterator::deleteFilesInDir(gDirUtilp->getExpandedFilename(LL_PATH_CACHE,
+                                                                 "xui"));
   LLDirIterator::deleteFilesInDir(gDirUtilp->getCacheDir());
 }
 
@@ -3911,6 +3937,8 @@ void LLAppViewer::idle(bool run_rlv_maintenance)
   // Global frame timer. Smoothly weight toward current frame
   gFPSClamped = (frame_rate_clamped + 4.f * gFPSClamped) / 5.f;
 
+  settings_log_lookups();
+
   static LLCachedControl<F32> qas(gSavedSettings, "QuitAfterSeconds");
   if (qas > 0.f)
   {
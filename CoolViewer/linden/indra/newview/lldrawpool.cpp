@@ -313,19 +313,144 @@ void LLRenderPass::renderTexture(U32 type, U32 mask, bool batch_textures)
 	pushBatches(type, mask, true, batch_textures);
 }
 
+// Returns true when 'b' may be drawn together with 'a' in the same
+// glMultiDrawElements() call, i.e. when pushBatch() would not alter any
+// state between the two draws.
+static bool can_merge_batches(const LLDrawInfo& a, const LLDrawInfo& b,
+							  bool texture, bool batch_textures)
+{
+	if (!b.mCount || a.mVertexBuffer.isNull() ||
+		a.mVertexBuffer != b.mVertexBuffer || a.mGroup != b.mGroup ||
+		a.mModelMatrix != b.mModelMatrix || a.mDrawMode != b.mDrawMode)
+	{
+		return false;
+	}
+	if (!texture)
+	{
+		return true;
+	}
+	if (a.mTextureMatrix || b.mTextureMatrix)
+	{
+		return false;
+	}
+	if (batch_textures &&
+		(a.mTextureList.size() > 1 || b.mTextureList.size() > 1))
+	{
+		return a.mTextureList == b.mTextureList;
+	}
+	return a.mTexture == b.mTexture;
+}
+
 void LLRenderPass::pushBatches(U32 type, U32 mask, bool texture,
 							   bool batch_textures)
 {
+	static LLCachedControl<bool> multi_draw(gSavedSettings,
+											"RenderMultiDrawBatches");
+	bool can_merge = multi_draw && canMergeBatches();
+
+	static std::vector<LLDrawInfo*> batch;
+
 	for (LLCullResult::drawinfo_iterator i = gPipeline.beginRenderMap(type),
 										 end = gPipeline.endRenderMap(type);
-		 i != end; ++i)
+		 i != end; )
 	{
-		LLDrawInfo* pparams = *i;
-		if (pparams)
+		LLDrawInfo* pparams = *i++;
+		if (!pparams)
+		{
+			continue;
+		}
+
+		if (can_merge && pparams->mCount)
+		{
+			// Gather the following draw infos that may be drawn together
+			// with this one.
+			while (i != end && *i &&
+				   can_merge_batches(*pparams, **i, texture, batch_textures))
+			{
+				if (batch.empty())
+				{
+					batch.push_back(pparams);
+				}
+				batch.push_back(*i++);
+			}
+		}
+
+		if (batch.empty())
 		{
 			pushBatch(*pparams, mask, texture, batch_textures);
 		}
+		else
+		{
+			pushMultiBatch(batch, mask, texture, batch_textures);
+			batch.clear();
+		}
+	}
+}
+
+void LLRenderPass::pushMultiBatch(std::vector<LLDrawInfo*>& batch, U32 mask,
+								  bool texture, bool batch_textures)
+{
+	LLDrawInfo& params = *batch[0];
+	applyModelMatrix(params);
+
+	U32 count = batch.size();
+
+	if (texture)
+	{
+		if (batch_textures && params.mTextureList.size() > 1)
+		{
+			for (U32 i = 0, tex_count = params.mTextureList.size();
+				 i < tex_count; ++i)
+			{
+				const LLPointer<LLViewerTexture>& tex = params.mTextureList[i];
+				if (tex.notNull())
+				{
+					gGL.getTexUnit(i)->bind(tex);
+				}
+			}
+		}
+		else if (params.mTexture.notNull())
+		{
+			for (U32 i = 0; i < count; ++i)
+			{
+				params.mTexture->addTextureStats(batch[i]->mVSize);
+			}
+			gGL.getTexUnit(0)->bind(params.mTexture);
+		}
+		else
+		{
+			gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+		}
+	}
+
+	if (params.mGroup)
+	{
+		params.mGroup->rebuildMesh();
 	}
+
+	static std::vector<S32> counts;
+	static std::vector<U32> offsets;
+	counts.resize(count);
+	offsets.resize(count);
+	U32 start = params.mStart;
+	U32 end = params.mEnd;
+	U32 total = 0;
+	for (U32 i = 0; i < count; ++i)
+	{
+		const LLDrawInfo* drawinfo = batch[i];
+		counts[i] = drawinfo->mCount;
+		offsets[i] = drawinfo->mOffset;
+		start = llmin(start, (U32)drawinfo->mStart);
+		end = llmax(end, (U32)drawinfo->mEnd);
+		total += drawinfo->mCount;
+	}
+
+	params.mVertexBuffer->setBuffer(mask);
+	params.mVertexBuffer->drawMultiRange(params.mDrawMode, start, end,
+										 counts.data(), offsets.data(),
+										 count);
+	gPipeline.addTrianglesDrawn(total, params.mDrawMode);
+	gPipeline.mDrawCallsSaved += count - 1;
 }
 
 void LLRenderPass::pushMaskBatches(U32 type, U32 mask, bool texture,
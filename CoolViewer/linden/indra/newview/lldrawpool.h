@@ -184,6 +184,13 @@ public:
 								 bool batch_textures = false);
 	virtual void pushBatch(LLDrawInfo& params, U32 mask, bool texture,
 						   bool batch_textures = false);
+	// Draws with a single call a list of draw infos sharing the same vertex
+	// buffer and rendering state (see pushBatches()).
+	void pushMultiBatch(std::vector<LLDrawInfo*>& batch, U32 mask,
+						bool texture, bool batch_textures);
+	// Pools overriding pushBatch() to set up a per-draw info state must
+	// return false here, so that pushBatches() never merges their batches.
+	LL_INLINE virtual bool canMergeBatches() const		{ return true; }
 	virtual void renderGroup(LLSpatialGroup* group, U32 type, U32 mask,
 							 bool texture = true);
 	virtual void renderGroups(U32 type, U32 mask, bool texture = true);
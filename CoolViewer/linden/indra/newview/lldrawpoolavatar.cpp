@@ -38,6 +38,7 @@
 #include "llmatrix4a.h"
 #include "llnoise.h"
 #include "llrenderutils.h"			// For gSphere
+#include "llthreadpool.h"
 #include "llvolume.h"
 
 #include "llagent.h"
@@ -1952,7 +1953,8 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(LLVOAvatar* avatar,
 													LLFace* face,
 													LLVOVolume* vobj,
 													LLVolume* volume,
-													const LLVolumeFace& vol_face)
+													const LLVolumeFace& vol_face,
+													LLFace::geom_jobs_t* jobs)
 {
 	LLVector4a* weights = vol_face.mWeights;
 	if (!weights)	// A rather common occurrence
@@ -2049,39 +2051,33 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(LLVOAvatar* avatar,
 	}
 	LLVector4a* norm = has_normal ? (LLVector4a*)normal.get() : NULL;
 
-	// Build matrix palette
+	// Build matrix palette, with the bind shape matrix pre-applied
 	if (!skin)
 	{
 		skin = vobj->getSkinInfo();
 	}
 	U32 count = 0;
-	const LLMatrix4a* mat = avatar->getRiggedMatrix4a(skin, count);
+	const LLMatrix4a* mat = avatar->getBoundRiggedMatrix4a(skin, count);
 	LLSkinningUtil::checkSkinWeights(weights, buffer->getNumVerts(), skin);
 
-	LLMatrix4a bind_shape_matrix;
-	bind_shape_matrix.loadu(skin->mBindShapeMatrix);
-
 	count = buffer->getNumVerts();
-	LLVector4a t, dst;
-	LLMatrix4a final_mat;
-	for (U32 j = 0; j < count; ++j)
+	const LLVector4a* positions = vol_face.mPositions;
+	const LLVector4a* normals = vol_face.mNormals;
+	auto skin_job = [=]()
 	{
-		final_mat.clear();
-		LLSkinningUtil::getPerVertexSkinMatrix(weights[j], mat, final_mat);
-
-		LLVector4a& v = vol_face.mPositions[j];
-		bind_shape_matrix.affineTransform(v, t);
-		final_mat.affineTransform(t, dst);
-		pos[j] = dst;
-
-		if (norm)
-		{
-			LLVector4a& n = vol_face.mNormals[j];
-			bind_shape_matrix.rotate(n, t);
-			final_mat.rotate(t, dst);
-			dst.normalize3fast();
-			norm[j] = dst;
-		}
+		LLSkinningUtil::skinVertices(mat, weights, positions, normals, count,
+									 pos, norm);
+	};
+	if (jobs)
+	{
+		// Note: the palette is cached per mesh and per frame by the avatar,
+		// and the mapped buffer is kept alive by the face, so both stay valid
+		// till the jobs are run by updateRiggedVertexBuffers().
+		jobs->emplace_back(skin_job);
+	}
+	else
+	{
+		skin_job();
 	}
 }
 
@@ -2445,6 +2441,18 @@ void LLDrawPoolAvatar::updateRiggedVertexBuffers(LLVOAvatar* avatar)
 {
 	LL_FAST_TIMER(FTM_RIGGED_VBO);
 
+	// When software skinning is used, the faces get skinned in parallel in
+	// the worker threads, once all their buffers have been mapped here.
+	static LLFace::geom_jobs_t jobs;
+	static LLCachedControl<bool> parallel(gSavedSettings,
+										  "RenderParallelSkinning");
+	LLFace::geom_jobs_t* jobsp = NULL;
+	if (sShaderLevel == 0 && parallel && gThreadPoolp &&
+		gThreadPoolp->getSize())
+	{
+		jobsp = &jobs;
+	}
+
 	// Update rigged vertex buffers
 	for (U32 type = 0; type < NUM_RIGGED_PASSES; ++type)
 	{
@@ -2477,9 +2485,21 @@ void LLDrawPoolAvatar::updateRiggedVertexBuffers(LLVOAvatar* avatar)
 			}
 
 			const LLVolumeFace& vol_face = volume->getVolumeFace(te);
-			updateRiggedFaceVertexBuffer(avatar, face, vobj, volume, vol_face);
+			updateRiggedFaceVertexBuffer(avatar, face, vobj, volume, vol_face,
+										 jobsp);
 		}
 	}
+
+	U32 count = jobs.size();
+	if (count == 1)
+	{
+		jobs[0]();
+	}
+	else if (count)
+	{
+		gThreadPoolp->parallelFor(count, [](U32 i) { jobs[i](); });
+	}
+	jobs.clear();
 }
 
 void LLDrawPoolAvatar::renderRiggedSimple(LLVOAvatar* avatar)
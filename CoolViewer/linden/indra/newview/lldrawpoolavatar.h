@@ -34,12 +34,12 @@
 #define LL_LLDRAWPOOLAVATAR_H
 
 #include "lldrawpool.h"
+#include "llface.h"
 //MK
 #include "llvoavatar.h"
 //mk
 
 class LLGLSLShader;
-class LLFace;
 class LLMeshSkinInfo;
 class LLVolume;
 class LLVolumeFace;
@@ -296,7 +296,8 @@ public:
 private:
 	void updateRiggedFaceVertexBuffer(LLVOAvatar* avatar, LLFace* facep,
 									  LLVOVolume* vobj, LLVolume* volume,
-									  const LLVolumeFace& vol_face);
+									  const LLVolumeFace& vol_face,
+									  LLFace::geom_jobs_t* jobs = NULL);
 	void riggedFaceError(LLVOAvatar* avatar, const LLVolumeFace& vol_face,
 						 LLVOVolume* vobj);
 	F32* getRiggedMatrix(LLVOAvatar* avatar, const LLMeshSkinInfo* skin,
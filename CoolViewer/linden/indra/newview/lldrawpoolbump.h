@@ -71,6 +71,7 @@ public:
 	void prerender() override;
 	void pushBatch(LLDrawInfo& params, U32 mask, bool texture,
 				   bool batch_textures = false) override;
+	LL_INLINE bool canMergeBatches() const override		{ return false; }
 
 	void renderBump(U32 type, U32 mask);
 	void renderGroup(LLSpatialGroup* group, U32 type, U32 mask,
@@ -77,6 +77,7 @@ public:
 
 	void pushBatch(LLDrawInfo& params, U32 mask, bool texture,
 				   bool batch_textures = false) override;
+	LL_INLINE bool canMergeBatches() const override		{ return false; }
 
 private:
 	LLGLSLShader* mShader;
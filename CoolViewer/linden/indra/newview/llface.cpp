@@ -107,6 +107,59 @@ void planarProjection(LLVector2& tc, const LLVector4a& normal,
 	tc.mV[0] = 2.f * binormal.dot3(vec).getF32() + 0.5f;
 }
 
+// Same as planarProjection(), for 4 vertices at once, with 'positions' not
+// yet scaled. The texture coordinates are returned in structure of arrays
+// form ('s' and 't' components in separate registers).
+static LL_INLINE void planarProjection4(const LLVector4a* normals,
+										const LLVector4a* positions,
+										const LLVector4a& scale,
+										__m128& s, __m128& t)
+{
+	__m128 nx = normals[0];
+	__m128 ny = normals[1];
+	__m128 nz = normals[2];
+	__m128 nw = normals[3];
+	_MM_TRANSPOSE4_PS(nx, ny, nz, nw);
+
+	__m128 px = positions[0];
+	__m128 py = positions[1];
+	__m128 pz = positions[2];
+	__m128 pw = positions[3];
+	_MM_TRANSPOSE4_PS(px, py, pz, pw);
+	px = _mm_mul_ps(px, _mm_set1_ps(scale[0]));
+	py = _mm_mul_ps(py, _mm_set1_ps(scale[1]));
+	pz = _mm_mul_ps(pz, _mm_set1_ps(scale[2]));
+
+	// Binormal selection, as done in planarProjection() (its Z is always 0)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 minus_one = _mm_set1_ps(-1.f);
+	__m128 neg = _mm_cmple_ps(nx, _mm_set1_ps(-0.5f));
+	__m128 pos = _mm_cmpge_ps(nx, _mm_set1_ps(0.5f));
+	__m128 y_pos = _mm_cmpgt_ps(ny, zero);
+	__m128 by = _mm_or_ps(_mm_and_ps(neg, minus_one), _mm_and_ps(pos, one));
+	__m128 bx = _mm_andnot_ps(_mm_or_ps(neg, pos),
+							  _mm_or_ps(_mm_and_ps(y_pos, minus_one),
+										_mm_andnot_ps(y_pos, one)));
+
+	// tangent = binormal x normal, computed like LLVector4a::setCross3()
+	__m128 tx = _mm_sub_ps(_mm_mul_ps(by, nz), _mm_mul_ps(zero, ny));
+	__m128 ty = _mm_sub_ps(_mm_mul_ps(zero, nx), _mm_mul_ps(bx, nz));
+	__m128 tz = _mm_sub_ps(_mm_mul_ps(bx, ny), _mm_mul_ps(by, nx));
+
+	// Dot products, in the same order as LLVector4a::dot3()
+	__m128 b_dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, px),
+										 _mm_mul_ps(by, py)),
+							  _mm_mul_ps(zero, pz));
+	__m128 t_dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px),
+										 _mm_mul_ps(ty, py)),
+							  _mm_mul_ps(tz, pz));
+
+	const __m128 half = _mm_set1_ps(0.5f);
+	s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.f), b_dot), half);
+	t = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-2.f), t_dot), half);
+}
+
 void LLFace::init(LLDrawable* drawablep, LLViewerObject* objp)
 {
 	mLastUpdateTime = gFrameTimeSeconds;
@@ -796,6 +849,30 @@ static void xform4a(LLVector4a& tex_coord, const LLVector4a& trans,
 	tex_coord.setAdd(st, offset);
 }
 
+// Fills 'count' colors with 'rgba', without overflowing on the colors of the
+// next face in the buffer, which may be rebuilt at the same time by another
+// thread.
+static void fill_colors(U32* dst, U32 rgba, S32 count)
+{
+	S32 i = 0;
+#if defined(__AVX2__)
+	const __m256i src8 = _mm256_set1_epi32(rgba);
+	for ( ; i + 8 <= count; i += 8)
+	{
+		_mm256_storeu_si256((__m256i*)(dst + i), src8);
+	}
+#endif
+	const __m128i src4 = _mm_set1_epi32(rgba);
+	for ( ; i + 4 <= count; i += 4)
+	{
+		_mm_store_si128((__m128i*)(dst + i), src4);
+	}
+	for ( ; i < count; ++i)
+	{
+		dst[i] = rgba;
+	}
+}
+
 #if LL_DEBUG
 // Defined in llspatialpartition.cpp
 extern LLVector4a gOctreeMaxMag;
@@ -1170,7 +1247,8 @@ bool LLFace::canRenderAsMask()
 bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 							   const LLMatrix4& mat_vert_in,
 							   const LLMatrix3& mat_norm_in,
-							   const U16& index_offset, bool force_rebuild)
+							   const U16& index_offset, bool force_rebuild,
+							   geom_jobs_t* jobs)
 {
 	LL_FAST_TIMER(FTM_FACE_GET_GEOM);
 	llassert(verify());
@@ -1364,6 +1442,33 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 		}
 	}
 
+	// The CPU-bound parts of the rebuild (vertex data transforms and fills)
+	// only touch the mapped buffer memory and the volume face data; when
+	// 'jobs' is not NULL, they are queued there instead of being ran now, so
+	// that the caller may run them in parallel for several faces before
+	// flushing the buffers. Everything touching the GL state or any shared
+	// data (buffers mapping, tangents generation, etc) is still done here, on
+	// the main thread.
+#if USE_MAP_RANGE
+	if (map_range)
+	{
+		// Each step flushes its buffer range, so we cannot defer them.
+		jobs = NULL;
+	}
+#endif
+	auto run_job = [jobs](const auto& job)
+	{
+		if (jobs)
+		{
+			jobs->emplace_back(job);
+		}
+		else
+		{
+			job();
+		}
+	};
+	const LLVolumeFace* vfp = &vf;
+
     // INDICES
 	bool result;
 	if (full_rebuild)
@@ -1377,27 +1482,32 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 			return false;
 		}
 
-		volatile __m128i* dst = (__m128i*)indicesp.get();
-		__m128i* src = (__m128i*)vf.mIndices;
-		__m128i offset = _mm_set1_epi16(index_offset);
-
-		S32 end = num_indices / 8;
-
-		for (S32 i = 0; i < end; ++i)
+		U16* indices = indicesp.get();
+		U16 idx_offset = index_offset;
+		run_job([vfp, indices, idx_offset, num_indices]()
 		{
-			__m128i res = _mm_add_epi16(src[i], offset);
-			_mm_storeu_si128((__m128i*)dst++, res);
-		}
+			volatile __m128i* dst = (__m128i*)indices;
+			__m128i* src = (__m128i*)vfp->mIndices;
+			__m128i offset = _mm_set1_epi16(idx_offset);
 
-		{
-			LL_FAST_TIMER(FTM_FACE_GEOM_INDEX_TAIL);
-			U16* idx = (U16*)dst;
+			S32 end = num_indices / 8;
 
-			for (S32 i = end * 8; i < num_indices; ++i)
+			for (S32 i = 0; i < end; ++i)
 			{
-				*idx++ = vf.mIndices[i] + index_offset;
+				__m128i res = _mm_add_epi16(src[i], offset);
+				_mm_storeu_si128((__m128i*)dst++, res);
 			}
-		}
+
+			{
+				LL_FAST_TIMER(FTM_FACE_GEOM_INDEX_TAIL);
+				U16* idx = (U16*)dst;
+
+				for (S32 i = end * 8; i < num_indices; ++i)
+				{
+					*idx++ = vfp->mIndices[i] + idx_offset;
+				}
+			}
+		});
 
 #if USE_MAP_RANGE
 		if (map_range)
@@ -1436,7 +1546,8 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 		LLVector4a bump_t_prim_light_ray(0.f, 0.f, 0.f);
 
 		LLQuaternion bump_quat;
-		if (mDrawablep->isActive())
+		bool is_active = mDrawablep->isActive();
+		if (is_active)
 		{
 			bump_quat = LLQuaternion(mDrawablep->getRenderMatrix());
 		}
@@ -1550,6 +1661,11 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 				mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TEXCOORD2);
 		}
 		bool do_tex_mat = tex_mode && mTextureMatrix;
+		LLMatrix4 tex_mat;
+		if (do_tex_mat)
+		{
+			tex_mat = *mTextureMatrix;
+		}
 
 		if (!do_bump)
 		{
@@ -1562,6 +1678,7 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 				llwarns << "getTexCoord0Strider() failed !" << llendl;
 				return false;
 			}
+			LLVector2* tc0 = tex_coords0.get();
 
 			if (texgen != LLTextureEntry::TEX_GEN_PLANAR)
 			{
@@ -1570,103 +1687,175 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 				{
 					if (!do_xform)
 					{
-						LL_FAST_TIMER(FTM_FACE_TEX_QUICK_NO_XFORM);
-						S32 tc_size = (num_vertices * 2 * sizeof(F32) + 0xF) &
-									  ~0xF;
-						LLVector4a::memcpyNonAliased16((F32*)tex_coords0.get(),
-													   (F32*)vf.mTexCoords,
-													   tc_size);
+						run_job([vfp, tc0, num_vertices]()
+						{
+							LL_FAST_TIMER(FTM_FACE_TEX_QUICK_NO_XFORM);
+							// Note: only copy the texture coordinates of this
+							// face, without overflowing on the next face ones
+							// when their number is odd.
+							S32 tc_size = (num_vertices & ~1) * 2 *
+										  sizeof(F32);
+							if (tc_size)
+							{
+								LLVector4a::memcpyNonAliased16((F32*)tc0,
+															   (F32*)vfp->mTexCoords,
+															   tc_size);
+							}
+							if (num_vertices & 1)
+							{
+								tc0[num_vertices - 1] =
+									vfp->mTexCoords[num_vertices - 1];
+							}
+						});
 					}
 					else
 					{
-						LL_FAST_TIMER(FTM_FACE_TEX_QUICK_XFORM);
-						F32* dst = (F32*)tex_coords0.get();
-						LLVector4a* src = (LLVector4a*)vf.mTexCoords;
+						run_job([vfp, tc0, num_vertices, cos_ang, sin_ang,
+								 os, ot, ms, mt]()
+						{
+							LL_FAST_TIMER(FTM_FACE_TEX_QUICK_XFORM);
+							F32* dst = (F32*)tc0;
+							LLVector4a* src = (LLVector4a*)vfp->mTexCoords;
 
-						LLVector4a trans;
-						trans.splat(-0.5f);
+							LLVector4a trans;
+							trans.splat(-0.5f);
 
-						LLVector4a rot0;
-						rot0.set(cos_ang, -sin_ang, cos_ang, -sin_ang);
+							LLVector4a rot0;
+							rot0.set(cos_ang, -sin_ang, cos_ang, -sin_ang);
 
-						LLVector4a rot1;
-						rot1.set(sin_ang, cos_ang, sin_ang, cos_ang);
+							LLVector4a rot1;
+							rot1.set(sin_ang, cos_ang, sin_ang, cos_ang);
 
-						LLVector4a scale;
-						scale.set(ms, mt, ms, mt);
+							LLVector4a scale;
+							scale.set(ms, mt, ms, mt);
 
-						LLVector4a offset;
-						offset.set(os + 0.5f, ot + 0.5f, os + 0.5f, ot + 0.5f);
+							LLVector4a offset;
+							offset.set(os + 0.5f, ot + 0.5f, os + 0.5f,
+									   ot + 0.5f);
 
-						LLVector4Logical mask;
-						mask.clear();
-						mask.setElement<2>();
-						mask.setElement<3>();
+							LLVector4Logical mask;
+							mask.clear();
+							mask.setElement<2>();
+							mask.setElement<3>();
 
-						U32 count = num_vertices / 2 + num_vertices % 2;
-						for (U32 i = 0; i < count; ++i)
-						{
-							LLVector4a res = *src++;
-							xform4a(res, trans, mask, rot0, rot1, offset,
-									scale);
-							res.store4a(dst);
-							dst += 4;
-						}
+							U32 count = num_vertices / 2;
+							U32 i = 0;
+#if defined(__AVX2__)
+							// Four texture coordinates per iteration, with the
+							// same operations as xform4a().
+							const __m256 trans8 = _mm256_set1_ps(-0.5f);
+							const __m256 rot0_8 =
+								_mm256_broadcast_ps((__m128*)rot0.getF32ptr());
+							const __m256 rot1_8 =
+								_mm256_broadcast_ps((__m128*)rot1.getF32ptr());
+							const __m256 scale8 =
+								_mm256_broadcast_ps((__m128*)scale.getF32ptr());
+							const __m256 offset8 =
+								_mm256_broadcast_ps((__m128*)offset.getF32ptr());
+							for ( ; i + 2 <= count; i += 2)
+							{
+								__m256 st =
+									_mm256_add_ps(_mm256_loadu_ps((F32*)src),
+												  trans8);
+								__m256 ss = _mm256_permute_ps(st, 0xa0);
+								__m256 tt = _mm256_permute_ps(st, 0xf5);
+								st = _mm256_add_ps(_mm256_mul_ps(rot0_8, ss),
+												   _mm256_mul_ps(rot1_8, tt));
+								st = _mm256_add_ps(_mm256_mul_ps(st, scale8),
+												   offset8);
+								_mm256_storeu_ps(dst, st);
+								src += 2;
+								dst += 8;
+							}
+#endif
+							for ( ; i < count; ++i)
+							{
+								LLVector4a res = *src++;
+								xform4a(res, trans, mask, rot0, rot1, offset,
+										scale);
+								res.store4a(dst);
+								dst += 4;
+							}
+							if (num_vertices & 1)
+							{
+								// Last, odd coordinate: do not overflow on
+								// the next face ones.
+								LLVector4a res = *src;
+								xform4a(res, trans, mask, rot0, rot1, offset,
+										scale);
+								dst[0] = res[0];
+								dst[1] = res[1];
+							}
+						});
 					}
 				}
 				else
 				{
 					// Do tex mat, no texgen, no bump
-					for (S32 i = 0; i < num_vertices; ++i)
+					run_job([vfp, tc0, num_vertices, tex_mat]()
 					{
-						LLVector2 tc(vf.mTexCoords[i]);
-						LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
-						tmp = tmp * *mTextureMatrix;
-						tc.mV[0] = tmp.mV[0];
-						tc.mV[1] = tmp.mV[1];
-						*tex_coords0++ = tc;
-					}
+						LLVector2* dst = tc0;
+						for (S32 i = 0; i < num_vertices; ++i)
+						{
+							LLVector2 tc(vfp->mTexCoords[i]);
+							LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
+							tmp = tmp * tex_mat;
+							tc.mV[0] = tmp.mV[0];
+							tc.mV[1] = tmp.mV[1];
+							*dst++ = tc;
+						}
+					});
 				}
 			}
 			else
 			{
 				// No bump, tex gen planar
-				LL_FAST_TIMER(FTM_FACE_TEX_QUICK_PLANAR);
-				if (do_tex_mat)
-				{
-					for (S32 i = 0; i < num_vertices; ++i)
-					{
-						LLVector2 tc(vf.mTexCoords[i]);
-						LLVector4a& norm = vf.mNormals[i];
-						LLVector4a& center = *(vf.mCenter);
-						LLVector4a vec = vf.mPositions[i];
-						vec.mul(scalea);
-						planarProjection(tc, norm, center, vec);
-
-						LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
-						tmp = tmp * *mTextureMatrix;
-						tc.mV[0] = tmp.mV[0];
-						tc.mV[1] = tmp.mV[1];
-
-						*tex_coords0++ = tc;
-					}
-				}
-				else
+				run_job([vfp, tc0, num_vertices, scalea, do_tex_mat, tex_mat,
+						 cos_ang, sin_ang, os, ot, ms, mt]()
 				{
+					LL_FAST_TIMER(FTM_FACE_TEX_QUICK_PLANAR);
+					LLVector2* dst = tc0;
+					const LLVector4a& center = *(vfp->mCenter);
+					F32 sv[4], tv[4];
 					for (S32 i = 0; i < num_vertices; ++i)
 					{
-						LLVector2 tc(vf.mTexCoords[i]);
-						LLVector4a& norm = vf.mNormals[i];
-						LLVector4a& center = *(vf.mCenter);
-						LLVector4a vec = vf.mPositions[i];
-						vec.mul(scalea);
-						planarProjection(tc, norm, center, vec);
-
-						xform(tc, cos_ang, sin_ang, os, ot, ms, mt);
-
-						*tex_coords0++ = tc;
+						LLVector2 tc;
+						S32 j = i & 3;
+						if (j == 0 && i + 4 <= num_vertices)
+						{
+							// Project the next 4 vertices at once
+							__m128 s, t;
+							planarProjection4(vfp->mNormals + i,
+											  vfp->mPositions + i, scalea,
+											  s, t);
+							_mm_storeu_ps(sv, s);
+							_mm_storeu_ps(tv, t);
+						}
+						if (i + 4 - j <= num_vertices)
+						{
+							tc.set(sv[j], tv[j]);
+						}
+						else
+						{
+							LLVector4a vec = vfp->mPositions[i];
+							vec.mul(scalea);
+							planarProjection(tc, vfp->mNormals[i], center,
+											 vec);
+						}
+						if (do_tex_mat)
+						{
+							LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
+							tmp = tmp * tex_mat;
+							tc.mV[0] = tmp.mV[0];
+							tc.mV[1] = tmp.mV[1];
+						}
+						else
+						{
+							xform(tc, cos_ang, sin_ang, os, ot, ms, mt);
+						}
+						*dst++ = tc;
 					}
-				}
+				});
 			}
 
 #if USE_MAP_RANGE
@@ -1680,7 +1869,6 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 		{
 			// Bump mapped or has material, just do the whole expensive loop
 			LL_FAST_TIMER(FTM_FACE_TEX_DEFAULT);
-			std::vector<LLVector2> bump_tc;
 
 			if (mat && mat->getNormalID().notNull())
 			{
@@ -1689,8 +1877,11 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 				do_bump = false;
 			}
 
+			// Fetch the destination of each channel, together with its
+			// texture transform parameters.
+			LLVector2* channels[3] = { NULL, NULL, NULL };
+			F32 xforms[3][6];
 			LLStrider<LLVector2> dst;
-
 			for (U32 ch = 0; ch < 3; ++ch)
 			{
 				switch (ch)
@@ -1766,375 +1957,416 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 					}
 				}
 
-				if (!mat && do_bump)
+				channels[ch] = dst.get();
+				F32* params = xforms[ch];
+				params[0] = cos_ang;
+				params[1] = sin_ang;
+				params[2] = os;
+				params[3] = ot;
+				params[4] = ms;
+				params[5] = mt;
+			}
+
+			bool bump_offsets = !mat && do_bump;
+			LLVector2* tc1 = NULL;
+			if (bump_offsets)
+			{
+				result = mVertexBuffer->getTexCoord1Strider(tex_coords1,
+															mGeomIndex,
+															mGeomCount,
+															map_range);
+				if (!result)
+				{
+					llwarns << "getTexCoord1Strider() failed !" << llendl;
+					return false;
+				}
+				tc1 = tex_coords1.get();
+			}
+
+			run_job([vfp, num_vertices, channels, xforms, texgen, do_tex_mat,
+					 tex_mat, scalea, bump_offsets, tc1, mat_normal,
+					 binormal_dir, bump_s_prim_light_ray,
+					 bump_t_prim_light_ray, is_active, bump_quat]()
+			{
+				std::vector<LLVector2> bump_tc;
+				if (bump_offsets)
 				{
 					bump_tc.reserve(num_vertices);
 				}
 
-				if (texgen == LLTextureEntry::TEX_GEN_PLANAR &&
-					!(tex_mode && mTextureMatrix))
+				for (U32 ch = 0; ch < 3; ++ch)
 				{
-					S32 i = 0;
-#if defined(__AVX2__)
-					if (num_vertices >= 8)
+					LLVector2* dst = channels[ch];
+					if (!dst)
+					{
+						continue;
+					}
+					const F32* params = xforms[ch];
+					F32 cos_ang = params[0];
+					F32 sin_ang = params[1];
+					F32 os = params[2];
+					F32 ot = params[3];
+					F32 ms = params[4];
+					F32 mt = params[5];
+
+					if (texgen == LLTextureEntry::TEX_GEN_PLANAR &&
+						!do_tex_mat)
 					{
-						__m256 cos_vec = _mm256_set1_ps(cos_ang);
-						__m256 sin_vec = _mm256_set1_ps(sin_ang);
-						__m256 off = _mm256_set1_ps(-0.5f);
-						__m256 osoff = _mm256_set1_ps(os + 0.5f);
-						__m256 otoff = _mm256_set1_ps(ot + 0.5f);
-						__m256 ms_vec = _mm256_set1_ps(ms);
-						__m256 mt_vec = _mm256_set1_ps(mt);
-						F32 sv[8], tv[8];
-						LLVector4a& center = *(vf.mCenter);
-
-						do
+						S32 i = 0;
+#if defined(__AVX2__)
+						if (num_vertices >= 8)
 						{
-							for (S32 j = 0; j < 8; ++j, ++i)
+							__m256 cos_vec = _mm256_set1_ps(cos_ang);
+							__m256 sin_vec = _mm256_set1_ps(sin_ang);
+							__m256 off = _mm256_set1_ps(-0.5f);
+							__m256 osoff = _mm256_set1_ps(os + 0.5f);
+							__m256 otoff = _mm256_set1_ps(ot + 0.5f);
+							__m256 ms_vec = _mm256_set1_ps(ms);
+							__m256 mt_vec = _mm256_set1_ps(mt);
+							F32 sv[8], tv[8];
+
+							do
 							{
-								LLVector2 tcv(vf.mTexCoords[i]);
-								LLVector4a vec = vf.mPositions[i];
-								vec.mul(scalea);
-								planarProjection(tcv, vf.mNormals[i], center,
-												 vec);
-								sv[j] = tcv.mV[0];
-								tv[j] = tcv.mV[1];
-							}
-
-							__m256 svv = _mm256_loadu_ps(sv);
-							__m256 tvv = _mm256_loadu_ps(tv);
-
-							// Texture transforms are done about the center of
-							// the face
-							svv = _mm256_add_ps(svv, off);
-							tvv = _mm256_add_ps(tvv, off);
-
-							// Transform the texture coordinates for this face.
-							__m256 coss = _mm256_mul_ps(svv, cos_vec);
-							__m256 sins = _mm256_mul_ps(svv, sin_vec);
-							svv = _mm256_fmadd_ps(tvv, sin_vec, coss);
-							tvv = _mm256_fmsub_ps(tvv, cos_vec, sins);
-
-							// Then scale and offset
-							svv = _mm256_fmadd_ps(svv, ms_vec, osoff);
-							tvv = _mm256_fmadd_ps(tvv, mt_vec, otoff);
-
-							_mm256_storeu_ps(sv, svv);
-							_mm256_storeu_ps(tv, tvv);
-
-							for (S32 j = 0; j < 8; ++j)
-							{
-								LLVector2 tc(sv[j], tv[j]);
-								*dst++ = tc;
-
-								if (!mat && do_bump)
+								__m128 s0, t0, s1, t1;
+								planarProjection4(vfp->mNormals + i,
+												  vfp->mPositions + i, scalea,
+												  s0, t0);
+								planarProjection4(vfp->mNormals + i + 4,
+												  vfp->mPositions + i + 4,
+												  scalea, s1, t1);
+								i += 8;
+
+								__m256 svv =
+									_mm256_insertf128_ps(_mm256_castps128_ps256(s0),
+														 s1, 1);
+								__m256 tvv =
+									_mm256_insertf128_ps(_mm256_castps128_ps256(t0),
+														 t1, 1);
+
+								// Texture transforms are done about the center
+								// of the face
+								svv = _mm256_add_ps(svv, off);
+								tvv = _mm256_add_ps(tvv, off);
+
+								// Transform the texture coordinates for this
+								// face.
+								__m256 coss = _mm256_mul_ps(svv, cos_vec);
+								__m256 sins = _mm256_mul_ps(svv, sin_vec);
+								svv = _mm256_fmadd_ps(tvv, sin_vec, coss);
+								tvv = _mm256_fmsub_ps(tvv, cos_vec, sins);
+
+								// Then scale and offset
+								svv = _mm256_fmadd_ps(svv, ms_vec, osoff);
+								tvv = _mm256_fmadd_ps(tvv, mt_vec, otoff);
+
+								_mm256_storeu_ps(sv, svv);
+								_mm256_storeu_ps(tv, tvv);
+
+								for (S32 j = 0; j < 8; ++j)
 								{
-									bump_tc.emplace_back(tc);
+									LLVector2 tc(sv[j], tv[j]);
+									*dst++ = tc;
+
+									if (bump_offsets)
+									{
+										bump_tc.emplace_back(tc);
+									}
 								}
 							}
+							while (i + 8 <= num_vertices);
 						}
-						while (i + 8 <= num_vertices);
-					}
 #endif
-					// SSE2 version
-					if (i + 4 <= num_vertices)
-					{
-						__m128 cos_vec = _mm_set1_ps(cos_ang);
-						__m128 sin_vec = _mm_set1_ps(sin_ang);
-						__m128 off = _mm_set1_ps(-0.5f);
-						__m128 osoff = _mm_set1_ps(os + 0.5f);
-						__m128 otoff = _mm_set1_ps(ot + 0.5f);
-						__m128 ms_vec = _mm_set1_ps(ms);
-						__m128 mt_vec = _mm_set1_ps(mt);
-						F32 sv[4], tv[4];
-						LLVector4a& center = *(vf.mCenter);
-
-						do
+						// SSE2 version
+						if (i + 4 <= num_vertices)
 						{
-							for (S32 j = 0; j < 4; ++j, ++i)
-							{
-								LLVector2 tcv(vf.mTexCoords[i]);
-								LLVector4a vec = vf.mPositions[i];
-								vec.mul(scalea);
-								planarProjection(tcv, vf.mNormals[i], center,
-												 vec);
-								sv[j] = tcv.mV[0];
-								tv[j] = tcv.mV[1];
-							}
-
-							__m128 svv = _mm_loadu_ps(sv);
-							__m128 tvv = _mm_loadu_ps(tv);
-
-							// Texture transforms are done about the center of
-							// the face
-							svv = _mm_add_ps(svv, off);
-							tvv = _mm_add_ps(tvv, off);
-
-							// Transform the texture coordinates for this face.
-							__m128 coss = _mm_mul_ps(svv, cos_vec);
-							__m128 sins = _mm_mul_ps(svv, sin_vec);
-							// No fmadd/fmsub in SSE2: two steps needed...
-							svv = _mm_add_ps(_mm_mul_ps(tvv, sin_vec), coss);
-							tvv = _mm_sub_ps(_mm_mul_ps(tvv, cos_vec), sins);
-
-							// Then scale and offset
-							svv = _mm_add_ps(_mm_mul_ps(svv, ms_vec), osoff);
-							tvv = _mm_add_ps(_mm_mul_ps(tvv, mt_vec), otoff);
-
-							_mm_storeu_ps(sv, svv);
-							_mm_storeu_ps(tv, tvv);
-
-							for (S32 j = 0; j < 4; ++j)
+							__m128 cos_vec = _mm_set1_ps(cos_ang);
+							__m128 sin_vec = _mm_set1_ps(sin_ang);
+							__m128 off = _mm_set1_ps(-0.5f);
+							__m128 osoff = _mm_set1_ps(os + 0.5f);
+							__m128 otoff = _mm_set1_ps(ot + 0.5f);
+							__m128 ms_vec = _mm_set1_ps(ms);
+							__m128 mt_vec = _mm_set1_ps(mt);
+							F32 sv[4], tv[4];
+
+							do
 							{
-								LLVector2 tc(sv[j], tv[j]);
-								*dst++ = tc;
-
-								if (!mat && do_bump)
+								__m128 svv, tvv;
+								planarProjection4(vfp->mNormals + i,
+												  vfp->mPositions + i, scalea,
+												  svv, tvv);
+								i += 4;
+
+								// Texture transforms are done about the center
+								// of the face
+								svv = _mm_add_ps(svv, off);
+								tvv = _mm_add_ps(tvv, off);
+
+								// Transform the texture coordinates for this
+								// face.
+								__m128 coss = _mm_mul_ps(svv, cos_vec);
+								__m128 sins = _mm_mul_ps(svv, sin_vec);
+								// No fmadd/fmsub in SSE2: two steps needed...
+								svv = _mm_add_ps(_mm_mul_ps(tvv, sin_vec),
+												 coss);
+								tvv = _mm_sub_ps(_mm_mul_ps(tvv, cos_vec),
+												 sins);
+
+								// Then scale and offset
+								svv = _mm_add_ps(_mm_mul_ps(svv, ms_vec),
+												 osoff);
+								tvv = _mm_add_ps(_mm_mul_ps(tvv, mt_vec),
+												 otoff);
+
+								_mm_storeu_ps(sv, svv);
+								_mm_storeu_ps(tv, tvv);
+
+								for (S32 j = 0; j < 4; ++j)
 								{
-									bump_tc.emplace_back(tc);
+									LLVector2 tc(sv[j], tv[j]);
+									*dst++ = tc;
+
+									if (bump_offsets)
+									{
+										bump_tc.emplace_back(tc);
+									}
 								}
 							}
+							while (i + 4 <= num_vertices);
 						}
-						while (i + 4 <= num_vertices);
-					}
 
-					while (i < num_vertices)
-					{
-						LLVector2 tc(vf.mTexCoords[i]);
-						LLVector4a& norm = vf.mNormals[i];
-						LLVector4a& center = *(vf.mCenter);
-
-						LLVector4a vec = vf.mPositions[i++];
-						vec.mul(scalea);
-						planarProjection(tc, norm, center, vec);
-
-						// Texture transforms are done about the center of the face.
-						F32 s = tc.mV[0] - 0.5f;
-						F32 t = tc.mV[1] - 0.5f;
-							
-						// Handle rotation
-						F32 temp = s;
-						s = s * cos_ang + t * sin_ang;
-						t = -temp * sin_ang + t * cos_ang;
-
-						// Then scale
-						s *= ms;
-						t *= mt;
-						// Then offset
-						s += os + 0.5f;
-						t += ot + 0.5f;
-						tc.mV[0] = s;
-						tc.mV[1] = t;
+						while (i < num_vertices)
+						{
+							LLVector2 tc(vfp->mTexCoords[i]);
+							const LLVector4a& norm = vfp->mNormals[i];
+							const LLVector4a& center = *(vfp->mCenter);
 
-						*dst++ = tc;
+							LLVector4a vec = vfp->mPositions[i++];
+							vec.mul(scalea);
+							planarProjection(tc, norm, center, vec);
 
-						if (!mat && do_bump)
-						{
-							bump_tc.emplace_back(tc);
+							// Texture transforms are done about the center of
+							// the face.
+							F32 s = tc.mV[0] - 0.5f;
+							F32 t = tc.mV[1] - 0.5f;
+
+							// Handle rotation
+							F32 temp = s;
+							s = s * cos_ang + t * sin_ang;
+							t = -temp * sin_ang + t * cos_ang;
+
+							// Then scale
+							s *= ms;
+							t *= mt;
+							// Then offset
+							s += os + 0.5f;
+							t += ot + 0.5f;
+							tc.mV[0] = s;
+							tc.mV[1] = t;
+
+							*dst++ = tc;
+
+							if (bump_offsets)
+							{
+								bump_tc.emplace_back(tc);
+							}
 						}
 					}
-				}
-				else if (tex_mode && mTextureMatrix) 
-				{
-					for (S32 i = 0; i < num_vertices; ++i)
+					else if (do_tex_mat)
 					{
-						LLVector2 tc(vf.mTexCoords[i]);
-						if (texgen == LLTextureEntry::TEX_GEN_PLANAR)
+						for (S32 i = 0; i < num_vertices; ++i)
 						{
-							LLVector4a& norm = vf.mNormals[i];
-							LLVector4a& center = *(vf.mCenter);
-							LLVector4a vec = vf.mPositions[i];
-							vec.mul(scalea);
-							planarProjection(tc, norm, center, vec);
-						}
-						LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
-						tmp = tmp * *mTextureMatrix;
+							LLVector2 tc(vfp->mTexCoords[i]);
+							if (texgen == LLTextureEntry::TEX_GEN_PLANAR)
+							{
+								const LLVector4a& norm = vfp->mNormals[i];
+								const LLVector4a& center = *(vfp->mCenter);
+								LLVector4a vec = vfp->mPositions[i];
+								vec.mul(scalea);
+								planarProjection(tc, norm, center, vec);
+							}
+							LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
+							tmp = tmp * tex_mat;
 
-						tc.mV[0] = tmp.mV[0];
-						tc.mV[1] = tmp.mV[1];
+							tc.mV[0] = tmp.mV[0];
+							tc.mV[1] = tmp.mV[1];
 
-						*dst++ = tc;
+							*dst++ = tc;
 
-						if (!mat && do_bump)
-						{
-							bump_tc.emplace_back(tc);
+							if (bump_offsets)
+							{
+								bump_tc.emplace_back(tc);
+							}
 						}
 					}
-				}
-				else
-				{
-					S32 i = 0;
-#if defined(__AVX2__)
-					if (num_vertices >= 8)
+					else
 					{
-						__m256 cos_vec = _mm256_set1_ps(cos_ang);
-						__m256 sin_vec = _mm256_set1_ps(sin_ang);
-						__m256 off = _mm256_set1_ps(-0.5f);
-						__m256 osoff = _mm256_set1_ps(os + 0.5f);
-						__m256 otoff = _mm256_set1_ps(ot + 0.5f);
-						__m256 ms_vec = _mm256_set1_ps(ms);
-						__m256 mt_vec = _mm256_set1_ps(mt);
-						F32 sv[8], tv[8];
-						do
+						S32 i = 0;
+						const LLVector2* tcs = vfp->mTexCoords;
+#if defined(__AVX2__)
+						if (num_vertices >= 8)
 						{
-							sv[0] = vf.mTexCoords[i].mV[0];
-							tv[0] = vf.mTexCoords[i++].mV[1];
-							sv[1] = vf.mTexCoords[i].mV[0];
-							tv[1] = vf.mTexCoords[i++].mV[1];
-							sv[2] = vf.mTexCoords[i].mV[0];
-							tv[2] = vf.mTexCoords[i++].mV[1];
-							sv[3] = vf.mTexCoords[i].mV[0];
-							tv[3] = vf.mTexCoords[i++].mV[1];
-							sv[4] = vf.mTexCoords[i].mV[0];
-							tv[4] = vf.mTexCoords[i++].mV[1];
-							sv[5] = vf.mTexCoords[i].mV[0];
-							tv[5] = vf.mTexCoords[i++].mV[1];
-							sv[6] = vf.mTexCoords[i].mV[0];
-							tv[6] = vf.mTexCoords[i++].mV[1];
-							sv[7] = vf.mTexCoords[i].mV[0];
-							tv[7] = vf.mTexCoords[i++].mV[1];
-
-							__m256 svv = _mm256_loadu_ps(sv);
-							__m256 tvv = _mm256_loadu_ps(tv);
-
-							// Texture transforms are done about the center of
-							// the face
-							svv = _mm256_add_ps(svv, off);
-							tvv = _mm256_add_ps(tvv, off);
-
-							// Transform the texture coordinates for this face.
-							__m256 coss = _mm256_mul_ps(svv, cos_vec);
-							__m256 sins = _mm256_mul_ps(svv, sin_vec);
-							svv = _mm256_fmadd_ps(tvv, sin_vec, coss);
-							tvv = _mm256_fmsub_ps(tvv, cos_vec, sins);
-
-							// Then scale and offset
-							svv = _mm256_fmadd_ps(svv, ms_vec, osoff);
-							tvv = _mm256_fmadd_ps(tvv, mt_vec, otoff);
-
-							_mm256_storeu_ps(sv, svv);
-							_mm256_storeu_ps(tv, tvv);
-
-							for (S32 j = 0; j < 8; ++j)
+							__m256 cos_vec = _mm256_set1_ps(cos_ang);
+							__m256 sin_vec = _mm256_set1_ps(sin_ang);
+							__m256 off = _mm256_set1_ps(-0.5f);
+							__m256 osoff = _mm256_set1_ps(os + 0.5f);
+							__m256 otoff = _mm256_set1_ps(ot + 0.5f);
+							__m256 ms_vec = _mm256_set1_ps(ms);
+							__m256 mt_vec = _mm256_set1_ps(mt);
+							F32 sv[8], tv[8];
+							do
 							{
-								LLVector2 tc(sv[j], tv[j]);
-								*dst++ = tc;
-
-								if (!mat && do_bump)
+								sv[0] = tcs[i].mV[0];
+								tv[0] = tcs[i++].mV[1];
+								sv[1] = tcs[i].mV[0];
+								tv[1] = tcs[i++].mV[1];
+								sv[2] = tcs[i].mV[0];
+								tv[2] = tcs[i++].mV[1];
+								sv[3] = tcs[i].mV[0];
+								tv[3] = tcs[i++].mV[1];
+								sv[4] = tcs[i].mV[0];
+								tv[4] = tcs[i++].mV[1];
+								sv[5] = tcs[i].mV[0];
+								tv[5] = tcs[i++].mV[1];
+								sv[6] = tcs[i].mV[0];
+								tv[6] = tcs[i++].mV[1];
+								sv[7] = tcs[i].mV[0];
+								tv[7] = tcs[i++].mV[1];
+
+								__m256 svv = _mm256_loadu_ps(sv);
+								__m256 tvv = _mm256_loadu_ps(tv);
+
+								// Texture transforms are done about the center
+								// of the face
+								svv = _mm256_add_ps(svv, off);
+								tvv = _mm256_add_ps(tvv, off);
+
+								// Transform the texture coordinates for this
+								// face.
+								__m256 coss = _mm256_mul_ps(svv, cos_vec);
+								__m256 sins = _mm256_mul_ps(svv, sin_vec);
+								svv = _mm256_fmadd_ps(tvv, sin_vec, coss);
+								tvv = _mm256_fmsub_ps(tvv, cos_vec, sins);
+
+								// Then scale and offset
+								svv = _mm256_fmadd_ps(svv, ms_vec, osoff);
+								tvv = _mm256_fmadd_ps(tvv, mt_vec, otoff);
+
+								_mm256_storeu_ps(sv, svv);
+								_mm256_storeu_ps(tv, tvv);
+
+								for (S32 j = 0; j < 8; ++j)
 								{
-									bump_tc.emplace_back(tc);
+									LLVector2 tc(sv[j], tv[j]);
+									*dst++ = tc;
+
+									if (bump_offsets)
+									{
+										bump_tc.emplace_back(tc);
+									}
 								}
 							}
+							while (i + 8 <= num_vertices);
 						}
-						while (i + 8 <= num_vertices);
-					}
 #endif
-					// SSE2 version
-					if (i + 4 <= num_vertices)
-					{
-						__m128 cos_vec = _mm_set1_ps(cos_ang);
-						__m128 sin_vec = _mm_set1_ps(sin_ang);
-						__m128 off = _mm_set1_ps(-0.5f);
-						__m128 osoff = _mm_set1_ps(os + 0.5f);
-						__m128 otoff = _mm_set1_ps(ot + 0.5f);
-						__m128 ms_vec = _mm_set1_ps(ms);
-						__m128 mt_vec = _mm_set1_ps(mt);
-						F32 sv[4], tv[4];
-						do
+						// SSE2 version
+						if (i + 4 <= num_vertices)
 						{
-							sv[0] = vf.mTexCoords[i].mV[0];
-							tv[0] = vf.mTexCoords[i++].mV[1];
-							sv[1] = vf.mTexCoords[i].mV[0];
-							tv[1] = vf.mTexCoords[i++].mV[1];
-							sv[2] = vf.mTexCoords[i].mV[0];
-							tv[2] = vf.mTexCoords[i++].mV[1];
-							sv[3] = vf.mTexCoords[i].mV[0];
-							tv[3] = vf.mTexCoords[i++].mV[1];
-							__m128 svv = _mm_loadu_ps(sv);
-							__m128 tvv = _mm_loadu_ps(tv);
-
-							// Texture transforms are done about the center of
-							// the face
-							svv = _mm_add_ps(svv, off);
-							tvv = _mm_add_ps(tvv, off);
-
-							// Transform the texture coordinates for this face.
-							__m128 coss = _mm_mul_ps(svv, cos_vec);
-							__m128 sins = _mm_mul_ps(svv, sin_vec);
-							// No fmadd/fmsub in SSE2: two steps needed...
-							svv = _mm_add_ps(_mm_mul_ps(tvv, sin_vec), coss);
-							tvv = _mm_sub_ps(_mm_mul_ps(tvv, cos_vec), sins);
-
-							// Then scale and offset
-							svv = _mm_add_ps(_mm_mul_ps(svv, ms_vec), osoff);
-							tvv = _mm_add_ps(_mm_mul_ps(tvv, mt_vec), otoff);
-
-							_mm_storeu_ps(sv, svv);
-							_mm_storeu_ps(tv, tvv);
-
-							for (S32 j = 0; j < 4; ++j)
+							__m128 cos_vec = _mm_set1_ps(cos_ang);
+							__m128 sin_vec = _mm_set1_ps(sin_ang);
+							__m128 off = _mm_set1_ps(-0.5f);
+							__m128 osoff = _mm_set1_ps(os + 0.5f);
+							__m128 otoff = _mm_set1_ps(ot + 0.5f);
+							__m128 ms_vec = _mm_set1_ps(ms);
+							__m128 mt_vec = _mm_set1_ps(mt);
+							F32 sv[4], tv[4];
+							do
 							{
-								LLVector2 tc(sv[j], tv[j]);
-								*dst++ = tc;
-
-								if (!mat && do_bump)
+								sv[0] = tcs[i].mV[0];
+								tv[0] = tcs[i++].mV[1];
+								sv[1] = tcs[i].mV[0];
+								tv[1] = tcs[i++].mV[1];
+								sv[2] = tcs[i].mV[0];
+								tv[2] = tcs[i++].mV[1];
+								sv[3] = tcs[i].mV[0];
+								tv[3] = tcs[i++].mV[1];
+								__m128 svv = _mm_loadu_ps(sv);
+								__m128 tvv = _mm_loadu_ps(tv);
+
+								// Texture transforms are done about the center
+								// of the face
+								svv = _mm_add_ps(svv, off);
+								tvv = _mm_add_ps(tvv, off);
+
+								// Transform the texture coordinates for this
+								// face.
+								__m128 coss = _mm_mul_ps(svv, cos_vec);
+								__m128 sins = _mm_mul_ps(svv, sin_vec);
+								// No fmadd/fmsub in SSE2: two steps needed...
+								svv = _mm_add_ps(_mm_mul_ps(tvv, sin_vec),
+												 coss);
+								tvv = _mm_sub_ps(_mm_mul_ps(tvv, cos_vec),
+												 sins);
+
+								// Then scale and offset
+								svv = _mm_add_ps(_mm_mul_ps(svv, ms_vec),
+												 osoff);
+								tvv = _mm_add_ps(_mm_mul_ps(tvv, mt_vec),
+												 otoff);
+
+								_mm_storeu_ps(sv, svv);
+								_mm_storeu_ps(tv, tvv);
+
+								for (S32 j = 0; j < 4; ++j)
 								{
-									bump_tc.emplace_back(tc);
+									LLVector2 tc(sv[j], tv[j]);
+									*dst++ = tc;
+
+									if (bump_offsets)
+									{
+										bump_tc.emplace_back(tc);
+									}
 								}
 							}
+							while (i + 4 <= num_vertices);
 						}
-						while (i + 4 <= num_vertices);
-					}
-
-					while (i < num_vertices)
-					{
-						LLVector2 tc(vf.mTexCoords[i++]);
-						xform(tc, cos_ang, sin_ang, os, ot, ms, mt);
-						*dst++ = tc;
 
-						if (!mat && do_bump)
+						while (i < num_vertices)
 						{
-							bump_tc.emplace_back(tc);
+							LLVector2 tc(tcs[i++]);
+							xform(tc, cos_ang, sin_ang, os, ot, ms, mt);
+							*dst++ = tc;
+
+							if (bump_offsets)
+							{
+								bump_tc.emplace_back(tc);
+							}
 						}
 					}
 				}
-			}
 
-#if USE_MAP_RANGE
-			if (map_range)
-			{
-				mVertexBuffer->flush();
-			}
-#endif
-
-			if (!mat && do_bump)
-			{
-				result = mVertexBuffer->getTexCoord1Strider(tex_coords1,
-															mGeomIndex,
-															mGeomCount,
-															map_range);
-				if (!result)
+				if (!bump_offsets)
 				{
-					llwarns << "getTexCoord1Strider() failed !" << llendl;
-					return false;
+					return;
 				}
 
+				LLVector2* dst = tc1;
 				LLMatrix4a tangent_to_object;
 				LLVector4a tangent, binorm, t, binormal;
 				LLVector3 t2;
 				for (S32 i = 0; i < num_vertices; ++i)
 				{
-					tangent = vf.mTangents[i];
+					tangent = vfp->mTangents[i];
 
-					binorm.setCross3(vf.mNormals[i], tangent);
+					binorm.setCross3(vfp->mNormals[i], tangent);
 					binorm.mul(tangent.getF32ptr()[3]);
 
-					tangent_to_object.setRows(tangent, binorm, vf.mNormals[i]);
+					tangent_to_object.setRows(tangent, binorm,
+											  vfp->mNormals[i]);
 					tangent_to_object.rotate(binormal_dir, t);
 
 					mat_normal.rotate(t, binormal);
 					// VECTORIZE THIS
-					if (mDrawablep->isActive())
+					if (is_active)
 					{
 						t2.set(binormal.getF32ptr());
 						t2 *= bump_quat;
@@ -2142,18 +2374,18 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 					}
 					binormal.normalize3fast();
 
-					*tex_coords1++ = bump_tc[i] +
+					*dst++ = bump_tc[i] +
 						 LLVector2(bump_s_prim_light_ray.dot3(tangent).getF32(),
 								   bump_t_prim_light_ray.dot3(binormal).getF32());
 				}
+			});
 
 #if USE_MAP_RANGE
-				if (map_range)
-				{
-					mVertexBuffer->flush();
-				}
-#endif
+			if (map_range)
+			{
+				mVertexBuffer->flush();
 			}
+#endif
 		}
 	}
 
@@ -2170,9 +2402,6 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 			return false;
 		}
 
-		LLVector4a* src = vf.mPositions;
-		LLVector4a* end = src + num_vertices;
-
 		LLMatrix4a mat_vert;
 		mat_vert.loadu(mat_vert_in);
 
@@ -2185,35 +2414,39 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 		*vp = index;
 		LLVector4a tex_idx(0.f, 0.f, 0.f, val);
 
-		LLVector4Logical mask;
-		mask.clear();
-		mask.setElement<3>();
-
-		F32* dst = (F32*)vert.get();
-		F32* end_f32 = dst + mGeomCount * 4;
-
-		LLVector4a res0, tmp;
-
+		F32* verts = (F32*)vert.get();
+		U32 geom_count = mGeomCount;
+		run_job([vfp, num_vertices, mat_vert, tex_idx, verts, geom_count]()
 		{
-			LL_FAST_TIMER(FTM_FACE_POSITION_STORE);
-
-			while (src < end)
 			{
-				mat_vert.affineTransform(*src++, res0);
-				tmp.setSelectWithMask(mask, tex_idx, res0);
-				tmp.store4a((F32*)dst);
-				dst += 4;
+				LL_FAST_TIMER(FTM_FACE_POSITION_STORE);
+				mat_vert.affineTransformBatch(vfp->mPositions,
+											  (LLVector4a*)verts,
+											  num_vertices, tex_idx);
 			}
-		}
 
-		{
-			LL_FAST_TIMER(FTM_FACE_POSITION_PAD);
-			while (dst < end_f32)
+			F32* dst = verts + num_vertices * 4;
+			F32* end_f32 = verts + geom_count * 4;
+			if (dst < end_f32)
 			{
-				res0.store4a((F32*)dst);
-				dst += 4;
+				LL_FAST_TIMER(FTM_FACE_POSITION_PAD);
+				LLVector4a res0;
+				if (num_vertices)
+				{
+					mat_vert.affineTransform(vfp->mPositions[num_vertices - 1],
+											 res0);
+				}
+				else
+				{
+					res0.clear();
+				}
+				while (dst < end_f32)
+				{
+					res0.store4a((F32*)dst);
+					dst += 4;
+				}
 			}
-		}
+		});
 
 #if USE_MAP_RANGE
 		if (map_range)
@@ -2235,15 +2468,11 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 		}
 
 		F32* normals = (F32*)norm.get();
-		LLVector4a* src = vf.mNormals;
-		LLVector4a* end = src + num_vertices;
-		LLVector4a normal;
-		while (src < end)
+		run_job([vfp, num_vertices, mat_normal, normals]()
 		{
-			mat_normal.rotate(*src++, normal);
-			normal.store4a(normals);
-			normals += 4;
-		}
+			mat_normal.rotateBatch(vfp->mNormals, (LLVector4a*)normals,
+								   num_vertices);
+		});
 
 #if USE_MAP_RANGE
 		if (map_range)
@@ -2268,22 +2497,12 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 
 		mVObjp->getVolume()->genTangents(f);
 
-		LLVector4Logical mask;
-		mask.clear();
-		mask.setElement<3>();
-
-		LLVector4a* src = vf.mTangents;
-		LLVector4a* end = vf.mTangents + num_vertices;
-
-		LLVector4a tangent_out;
-		while (src < end)
+		run_job([vfp, num_vertices, mat_normal, tangents]()
 		{
-			mat_normal.rotate(*src, tangent_out);
-			tangent_out.normalize3fast();
-			tangent_out.setSelectWithMask(mask, *src++, tangent_out);
-			tangent_out.store4a(tangents);
-			tangents += 4;
-		}
+			mat_normal.rotateNormalizeBatch(vfp->mTangents,
+											(LLVector4a*)tangents,
+											num_vertices);
+		});
 
 #if USE_MAP_RANGE
 		if (map_range)
@@ -2303,16 +2522,14 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 			llwarns << "getWeight4Strider() failed !" << llendl;
 			return false;
 		}
-#if 1
+
 		F32* weights = (F32*)wght.get();
-		LLVector4a::memcpyNonAliased16(weights, (F32*)vf.mWeights,
-									   num_vertices * 4 * sizeof(F32));
-#else
-		for (S32 i = 0; i < num_vertices; ++i)
+		run_job([vfp, num_vertices, weights]()
 		{
-			*wght++ = vf.mWeights[i];
-		}
-#endif
+			LLVector4a::memcpyNonAliased16(weights, (F32*)vfp->mWeights,
+										   num_vertices * 4 * sizeof(F32));
+		});
+
 #if USE_MAP_RANGE
 		if (map_range)
 		{
@@ -2333,19 +2550,11 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 			return false;
 		}
 
-		U32 vec[4];
-		vec[0] = vec[1] = vec[2] = vec[3] = color.asRGBA();
-
-		LLVector4a src;
-		src.loadua((F32*)vec);
-
-		F32* dst = (F32*)colors.get();
-		S32 num_vecs = (num_vertices + 3) / 4; // Rounded up
-		for (S32 i = 0; i < num_vecs; ++i)
+		run_job([num_vertices, dst = (U32*)colors.get(),
+				 rgba = color.asRGBA()]()
 		{
-			src.store4a(dst);
-			dst += 4;
-		}
+			fill_colors(dst, rgba, num_vertices);
+		});
 
 #if USE_MAP_RANGE
 		if (map_range)
@@ -2371,21 +2580,11 @@ bool LLFace::getGeometryVolume(const LLVolume& volume, const S32& f,
 		U8 glow = (U8)llmin((S32)(glowf * 255.f), 255);
 
 		LLColor4U glow4u = LLColor4U(0, 0, 0, glow);
-		U32 glow32 = glow4u.asRGBA();
-
-		U32 vec[4];
-		vec[0] = vec[1] = vec[2] = vec[3] = glow32;
-
-		LLVector4a src;
-		src.loadua((F32*)vec);
-
-		F32* dst = (F32*)emissive.get();
-		S32 num_vecs = (num_vertices + 3) / 4; // Rounded up
-		for (S32 i = 0; i < num_vecs; ++i)
+		run_job([num_vertices, dst = (U32*)emissive.get(),
+				 rgba = glow4u.asRGBA()]()
 		{
-			src.store4a(dst);
-			dst += 4;
-		}
+			fill_colors(dst, rgba, num_vertices);
+		});
 
 #if USE_MAP_RANGE
 		if (map_range)
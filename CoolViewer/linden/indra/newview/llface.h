@@ -33,6 +33,9 @@
 #ifndef LL_LLFACE_H
 #define LL_LLFACE_H
 
+#include <functional>
+#include <vector>
+
 #include "llrender.h"
 #include "llstrider.h"
 #include "llvertexbuffer.h"
@@ -219,11 +222,17 @@ public:
 	// For volumes
 	void updateRebuildFlags();
 	bool canRenderAsMask();	// Logic helper
+	// When 'jobs' is not NULL, the CPU-bound parts of the rebuild are queued
+	// in it instead of being done immediately, and the caller is responsible
+	// for running them (possibly in parallel), before flushing the vertex
+	// buffer.
+	typedef std::vector<std::function<void()> > geom_jobs_t;
 	bool getGeometryVolume(const LLVolume& volume, const S32& f,
 						   const LLMatrix4& mat_vert,
 						   const LLMatrix3& mat_normal,
 						   const U16& index_offset,
-						   bool force_rebuild = false);
+						   bool force_rebuild = false,
+						   geom_jobs_t* jobs = NULL);
 
 	// For avatar
 	U16 getGeometryAvatar(LLStrider<LLVector3>& vertices,
@@ -207,6 +207,7 @@ static struct ft_display_info ft_display_table[] =
 	{ LLFastTimer::FTM_TEXTURE_MEMORY_CHECK,			"    Memory Check" },
 	{ LLFastTimer::FTM_IMAGE_UPDATE_BUMP,				"   Image Bump" },
 	{ LLFastTimer::FTM_IMAGE_UPDATE_LIST,				"   Image List" },
+	{ LLFastTimer::FTM_PREFETCH_PREDICTOR,				"   Prefetch Predictor" },
 	{ LLFastTimer::FTM_IMAGE_CALLBACKS,					"    Image Callbacks" },
 	{ LLFastTimer::FTM_BUMP_SOURCE_STANDARD_LOADED,		"     Bump Std Loaded" },
 	{ LLFastTimer::FTM_BUMP_GEN_NORMAL,					"      Gen. Normal Map" },
@@ -223,6 +224,8 @@ static struct ft_display_info ft_display_table[] =
 	{ LLFastTimer::FTM_FAST_CACHE_IMAGE_FETCH,			"   Fast Cache Fetch" },
 #endif
 	{ LLFastTimer::FTM_IMAGE_UPDATE_PRIO,				"   Prioritize Images" },
+	{ LLFastTimer::FTM_IMAGE_PRIORITIES,				"   Images Priorities" },
+	{ LLFastTimer::FTM_IMAGE_RESIDENCY,					"   Images Residency" },
 	{ LLFastTimer::FTM_IMAGE_FETCH,						"   Fetch Images" },
 	{ LLFastTimer::FTM_IMAGE_MARK_DIRTY,				"   Dirty Images" },
 	{ LLFastTimer::FTM_IMAGE_STATS,						"   Image Stats" },
@@ -230,6 +233,7 @@ static struct ft_display_info ft_display_table[] =
 	{ LLFastTimer::FTM_STATESORT,						"  State Sort" },
 	{ LLFastTimer::FTM_STATESORT_DRAWABLE,				"   Drawable" },
 	{ LLFastTimer::FTM_STATESORT_POSTSORT,				"   Post Sort" },
+	{ LLFastTimer::FTM_STATESORT_SORT_DRAWS,			"    Sort Draws" },
 	{ LLFastTimer::FTM_REBUILD_PRIORITY_GROUPS,			"    Rebuild Prio. Grps" },
 	{ LLFastTimer::FTM_REBUILD_MESH,					"     Rebuild Mesh Obj." },
 	{ LLFastTimer::FTM_REBUILD_VBO,						"    VBO Rebuild" },
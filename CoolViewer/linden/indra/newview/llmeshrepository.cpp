@@ -60,6 +60,7 @@
 #include "llsdserialize.h"
 #include "llsdutil_math.h"
 #include "llthread.h"
+#include "lltimer.h"
 #include "hbtracy.h"
 #include "lltrans.h"
 #include "llvolumemgr.h"
@@ -215,6 +216,7 @@
 //     sCacheBytesWritten              "
 //     sCacheReads                     "
 //     sCacheWrites                    "
+//     sCacheReadTime                  none            rw.lfs.none, ro.main.none [1]
 //     mLoadingMeshes                  mMeshMutex [4]  rw.main.none, rw.any.mMeshMutex
 //     mSkinMap                        none            rw.main.none
 //     mDecompositionMap               none            rw.main.none
@@ -234,6 +236,7 @@
 //
 //     sActiveHeaderRequests    atomic
 //     sActiveLODRequests       atomic
+//     sActiveCacheReads        atomic
 //     sMaxConcurrentRequests   mMutex        wo.main.none, ro.repo.none, ro.main.mMutex
 //     mMeshHeaders             mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex
 //     mSkinRequests            mMutex        rw.repo.mMutex, ro.repo.none [5]
@@ -246,6 +249,7 @@
 //     mUnavailableLODs         mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex
 //     mLoadedMeshes            mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex
 //     mPendingLOD              mMutex        rw.repo.mMutex, rw.any.mMutex
+//     mCacheReads              mMutex        ro.repo.none [3], rw.repo.mMutex, rw.lfs.mMutex
 //     mGetMeshCapability       mMutex        rw.main.mMutex, ro.repo.mMutex
 //     mGetMeshVersion          mMutex        rw.main.mMutex, ro.repo.mMutex
 //     mHttp*                   none          rw.repo.none
@@ -323,10 +327,12 @@ U32 LLMeshRepository::sCacheBytesRead = 0;
 U32 LLMeshRepository::sCacheBytesWritten = 0;
 U32 LLMeshRepository::sCacheReads = 0;
 U32 LLMeshRepository::sCacheWrites = 0;
+U64 LLMeshRepository::sCacheReadTime = 0;
 U32 LLMeshRepository::sMaxLockHoldoffs = 0;
 
 LLAtomicS32 LLMeshRepoThread::sActiveHeaderRequests(0);
 LLAtomicS32 LLMeshRepoThread::sActiveLODRequests(0);
+LLAtomicS32 LLMeshRepoThread::sActiveCacheReads(0);
 U32	LLMeshRepoThread::sMaxConcurrentRequests = 1;
 S32 LLMeshRepoThread::sRequestLowWater = REQUEST2_LOW_WATER_MIN;
 S32 LLMeshRepoThread::sRequestHighWater = REQUEST2_HIGH_WATER_MIN;
@@ -1003,6 +1009,97 @@ public:
 	LLUUID mMeshID;
 };
 
+// Asynchronous read of cached mesh data. Once completed, it gets queued for the
+// repo thread to parse the data, or to fall back to a fetch from the server
+// when the read failed. HB
+//
+// Thread: LFS (or repo, when the read is performed synchronously)
+class LLMeshCacheRead final : public LLFileSystem::Responder
+{
+protected:
+	LOG_CLASS(LLMeshCacheRead);
+
+	~LLMeshCacheRead() override
+	{
+		delete[] mBuffer;
+		--LLMeshRepoThread::sActiveCacheReads;
+	}
+
+public:
+	enum EType
+	{
+		HEADER,
+		LOD,
+		SKIN,
+		DECOMPOSITION,
+		PHYSICS_SHAPE
+	};
+
+	// For header and LOD reads
+	LLMeshCacheRead(EType type, const LLVolumeParams& mesh_params, S32 lod,
+					S32 offset, S32 size, const LLRequestStats& stats)
+	:	mType(type),
+		mMeshParams(mesh_params),
+		mMeshID(mesh_params.getSculptID()),
+		mLOD(lod),
+		mOffset(offset),
+		mSize(size),
+		mStats(stats),
+		mBuffer(NULL),
+		mBytesRead(0),
+		mStartTime(LLTimer::totalTime())
+	{
+		++LLMeshRepoThread::sActiveCacheReads;
+	}
+
+	// For skin info, decomposition and physics shape reads
+	LLMeshCacheRead(EType type, const LLUUID& mesh_id, S32 offset, S32 size,
+					const LLRequestStats& stats)
+	:	mType(type),
+		mMeshID(mesh_id),
+		mLOD(0),
+		mOffset(offset),
+		mSize(size),
+		mStats(stats),
+		mBuffer(NULL),
+		mBytesRead(0),
+		mStartTime(LLTimer::totalTime())
+	{
+		++LLMeshRepoThread::sActiveCacheReads;
+	}
+
+	void completed(S32 bytes) override
+	{
+		mBytesRead = bytes;
+		LLMeshRepository::sCacheBytesRead += bytes;
+		++LLMeshRepository::sCacheReads;
+		LLMeshRepository::sCacheReadTime += LLTimer::totalTime() - mStartTime;
+
+		LLMeshRepoThread* thread = gMeshRepo.mThread;
+		if (thread && !LLApp::isExiting())
+		{
+			thread->mMutex.lock();
+			thread->mCacheReads.emplace_back(this);
+			thread->mMutex.unlock();
+			thread->mSignal.signal();
+		}
+	}
+
+public:
+	EType			mType;
+	LLVolumeParams	mMeshParams;
+	LLUUID			mMeshID;
+	S32				mLOD;
+	S32				mOffset;
+	S32				mSize;
+	// Retries stats of the request, for when the fetch from the server
+	// failed to get issued and must be retried later.
+	LLRequestStats	mStats;
+	U8*				mBuffer;
+	S32				mBytesRead;
+	U64				mStartTime;
+};
+
 LLMeshRepoThread::LLMeshRepoThread()
 :	LLThread("mesh repo"),
 	mHttpPolicyClass(LLCore::HttpRequest::DEFAULT_POLICY_ID),
@@ -1149,9 +1246,13 @@ void LLMeshRepoThread::run()
 				// Dispatch all HttpHandler notifications
 				mHttpRequest->update(0L);
 			}
+			if (!mCacheReads.empty())
+			{
+				processCacheReads();
+			}
 			// Stats data update
 			sRequestWaterLevel = mHttpRequestSet.size();
-			can_req = sRequestWaterLevel < sRequestHighWater;
+			can_req = canRequest();
 		}
 
 		// NOTE: order of queue processing intentionally favors LOD requests
@@ -1179,7 +1280,7 @@ void LLMeshRepoThread::run()
 				{
 					--LLMeshRepository::sLODProcessing;
 					bool can_retry = req.canRetry();
-					if (!fetchMeshLOD(req.mMeshParams, req.mLOD, can_retry))
+					if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req))
 					{
 						if (can_retry)
 						{
@@ -1199,7 +1300,7 @@ void LLMeshRepoThread::run()
 					}
 				}
 				lodq_copy.pop_front();
-				can_req = (S32)mHttpRequestSet.size() < sRequestHighWater;
+				can_req = canRequest();
 			}
 			while (can_req && !lodq_copy.empty());
 
@@ -1272,7 +1373,7 @@ void LLMeshRepoThread::run()
 				else
 				{
 					bool can_retry = req.canRetry();
-					if (!fetchMeshHeader(req.mMeshParams, can_retry))
+					if (!fetchMeshHeader(req.mMeshParams, req))
 					{
 						if (can_retry)
 						{
@@ -1289,7 +1390,7 @@ void LLMeshRepoThread::run()
 					}
 				}
 				hdrq_copy.pop_front();
-				can_req = (S32)mHttpRequestSet.size() < sRequestHighWater;
+				can_req = canRequest();
 			}
 			while (can_req && !hdrq_copy.empty());
 
@@ -1363,7 +1464,7 @@ void LLMeshRepoThread::run()
 				{
 					incomplete_req.insert(req);
 				}
-				else if (!fetchMeshSkinInfo(req.mId))
+				else if (!fetchMeshSkinInfo(req.mId, req))
 				{
 					if (req.canRetry())
 					{
@@ -1377,7 +1478,7 @@ void LLMeshRepoThread::run()
 										  << req.mId << LL_ENDL;
 					}
 				}
-				can_req = (S32)mHttpRequestSet.size() < sRequestHighWater;
+				can_req = canRequest();
 				requests_copy.erase(iter);
 			}
 			while (can_req && !requests_copy.empty());
@@ -1404,7 +1505,7 @@ void LLMeshRepoThread::run()
 				{
 					incomplete_req.insert(req);
 				}
-				else if (!fetchMeshDecomposition(req.mId))
+				else if (!fetchMeshDecomposition(req.mId, req))
 				{
 					if (req.canRetry())
 					{
@@ -1418,7 +1519,7 @@ void LLMeshRepoThread::run()
 					}
 				}
 				requests_copy.erase(iter);
-				can_req = (S32)mHttpRequestSet.size() < sRequestHighWater;
+				can_req = canRequest();
 			}
 			while (can_req && !requests_copy.empty());
 
@@ -1445,7 +1546,7 @@ void LLMeshRepoThread::run()
 				{
 					incomplete_req.insert(req);
 				}
-				else if (!fetchMeshPhysicsShape(req.mId))
+				else if (!fetchMeshPhysicsShape(req.mId, req))
 				{
 					if (req.canRetry())
 					{
@@ -1459,7 +1560,7 @@ void LLMeshRepoThread::run()
 					}
 				}
 				requests_copy.erase(iter);
-				can_req = (S32)mHttpRequestSet.size() < sRequestHighWater;
+				can_req = canRequest();
 			}
 			while (can_req && !requests_copy.empty());
 
@@ -1616,7 +1717,26 @@ LLCore::HttpHandle LLMeshRepoThread::getByteRange(const std::string& url,
 	return handle;
 }
 
-bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id)
+// Allocates the buffer for 'read' and issues the asynchronous cache read.
+// Returns false when the buffer could not be allocated. HB
+static bool read_mesh_cache(LLMeshCacheRead* read)
+{
+	// Keep a reference, so that 'read' gets deleted on early return.
+	LLPointer<LLMeshCacheRead> readp = read;
+	read->mBuffer = new(std::nothrow) U8[read->mSize];
+	if (!read->mBuffer)
+	{
+		LLMemory::allocationFailed(read->mSize);
+		llwarns << "Could not allocate enough memory. Aborted." << llendl;
+		return false;
+	}
+	LLFileSystem::readAsync(read->mMeshID, read->mBuffer, read->mOffset,
+							read->mSize, read);
+	return true;
+}
+
+bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id,
+										 const LLRequestStats& stats)
 {
 	mHeaderMutex.lock();
 
@@ -1647,71 +1767,48 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id)
 	if (valid && offset >= 0 && size > 0)
 	{
 		// Check cache for mesh skin info
-		LLFileSystem file(mesh_id);
-		if (file.getSize() >= offset + size)
+		if (LLFileSystem::getFileSize(mesh_id) >= offset + size)
 		{
-			U8* buffer = new(std::nothrow) U8[size];
-			if (!buffer)
-			{
-				LLMemory::allocationFailed(size);
-				llwarns << "Could not allocate enough memory. Aborted."
-						<< llendl;
-				return false;
-			}
-			LLMeshRepository::sCacheBytesRead += size;
-			++LLMeshRepository::sCacheReads;
-			file.seek(offset);
-			file.read(buffer, size);
-
-			// Make sure the buffer is not all zeros by checking the first 128
-			// bytes (reserved block but not written)
-			bool zero = true;
-			for (S32 i = 0, count = llmin(size, 128); i < count && zero; ++i)
-			{
-				zero = buffer[i] == 0;
-			}
-
-			if (!zero)
-			{
-				// Attempt to parse
-				if (skinInfoReceived(mesh_id, buffer, size))
-				{
-					delete[] buffer;
-					return true;
-				}
-			}
-
-			delete[] buffer;
+			LLMeshCacheRead* read =
+				new LLMeshCacheRead(LLMeshCacheRead::SKIN, mesh_id, offset,
+									size, stats);
+			return read_mesh_cache(read);
 		}
+		return requestMeshSkinInfo(mesh_id, offset, size);
+	}
 
-		// Reading from cache failed for whatever reason, fetch from server
-		U32 cap_version = 2;
-		std::string http_url = constructUrl(mesh_id, &cap_version);
-		if (!http_url.empty())
-		{
-			LLMeshHandlerBase::ptr_t handler(new LLMeshSkinInfoHandler(mesh_id,
-																	   offset,
-																	   size));
-			LLCore::HttpHandle handle =
-				getByteRange(http_url, cap_version, offset, size, handler);
-			if (handle == LLCORE_HTTP_HANDLE_INVALID)
-			{
-				llwarns << "HTTP GET request failed for skin info on mesh "
-						<< mID << ". Reason: " << mHttpStatus.toString()
-						<< " (" << mHttpStatus.toTerseString() << ")"
-						<< llendl;
-				return false;
-			}
+	return true;
+}
 
-			handler->mHttpHandle = handle;
-			mHttpRequestSet.insert(handler);
+bool LLMeshRepoThread::requestMeshSkinInfo(const LLUUID& mesh_id, S32 offset,
+										   S32 size)
+{
+	U32 cap_version = 2;
+	std::string http_url = constructUrl(mesh_id, &cap_version);
+	if (!http_url.empty())
+	{
+		LLMeshHandlerBase::ptr_t handler(new LLMeshSkinInfoHandler(mesh_id,
+																   offset,
+																   size));
+		LLCore::HttpHandle handle =
+			getByteRange(http_url, cap_version, offset, size, handler);
+		if (handle == LLCORE_HTTP_HANDLE_INVALID)
+		{
+			llwarns << "HTTP GET request failed for skin info on mesh "
+					<< mID << ". Reason: " << mHttpStatus.toString()
+					<< " (" << mHttpStatus.toTerseString() << ")"
+					<< llendl;
+			return false;
 		}
-	}
 
+		handler->mHttpHandle = handle;
+		mHttpRequestSet.insert(handler);
+	}
 	return true;
 }
 
-bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
+bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id,
+											  const LLRequestStats& stats)
 {
 	mHeaderMutex.lock();
 
@@ -1741,72 +1838,49 @@ bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
 
 	if (valid && offset >= 0 && size > 0)
 	{
-		// Check cache for mesh skin info
-		LLFileSystem file(mesh_id);
-		if (file.getSize() >= offset + size)
+		// Check cache for mesh decomposition
+		if (LLFileSystem::getFileSize(mesh_id) >= offset + size)
 		{
-			U8* buffer = new(std::nothrow) U8[size];
-			if (!buffer)
-			{
-				LLMemory::allocationFailed(size);
-				llwarns << "Could not allocate enough memory. Aborted."
-						<< llendl;
-				return false;
-			}
-			LLMeshRepository::sCacheBytesRead += size;
-			++LLMeshRepository::sCacheReads;
-			file.seek(offset);
-			file.read(buffer, size);
-
-			// Make sure the buffer is not all zeros by checking the first 128
-			// bytes (reserved block but not written)
-			bool zero = true;
-			for (S32 i = 0, count = llmin(size, 128); i < count && zero; ++i)
-			{
-				zero = buffer[i] == 0;
-			}
-
-			if (!zero)
-			{
-				// Attempt to parse
-				if (decompositionReceived(mesh_id, buffer, size))
-				{
-					delete[] buffer;
-					return true;
-				}
-			}
-
-			delete[] buffer;
+			LLMeshCacheRead* read =
+				new LLMeshCacheRead(LLMeshCacheRead::DECOMPOSITION, mesh_id,
+									offset, size, stats);
+			return read_mesh_cache(read);
 		}
+		return requestMeshDecomposition(mesh_id, offset, size);
+	}
 
-		// Reading from cache failed for whatever reason, fetch from sim
-		U32 cap_version = 2;
-		std::string http_url = constructUrl(mesh_id, &cap_version);
-		if (!http_url.empty())
-		{
-			LLMeshHandlerBase::ptr_t handler(new LLMeshDecompositionHandler(mesh_id,
-																			offset,
-																			size));
-			LLCore::HttpHandle handle =
-				getByteRange(http_url, cap_version, offset, size, handler);
-			if (handle == LLCORE_HTTP_HANDLE_INVALID)
-			{
-				llwarns << "HTTP GET request failed for decomposition mesh "
-						<< mID << " - Reason: " << mHttpStatus.toString()
-						<< " (" << mHttpStatus.toTerseString() << ")"
-							<< llendl;
-				return false;
-			}
+	return true;
+}
 
-			handler->mHttpHandle = handle;
-			mHttpRequestSet.insert(handler);
+bool LLMeshRepoThread::requestMeshDecomposition(const LLUUID& mesh_id,
+												S32 offset, S32 size)
+{
+	U32 cap_version = 2;
+	std::string http_url = constructUrl(mesh_id, &cap_version);
+	if (!http_url.empty())
+	{
+		LLMeshHandlerBase::ptr_t handler(new LLMeshDecompositionHandler(mesh_id,
+																		offset,
+																		size));
+		LLCore::HttpHandle handle =
+			getByteRange(http_url, cap_version, offset, size, handler);
+		if (handle == LLCORE_HTTP_HANDLE_INVALID)
+		{
+			llwarns << "HTTP GET request failed for decomposition mesh "
+					<< mID << " - Reason: " << mHttpStatus.toString()
+					<< " (" << mHttpStatus.toTerseString() << ")"
+					<< llendl;
+			return false;
 		}
-	}
 
+		handler->mHttpHandle = handle;
+		mHttpRequestSet.insert(handler);
+	}
 	return true;
 }
 
-bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id)
+bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id,
+											 const LLRequestStats& stats)
 {
 	mHeaderMutex.lock();
 
@@ -1837,101 +1911,73 @@ bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id)
 	if (valid && offset >= 0 && size > 0)
 	{
 		// Check cache for mesh physics shape info
-		LLFileSystem file(mesh_id);
-		if (file.getSize() >= offset + size)
+		if (LLFileSystem::getFileSize(mesh_id) >= offset + size)
 		{
-			U8* buffer = new(std::nothrow) U8[size];
-			if (!buffer)
-			{
-				LLMemory::allocationFailed(size);
-				llwarns << "Could not allocate enough memory. Aborted."
-						<< llendl;
-				return false;
-			}
-			LLMeshRepository::sCacheBytesRead += size;
-			++LLMeshRepository::sCacheReads;
-			file.seek(offset);
-			file.read(buffer, size);
-
-			// Make sure the buffer is not all zeros by checking the first 128
-			// bytes (reserved block but not written)
-			bool zero = true;
-			for (S32 i = 0, count = llmin(size, 128); i < count && zero; ++i)
-			{
-				zero = buffer[i] == 0;
-			}
+			LLMeshCacheRead* read =
+				new LLMeshCacheRead(LLMeshCacheRead::PHYSICS_SHAPE, mesh_id,
+									offset, size, stats);
+			return read_mesh_cache(read);
+		}
+		return requestMeshPhysicsShape(mesh_id, offset, size);
+	}
 
-			if (!zero)
-			{
-				// Attempt to parse
-				if (physicsShapeReceived(mesh_id, buffer, size))
-				{
-					delete[] buffer;
-					return true;
-				}
-			}
+	// No physics shape whatsoever, report back NULL
+	physicsShapeReceived(mesh_id, NULL, 0);
 
-			delete[] buffer;
-		}
+	return true;
+}
 
-		// Reading from cache failed for whatever reason, fetch from sim
-		U32 cap_version = 2;
-		std::string http_url = constructUrl(mesh_id, &cap_version);
-		if (!http_url.empty())
+bool LLMeshRepoThread::requestMeshPhysicsShape(const LLUUID& mesh_id,
+											   S32 offset, S32 size)
+{
+	U32 cap_version = 2;
+	std::string http_url = constructUrl(mesh_id, &cap_version);
+	if (!http_url.empty())
+	{
+		LLMeshHandlerBase::ptr_t handler(new LLMeshPhysicsShapeHandler(mesh_id,
+																	   offset,
+																	   size));
+		LLCore::HttpHandle handle =
+			getByteRange(http_url, cap_version, offset, size, handler);
+		if (handle == LLCORE_HTTP_HANDLE_INVALID)
 		{
-			LLMeshHandlerBase::ptr_t handler(new LLMeshPhysicsShapeHandler(mesh_id,
-																		   offset,
-																		   size));
-			LLCore::HttpHandle handle =
-				getByteRange(http_url, cap_version, offset, size, handler);
-			if (handle == LLCORE_HTTP_HANDLE_INVALID)
-			{
-				llwarns << "HTTP GET request failed for physics shape on mesh "
-						<< mID << " - Reason: " << mHttpStatus.toString()
-						<< " (" << mHttpStatus.toTerseString() << ")"
-						<< llendl;
-				return false;
-			}
-
-			handler->mHttpHandle = handle;
-			mHttpRequestSet.insert(handler);
+			llwarns << "HTTP GET request failed for physics shape on mesh "
+					<< mID << " - Reason: " << mHttpStatus.toString()
+					<< " (" << mHttpStatus.toTerseString() << ")"
+					<< llendl;
+			return false;
 		}
-	}
-	else
-	{
-		// No physics shape whatsoever, report back NULL
-		physicsShapeReceived(mesh_id, NULL, 0);
-	}
 
+		handler->mHttpHandle = handle;
+		mHttpRequestSet.insert(handler);
+	}
 	return true;
 }
 
 // Returns false if failed to get header
 bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params,
-									   bool can_retry)
+									   const LLRequestStats& stats)
 {
 	++LLMeshRepository::sMeshRequestCount;
 
 	// Look for mesh in asset in cache
-	LLFileSystem file(mesh_params.getSculptID());
-	S32 size = file.getSize();
+	S32 size = LLFileSystem::getFileSize(mesh_params.getSculptID());
 	if (size > 0)
 	{
 		// NOTE: if the header size is ever more than 4KB, this will break
-		U8 buffer[MESH_HEADER_SIZE];
-		S32 bytes = llmin(size, MESH_HEADER_SIZE);
-		LLMeshRepository::sCacheBytesRead += bytes;
-		++LLMeshRepository::sCacheReads;
-		file.read(buffer, bytes);
-		if (headerReceived(mesh_params, buffer, bytes))
-		{
-			// Found mesh in cache
-			return true;
-		}
+		LLMeshCacheRead* read =
+			new LLMeshCacheRead(LLMeshCacheRead::HEADER, mesh_params, 0, 0,
+								llmin(size, MESH_HEADER_SIZE), stats);
+		return read_mesh_cache(read);
 	}
 
-	// Either cache entry does not exist or is corrupt, request header from
-	// simulator
+	// Cache entry does not exist, request header from simulator
+	return requestMeshHeader(mesh_params, stats.canRetry());
+}
+
+bool LLMeshRepoThread::requestMeshHeader(const LLVolumeParams& mesh_params,
+										 bool can_retry)
+{
 	U32 cap_version = 2;
 	std::string http_url = constructUrl(mesh_params.getSculptID(),
 										&cap_version);
@@ -1965,7 +2011,7 @@ bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params,
 
 // Returns false if failed to get mesh lod.
 bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
-									bool can_retry)
+									const LLRequestStats& stats)
 {
 	if (lod < 0)
 	{
@@ -1999,85 +2045,235 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 
 	mHeaderMutex.unlock();
 
-	bool available_lod = valid && offset >= 0 && size > 0;
-	if (available_lod)
+	if (valid && offset >= 0 && size > 0)
 	{
 		// Check cache for mesh asset
-		LLFileSystem file(mesh_id);
-		if (file.getSize() >= offset + size)
+		if (LLFileSystem::getFileSize(mesh_id) >= offset + size)
+		{
+			LLMeshCacheRead* read =
+				new LLMeshCacheRead(LLMeshCacheRead::LOD, mesh_params, lod,
+									offset, size, stats);
+			return read_mesh_cache(read);
+		}
+		return requestMeshLOD(mesh_params, lod, offset, size,
+							  stats.canRetry());
+	}
+
+	mMutex.lock();
+	mUnavailableLODs.emplace_back(mesh_params, lod);
+	mMutex.unlock();
+
+	return true;
+}
+
+bool LLMeshRepoThread::requestMeshLOD(const LLVolumeParams& mesh_params,
+									  S32 lod, S32 offset, S32 size,
+									  bool can_retry)
+{
+	U32 cap_version = 2;
+	std::string http_url = constructUrl(mesh_params.getSculptID(),
+										&cap_version);
+	bool available_lod = !http_url.empty();
+	if (available_lod)
+	{
+		LLMeshHandlerBase::ptr_t handler(new LLMeshLODHandler(mesh_params,
+															  lod, offset,
+															  size));
+		LLCore::HttpHandle handle =
+			getByteRange(http_url, cap_version, offset, size, handler);
+		if (handle == LLCORE_HTTP_HANDLE_INVALID)
+		{
+			llwarns << "HTTP GET request failed for LOD on mesh " << mID
+					<< " - Reason: " << mHttpStatus.toString() << " ("
+					<< mHttpStatus.toTerseString() << ")" << llendl;
+			return false;
+		}
+
+		if (can_retry)
+		{
+			handler->mHttpHandle = handle;
+			mHttpRequestSet.insert(handler);
+		}
+		else
 		{
-			U8* buffer = new(std::nothrow) U8[size];
-			if (!buffer)
+			available_lod = false;
+		}
+	}
+	if (!available_lod)
+	{
+		mMutex.lock();
+		mUnavailableLODs.emplace_back(mesh_params, lod);
+		mMutex.unlock();
+	}
+
+	return true;
+}
+
+void LLMeshRepoThread::processCacheReads()
+{
+	cache_reads_list_t reads;
+	mMutex.lock();
+	reads.swap(mCacheReads);
+	mMutex.unlock();
+
+	for (U32 i = 0, count = reads.size(); i < count; ++i)
+	{
+		LLMeshCacheRead* read = reads[i].get();
+		U8* buffer = read->mBuffer;
+		S32 size = read->mSize;
+		bool success = read->mBytesRead > 0;
+		if (read->mType != LLMeshCacheRead::HEADER)
+		{
+			// We need all the data, and we must make sure the buffer is not
+			// all zeros by checking the first 128 bytes (reserved block but
+			// not written)
+			success = read->mBytesRead == size;
+			if (success)
 			{
-				LLMemory::allocationFailed(size);
-				llwarns << "Could not allocate enough memory. Aborted."
-						<< llendl;
-				return false;
+				bool zero = true;
+				for (S32 j = 0, check = llmin(size, 128); j < check && zero;
+					 ++j)
+				{
+					zero = buffer[j] == 0;
+				}
+				success = !zero;
 			}
-			LLMeshRepository::sCacheBytesRead += size;
-			++LLMeshRepository::sCacheReads;
-			file.seek(offset);
-			file.read(buffer, size);
-
-			// Make sure the buffer is not all zeros by checking the first 128
-			// bytes (reserved block but not written)
-			bool zero = true;
-			for (S32 i = 0, count = llmin(size, 128); i < count && zero; ++i)
+		}
+
+		// Attempt to parse, or else fall back to fetching from the server.
+		// When the latter fails, retry later, like for failed fetchMesh*()
+		// calls.
+		const LLVolumeParams& mesh_params = read->mMeshParams;
+		const LLUUID& mesh_id = read->mMeshID;
+		bool can_retry = read->mStats.canRetry();
+		switch (read->mType)
+		{
+			case LLMeshCacheRead::HEADER:
 			{
-				zero = buffer[i] == 0;
+				if ((success &&
+					 headerReceived(mesh_params, buffer, read->mBytesRead)) ||
+					requestMeshHeader(mesh_params, can_retry))
+				{
+					break;
+				}
+				if (can_retry)
+				{
+					HeaderRequest req(mesh_params);
+					static_cast<LLRequestStats&>(req) = read->mStats;
+					req.updateTime();
+					mMutex.lock();
+					mHeaderReqQ.emplace_back(req);
+					mMutex.unlock();
+				}
+				else
+				{
+					llwarns << "Failed to load header " << mesh_params
+							<< ", skipping." << llendl;
+				}
+				break;
 			}
 
-			if (!zero)
+			case LLMeshCacheRead::LOD:
 			{
-				// Attempt to parse
-				if (lodReceived(mesh_params, lod, buffer, size))
+				S32 lod = read->mLOD;
+				if ((success && lodReceived(mesh_params, lod, buffer, size)) ||
+					requestMeshLOD(mesh_params, lod, read->mOffset, size,
+								   can_retry))
+				{
+					break;
+				}
+				if (can_retry)
+				{
+					LODRequest req(mesh_params, lod);
+					static_cast<LLRequestStats&>(req) = read->mStats;
+					req.updateTime();
+					mMutex.lock();
+					mLODReqQ.emplace_back(req);
+					mMutex.unlock();
+					++LLMeshRepository::sLODProcessing;
+				}
+				else
 				{
-					delete[] buffer;
-					return true;
+					llwarns << "Failed to load " << mesh_params
+							<< ", skipping." << llendl;
 				}
+				break;
 			}
 
-			delete[] buffer;
-		}
-
-		// Reading from cache failed for whatever reason, fetch from sim
-		U32 cap_version = 2;
-		std::string http_url = constructUrl(mesh_id, &cap_version);
-		available_lod = !http_url.empty();
-		if (available_lod)
-		{
-			LLMeshHandlerBase::ptr_t handler(new LLMeshLODHandler(mesh_params,
-																  lod, offset,
-																  size));
-			LLCore::HttpHandle handle =
-				getByteRange(http_url, cap_version, offset, size, handler);
-			if (handle == LLCORE_HTTP_HANDLE_INVALID)
+			case LLMeshCacheRead::SKIN:
 			{
-				llwarns << "HTTP GET request failed for LOD on mesh " << mID
-						<< " - Reason: " << mHttpStatus.toString() << " ("
-						<< mHttpStatus.toTerseString() << ")" << llendl;
-				return false;
+				if ((success && skinInfoReceived(mesh_id, buffer, size)) ||
+					requestMeshSkinInfo(mesh_id, read->mOffset, size))
+				{
+					break;
+				}
+				if (can_retry)
+				{
+					UUIDBasedRequest req(mesh_id);
+					static_cast<LLRequestStats&>(req) = read->mStats;
+					req.updateTime();
+					mMutex.lock();
+					mSkinRequests.insert(req);
+					mMutex.unlock();
+				}
+				else
+				{
+					// Common, harmless occurrence, so debug message only
+					LL_DEBUGS("Mesh") << "Skin request failed for " << mesh_id
+									  << LL_ENDL;
+				}
+				break;
 			}
 
-			if (can_retry)
+			case LLMeshCacheRead::DECOMPOSITION:
 			{
-				handler->mHttpHandle = handle;
-				mHttpRequestSet.insert(handler);
+				if ((success &&
+					 decompositionReceived(mesh_id, buffer, size)) ||
+					requestMeshDecomposition(mesh_id, read->mOffset, size))
+				{
+					break;
+				}
+				if (can_retry)
+				{
+					UUIDBasedRequest req(mesh_id);
+					static_cast<LLRequestStats&>(req) = read->mStats;
+					req.updateTime();
+					mMutex.lock();
+					mDecompositionRequests.insert(req);
+					mMutex.unlock();
+				}
+				else
+				{
+					llwarns << "Decomp request failed for " << mesh_id
+							<< llendl;
+				}
+				break;
 			}
-			else
+
+			case LLMeshCacheRead::PHYSICS_SHAPE:
 			{
-				available_lod = false;
+				if ((success && physicsShapeReceived(mesh_id, buffer, size)) ||
+					requestMeshPhysicsShape(mesh_id, read->mOffset, size))
+				{
+					break;
+				}
+				if (can_retry)
+				{
+					UUIDBasedRequest req(mesh_id);
+					static_cast<LLRequestStats&>(req) = read->mStats;
+					req.updateTime();
+					mMutex.lock();
+					mPhysicsShapeRequests.insert(req);
+					mMutex.unlock();
+				}
+				else
+				{
+					llwarns << "Physics shape request failed for " << mesh_id
+							<< llendl;
+				}
 			}
 		}
 	}
-	if (!available_lod)
-	{
-		mMutex.lock();
-		mUnavailableLODs.emplace_back(mesh_params, lod);
-		mMutex.unlock();
-	}
-
-	return true;
 }
 
 bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params,
@@ -3581,7 +3777,20 @@ void LLMeshHeaderHandler::processData(LLCore::BufferArray*, S32, U8* data,
 			++LLMeshRepository::sCacheWrites;
 
 			LLFileSystem file(mesh_id, LLFileSystem::OVERWRITE);
-			file.write(data, data_size);
+			if (file.isPacked() && bytes > data_size)
+			{
+				// With the pack store, reserve the space for the LODs now
+				// (padding with zeros), so that they later get written in
+				// place in the cache record instead of causing a rewrite of
+				// the whole record each time. HB
+				std::vector<U8> buffer(bytes);
+				memcpy((void*)buffer.data(), (void*)data, data_size);
+				file.write(buffer.data(), bytes);
+			}
+			else
+			{
+				file.write(data, data_size);
+			}
 		}
 		else
 		{
@@ -3982,6 +4191,29 @@ S32 LLMeshRepository::loadMesh(LLVOVolume* vobj,
 	return detail;
 }
 
+bool LLMeshRepository::prefetchMesh(const LLVolumeParams& mesh_params,
+									S32 detail)
+{
+	detail = llclamp(detail, 0, 3);
+
+	mMeshMutex.lock();
+	mesh_load_map_t& loading = mLoadingMeshes[detail];
+	if (loading.count(mesh_params))
+	{
+		mMeshMutex.unlock();
+		return false;
+	}
+	// Add it with an empty list of waiting objects: notifyMeshLoaded() and
+	// notifyMeshUnavailable() will then just update the system volume. Should
+	// an object request this mesh LOD meanwhile, loadMesh() will add it to the
+	// list.
+	loading[mesh_params];
+	mPendingRequests.emplace_back(mesh_params, detail);
+	++sLODPending;
+	mMeshMutex.unlock();
+	return true;
+}
+
 // Called from main thread
 void LLMeshRepository::notifyLoadedMeshes()
 {
@@ -4140,7 +4372,8 @@ void LLMeshRepository::notifyLoadedMeshes()
 			mUploadErrorQ.pop();
 		}
 		S32 active_count = LLMeshRepoThread::sActiveHeaderRequests +
-						   LLMeshRepoThread::sActiveLODRequests;
+						   LLMeshRepoThread::sActiveLODRequests +
+						   LLMeshRepoThread::sActiveCacheReads;
 		if (active_count < LLMeshRepoThread::sRequestLowWater)
 		{
 			S32 push_count = LLMeshRepoThread::sRequestHighWater -
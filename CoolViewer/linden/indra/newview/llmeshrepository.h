@@ -66,6 +66,7 @@
 // with not yet fully loaded meshes anyway... HB
 #define LL_PENDING_MESH_REQUEST_SORTING 0
 
+class LLMeshCacheRead;
 class LLMeshRepository;
 class LLVOVolume;
 
@@ -288,10 +289,15 @@ public:
 	void lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
 	void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
 
+	// These two methods, as well as the fetchMesh*() ones below, issue an
+	// asynchronous cache read when the data is cached, or else the request
+	// to the server. 'stats' are the retries stats of the corresponding
+	// request, for when the data could not be read from the cache and the
+	// request to the server failed to get issued.
 	bool fetchMeshHeader(const LLVolumeParams& mesh_params,
-						 bool can_retry = true);
+						 const LLRequestStats& stats);
 	bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
-					  bool can_retry = true);
+					  const LLRequestStats& stats);
 	bool headerReceived(const LLVolumeParams& mesh_params, U8* data,
 						S32 data_size);
 	bool lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data,
@@ -311,17 +317,20 @@ public:
 	// Sends the request for skin info, returns true if header info exists
 	// (should hold onto mesh_id and try again later if header info does not
 	// exist)
-	bool fetchMeshSkinInfo(const LLUUID& mesh_id);
+	bool fetchMeshSkinInfo(const LLUUID& mesh_id,
+						   const LLRequestStats& stats);
 
 	// Sends the request for decomposition, returns true if header info exists
 	// (should hold onto mesh_id and try again later if header info does not
 	// exist)
-	bool fetchMeshDecomposition(const LLUUID& mesh_id);
+	bool fetchMeshDecomposition(const LLUUID& mesh_id,
+								const LLRequestStats& stats);
 
 	// Sends the request for PhysicsShape, returns true if header info exists
 	// (should hold onto mesh_id and try again later if header info does not
 	// exist).
-	bool fetchMeshPhysicsShape(const LLUUID& mesh_id);
+	bool fetchMeshPhysicsShape(const LLUUID& mesh_id,
+							   const LLRequestStats& stats);
 
 	// Mutex: acquires mMutex
 	std::string constructUrl(const LLUUID& mesh_id, U32* version);
@@ -416,6 +425,34 @@ private:
 									size_t offset, size_t len,
 									const LLCore::HttpHandler::ptr_t& handler);
 
+	// Issue the requests to the server for the mesh data, when it is not
+	// cached or could not be read from the cache. They return false when the
+	// request could not be issued.
+	//
+	// Threads: Repo thread only
+	bool requestMeshHeader(const LLVolumeParams& mesh_params, bool can_retry);
+	bool requestMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
+						S32 offset, S32 size, bool can_retry);
+	bool requestMeshSkinInfo(const LLUUID& mesh_id, S32 offset, S32 size);
+	bool requestMeshDecomposition(const LLUUID& mesh_id, S32 offset,
+								  S32 size);
+	bool requestMeshPhysicsShape(const LLUUID& mesh_id, S32 offset,
+								 S32 size);
+
+	// Parses the data of the completed asynchronous cache reads, falling
+	// back to requests to the server for the failed ones.
+	//
+	// Threads: Repo thread only
+	void processCacheReads();
+
+	// Returns true when the outstanding HTTP requests and cache reads are
+	// below the high water mark.
+	LL_INLINE bool canRequest() const
+	{
+		return (S32)mHttpRequestSet.size() + sActiveCacheReads <
+				sRequestHighWater;
+	}
+
 	struct LoadedMesh
 	{
 		LoadedMesh(LLVolume* volume, const LLVolumeParams& mesh_params,
@@ -496,8 +533,14 @@ public:
 	typedef std::map<LLVolumeParams, std::vector<S32> > pending_lod_map_t;
 	pending_lod_map_t				mPendingLOD;
 
+	// Completed asynchronous cache reads, waiting to be processed
+	typedef std::vector<LLPointer<LLMeshCacheRead> > cache_reads_list_t;
+	cache_reads_list_t				mCacheReads;
+
 	static LLAtomicS32				sActiveHeaderRequests;
 	static LLAtomicS32				sActiveLODRequests;
+	// Issued, or completed but not yet processed, asynchronous cache reads
+	static LLAtomicS32				sActiveCacheReads;
 	static U32						sMaxConcurrentRequests;
 	static S32						sRequestLowWater;
 	static S32						sRequestHighWater;
@@ -706,6 +749,10 @@ public:
 	// Mesh management functions
 	S32 loadMesh(LLVOVolume* volume, const LLVolumeParams& mesh_params,
 				 S32 detail = 0, S32 last_lod = -1);
+	// Requests a mesh LOD no object is waiting for yet, so that it gets
+	// fetched (and cached) ahead of its use. Returns false when this LOD is
+	// already being loaded.
+	bool prefetchMesh(const LLVolumeParams& mesh_params, S32 detail);
 
 	void notifyLoadedMeshes();
 	void notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVolume* volume);
@@ -833,6 +880,8 @@ public:
 	static U32									sCacheBytesWritten;
 	static U32									sCacheReads;
 	static U32									sCacheWrites;
+	// Cumulated latency of the cache reads, in microseconds
+	static U64									sCacheReadTime;
 
 	// Maximum sequential locking failures
 	static U32									sMaxLockHoldoffs;
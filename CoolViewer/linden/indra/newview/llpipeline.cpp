@@ -40,6 +40,8 @@
 #include "llaudioengine.h"			// For sound beacons
 #include "llcubemap.h"
 #include "llfasttimer.h"
+#include "llimagebc.h"
+#include "llthreadpool.h"
 
 #include "llagent.h"
 #include "llappviewer.h"
@@ -328,6 +330,7 @@ LLPipeline::LLPipeline()
 	mBatchCount(0),
 	mMatrixOpCount(0),
 	mTextureMatrixOps(0),
+	mDrawCallsSaved(0),
 	mMaxBatchSize(0),
 	mMinBatchSize(0),
 	mTrianglesDrawn(0),
@@ -431,6 +434,8 @@ void LLPipeline::init()
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBool("RenderUseVAO");
 	LLVertexBuffer::sUseStreamDraw =
 		gSavedSettings.getBool("RenderUseStreamVBO");
+	LLVertexBuffer::sUseStreamRing =
+		gSavedSettings.getBool("RenderUseStreamRing");
 	LLVertexBuffer::sPreferStreamDraw =
 		gSavedSettings.getBool("RenderPreferStreamDraw");
 
@@ -450,6 +455,9 @@ void LLPipeline::init()
 		LLImageGL::sCompressThreshold =
 			gSavedSettings.getU32("RenderCompressThreshold");
 	}
+	LLImageGL::sUsePBOUploads = gSavedSettings.getBool("RenderUsePBOUploads");
+	LLImageBC::sEnabled = gGLManager.mHasTextureCompressionS3TC &&
+						  gSavedSettings.getBool("RenderCompressTexturesOnCPU");
 
 	mInitialized = true;
 
@@ -2780,6 +2788,54 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result,
 		camera.disableUserClipPlane();
 	}
 
+	// When enabled, the frustum checks for all the spatial partitions of all
+	// regions are performed in parallel on the threads pool, while the
+	// occlusion checks and the culling results (which involve GL calls and
+	// the pipeline state) are then applied in the main thread and in the same
+	// order as for the serial culling. This is not possible when using old
+	// culling with a water clip plane, since the latter then varies with each
+	// region.
+	static LLCachedControl<bool> parallel_culling(gSavedSettings,
+												  "RenderParallelCulling");
+	bool parallel = parallel_culling && gThreadPoolp &&
+					(use_new_culling || !water_clip);
+	if (parallel)
+	{
+		if (!use_new_culling)
+		{
+			camera.disableUserClipPlane();
+		}
+
+		static std::vector<LLSpatialPartition*> partitions;
+		partitions.clear();
+		for (LLWorld::region_list_t::const_iterator
+				iter = gWorld.getRegionList().begin(),
+				end = gWorld.getRegionList().end();
+			 iter != end; ++iter)
+		{
+			LLViewerRegion* region = *iter;
+			for (U32 i = 0; i < LLViewerRegion::PARTITION_VO_CACHE; ++i)
+			{
+				LLSpatialPartition* part = region->getSpatialPartition(i);
+				if (hasRenderType(part->mDrawableType) ||
+					(!hud_attachments && i == LLViewerRegion::PARTITION_BRIDGE))
+				{
+					part->cullRebound();
+					partitions.push_back(part);
+				}
+			}
+		}
+
+		{
+			LL_FAST_TIMER(FTM_FRUSTUM_CULL);
+			gThreadPoolp->parallelFor(partitions.size(),
+									  [&camera](U32 i)
+									  {
+										partitions[i]->cullFrustum(camera);
+									  });
+		}
+	}
+
 	for (LLWorld::region_list_t::const_iterator
 			iter = gWorld.getRegionList().begin(),
 			end = gWorld.getRegionList().end();
@@ -2787,7 +2843,19 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result,
 	{
 		LLViewerRegion* region = *iter;
 
-		if (!use_new_culling)
+		if (parallel)
+		{
+			for (U32 i = 0; i < LLViewerRegion::PARTITION_VO_CACHE; ++i)
+			{
+				LLSpatialPartition* part = region->getSpatialPartition(i);
+				if (hasRenderType(part->mDrawableType) ||
+					(!hud_attachments && i == LLViewerRegion::PARTITION_BRIDGE))
+				{
+					part->cullApply(camera);
+				}
+			}
+		}
+		else if (!use_new_culling)
 		{
 			if (water_clip != 0)
 			{
@@ -2802,14 +2870,18 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result,
 			}
 		}
 
-		for (U32 i = 0; i < LLViewerRegion::PARTITION_VO_CACHE; ++i)
+		if (!parallel)
 		{
-			LLSpatialPartition* part = region->getSpatialPartition(i);
-			// None of the partitions under PARTITION_VO_CACHE can be NULL
-			if (hasRenderType(part->mDrawableType) ||
-				(!hud_attachments && i == LLViewerRegion::PARTITION_BRIDGE))
+			for (U32 i = 0; i < LLViewerRegion::PARTITION_VO_CACHE; ++i)
 			{
-				part->cull(camera);
+				LLSpatialPartition* part = region->getSpatialPartition(i);
+				// None of the partitions under PARTITION_VO_CACHE can be NULL
+				if (hasRenderType(part->mDrawableType) ||
+					(!hud_attachments &&
+					 i == LLViewerRegion::PARTITION_BRIDGE))
+				{
+					part->cull(camera);
+				}
 			}
 		}
 
@@ -4406,6 +4478,14 @@ void LLPipeline::postSort(LLCamera& camera)
 	}
 	mMeshDirtyGroup.clear();
 
+	static LLCachedControl<bool> sort_draws(gSavedSettings,
+											"RenderSortDrawInfos");
+	if (sort_draws)
+	{
+		LL_FAST_TIMER(FTM_STATESORT_SORT_DRAWS);
+		sCull->sortRenderMaps(camera.getOrigin());
+	}
+
 	if (!sShadowRender)
 	{
 		std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(),
@@ -7427,6 +7507,8 @@ void LLPipeline::doResetVertexBuffers(bool forced)
 	sRenderBump = gSavedSettings.getBool("RenderObjectBump");
 	LLVertexBuffer::sUseStreamDraw =
 		gSavedSettings.getBool("RenderUseStreamVBO");
+	LLVertexBuffer::sUseStreamRing =
+		gSavedSettings.getBool("RenderUseStreamRing");
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBool("RenderUseVAO");
 	LLVertexBuffer::sPreferStreamDraw =
 		gSavedSettings.getBool("RenderPreferStreamDraw");
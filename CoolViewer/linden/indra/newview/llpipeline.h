@@ -573,6 +573,7 @@ public:
 	S32								mBatchCount;
 	S32								mMatrixOpCount;
 	S32								mTextureMatrixOps;
+	S32								mDrawCallsSaved;
 	S32								mMaxBatchSize;
 	S32								mMinBatchSize;
 	S32								mTrianglesDrawn;
@@ -0,0 +1,478 @@
+/**
+ * @file llprefetchpredictor.cpp
+ * @brief Predictive prefetching of cached objects assets.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llprefetchpredictor.h"
+
+#include "llvolumemgr.h"
+
+#include "llagent.h"
+#include "llmeshrepository.h"
+#include "llviewercamera.h"
+#include "llviewercontrol.h"
+#include "llviewerregion.h"
+#include "llviewertexturelist.h"
+#include "llvocache.h"
+#include "llvovolume.h"
+#include "llworld.h"
+
+// Interval between two predictions, in seconds.
+constexpr F32 PREDICTION_INTERVAL = 0.5f;
+// Number of points sampled along the predicted camera path.
+constexpr U32 PREDICTION_STEPS = 3;
+// Minimum camera linear (m/s) and at-axis (1/s) speeds for predictions.
+constexpr F32 MIN_SPEED = 0.5f;
+constexpr F32 MIN_TURN_SPEED = 0.05f;
+// Above this speed (m/s), the motion is a teleport or a camera jump.
+constexpr F32 MAX_SPEED = 200.f;
+// Radius (m) around a teleport destination within which to prefetch.
+constexpr F32 TELEPORT_RADIUS = 64.f;
+// How long (beyond the prediction horizon) a prefetched asset is kept before
+// being accounted as a miss.
+constexpr F32 PREFETCH_TIMEOUT = 15.f;
+// How long a cache entry is ignored after it was considered.
+constexpr F32 SEEN_ENTRY_TIMEOUT = 30.f;
+// Limits on the work done and the number of pending prefetches.
+constexpr U32 MAX_ENTRIES_PER_UPDATE = 64;
+constexpr U32 MAX_PENDING = 1024;
+// Virtual size range (in pixels) for the prefetched textures.
+constexpr F32 MIN_VIRTUAL_SIZE = 32.f * 32.f;
+constexpr F32 MAX_VIRTUAL_SIZE = 256.f * 256.f;
+
+LLPrefetchPredictor::textures_map_t LLPrefetchPredictor::sTextures;
+LLPrefetchPredictor::meshes_map_t LLPrefetchPredictor::sMeshes;
+LLPrefetchPredictor::entries_map_t LLPrefetchPredictor::sSeenEntries;
+LLVector3d LLPrefetchPredictor::sLastOrigin;
+LLVector3 LLPrefetchPredictor::sLastAtAxis;
+LLVector3 LLPrefetchPredictor::sVelocity;
+LLVector3 LLPrefetchPredictor::sAtAxisVelocity;
+F32 LLPrefetchPredictor::sLastUpdateTime = 0.f;
+U32 LLPrefetchPredictor::sEntriesBudget = 0;
+U32 LLPrefetchPredictor::sTextureRequests = 0;
+U32 LLPrefetchPredictor::sTextureHits = 0;
+U32 LLPrefetchPredictor::sTextureMisses = 0;
+U32 LLPrefetchPredictor::sMeshRequests = 0;
+U32 LLPrefetchPredictor::sMeshHits = 0;
+U32 LLPrefetchPredictor::sMeshMisses = 0;
+
+// Returns true when the sphere at 'delta' from the camera, with 'dist' the
+// length of 'delta', is within the cone of half angle 'half_angle' around
+// 'at_axis'.
+static bool in_view_cone(const LLVector3& delta, F32 dist, F32 radius,
+						 const LLVector3& at_axis, F32 half_angle)
+{
+	if (dist <= radius)
+	{
+		return true;
+	}
+	F32 cos_angle = llclamp(delta * at_axis / dist, -1.f, 1.f);
+	return acosf(cos_angle) - asinf(radius / dist) < half_angle;
+}
+
+//static
+void LLPrefetchPredictor::cleanup()
+{
+	sTextures.clear();
+	sMeshes.clear();
+	sSeenEntries.clear();
+	sVelocity.clear();
+	sAtAxisVelocity.clear();
+	sLastUpdateTime = 0.f;
+}
+
+//static
+F32 LLPrefetchPredictor::getHitRate()
+{
+	U32 hits = sTextureHits + sMeshHits;
+	U32 resolved = hits + sTextureMisses + sMeshMisses;
+	return resolved ? 100.f * (F32)hits / (F32)resolved : 0.f;
+}
+
+//static
+void LLPrefetchPredictor::update()
+{
+	static LLCachedControl<bool> enabled(gSavedSettings, "PrefetchPredictor");
+	if (!enabled)
+	{
+		if (sLastUpdateTime > 0.f)
+		{
+			cleanup();
+		}
+		return;
+	}
+
+	updatePending();
+
+	if (gFrameTimeSeconds - sLastUpdateTime < PREDICTION_INTERVAL)
+	{
+		return;
+	}
+	updateMotion();
+
+	// Forget about the entries considered long ago, so that they may be
+	// considered again if they did not get instantiated meanwhile.
+	for (entries_map_t::iterator it = sSeenEntries.begin();
+		 it != sSeenEntries.end(); )
+	{
+		if (it->second < gFrameTimeSeconds)
+		{
+			sSeenEntries.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if (getPending() >= MAX_PENDING)
+	{
+		return;
+	}
+	sEntriesBudget = MAX_ENTRIES_PER_UPDATE;
+
+	// When teleporting to a known destination in a region we are connected to
+	// (local teleports, or to neighbour regions), prefetch the assets of the
+	// objects around that destination.
+	if (gAgent.teleportInProgress())
+	{
+		const LLVector3d& dest_global = gAgent.getTeleportedPosGlobal();
+		if (!dest_global.isExactlyZero())
+		{
+			LLViewerRegion* regionp =
+				gWorld.getRegionFromPosGlobal(dest_global);
+			if (regionp)
+			{
+				LLVector3 dest = gAgent.getPosAgentFromGlobal(dest_global);
+				prefetchRegion(regionp, 0.f, &dest);
+			}
+		}
+		// The camera motion is meaningless while teleporting
+		return;
+	}
+
+	if (sVelocity.lengthSquared() < MIN_SPEED * MIN_SPEED &&
+		sAtAxisVelocity.lengthSquared() < MIN_TURN_SPEED * MIN_TURN_SPEED)
+	{
+		// Static camera: the normal objects culling will do just fine.
+		return;
+	}
+
+	static LLCachedControl<F32> horizon(gSavedSettings,
+										"PrefetchPredictorHorizon");
+	F32 seconds = llclamp((F32)horizon, 1.f, 10.f);
+	for (LLWorld::region_list_t::const_iterator
+			it = gWorld.getRegionList().begin(),
+			end = gWorld.getRegionList().end();
+		 it != end && sEntriesBudget; ++it)
+	{
+		prefetchRegion(*it, seconds, NULL);
+	}
+}
+
+//static
+void LLPrefetchPredictor::updatePending()
+{
+	// Textures: a texture is a hit as soon as a face uses it, meaning its
+	// object got instantiated. Until then, keep it wanted with our virtual
+	// size, since it got no face to provide one.
+	for (textures_map_t::iterator it = sTextures.begin();
+		 it != sTextures.end(); )
+	{
+		PrefetchedTexture& data = it->second;
+		if (data.mTexture->getTotalNumFaces() > 0)
+		{
+			++sTextureHits;
+			sTextures.erase(it++);
+		}
+		else if (data.mExpiry < gFrameTimeSeconds)
+		{
+			++sTextureMisses;
+			sTextures.erase(it++);
+		}
+		else
+		{
+			data.mTexture->addTextureStats(data.mVirtualSize);
+			++it;
+		}
+	}
+
+	// Meshes: a mesh is a hit when a volume using it got created.
+	for (meshes_map_t::iterator it = sMeshes.begin(); it != sMeshes.end(); )
+	{
+		PrefetchedMesh& data = it->second;
+		if (gVolumeMgrp && gVolumeMgrp->getGroup(data.mParams))
+		{
+			++sMeshHits;
+			sMeshes.erase(it++);
+		}
+		else if (data.mExpiry < gFrameTimeSeconds)
+		{
+			++sMeshMisses;
+			sMeshes.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+//static
+void LLPrefetchPredictor::updateMotion()
+{
+	F32 dt = gFrameTimeSeconds - sLastUpdateTime;
+	sLastUpdateTime = gFrameTimeSeconds;
+
+	LLVector3d origin = gAgent.getPosGlobalFromAgent(gViewerCamera.getOrigin());
+	const LLVector3& at_axis = gViewerCamera.getAtAxis();
+	if (dt > 0.f && dt < 4.f * PREDICTION_INTERVAL)
+	{
+		LLVector3 velocity = LLVector3(origin - sLastOrigin) / dt;
+		if (velocity.lengthSquared() > MAX_SPEED * MAX_SPEED)
+		{
+			sVelocity.clear();
+			sAtAxisVelocity.clear();
+		}
+		else
+		{
+			// Smooth the motion over the last updates
+			sVelocity = lerp(sVelocity, velocity, 0.5f);
+			sAtAxisVelocity = lerp(sAtAxisVelocity,
+								   (at_axis - sLastAtAxis) / dt, 0.5f);
+		}
+	}
+	else
+	{
+		sVelocity.clear();
+		sAtAxisVelocity.clear();
+	}
+	sLastOrigin = origin;
+	sLastAtAxis = at_axis;
+}
+
+//static
+void LLPrefetchPredictor::prefetchRegion(LLViewerRegion* regionp,
+										 F32 horizon, const LLVector3* tp_dest)
+{
+	if (!regionp || !regionp->isAlive())
+	{
+		return;
+	}
+
+	const LLVector3& origin = gViewerCamera.getOrigin();
+	const LLVector3& at_axis = gViewerCamera.getAtAxis();
+	F32 far_dist = gAgent.mDrawDistance;
+	F32 tan_half = tanf(0.5f * gViewerCamera.getView());
+	F32 aspect = gViewerCamera.getAspect();
+	F32 half_angle = atanf(tan_half * sqrtf(1.f + aspect * aspect));
+
+	// Predicted camera positions and orientations along the path
+	LLVector3 origins[PREDICTION_STEPS];
+	LLVector3 at_axes[PREDICTION_STEPS];
+	U32 steps = tp_dest ? 0 : PREDICTION_STEPS;
+	for (U32 i = 0; i < steps; ++i)
+	{
+		F32 t = horizon * (F32)(i + 1) / (F32)PREDICTION_STEPS;
+		origins[i] = origin + sVelocity * t;
+		at_axes[i] = at_axis + sAtAxisVelocity * t;
+		at_axes[i].normalize();
+	}
+
+	// Reject the regions which cannot be reached by the predicted frusta.
+	LLVector3 region_origin = regionp->getOriginAgent();
+	F32 half_width = 0.5f * regionp->getWidth();
+	LLVector3 region_center = region_origin +
+							  LLVector3(half_width, half_width, 0.f);
+	if (tp_dest)
+	{
+		if (dist_vec(*tp_dest, region_center) >
+				TELEPORT_RADIUS + half_width * F_SQRT2)
+		{
+			return;
+		}
+	}
+	else if (dist_vec(origins[steps - 1], region_center) >
+				far_dist + horizon * sVelocity.length() +
+				half_width * F_SQRT2 &&
+			 dist_vec(origin, region_center) >
+				far_dist + half_width * F_SQRT2)
+	{
+		return;
+	}
+
+	const LLVOCacheEntry::vocache_entry_map_t& entries =
+		regionp->getCacheMap();
+	for (LLVOCacheEntry::vocache_entry_map_t::const_iterator
+			it = entries.begin(), end = entries.end();
+		 it != end && sEntriesBudget; ++it)
+	{
+		LLVOCacheEntry* entryp = it->second.get();
+		if (!entryp || !entryp->isValid() || entryp->isChild() ||
+			!entryp->isState(LLVOCacheEntry::INACTIVE) ||
+			!entryp->getEntry() || sSeenEntries.count(entryp))
+		{
+			continue;
+		}
+
+		LLVector3 center(entryp->getEntry()->getPositionGroup().getF32ptr());
+		center += region_origin;
+		F32 radius = entryp->getBinRadius();
+
+		F32 distance = -1.f;
+		if (tp_dest)
+		{
+			F32 dist = dist_vec(center, *tp_dest);
+			if (dist < TELEPORT_RADIUS + radius)
+			{
+				distance = dist;
+			}
+		}
+		else
+		{
+			LLVector3 delta = center - origin;
+			F32 dist = delta.length();
+			if (dist < far_dist + radius &&
+				in_view_cone(delta, dist, radius, at_axis, half_angle))
+			{
+				// Already in view: the normal objects culling will deal with
+				// it.
+				continue;
+			}
+			for (U32 i = 0; i < steps; ++i)
+			{
+				delta = center - origins[i];
+				dist = delta.length();
+				if (dist < far_dist + radius &&
+					in_view_cone(delta, dist, radius, at_axes[i],
+								 half_angle))
+				{
+					distance = dist;
+					break;
+				}
+			}
+		}
+		if (distance < 0.f)
+		{
+			continue;
+		}
+
+		sSeenEntries.emplace(entryp, gFrameTimeSeconds + SEEN_ENTRY_TIMEOUT);
+		--sEntriesBudget;
+		prefetchEntry(entryp, llmax(distance, 1.f), radius);
+		// Children of linksets are only attached to their (inactive) parent
+		const LLVOCacheEntry::vocache_entry_set_t& children =
+			entryp->getChildren();
+		for (LLVOCacheEntry::vocache_entry_set_t::const_iterator
+				cit = children.begin(), cend = children.end();
+			 cit != cend; ++cit)
+		{
+			prefetchEntry(*cit, llmax(distance, 1.f), radius);
+		}
+	}
+}
+
+//static
+void LLPrefetchPredictor::prefetchEntry(LLVOCacheEntry* entryp, F32 distance,
+										F32 radius)
+{
+	if (!entryp || getPending() >= MAX_PENDING)
+	{
+		return;
+	}
+
+	static uuid_list_t texture_ids;
+	texture_ids.clear();
+	LLVolumeParams mesh_params;
+	if (!entryp->getAssetIDs(texture_ids, mesh_params))
+	{
+		return;
+	}
+
+	F32 expiry = gFrameTimeSeconds + PREFETCH_TIMEOUT;
+
+	// Approximate pixel area of the object once in view.
+	F32 pixels = 2.f * radius * gViewerCamera.getPixelMeterRatio() / distance;
+	F32 vsize = llclamp(pixels * pixels, MIN_VIRTUAL_SIZE, MAX_VIRTUAL_SIZE);
+	for (uuid_list_t::const_iterator it = texture_ids.begin(),
+									 end = texture_ids.end();
+		 it != end; ++it)
+	{
+		const LLUUID& id = *it;
+		textures_map_t::iterator tit = sTextures.find(id);
+		if (tit != sTextures.end())
+		{
+			PrefetchedTexture& data = tit->second;
+			data.mVirtualSize = llmax(data.mVirtualSize, vsize);
+			data.mExpiry = expiry;
+			continue;
+		}
+		LLViewerFetchedTexture* texp = gTextureList.findImage(id);
+		if (texp && texp->getTotalNumFaces() > 0)
+		{
+			continue;	// Already in use
+		}
+		texp = LLViewerTextureManager::getFetchedTexture(id, FTT_DEFAULT,
+														 true,
+														 LLGLTexture::BOOST_NONE,
+														 LLViewerTexture::LOD_TEXTURE);
+		if (!texp || texp->isMissingAsset())
+		{
+			continue;
+		}
+		texp->addTextureStats(vsize);
+		PrefetchedTexture& data = sTextures[id];
+		data.mTexture = texp;
+		data.mVirtualSize = vsize;
+		data.mExpiry = expiry;
+		++sTextureRequests;
+	}
+
+	const LLUUID& mesh_id = mesh_params.getSculptID();
+	if (mesh_id.isNull() || sMeshes.count(mesh_id) ||
+		!gMeshRepo.meshRezEnabled() ||
+		// Already in use by an object
+		(gVolumeMgrp && gVolumeMgrp->getGroup(mesh_params)))
+	{
+		return;
+	}
+	S32 lod = LLVOVolume::computeLODDetail(distance *
+										   LLVOVolume::sDistanceFactor,
+										   radius, LLVOVolume::sLODFactor);
+	if (gMeshRepo.prefetchMesh(mesh_params, lod))
+	{
+		PrefetchedMesh& data = sMeshes[mesh_id];
+		data.mParams = mesh_params;
+		data.mExpiry = expiry;
+		++sMeshRequests;
+	}
+}
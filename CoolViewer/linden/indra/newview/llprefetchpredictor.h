@@ -0,0 +1,132 @@
+/**
+ * @file llprefetchpredictor.h
+ * @brief Predictive prefetching of cached objects assets.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewergpl$
+ *
+ * Copyright (c) 2026, Henri Beauchamp.
+ *
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ *
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ *
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ *
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLPREFETCHPREDICTOR_H
+#define LL_LLPREFETCHPREDICTOR_H
+
+#include "llfastmap.h"
+#include "llpointer.h"
+#include "lluuid.h"
+#include "llvector3.h"
+#include "llvector3d.h"
+#include "llvolume.h"
+
+class LLVOCacheEntry;
+class LLViewerFetchedTexture;
+class LLViewerRegion;
+
+// Predictive prefetching of the textures and mesh LODs used by the objects
+// which are still only present in the objects cache (i.e. not yet
+// instantiated), and which should enter the view within the next seconds,
+// based on the extrapolated camera motion, or which are close to the
+// destination of a teleport in progress, when that destination lies in a
+// region we are already connected to. The textures are fetched with a small
+// virtual size, so that they get a low priority compared with the ones of the
+// visible objects. HB
+
+class LLPrefetchPredictor
+{
+	LLPrefetchPredictor() = delete;
+	~LLPrefetchPredictor() = delete;
+
+protected:
+	LOG_CLASS(LLPrefetchPredictor);
+
+public:
+	// Called once per frame, from the main thread.
+	static void update();
+	// Releases all the pending prefetches.
+	static void cleanup();
+
+	// Statistics
+	LL_INLINE static U32 getTextureRequests()			{ return sTextureRequests; }
+	LL_INLINE static U32 getTextureHits()				{ return sTextureHits; }
+	LL_INLINE static U32 getMeshRequests()				{ return sMeshRequests; }
+	LL_INLINE static U32 getMeshHits()					{ return sMeshHits; }
+	LL_INLINE static U32 getPending()
+	{
+		return sTextures.size() + sMeshes.size();
+	}
+	// Percentage of the resolved (used or expired) prefetches which got used.
+	static F32 getHitRate();
+
+private:
+	static void updatePending();
+	static void updateMotion();
+	static void prefetchRegion(LLViewerRegion* regionp, F32 horizon,
+							   const LLVector3* tp_dest);
+	static void prefetchEntry(LLVOCacheEntry* entryp, F32 distance,
+							  F32 radius);
+
+private:
+	struct PrefetchedTexture
+	{
+		LLPointer<LLViewerFetchedTexture>	mTexture;
+		F32									mVirtualSize;
+		F32									mExpiry;
+	};
+	typedef fast_hmap<LLUUID, PrefetchedTexture> textures_map_t;
+	static textures_map_t		sTextures;
+
+	struct PrefetchedMesh
+	{
+		LLVolumeParams	mParams;
+		F32				mExpiry;
+	};
+	typedef fast_hmap<LLUUID, PrefetchedMesh> meshes_map_t;
+	static meshes_map_t			sMeshes;
+
+	// Cache entries already considered, with the time after which they may
+	// be considered again. Only used to compare pointers.
+	typedef fast_hmap<const LLVOCacheEntry*, F32> entries_map_t;
+	static entries_map_t		sSeenEntries;
+
+	// Camera motion, in global coordinates (so that the agent coordinates
+	// change on region crossing does not count as a motion).
+	static LLVector3d			sLastOrigin;
+	static LLVector3			sLastAtAxis;
+	static LLVector3			sVelocity;
+	static LLVector3			sAtAxisVelocity;
+	static F32					sLastUpdateTime;
+
+	// Per-update budget of newly considered cache entries.
+	static U32					sEntriesBudget;
+
+	static U32					sTextureRequests;
+	static U32					sTextureHits;
+	static U32					sTextureMisses;
+	static U32					sMeshRequests;
+	static U32					sMeshHits;
+	static U32					sMeshMisses;
+};
+
+#endif	// LL_LLPREFETCHPREDICTOR_H
@@ -307,6 +307,70 @@ void LLSkinningUtil::getPerVertexSkinMatrix(const LLVector4a& weights,
 	}
 }
 
+//static
+void LLSkinningUtil::skinVertices(const LLMatrix4a* mat,
+								  const LLVector4a* weights,
+								  const LLVector4a* positions,
+								  const LLVector4a* normals, U32 count,
+								  LLVector4a* out_pos, LLVector4a* out_norm)
+{
+	constexpr S16 LAST_JOINT = (S16)LL_MAX_JOINTS_PER_MESH_OBJECT - 1;
+	const __m128i max_idx = _mm_set1_epi16(LAST_JOINT);
+	alignas(16) S32 idx[4];
+	alignas(16) F32 wght[4];
+	LLMatrix4a final_mat;
+#if defined(__AVX2__)
+	// Two matrix rows per AVX register, so the blending of the four joints
+	// matrices only takes 8 multiply-adds per vertex.
+	F32* final_ptr = final_mat.getF32ptr();
+#else
+	LLMatrix4a src;
+#endif
+	for (U32 i = 0; i < count; ++i)
+	{
+		// Same weights decoding as in getPerVertexSkinMatrix(), minus the bad
+		// scale handling since the weights got checked by the caller.
+		__m128i m_idx = _mm_cvttps_epi32((LLQuad)weights[i]);
+		LLQuad w = _mm_sub_ps((LLQuad)weights[i], _mm_cvtepi32_ps(m_idx));
+		_mm_store_si128((__m128i*)idx, _mm_min_epi16(m_idx, max_idx));
+		LLQuad scale = _mm_add_ps(w, _mm_movehl_ps(w, w));
+		scale = _mm_add_ss(scale, _mm_shuffle_ps(scale, scale, 1));
+		scale = _mm_shuffle_ps(scale, scale, 0);
+		_mm_store_ps(wght, _mm_div_ps(w, scale));
+
+#if defined(__AVX2__)
+		const F32* m = mat[idx[0]].getF32ptr();
+		__m256 wk = _mm256_set1_ps(wght[0]);
+		__m256 r01 = _mm256_mul_ps(_mm256_loadu_ps(m), wk);
+		__m256 r23 = _mm256_mul_ps(_mm256_loadu_ps(m + 8), wk);
+		for (U32 k = 1; k < 4; ++k)
+		{
+			m = mat[idx[k]].getF32ptr();
+			wk = _mm256_set1_ps(wght[k]);
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_loadu_ps(m), wk));
+			r23 = _mm256_add_ps(r23,
+								_mm256_mul_ps(_mm256_loadu_ps(m + 8), wk));
+		}
+		_mm256_storeu_ps(final_ptr, r01);
+		_mm256_storeu_ps(final_ptr + 8, r23);
+#else
+		final_mat.setMul(mat[idx[0]], wght[0]);
+		for (U32 k = 1; k < 4; ++k)
+		{
+			src.setMul(mat[idx[k]], wght[k]);
+			final_mat.add(src);
+		}
+#endif
+
+		final_mat.affineTransform(positions[i], out_pos[i]);
+		if (out_norm)
+		{
+			final_mat.rotate(normals[i], out_norm[i]);
+			out_norm[i].normalize3fast();
+		}
+	}
+}
+
 void LLSkinningUtil::updateRiggingInfo(const LLMeshSkinInfo* skin,
 									   LLVOAvatar* avatar,
 									   LLVolumeFace& vol_face)
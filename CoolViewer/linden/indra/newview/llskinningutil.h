@@ -33,6 +33,7 @@
 class LLMatrix4a;
 class LLMeshSkinInfo;
 class LLQuaternion;
+class LLVector4a;
 class LLVOAvatar;
 class LLVolumeFace;
 
@@ -56,6 +57,16 @@ public:
 									   LLMatrix4a& final_mat,
 									   bool handle_bad_scale = false);
 
+	// Skins 'count' vertices at once: 'mat' must be a palette with the bind
+	// shape matrix already applied (see LLVOAvatar::getBoundRiggedMatrix4a()).
+	// 'normals' and 'out_norm' may be NULL when there are no normals to skin.
+	// This method does not touch any shared state and is therefore safe to
+	// call from worker threads. The weights must have been checked already.
+	static void skinVertices(const LLMatrix4a* mat, const LLVector4a* weights,
+							 const LLVector4a* positions,
+							 const LLVector4a* normals, U32 count,
+							 LLVector4a* out_pos, LLVector4a* out_norm);
+
 	static void updateRiggingInfo(const LLMeshSkinInfo* skin,
 								  LLVOAvatar* avatar, LLVolumeFace& volface);
 
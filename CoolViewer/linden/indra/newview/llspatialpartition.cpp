@@ -39,6 +39,7 @@
 #include "lloctree.h"
 #include "llphysicsshapebuilderutil.h"
 #include "llrender.h"
+#include "llthreadpool.h"
 #include "llvolume.h"
 #include "llvolumeoctree.h"
 
@@ -832,6 +833,8 @@ void LLSpatialGroup::handleDestruction(const TreeNode* node)
 	}
 	setState(DEAD);
 
+	getSpatialPartition()->mBoundsSnapshot.invalidate();
+
 	for (element_iter i = getDataBegin(); i != getDataEnd(); ++i)
 	{
 		LLViewerOctreeEntry* entry = *i;
@@ -874,6 +877,8 @@ void LLSpatialGroup::handleChildAddition(const OctreeNode* parent,
 		llassert(false);
 	}
 
+	getSpatialPartition()->mBoundsSnapshot.invalidate();
+
 	unbound();
 
 	assert_states_valid(this);
@@ -1059,6 +1064,7 @@ void LLSpatialPartition::shift(const LLVector4a& offset)
 	// Shift octree node bounding boxes by offset
 	LLSpatialShift shifter(offset);
 	shifter.traverse(mOctree);
+	mBoundsSnapshot.invalidate();
 }
 
 class LLOctreeCull : public LLViewerOctreeCull
@@ -1112,6 +1118,24 @@ public:
 		return res;
 	}
 
+	bool frustumCheckBatch(LLViewerOctreeBounds& bounds) override
+	{
+		const F32* soa[6];
+		for (U32 i = 0; i < 6; ++i)
+		{
+			soa[i] = bounds.mComponents[i].data();
+		}
+		mCamera->AABBsInFrustum(soa, bounds.size(), bounds.mResults.data(),
+								true);
+		return true;
+	}
+
+	S32 frustumCheckRefine(const LLViewerOctreeGroup* group,
+						   S32 res) override
+	{
+		return llmin(res, AABBSphereIntersectGroupExtents(group));
+	}
+
 	S32 frustumCheckObjects(const LLViewerOctreeGroup* group) override
 	{
 		S32 res = AABBInFrustumNoFarClipObjectBounds(group);
@@ -1159,6 +1183,12 @@ public:
 	{
 		return AABBInFrustumNoFarClipObjectBounds(group);
 	}
+
+	S32 frustumCheckRefine(const LLViewerOctreeGroup* group,
+						   S32 res) override
+	{
+		return res;
+	}
 };
 
 class LLOctreeCullShadow : public LLOctreeCull
@@ -1178,6 +1208,23 @@ public:
 	{
 		return AABBInFrustumObjectBounds(group);
 	}
+
+	bool frustumCheckBatch(LLViewerOctreeBounds& bounds) override
+	{
+		const F32* soa[6];
+		for (U32 i = 0; i < 6; ++i)
+		{
+			soa[i] = bounds.mComponents[i].data();
+		}
+		mCamera->AABBsInFrustum(soa, bounds.size(), bounds.mResults.data());
+		return true;
+	}
+
+	S32 frustumCheckRefine(const LLViewerOctreeGroup* group,
+						   S32 res) override
+	{
+		return res;
+	}
 };
 
 class LLOctreeCullVisExtents final : public LLOctreeCullShadow
@@ -1641,6 +1688,38 @@ S32 LLSpatialPartition::cull(LLCamera& camera,
 }
 
 S32 LLSpatialPartition::cull(LLCamera& camera, bool do_occlusion)
+{
+	cullRebound();
+
+	if (LLViewerOctreeBounds::sUseSnapshots)
+	{
+		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
+		cullFrustum(camera);
+		cullApply(camera);
+	}
+	else if (LLPipeline::sShadowRender)
+	{
+		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
+		LLOctreeCullShadow culler(&camera);
+		culler.traverse(mOctree);
+	}
+	else if (mInfiniteFarClip || !LLPipeline::sUseFarClip)
+	{
+		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
+		LLOctreeCullNoFarClip culler(&camera);
+		culler.traverse(mOctree);
+	}
+	else
+	{
+		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
+		LLOctreeCull culler(&camera);
+		culler.traverse(mOctree);
+	}
+
+	return 0;
+}
+
+void LLSpatialPartition::cullRebound()
 {
 #if LL_OCTREE_PARANOIA_CHECK
 	((LLSpatialGroup*)mOctree->getListener(0))->checkStates();
@@ -1658,26 +1737,61 @@ S32 LLSpatialPartition::cull(LLCamera& camera, bool do_occlusion)
 	((LLSpatialGroup*)mOctree->getListener(0))->validate();
 #endif
 
+	if (LLViewerOctreeBounds::sUseSnapshots)
+	{
+		mBoundsSnapshot.update(mOctree);
+	}
+	else
+	{
+		mBoundsSnapshot.invalidate();
+	}
+}
+
+// Note: no fast timer here, since this may run in a worker thread.
+void LLSpatialPartition::cullFrustum(LLCamera& camera)
+{
+	LLViewerOctreeBounds* bounds =
+		LLViewerOctreeBounds::sUseSnapshots ? &mBoundsSnapshot : NULL;
 	if (LLPipeline::sShadowRender)
 	{
-		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
 		LLOctreeCullShadow culler(&camera);
-		culler.traverse(mOctree);
+		culler.frustumPass(mOctree, mCullEntries, bounds);
 	}
 	else if (mInfiniteFarClip || !LLPipeline::sUseFarClip)
 	{
-		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
 		LLOctreeCullNoFarClip culler(&camera);
-		culler.traverse(mOctree);
+		culler.frustumPass(mOctree, mCullEntries, bounds);
 	}
 	else
 	{
-		LL_FAST_TIMER(FTM_FRUSTUM_CULL);
 		LLOctreeCull culler(&camera);
-		culler.traverse(mOctree);
+		culler.frustumPass(mOctree, mCullEntries, bounds);
 	}
+}
 
-	return 0;
+void LLSpatialPartition::cullApply(LLCamera& camera)
+{
+	if (LLPipeline::sShadowRender)
+	{
+		LLOctreeCullShadow culler(&camera);
+		culler.applyPass(mCullEntries);
+	}
+	else if (mInfiniteFarClip || !LLPipeline::sUseFarClip)
+	{
+		LLOctreeCullNoFarClip culler(&camera);
+		culler.applyPass(mCullEntries);
+	}
+	else
+	{
+		LLOctreeCull culler(&camera);
+		culler.applyPass(mCullEntries);
+	}
+	mCullEntries.clear();
+
+	if (LLViewerOctreeBounds::sUseSnapshots)
+	{
+		LLViewerOctreeBounds::sBoxesTested += mBoundsSnapshot.size();
+	}
 }
 
 void pushVerts(LLDrawInfo* params, U32 mask)
@@ -4287,6 +4401,128 @@ void LLCullResult::pushDrawInfo(U32 type, LLDrawInfo* draw_info)
 			<< llendl;
 }
 
+// Returns a 'bits' wide hash of a pointer. Equal pointers always give equal
+// hashes, which is all the sorting needs to group the draws sharing a state.
+static LL_INLINE U64 ptr_sort_hash(const void* ptr, U32 bits)
+{
+	return ((U64)(uintptr_t)ptr * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+}
+
+static U64 draw_info_sort_key(const LLDrawInfo* params,
+							  const LLVector4a& origin)
+{
+	const LLViewerTexture* tex = params->mTexture.get();
+	if (!tex && !params->mTextureList.empty())
+	{
+		tex = params->mTextureList[0].get();
+	}
+
+	// Front to back, with a coarser resolution for the far draws
+	LLVector4a center;
+	center.setAdd(params->mExtents[0], params->mExtents[1]);
+	center.mul(0.5f);
+	center.sub(origin);
+	U64 depth = llmin((U32)(sqrtf(center.getLength3().getF32()) * 8.f), 255U);
+
+	U64 shader = params->mMaterial.notNull() ? params->mShaderMask & 0xFF : 0;
+
+	return (shader << 56) | (ptr_sort_hash(tex, 20) << 36) |
+		   (ptr_sort_hash(params->mModelMatrix, 8) << 28) |
+		   (ptr_sort_hash(params->mVertexBuffer.get(), 20) << 8) | depth;
+}
+
+// Stable LSD radix sort of 'list' on the keys of its draw infos, skipping the
+// key bytes shared by all the draw infos.
+static void radix_sort_draw_infos(LLCullResult::drawinfo_list_t& list,
+								  const LLVector4a& origin)
+{
+	typedef std::pair<U64, LLDrawInfo*> entry_t;
+	thread_local std::vector<entry_t> entries;
+	thread_local std::vector<entry_t> temp;
+
+	U32 count = list.size();
+	entries.resize(count);
+	temp.resize(count);
+
+	U32 histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (U32 i = 0; i < count; ++i)
+	{
+		LLDrawInfo* params = list[i];
+		U64 key = params ? draw_info_sort_key(params, origin) : ~0ULL;
+		entries[i] = entry_t(key, params);
+		for (U32 b = 0; b < 8; ++b)
+		{
+			++histograms[b][(key >> (b * 8)) & 0xFF];
+		}
+	}
+
+	entry_t* src = entries.data();
+	entry_t* dst = temp.data();
+	for (U32 b = 0; b < 8; ++b)
+	{
+		U32* histogram = histograms[b];
+		U32 shift = b * 8;
+		if (histogram[(src[0].first >> shift) & 0xFF] == count)
+		{
+			continue;	// All the keys share this byte
+		}
+
+		U32 offset = 0;
+		for (U32 i = 0; i < 256; ++i)
+		{
+			U32 n = histogram[i];
+			histogram[i] = offset;
+			offset += n;
+		}
+		for (U32 i = 0; i < count; ++i)
+		{
+			dst[histogram[(src[i].first >> shift) & 0xFF]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+
+	for (U32 i = 0; i < count; ++i)
+	{
+		list[i] = src[i].second;
+	}
+}
+
+void LLCullResult::sortRenderMaps(const LLVector3& origin)
+{
+	LLVector4a origin4a;
+	origin4a.load3(origin.mV);
+
+	static std::vector<U32> types;
+	types.clear();
+	for (U32 i = 0; i < LLRenderPass::NUM_RENDER_TYPES; ++i)
+	{
+		// Alpha draws are sorted by distance, back to front
+		if (i != LLRenderPass::PASS_ALPHA && mRenderMap[i].size() > 1)
+		{
+			types.push_back(i);
+		}
+	}
+
+	U32 count = types.size();
+	if (gThreadPoolp && gThreadPoolp->getSize() && count > 1)
+	{
+		gThreadPoolp->parallelFor(count,
+								  [&](U32 i)
+								  {
+									radix_sort_draw_infos(mRenderMap[types[i]],
+														  origin4a);
+								  });
+	}
+	else
+	{
+		for (U32 i = 0; i < count; ++i)
+		{
+			radix_sort_draw_infos(mRenderMap[types[i]], origin4a);
+		}
+	}
+}
+
 void LLCullResult::assertDrawMapsEmpty()
 {
 	for (U32 i = 0; i < LLRenderPass::NUM_RENDER_TYPES; ++i)
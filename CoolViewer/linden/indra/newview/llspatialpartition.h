@@ -471,6 +471,14 @@ public:
 	S32 cull(LLCamera& camera, bool do_occlusion = false) override;
 	S32 cull(LLCamera& camera, std::vector<LLDrawable*>* res, bool for_sel);
 
+	// Split cull() steps, used by the parallel culling code in
+	// LLPipeline::updateCull(): cullRebound() and cullApply() must be called
+	// from the main thread, while cullFrustum() may run in a worker thread,
+	// as long as no other thread modifies the octree in the meantime.
+	void cullRebound();
+	void cullFrustum(LLCamera& camera);
+	void cullApply(LLCamera& camera);
+
 	bool isVisible(const LLVector3& v);
 	bool isHUDPartition();
 
@@ -486,6 +494,10 @@ public:
 	bool getVisibleExtents(LLCamera& camera, LLVector3& visMin,
 						   LLVector3& visMax);
 
+private:
+	// Recorded by cullFrustum() for cullApply()
+	LLViewerOctreeCull::entries_vec_t	mCullEntries;
+
 public:
 	// NULL for non-LLSpatialBridge instances, otherwise, mBridge == this. Uses
 	// a pointer instead of making "isBridge" and "asBridge" virtual so it is
@@ -621,6 +633,12 @@ public:
 	LL_INLINE void pushBridge(LLSpatialBridge* bridge)	{ mVisibleBridge.push_back(bridge); }
 	void pushDrawInfo(U32 type, LLDrawInfo* draw_info);
 
+	// Sorts the draw infos of each opaque render map on a 64 bits key (shader
+	// mask, texture, model matrix, vertex buffer and distance to 'origin'),
+	// so that the state changes get minimized while rendering them. The maps
+	// are radix-sorted in parallel in the worker threads, when available.
+	void sortRenderMaps(const LLVector3& origin);
+
 	void assertDrawMapsEmpty();
 
 private:
@@ -756,7 +774,22 @@ private:
 	void allocateFaces(U32 max_face_count);
 	void freeFaces();
 
+	// Returns the jobs queue to pass to LLFace::getGeometryVolume(), or NULL
+	// when the faces geometry should be rebuilt serially.
+	static LLFace::geom_jobs_t* getGeometryJobs();
+	// Runs the queued geometry jobs in the worker threads pool, then flushes
+	// the vertex buffers registered with deferGeometryFlush().
+	static void runGeometryJobs();
+
+	LL_INLINE static void deferGeometryFlush(LLVertexBuffer* buffp)
+	{
+		sGeomJobsBuffers.emplace_back(buffp);
+	}
+
 private:
+	static LLFace::geom_jobs_t							sGeomJobs;
+	static std::vector<LLPointer<LLVertexBuffer> >	sGeomJobsBuffers;
+
 	static S32		sInstanceCount;
 	static LLFace**	sFullbrightFaces;
 	static LLFace**	sBumpFaces;
@@ -43,6 +43,7 @@
 #include "llhttpconstants.h"
 #include "llhttpretrypolicy.h"
 #include "llimage.h"
+#include "llimagebc.h"
 #include "llimagej2c.h"
 #include "llimageworker.h"
 #include "llsdutil.h"
@@ -320,12 +321,13 @@ private:
 		}
 
 		// Threads: Tid
-		void completed(bool success, LLImageRaw* raw, LLImageRaw* aux) override
+		void completed(bool success, LLImageRaw* raw, LLImageRaw* aux,
+					   LLImageBC* bc, LLImageAlphaInfo* alpha) override
 		{
 			LLTextureFetchWorker* worker = mFetcher->getWorker(mID);
 			if (worker)
 			{
- 				worker->callbackDecoded(success, raw, aux);
+ 				worker->callbackDecoded(success, raw, aux, bc, alpha);
 			}
 		}
 
@@ -386,7 +388,8 @@ public:
 	void callbackCacheWrite(bool success);
 
 	// Threads: Tid
-	void callbackDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux);
+	void callbackDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux,
+						 LLImageBC* bc, LLImageAlphaInfo* alpha);
 
 	// Threads: T*
 	const std::string& setGetStatus(LLCore::HttpStatus status)
@@ -523,6 +526,10 @@ private:
 	LLPointer<LLImageFormatted>	mFormattedImage;
 	LLPointer<LLImageRaw>		mRawImage;
 	LLPointer<LLImageRaw>		mAuxImage;
+	// Block-compressed version of mRawImage, when enabled and possible.
+	LLPointer<LLImageBC>		mCompressedImage;
+	// Alpha channel analysis results for mRawImage.
+	LLPointer<LLImageAlphaInfo>	mAlphaInfo;
 	FTType						mFTType;
 	LLUUID						mID;
 	LLHost						mHost;
@@ -874,7 +881,9 @@ bool LLTextureFetchWorker::doWork(S32 param)
 
 	if (mState == INIT)
 	{
-		mRawImage = NULL ;
+		mRawImage = NULL;
+		mCompressedImage = NULL;
+		mAlphaInfo = NULL;
 		mRequestedDiscard = mLoadedDiscard = mDecodedDiscard = -1;
 		mRequestedSize = mRequestedOffset = mFileSize = mCachedSize = 0;
 		mLoaded = mDecoded = mWritten = mHaveAllData = false;
@@ -1594,6 +1603,8 @@ decode_image:
 
 		mRawImage = NULL;
 		mAuxImage = NULL;
+		mCompressedImage = NULL;
+		mAlphaInfo = NULL;
 		llassert_always(mFormattedImage.notNull());
 		S32 discard = mHaveAllData ? 0 : mLoadedDiscard;
 		U32 image_priority = LLWorkerThread::PRIORITY_LOW | mWorkPriority;
@@ -1603,12 +1614,18 @@ decode_image:
 								  << mFormattedImage->getDataSize()
 								  << ". Discard: " << discard << ". All data: "
 								  << mHaveAllData << LL_ENDL;
+		// Only the regular texture assets get block-compressed: the bakes
+		// and local files may change for a same UUID, and the textures
+		// needing an auxiliary channel are used for their raw data. HB
+		bool compress = mFTType == FTT_DEFAULT && !mNeedsAux;
 		mDecodeHandle =
 			mFetcher->mImageDecodeThread->decodeImage(mFormattedImage,
 													  image_priority, discard,
 													  mNeedsAux,
 													  new DecodeResponder(mFetcher,
-																		  mID));
+																		  mID),
+													  compress ? mID
+															   : LLUUID::null);
 		// Fall through
 	}
 
@@ -2184,7 +2201,8 @@ void LLTextureFetchWorker::callbackCacheWrite(bool success)
 
 // Threads: Tid
 void LLTextureFetchWorker::callbackDecoded(bool success, LLImageRaw* raw,
-										   LLImageRaw* aux)
+										   LLImageRaw* aux, LLImageBC* bc,
+										   LLImageAlphaInfo* alpha)
 {
 	mWorkMutex.lock();
 
@@ -2211,6 +2229,8 @@ void LLTextureFetchWorker::callbackDecoded(bool success, LLImageRaw* raw,
 		llassert_always(raw);
 		mRawImage = raw;
 		mAuxImage = aux;
+		mCompressedImage = bc;
+		mAlphaInfo = alpha;
 		mDecodedDiscard = mFormattedImage->getDiscardLevel();
  		LL_DEBUGS("TextureFetch") << "Decode finished for " << mID
 								  << ". Discard: " << mDecodedDiscard
@@ -2598,6 +2618,8 @@ LLTextureFetchWorker* LLTextureFetch::getWorker(const LLUUID& id)
 bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 										LLPointer<LLImageRaw>& raw,
 										LLPointer<LLImageRaw>& aux,
+										LLPointer<LLImageBC>& bc,
+										LLPointer<LLImageAlphaInfo>& alpha,
 										LLCore::HttpStatus& last_http_get_status)
 {
 	LLTextureFetchWorker* worker = getWorker(id);
@@ -2626,6 +2648,8 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 		discard_level = worker->mDecodedDiscard;
 		raw = worker->mRawImage;
 		aux = worker->mAuxImage;
+		bc = worker->mCompressedImage;
+		alpha = worker->mAlphaInfo;
 		LL_DEBUGS("TextureFetch") << id << ": request finished. State: "
 								  << worker->mState << ". Discard: "
 								  << discard_level << LL_ENDL;
@@ -2642,6 +2666,8 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 		discard_level = worker->mDecodedDiscard;
 		raw = worker->mRawImage;
 		aux = worker->mAuxImage;
+		bc = worker->mCompressedImage;
+		alpha = worker->mAlphaInfo;
 	}
 	worker->unlockWorkMutex();
 	return false;
@@ -44,6 +44,8 @@
 
 class HTTPGetResponder;
 class LLHost;
+class LLImageAlphaInfo;
+class LLImageBC;
 class LLImageDecodeThread;
 class LLTextureCache;
 class LLTextureFetchWorker;
@@ -77,6 +79,8 @@ public:
 	bool getRequestFinished(const LLUUID& id, S32& discard_level,
 							LLPointer<LLImageRaw>& raw,
 							LLPointer<LLImageRaw>& aux,
+							LLPointer<LLImageBC>& bc,
+							LLPointer<LLImageAlphaInfo>& alpha,
 							LLCore::HttpStatus& last_http_get_status);
 	bool updateRequestPriority(const LLUUID& id, F32 priority);
 
@@ -41,6 +41,7 @@
 
 #include "llappviewer.h"
 #include "llhoverview.h"
+#include "llprefetchpredictor.h"
 #include "llselectmgr.h"
 #include "lltexturecache.h"
 #include "lltexturefetch.h"
@@ -58,6 +59,10 @@ LLTextureView* gTextureViewp = NULL;
 
 static const char* mem_format_str =
 	"GL tot: %d/%d MB - Bound: %d/%d MB - Raw tot: %d MB - Bias: %.2f - Cache: %.1f/%.1f MB";
+static const char* residency_format_str =
+	"Avatars: %d MB - World: %d MB - UI: %d MB - Media: %d MB - Budget: %d MB - Evicted: %d - Downsampled: %d - Raw freed: %d";
+static const char* prefetch_format_str =
+	"Prefetched textures: %d (hits: %d) - Meshes: %d (hits: %d) - Pending: %d - Hit rate: %.1f%%";
 static const char* tex_format_str =
 	"Tex(Raw): %d(%d) Fetches: %d(%d) HTTP: %d UDP BW: %.0f Cache R/W: %d/%d LFS: %d Dec: %d Boost: %.1f";
 static const char* fetch1_format_str = "%s %7.0f %d(%d) 0x%08x(%8.0f)";
@@ -389,7 +394,7 @@ public:
 	{
 		S32 line_height =
 			(S32)(LLFontGL::getFontMonospace()->getLineHeight() + .5f);
-		setRect(LLRect(0, 0, 100, line_height * 4));
+		setRect(LLRect(0, 0, 100, line_height * 6));
 	}
 
 	void draw() override;
@@ -403,7 +408,7 @@ public:
 	LL_INLINE LLRect getRequiredRect() override
 	{
 		LLRect rect;
-		rect.mTop = 2 * BAR_HEIGHT;	// Room for three lines of text
+		rect.mTop = 3 * BAR_HEIGHT;	// Room for four lines of text
 		return rect;
 	}
 
@@ -440,7 +445,36 @@ void LLGLTexMemBar::draw()
 	LLColor4 text_color(1.f, 1.f, 1.f, 0.75f);
 	LLColor4 color;
 
-	std::string text = llformat(mem_format_str, total_mem, max_total_mem,
+	// Residency manager usage per category, against the total budget
+	S32 usage[LLViewerTextureList::RESIDENCY_COUNT];
+	for (U32 i = 0; i < LLViewerTextureList::RESIDENCY_COUNT; ++i)
+	{
+		usage[i] = BYTES2MEGABYTES(gTextureList.getResidencyUsage(i));
+	}
+	std::string text = llformat(residency_format_str,
+								usage[LLViewerTextureList::RESIDENCY_AVATARS],
+								usage[LLViewerTextureList::RESIDENCY_WORLD],
+								usage[LLViewerTextureList::RESIDENCY_UI],
+								usage[LLViewerTextureList::RESIDENCY_MEDIA],
+								max_total_mem,
+								gTextureList.getResidencyEvictions(),
+								gTextureList.getResidencyDownsamples(),
+								gTextureList.getResidencyRawFreed());
+	color = total_mem > max_total_mem ? LLColor4::orange : text_color;
+	fontp->renderUTF8(text, 0, 0, line_height * 4, color, LLFontGL::LEFT,
+					  LLFontGL::TOP);
+
+	text = llformat(prefetch_format_str,
+					LLPrefetchPredictor::getTextureRequests(),
+					LLPrefetchPredictor::getTextureHits(),
+					LLPrefetchPredictor::getMeshRequests(),
+					LLPrefetchPredictor::getMeshHits(),
+					LLPrefetchPredictor::getPending(),
+					LLPrefetchPredictor::getHitRate());
+	fontp->renderUTF8(text, 0, 0, line_height * 5, text_color, LLFontGL::LEFT,
+					  LLFontGL::TOP);
+
+	text = llformat(mem_format_str, total_mem, max_total_mem,
 								bound_mem, max_bound_mem,
 								LLImageRaw::sGlobalRawMemory >> 20,
 								discard_bias, cache_usage, cache_max_usage);
@@ -42,6 +42,7 @@
 #include "llerrorcontrol.h"
 #include "llfloater.h"
 #include "llgl.h"
+#include "llimagebc.h"
 #include "llimagegl.h"
 #include "llkeyboard.h"
 #include "llnotifications.h"
@@ -90,6 +91,7 @@
 #include "llviewerjoystick.h"
 #include "llviewermenu.h"
 #include "llviewerobjectlist.h"
+#include "llvieweroctree.h"
 #include "llviewerparcelmedia.h"
 #include "llviewerparcelmgr.h"
 #include "llviewershadermgr.h"
@@ -153,6 +155,15 @@ static bool handleFastTimersAlwaysEnabledChanged(const LLSD& newvalue)
 }
 #endif	// LL_FAST_TIMERS_ENABLED
 
+static bool handleLogControlLookupsChanged(const LLSD& newvalue)
+{
+	bool enable = newvalue.asBoolean();
+	gSavedSettings.setTrackLookups(enable);
+	gSavedPerAccountSettings.setTrackLookups(enable);
+	gColors.setTrackLookups(enable);
+	return true;
+}
+
 static bool handleRenderCompressTexturesChanged(const LLSD& newvalue)
 {
 	if (gFeatureManager.isFeatureAvailable("RenderCompressTextures") &&
@@ -164,6 +175,19 @@ static bool handleRenderCompressTexturesChanged(const LLSD& newvalue)
 	return true;
 }
 
+static bool handleRenderCompressTexturesOnCPUChanged(const LLSD& newvalue)
+{
+	LLImageBC::sEnabled = gGLManager.mHasTextureCompressionS3TC &&
+						  newvalue.asBoolean();
+	return true;
+}
+
+static bool handleRenderUsePBOUploadsChanged(const LLSD& newvalue)
+{
+	LLImageGL::sUsePBOUploads = newvalue.asBoolean();
+	return true;
+}
+
 static bool handleRenderClearARBBufferChanged(const LLSD& newvalue)
 {
 	if (!gGLManager.mIsNVIDIA) // Never disable for NVIDIA
@@ -550,12 +574,24 @@ static bool handleWLSkyDetailChanged(const LLSD& newvalue)
 	return true;
 }
 
+static bool handleRenderBatchedFrustumChecksChanged(const LLSD& newvalue)
+{
+	LLViewerOctreeBounds::sUseSnapshots = newvalue.asBoolean();
+	return true;
+}
+
 static bool handleRenderBatchedGlyphsChanged(const LLSD& newvalue)
 {
 	LLFontGL::setUseBatchedRender((bool)newvalue.asBoolean());
 	return true;
 }
 
+static bool handleRenderTextRunsCacheChanged(const LLSD& newvalue)
+{
+	LLFontGL::setUseTextRunsCache((bool)newvalue.asBoolean());
+	return true;
+}
+
 static bool handleResetVertexBuffersChanged(const LLSD&)
 {
 	LLVOVolume::sRenderMaxVBOSize = gSavedSettings.getU32("RenderMaxVBOSize");
@@ -701,6 +737,12 @@ static bool handleDebugViewsChanged(const LLSD& newvalue)
 	return true;
 }
 
+static bool handleUIChildViewIndexChanged(const LLSD& newvalue)
+{
+	LLView::sUseChildIndex = newvalue.asBoolean();
+	return true;
+}
+
 static bool handleFSFlushOnWriteChanged(const LLSD& newvalue)
 {
 	LLFile::sFlushOnWrite = newvalue.asBoolean();
@@ -1036,6 +1078,7 @@ void settings_setup_listeners()
 	gSavedSettings.getControl("SnapMargin")->getSignal()->connect(boost::bind(&handleUISettingsChanged, _2));
 	gSavedSettings.getControl("TabToTextFieldsOnly")->getSignal()->connect(boost::bind(&handleUISettingsChanged, _2));
 	gSavedSettings.getControl("TypeAheadTimeout")->getSignal()->connect(boost::bind(&handleUISettingsChanged, _2));
+	gSavedSettings.getControl("UIChildViewIndex")->getSignal()->connect(boost::bind(&handleUIChildViewIndexChanged, _2));
 	gSavedSettings.getControl("UseAltKeyForMenus")->getSignal()->connect(boost::bind(&handleUISettingsChanged, _2));
 	gSavedSettings.getControl("StackMinimizedTopToBottom")->getSignal()->connect(boost::bind(&handleStackMinimizedTopToBottom, _2));
 	gSavedSettings.getControl("StackMinimizedRightToLeft")->getSignal()->connect(boost::bind(&handleStackMinimizedRightToLeft, _2));
@@ -1127,10 +1170,13 @@ void settings_setup_listeners()
 	gSavedSettings.getControl("RenderAvatarPhysicsLODFactor")->getSignal()->connect(boost::bind(&handleAvatarDebugSettingsChanged, _2));
 	gSavedSettings.getControl("RenderAvatarVP")->getSignal()->connect(boost::bind(&handleSetShaderChanged, _2));
 	gSavedSettings.getControl("RenderBakeSunlight")->getSignal()->connect(boost::bind(&handleResetVertexBuffersChanged, _2));
+	gSavedSettings.getControl("RenderBatchedFrustumChecks")->getSignal()->connect(boost::bind(&handleRenderBatchedFrustumChecksChanged, _2));
 	gSavedSettings.getControl("RenderBatchedGlyphs")->getSignal()->connect(boost::bind(&handleRenderBatchedGlyphsChanged, _2));
 	gSavedSettings.getControl("RenderClearARBBuffer")->getSignal()->connect(boost::bind(&handleRenderClearARBBufferChanged, _2));
 	gSavedSettings.getControl("RenderCompressTextures")->getSignal()->connect(boost::bind(&handleRenderCompressTexturesChanged, _2));
 	gSavedSettings.getControl("RenderCompressThreshold")->getSignal()->connect(boost::bind(&handleRenderCompressTexturesChanged, _2));
+	gSavedSettings.getControl("RenderCompressTexturesOnCPU")->getSignal()->connect(boost::bind(&handleRenderCompressTexturesOnCPUChanged, _2));
+	gSavedSettings.getControl("RenderUsePBOUploads")->getSignal()->connect(boost::bind(&handleRenderUsePBOUploadsChanged, _2));
 	gSavedSettings.getControl("RenderDebugGL")->getSignal()->connect(boost::bind(&handleRenderDebugGLChanged, _2));
 	gSavedSettings.getControl("RenderDebugTextureBind")->getSignal()->connect(boost::bind(&handleResetVertexBuffersChanged, _2));
 	gSavedSettings.getControl("RenderDeferred")->getSignal()->connect(boost::bind(&handleRenderDeferredChanged, _2));
@@ -1166,10 +1212,12 @@ void settings_setup_listeners()
 	gSavedSettings.getControl("RenderTerrainDetail")->getSignal()->connect(boost::bind(&handleTerrainDetailChanged, _2));
 	gSavedSettings.getControl("RenderTerrainLODFactor")->getSignal()->connect(boost::bind(&handleTerrainLODChanged, _2));
 	gSavedSettings.getControl("RenderTransparentWater")->getSignal()->connect(boost::bind(&handleRenderTransparentWaterChanged, _2));
+	gSavedSettings.getControl("RenderTextRunsCache")->getSignal()->connect(boost::bind(&handleRenderTextRunsCacheChanged, _2));
 	gSavedSettings.getControl("RenderTreeAnimationDamping")->getSignal()->connect(boost::bind(&handleTreeSettingsChanged, _2));
 	gSavedSettings.getControl("RenderTreeTrunkStiffness")->getSignal()->connect(boost::bind(&handleTreeSettingsChanged, _2));
 	gSavedSettings.getControl("RenderTreeWindSensitivity")->getSignal()->connect(boost::bind(&handleTreeSettingsChanged, _2));
 	gSavedSettings.getControl("RenderTreeLODFactor")->getSignal()->connect(boost::bind(&handleTreeSettingsChanged, _2));
+	gSavedSettings.getControl("RenderUseStreamRing")->getSignal()->connect(boost::bind(&handleResetVertexBuffersChanged, _2));
 	gSavedSettings.getControl("RenderUseStreamVBO")->getSignal()->connect(boost::bind(&handleResetVertexBuffersChanged, _2));
 	gSavedSettings.getControl("RenderUseVAO")->getSignal()->connect(boost::bind(&handleResetVertexBuffersChanged, _2));
 	gSavedSettings.getControl("RenderVBOEnable")->getSignal()->connect(boost::bind(&handleResetVertexBuffersChanged, _2));
@@ -1269,6 +1317,7 @@ void settings_setup_listeners()
 	gSavedSettings.getControl("FastTimersAlwaysEnabled")->getSignal()->connect(boost::bind(&handleFastTimersAlwaysEnabledChanged, _2));
 #endif
 	gSavedSettings.getControl("FSFlushOnWrite")->getSignal()->connect(boost::bind(&handleFSFlushOnWriteChanged, _2));
+	gSavedSettings.getControl("LogControlLookups")->getSignal()->connect(boost::bind(&handleLogControlLookupsChanged, _2));
 	gSavedSettings.getControl("UserLogFile")->getSignal()->connect(boost::bind(&handleLogFileChanged, _2));
 	gSavedSettings.getControl("TextureFetchBoostWithFetches")->getSignal()->connect(boost::bind(&handleTextureFetchBoostWithFetchesChanged, _2));
 	gSavedSettings.getControl("TextureFetchBoostWithSpeed")->getSignal()->connect(boost::bind(&handleTextureFetchBoostWithSpeedChanged, _2));
@@ -1277,3 +1326,27 @@ void settings_setup_listeners()
 	gSavedSettings.getControl("RestrainedLoveAutomaticRenameItems")->getSignal()->connect(boost::bind(&handleRestrainedLoveAutomaticRenameItemsChanged, _2));
 //mk
 }
+
+void settings_log_lookups()
+{
+	if (!gSavedSettings.getTrackLookups())
+	{
+		return;
+	}
+
+	constexpr F32 LOOKUPS_LOG_INTERVAL = 10.f;	// In seconds
+	static LLFrameTimer log_timer;
+	static U32 last_frame = LLFrameTimer::getFrameCount();
+	if (log_timer.getElapsedTimeF32() < LOOKUPS_LOG_INTERVAL)
+	{
+		return;
+	}
+	log_timer.reset();
+
+	U32 frame = LLFrameTimer::getFrameCount();
+	U32 frames = frame - last_frame;
+	last_frame = frame;
+	gSavedSettings.dumpLookupStats(frames);
+	gSavedPerAccountSettings.dumpLookupStats(frames);
+	gColors.dumpLookupStats(frames);
+}
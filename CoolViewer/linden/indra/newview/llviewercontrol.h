@@ -40,6 +40,10 @@
 // Setting variables are declared in this function
 void settings_setup_listeners();
 
+// Called once per frame from LLAppViewer::idle(), to log the controls lookups
+// by name statistics when the "LogControlLookups" setting is TRUE.
+void settings_log_lookups();
+
 extern std::map<std::string, LLControlGroup*> gSettings;
 
 // Saved at end of session
@@ -44,6 +44,7 @@
 
 #include "llagent.h"
 #include "llappviewer.h"
+#include "llcontrolhandles.h"
 #include "lldynamictexture.h"
 #include "lldrawpoolalpha.h"
 #include "lldrawpoolbump.h"
@@ -58,6 +59,7 @@
 //MK
 #include "mkrlinterface.h"
 //mk
+#include "llprefetchpredictor.h"
 #include "llselectmgr.h"
 #include "llsky.h"
 #include "llspatialpartition.h"
@@ -449,7 +451,7 @@ void display(bool rebuild, F32 zoom_factor, S32 subfield, bool for_snapshot)
 					gAgent.setTeleportMessage(LLAgent::sTeleportProgressMessages["arriving"]);
 				}
 				gAgent.setTeleportState(LLAgent::TELEPORT_ARRIVING);
-				if (gSavedSettings.getBool("DisablePrecacheDelayAfterTP"))
+				if (LLCtrl::DisablePrecacheDelayAfterTP())
 				{
 					LLFirstUse::useTeleport();
 					gAgent.setTeleportState(LLAgent::TELEPORT_NONE);
@@ -549,7 +551,7 @@ void display(bool rebuild, F32 zoom_factor, S32 subfield, bool for_snapshot)
 		if (gTeleportArrivalTimer.getElapsedTimeF32() >= (F32)speed_rez_interval)
 		{
 			gTeleportArrivalTimer.reset();
-			F32 current = gSavedSettings.getF32("RenderFarClip");
+			F32 current = LLCtrl::RenderFarClip();
 			if (gSavedDrawDistance > current)
 			{
 				current *= 2.f;
@@ -585,7 +587,7 @@ void display(bool rebuild, F32 zoom_factor, S32 subfield, bool for_snapshot)
 	if (gUpdateDrawDistance)
 	{
 		gUpdateDrawDistance = false;
-		F32 draw_distance = gSavedSettings.getF32("RenderFarClip");
+		F32 draw_distance = LLCtrl::RenderFarClip();
 		gAgent.mDrawDistance = draw_distance;
 		gWorld.setLandFarClip(draw_distance);
 		LLVOCacheEntry::updateSettings();
@@ -878,6 +880,11 @@ void display(bool rebuild, F32 zoom_factor, S32 subfield, bool for_snapshot)
 												0.005f);
 				gTextureList.updateImages(max_image_decode_time);
 			}
+
+			{
+				LL_FAST_TIMER(FTM_PREFETCH_PREDICTOR);
+				LLPrefetchPredictor::update();
+			}
 		}
 
 		LLGLState::check(true, true);
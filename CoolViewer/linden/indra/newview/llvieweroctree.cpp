@@ -487,7 +487,8 @@ void LLViewerOctreeEntryData::resetVisible() const
 LLViewerOctreeGroup::LLViewerOctreeGroup(OctreeNode* node)
 :	mOctreeNode(node),
 	mAnyVisible(0),
-	mState(CLEAN)
+	mState(CLEAN),
+	mBoundsIndex(-1)
 {
 	LLVector4a tmp;
 	tmp.splat(0.f);
@@ -655,6 +656,8 @@ void LLViewerOctreeGroup::rebound()
 		mBounds[1].mul(0.5f);
 	}
 
+	boundsChanged();
+
 	clearState(DIRTY);
 
 	return;
@@ -968,6 +971,15 @@ bool LLOcclusionCullingGroup::isAnyRecentlyVisible() const
 	return LLDrawable::getCurrentFrame() - mAnyVisible < MIN_VIS_FRAME_RANGE;
 }
 
+//virtual
+void LLOcclusionCullingGroup::boundsChanged()
+{
+	if (mSpatialPartition)
+	{
+		mSpatialPartition->mBoundsSnapshot.setChanged(mBoundsIndex);
+	}
+}
+
 //virtual
 void LLOcclusionCullingGroup::handleChildAddition(const OctreeNode* parent,
 												  OctreeNode* child)
@@ -1497,6 +1509,129 @@ bool LLViewerOctreePartition::isOcclusionEnabled()
 	return mOcclusionEnabled || LLPipeline::sUseOcclusion > 2;
 }
 
+//-----------------------------------------------------------------------------
+// LLViewerOctreeBounds class
+//-----------------------------------------------------------------------------
+
+U32 LLViewerOctreeBounds::sBoxesTested = 0;
+U32 LLViewerOctreeBounds::sRebuilds = 0;
+U32 LLViewerOctreeBounds::sRefreshes = 0;
+bool LLViewerOctreeBounds::sUseSnapshots = true;
+
+LLViewerOctreeBounds::LLViewerOctreeBounds()
+:	mValid(false)
+{
+}
+
+void LLViewerOctreeBounds::update(OctreeNode* root)
+{
+	if (mValid)
+	{
+		for (U32 i = 0, count = mChanged.size(); i < count; ++i)
+		{
+			U32 index = mChanged[i];
+			if (index < mGroups.size())
+			{
+				setEntry(index);
+			}
+		}
+		sRefreshes += mChanged.size();
+		mChanged.clear();
+		return;
+	}
+
+	mGroups.clear();
+	mSubtreeSizes.clear();
+	mFlags.clear();
+	for (U32 i = 0; i < 6; ++i)
+	{
+		mComponents[i].clear();
+	}
+	mChanged.clear();
+
+	if (root && root->getListener(0))
+	{
+		addNode(root);
+	}
+
+	U32 count = mGroups.size();
+	// Pad to a multiple of 8 entries for the SIMD code
+	U32 padded = (count + 7) & ~7;
+	for (U32 i = 0; i < 6; ++i)
+	{
+		mComponents[i].resize(padded);
+	}
+	mResults.resize(padded);
+	for (U32 i = 0; i < count; ++i)
+	{
+		setEntry(i);
+	}
+
+	mValid = true;
+	++sRebuilds;
+}
+
+void LLViewerOctreeBounds::addNode(OctreeNode* node)
+{
+	LLViewerOctreeGroup* group = (LLViewerOctreeGroup*)node->getListener(0);
+	U32 index = mGroups.size();
+	group->setBoundsIndex(index);
+	mGroups.push_back(group);
+	mSubtreeSizes.push_back(1);
+	mFlags.push_back(0);
+
+	for (U32 i = 0, count = node->getChildCount(); i < count; ++i)
+	{
+		OctreeNode* child = node->getChild(i);
+		// Skip any (normally impossible) group-less node, with its sub-tree,
+		// like LLViewerOctreeCull::traverse() does.
+		if (child->getListener(0))
+		{
+			addNode(child);
+		}
+	}
+
+	mSubtreeSizes[index] = mGroups.size() - index;
+}
+
+// Note: the SKIP_FRUSTUM_CHECK state of the children of a group is set by
+// the rebound of that group, so we refresh their flags here as well.
+void LLViewerOctreeBounds::setEntry(U32 index)
+{
+	LLViewerOctreeGroup* group = mGroups[index];
+	const LLVector4a* bounds = group->getBounds();
+	for (U32 i = 0; i < 3; ++i)
+	{
+		mComponents[i][index] = bounds[0][i];
+		mComponents[i + 3][index] = bounds[1][i];
+	}
+
+	OctreeNode* node = group->getOctreeNode();
+	U8& flags = mFlags[index];
+	flags &= SKIP_FRUSTUM_CHECK;
+	if (node->getElementCount())
+	{
+		flags |= HAS_ELEMENTS;
+	}
+	if (node->getChildCount() == 0)
+	{
+		flags |= IS_LEAF;
+	}
+
+	for (U32 i = index + 1, end = index + mSubtreeSizes[index]; i < end;
+		 i += mSubtreeSizes[i])
+	{
+		if (mGroups[i]->hasState(LLViewerOctreeGroup::SKIP_FRUSTUM_CHECK))
+		{
+			mFlags[i] |= SKIP_FRUSTUM_CHECK;
+		}
+		else
+		{
+			mFlags[i] &= ~SKIP_FRUSTUM_CHECK;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // LLViewerOctreeCull class
 //-----------------------------------------------------------------------------
@@ -1551,6 +1686,149 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
 	}
 }
 
+void LLViewerOctreeCull::frustumPass(const OctreeNode* n,
+									 entries_vec_t& entries,
+									 LLViewerOctreeBounds* bounds)
+{
+	entries.clear();
+	mRes = 0;
+	if (bounds && bounds->isValid() && bounds->size() &&
+		(OctreeNode*)bounds->mGroups[0]->getOctreeNode() == n &&
+		frustumCheckBatch(*bounds))
+	{
+		frustumPass(*bounds, 0, 0, entries);
+	}
+	else
+	{
+		frustumPass(n, 0, entries);
+	}
+}
+
+// Same as below, but using the flattened octree and batched checks results.
+void LLViewerOctreeCull::frustumPass(const LLViewerOctreeBounds& bounds,
+									 U32 index, U32 depth,
+									 entries_vec_t& entries)
+{
+	LLViewerOctreeGroup* group = bounds.mGroups[index];
+	size_t entry_index = entries.size();
+	entries.emplace_back(group, depth);
+
+	U8 flags = bounds.mFlags[index];
+	bool checked = false;
+	if (mRes != 2 &&
+		!(mRes && (flags & LLViewerOctreeBounds::SKIP_FRUSTUM_CHECK)))
+	{
+		mRes = bounds.mResults[index];
+		if (mRes)
+		{
+			mRes = frustumCheckRefine(group, mRes);
+		}
+		if (!mRes)
+		{
+			return;
+		}
+		checked = true;
+	}
+
+	CullEntry& entry = entries[entry_index];
+	entry.mVisited = true;
+	entry.mRes = mRes;
+	// Same as checkObjects(), using the cached flags
+	entry.mProcess = (flags & LLViewerOctreeBounds::HAS_ELEMENTS) &&
+					 ((flags & LLViewerOctreeBounds::IS_LEAF) || mRes != 1 ||
+					  frustumCheckObjects(group));
+
+	for (U32 i = index + 1, end = index + bounds.mSubtreeSizes[index];
+		 i < end; i += bounds.mSubtreeSizes[i])
+	{
+		frustumPass(bounds, i, depth + 1, entries);
+	}
+
+	if (checked)
+	{
+		mRes = 0;
+	}
+}
+
+// Note: this mirrors traverse() and visit(), minus the early fails and the
+// groups processing. Since this may run in a worker thread, nothing is logged
+// here either.
+void LLViewerOctreeCull::frustumPass(const OctreeNode* n, U32 depth,
+									 entries_vec_t& entries)
+{
+	LLViewerOctreeGroup* group = n ? (LLViewerOctreeGroup*)n->getListener(0)
+								   : NULL;
+	if (!group)
+	{
+		return;
+	}
+
+	// Note: entries may get reallocated while traversing the children, so we
+	// must use an index and not a reference or pointer to our entry.
+	size_t index = entries.size();
+	entries.emplace_back(group, depth);
+
+	bool checked = false;
+	if (mRes != 2 &&
+		!(mRes && group->hasState(LLViewerOctreeGroup::SKIP_FRUSTUM_CHECK)))
+	{
+		mRes = frustumCheck(group);
+		if (!mRes)
+		{
+			return;
+		}
+		checked = true;
+	}
+
+	CullEntry& entry = entries[index];
+	entry.mVisited = true;
+	entry.mRes = mRes;
+	entry.mProcess = checkObjects(n, group);
+
+	for (U32 i = 0, count = n->getChildCount(); i < count; ++i)
+	{
+		frustumPass(n->getChild(i), depth + 1, entries);
+	}
+
+	if (checked)
+	{
+		mRes = 0;
+	}
+}
+
+void LLViewerOctreeCull::applyPass(const entries_vec_t& entries)
+{
+	// Depth of the last early-failed group, the entries for its sub-groups
+	// being skipped
+	U32 skip_depth = U32_MAX;
+	for (size_t i = 0, count = entries.size(); i < count; ++i)
+	{
+		const CullEntry& entry = entries[i];
+		if (entry.mDepth > skip_depth)
+		{
+			continue;
+		}
+		skip_depth = U32_MAX;
+
+		if (earlyFail(entry.mGroup))
+		{
+			skip_depth = entry.mDepth;
+			continue;
+		}
+
+		if (entry.mVisited)
+		{
+			mRes = entry.mRes;
+			preprocess(entry.mGroup);
+			if (entry.mProcess)
+			{
+				processGroup(entry.mGroup);
+			}
+		}
+	}
+	mRes = 0;
+}
+
 //------------------------------------------
 // Agent space group culling
 //------------------------------------------
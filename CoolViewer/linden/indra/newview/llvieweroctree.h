@@ -296,7 +296,6 @@ public:
 	};
 
 	typedef LLOctreeNode<LLViewerOctreeEntry>::element_iter element_iter;
-	typedef LLOctreeNode<LLViewerOctreeEntry>::element_list element_list;
 
 	LLViewerOctreeGroup(OctreeNode* node);
 
@@ -311,6 +310,11 @@ public:
 	virtual void unbound();
 	virtual void rebound();
 
+	// Index of this group in its partition bounds snapshot, or -1 when not
+	// (yet) in it.
+	LL_INLINE S32 getBoundsIndex() const			{ return mBoundsIndex; }
+	LL_INLINE void setBoundsIndex(S32 index)		{ mBoundsIndex = index; }
+
 	LL_INLINE bool isDead()							{ return hasState(DEAD); }
 
 	void setVisible();
@@ -364,7 +368,6 @@ public:
 	}
 
 	// Octree wrappers to make code more readable
-	LL_INLINE element_list& getData()				{ return mOctreeNode->getData(); }
 	LL_INLINE element_iter getDataBegin()			{ return mOctreeNode->getDataBegin(); }
 	LL_INLINE element_iter getDataEnd()				{ return mOctreeNode->getDataEnd(); }
 	LL_INLINE U32 getElementCount() const			{ return mOctreeNode->getElementCount(); }
@@ -373,6 +376,9 @@ public:
 protected:
 	void checkStates();
 
+	// Called by rebound() whenever the bounds got recomputed.
+	LL_INLINE virtual void boundsChanged()			{}
+
 private:
 	virtual bool boundObjects(bool empty, LLVector4a& minOut,
 							  LLVector4a& maxOut);
@@ -392,6 +398,7 @@ protected:
 	S32						mVisible[LLViewerCamera::NUM_CAMERAS];
 	U32						mState;
 	S32						mAnyVisible;	// Latest visible to any camera
+	S32						mBoundsIndex;
 };
 
 // Octree group which has capability to support occlusion culling
@@ -454,6 +461,8 @@ public:
 	bool isRecentlyVisible() const override;
 	bool isAnyRecentlyVisible() const;
 
+	void boundsChanged() override;
+
 	LL_INLINE LLViewerOctreePartition* getSpatialPartition() const
 	{
 		return mSpatialPartition;
@@ -477,6 +486,85 @@ protected:
 
 };
 
+// Flattened, structure-of-arrays snapshot of the bounds of the groups of an
+// octree, stored in depth-first traversal order, so that the frustum checks
+// can be performed in batches with SIMD code (see LLCamera::AABBsInFrustum())
+// and the octree traversed without chasing the nodes pointers. The snapshot
+// is rebuilt whenever the octree structure changes, while only the entries
+// for the groups that got rebound are refreshed otherwise.
+class LLViewerOctreeBounds
+{
+protected:
+	LOG_CLASS(LLViewerOctreeBounds);
+
+public:
+	enum
+	{
+		HAS_ELEMENTS = 0x01,
+		IS_LEAF = 0x02,
+		SKIP_FRUSTUM_CHECK = 0x04,
+	};
+
+	LLViewerOctreeBounds();
+
+	LL_INLINE bool isValid() const					{ return mValid; }
+	LL_INLINE U32 size() const						{ return mGroups.size(); }
+
+	// To call whenever the octree structure changes.
+	LL_INLINE void invalidate()
+	{
+		mValid = false;
+		mChanged.clear();
+	}
+
+	// To call whenever the bounds of the group at 'index' changed.
+	LL_INLINE void setChanged(S32 index)
+	{
+		if (mValid && index >= 0)
+		{
+			if (mChanged.size() < mGroups.size())
+			{
+				mChanged.push_back(index);
+			}
+			else	// Cheaper to rebuild it all at this point
+			{
+				invalidate();
+			}
+		}
+	}
+
+	// Rebuilds or refreshes the snapshot as needed, after the octree got
+	// rebound.
+	void update(OctreeNode* root);
+
+private:
+	void addNode(OctreeNode* node);
+	void setEntry(U32 index);
+
+public:
+	std::vector<LLViewerOctreeGroup*>	mGroups;
+	// Number of entries in the sub-tree starting at each entry, this entry
+	// included.
+	std::vector<U32>					mSubtreeSizes;
+	std::vector<U8>						mFlags;
+	// Centers and radii components, padded to a multiple of 8 elements
+	std::vector<F32>					mComponents[6];
+	// Scratch results of the batched frustum checks
+	std::vector<S8>						mResults;
+
+	// Statistics for the debug info display, reset each frame
+	static U32							sBoxesTested;
+	static U32							sRebuilds;
+	static U32							sRefreshes;
+
+	// When false, the snapshots are not used for culling.
+	static bool							sUseSnapshots;
+
+private:
+	std::vector<S32>					mChanged;
+	bool								mValid;
+};
+
 class LLViewerOctreePartition
 {
 public:
@@ -504,6 +592,8 @@ public:
 
 	// If true, occlusion culling is performed:
 	bool			mOcclusionEnabled;
+
+	LLViewerOctreeBounds	mBoundsSnapshot;
 };
 
 class LLViewerOctreeCull : public OctreeTraveler
@@ -520,6 +610,38 @@ public:
 
 	void traverse(const OctreeNode* n) override;
 
+	// Two-pass culling, used by the parallel culling code. frustumPass() only
+	// performs the frustum checks (which are thread-safe since they do not
+	// modify the octree nor the camera) and records the groups it reached in
+	// traversal order; applyPass(), which must be called from the main thread,
+	// then performs the occlusion checks (early fails) and processes the
+	// recorded groups, in the same order as traverse() would have.
+	struct CullEntry
+	{
+		LL_INLINE CullEntry(LLViewerOctreeGroup* group, U32 depth)
+		:	mGroup(group),
+			mDepth(depth),
+			mRes(0),
+			mVisited(false),
+			mProcess(false)
+		{
+		}
+
+		LLViewerOctreeGroup*	mGroup;
+		U32						mDepth;
+		S32						mRes;
+		bool					mVisited;
+		bool					mProcess;
+	};
+	typedef std::vector<CullEntry> entries_vec_t;
+
+	// When 'bounds' is not NULL, it is used to perform the frustum checks in
+	// batches, if possible, and then traverse its flattened octree.
+	void frustumPass(const OctreeNode* n, entries_vec_t& entries,
+					 LLViewerOctreeBounds* bounds = NULL);
+
+	void applyPass(const entries_vec_t& entries);
+
 protected:
 	virtual bool earlyFail(LLViewerOctreeGroup* group);
 
@@ -548,6 +670,23 @@ protected:
 	virtual S32 frustumCheck(const LLViewerOctreeGroup* group) = 0;
 	virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group) = 0;
 
+	// Batched frustum checks support: frustumCheckBatch() must fill the
+	// bounds.mResults with the planes checks results for all the groups and
+	// return true, or return false when not supported by the culler.
+	// frustumCheckRefine() is then called for the groups which passed the
+	// planes checks and are actually reached during the traversal, to
+	// perform any additional check done by frustumCheck().
+	LL_INLINE virtual bool frustumCheckBatch(LLViewerOctreeBounds& bounds)
+	{
+		return false;
+	}
+
+	LL_INLINE virtual S32 frustumCheckRefine(const LLViewerOctreeGroup* group,
+											 S32 res)
+	{
+		return res;
+	}
+
 	bool checkProjectionArea(const LLVector4a& center, const LLVector4a& size,
 							 const LLVector3& shift, F32 pixel_threshold,
 							 F32 near_radius);
@@ -557,6 +696,11 @@ protected:
 	virtual void processGroup(LLViewerOctreeGroup* group);
 	void visit(const OctreeNode* branch) override;
 
+private:
+	void frustumPass(const OctreeNode* n, U32 depth, entries_vec_t& entries);
+	void frustumPass(const LLViewerOctreeBounds& bounds, U32 index, U32 depth,
+					 entries_vec_t& entries);
+
 protected:
 	LLCamera*	mCamera;
 	S32			mRes;
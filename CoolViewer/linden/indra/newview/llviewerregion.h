@@ -428,6 +428,10 @@ public:
 
 	LLVOCacheEntry* getCacheEntryForOctree(U32 local_id);
 	LLVOCacheEntry* getCacheEntry(U32 local_id, bool valid = true);
+	LL_INLINE const LLVOCacheEntry::vocache_entry_map_t& getCacheMap() const
+	{
+		return mCacheMap;
+	}
 	bool probeCache(U32 local_id, U32 crc, U32 flags, U8& cache_miss_type);
 	void requestCacheMisses();
 	void addCacheMissFull(U32 local_id);
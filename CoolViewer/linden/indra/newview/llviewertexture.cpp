@@ -41,6 +41,7 @@
 #include "llfasttimer.h"
 #include "llhost.h"
 #include "llimage.h"
+#include "llimagebc.h"
 #include "llimagegl.h"
 #include "llimagebmp.h"
 #include "llimagej2c.h"
@@ -1203,6 +1204,7 @@ void LLViewerFetchedTexture::init(bool firstinit)
 	{
 		mDecodePriority = 0.f;
 		mInImageList = false;
+		mPriorityIndex = -1;
 	}
 
 	// Only set mIsMissingAsset true when we know for certain that the database
@@ -1247,6 +1249,12 @@ void LLViewerFetchedTexture::init(bool firstinit)
 	mKeptSavedRawImageTime = 0.f;
 	mLastCallBackActiveTime = 0.f;
 
+	mImportance = 0.f;
+	mImportanceUpdateTime = gFrameTimeSeconds;
+	mResidencyDiscard = 0;
+
+	mStatsVirtualSize = 0.f;
+
 	mFTType = FTT_UNKNOWN;
 
 	mLastPacketTime = mStopFetchingTime = gFrameTimeSeconds;
@@ -1635,7 +1643,10 @@ bool LLViewerFetchedTexture::createTexture(S32 usename)
 	}
 
 	res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename,
-									   true, mBoostLevel);
+									   true, mBoostLevel, mCompressedImage,
+									   mAlphaInfo);
+	mCompressedImage = NULL;
+	mAlphaInfo = NULL;
 
 	notifyAboutCreatingTexture();
 
@@ -1764,50 +1775,84 @@ constexpr F32 MAX_DECODE_PRIORITY = PRIORITY_BOOST_HIGH_FACTOR +
 
 F32 LLViewerFetchedTexture::calcDecodePriority()
 {
-	if (mNeedsCreateTexture)
+	LLTexturePriorityInputs inputs;
+	getPriorityInputs(inputs);
+	F32 priority = computeDecodePriority(inputs);
+	setAdditionalDecodePriority(inputs.mAdditionalPriority);
+	return priority;
+}
+
+void LLViewerFetchedTexture::getPriorityInputs(LLTexturePriorityInputs& inputs) const
+{
+	inputs.mMaxVirtualSize = mMaxVirtualSize;
+	inputs.mDecodePriority = mDecodePriority;
+	inputs.mAdditionalPriority = mAdditionalDecodePriority;
+	inputs.mTexelsPerImage = mTexelsPerImage;
+	inputs.mCurrentDiscard = getCurrentDiscardLevelForFetching();
+	inputs.mDesiredDiscard = mDesiredDiscardLevel;
+	inputs.mCachedRawDiscard = mCachedRawDiscardLevel;
+	inputs.mMaxDiscard = getMaxDiscardLevel();
+	inputs.mMinDiscard = mMinDiscardLevel;
+	inputs.mBoostLevel = mBoostLevel;
+	inputs.mNeedsCreateTexture = mNeedsCreateTexture;
+	inputs.mFullyLoaded = mFullyLoaded && !mForceToSaveRawImage;
+	inputs.mMissingOrDeleted = mIsMissingAsset || mWasDeleted;
+	inputs.mJustBound = isJustBound();
+	inputs.mCachedRawImageReady = mCachedRawImageReady;
+	// Note: fully loaded textures do not update their virtual size in
+	// LLViewerFetchedTexture::processTextureStats()
+	inputs.mStaleStats = !mFullyLoaded &&
+						 mMaxVirtualSize > 2.f * mStatsVirtualSize + 1.f;
+}
+
+//static
+F32 LLViewerFetchedTexture::computeDecodePriority(LLTexturePriorityInputs& inputs)
+{
+	if (inputs.mNeedsCreateTexture)
 	{
-		return mDecodePriority; // No change while waiting to create
+		return inputs.mDecodePriority; // No change while waiting to create
 	}
-	if (mFullyLoaded && !mForceToSaveRawImage)
+	if (inputs.mFullyLoaded)
 	{
 		return -1.f;	// Already loaded for static texture
 	}
 
-	S32 cur_discard = getCurrentDiscardLevelForFetching();
-	bool have_all_data = cur_discard >= 0 &&
-						 cur_discard <= mDesiredDiscardLevel;
-	F32 pixel_priority = sqrtf(mMaxVirtualSize);
+	S32 cur_discard = inputs.mCurrentDiscard;
+	S32 desired_discard = inputs.mDesiredDiscard;
+	S32 boost_level = inputs.mBoostLevel;
+	bool have_all_data = cur_discard >= 0 && cur_discard <= desired_discard;
+	F32 pixel_priority = sqrtf(inputs.mMaxVirtualSize);
 
 	F32 priority = 0.f;
 
-	if (mIsMissingAsset || mWasDeleted)
+	if (inputs.mMissingOrDeleted)
 	{
 		priority = 0.f;
 	}
-	else if (mDesiredDiscardLevel >= cur_discard && cur_discard > -1)
+	else if (desired_discard >= cur_discard && cur_discard > -1)
 	{
 		priority = -2.f;
 	}
-	else if (mCachedRawDiscardLevel > -1 &&
-			 mDesiredDiscardLevel >= mCachedRawDiscardLevel)
+	else if (inputs.mCachedRawDiscard > -1 &&
+			 desired_discard >= inputs.mCachedRawDiscard)
 	{
 		priority = -3.f;
 	}
-	else if (mDesiredDiscardLevel > getMaxDiscardLevel())
+	else if (desired_discard > inputs.mMaxDiscard)
 	{
 		// Do not decode anything we do not need
 		priority = -4.f;
 	}
 	else if (!have_all_data &&
-			 (mBoostLevel == LLGLTexture::BOOST_UI ||
-			  mBoostLevel == LLGLTexture::BOOST_ICON))
+			 (boost_level == LLGLTexture::BOOST_UI ||
+			  boost_level == LLGLTexture::BOOST_ICON))
 	{
 		priority = 1.f;
 	}
 	else if (pixel_priority < 0.001f && !have_all_data)
 	{
 		// Not on screen but we might want some data
-		if (mBoostLevel > BOOST_HIGH)
+		if (boost_level > BOOST_HIGH)
 		{
 			// Always want high boosted images
 			priority = 1.f;
@@ -1826,9 +1871,9 @@ F32 LLViewerFetchedTexture::calcDecodePriority()
 		ddiscard = llclamp(ddiscard, 0, MAX_DELTA_DISCARD_LEVEL_FOR_PRIORITY);
 		priority = (ddiscard + 1) * PRIORITY_DELTA_DISCARD_LEVEL_FACTOR;
 		// Boost the textures without any data so far
-		setAdditionalDecodePriority(0.1f);
+		inputs.mAdditionalPriority = llmax(inputs.mAdditionalPriority, 0.1f);
 	}
-	else if (mMinDiscardLevel > 0 && cur_discard <= mMinDiscardLevel)
+	else if (inputs.mMinDiscard > 0 && cur_discard <= inputs.mMinDiscard)
 	{
 		// Larger mips are corrupted
 		priority = -6.f;
@@ -1836,10 +1881,9 @@ F32 LLViewerFetchedTexture::calcDecodePriority()
 	else
 	{
 		// Priority range = 100,000 - 500,000
-		S32 desired_discard = mDesiredDiscardLevel;
-		if (!isJustBound() && mCachedRawImageReady)
+		if (!inputs.mJustBound && inputs.mCachedRawImageReady)
 		{
-			if (mBoostLevel < BOOST_HIGH)
+			if (boost_level < BOOST_HIGH)
 			{
 				// We do not have rendered this in a while, de-prioritize it
 				desired_discard += 2;
@@ -1862,8 +1906,8 @@ F32 LLViewerFetchedTexture::calcDecodePriority()
 	// [10,000,000] + [1,000,000-9,000,000]  + [100,000-500,000]   + [1-20,000]  + [0-999]
 	if (priority > 0.f)
 	{
-		bool large_enough = mCachedRawImageReady &&
-							mTexelsPerImage > sMinLargeImageSize;
+		bool large_enough = inputs.mCachedRawImageReady &&
+							inputs.mTexelsPerImage > sMinLargeImageSize;
 		if (large_enough)
 		{
 			// Note: to give small, low-priority textures some chance to be
@@ -1874,22 +1918,23 @@ F32 LLViewerFetchedTexture::calcDecodePriority()
 
 		pixel_priority = llclamp(pixel_priority, 0.f, MAX_PRIORITY_PIXEL);
 
-		priority += pixel_priority + PRIORITY_BOOST_LEVEL_FACTOR * mBoostLevel;
+		priority += pixel_priority + PRIORITY_BOOST_LEVEL_FACTOR * boost_level;
 
-		if (mBoostLevel > BOOST_HIGH)
+		if (boost_level > BOOST_HIGH)
 		{
-			if (mBoostLevel > BOOST_SUPER_HIGH)
+			if (boost_level > BOOST_SUPER_HIGH)
 			{
 				// For very important textures, always grant the highest
 				// priority.
 				priority += PRIORITY_BOOST_HIGH_FACTOR;
 			}
-			else if (mCachedRawImageReady)
+			else if (inputs.mCachedRawImageReady)
 			{
 				// Note: to give small, low-priority textures some chance to be
 				// fetched, if high priority texture has a 64*64 ready, lower
 				// its fetching priority.
-				setAdditionalDecodePriority(0.5f);
+				inputs.mAdditionalPriority =
+					llmax(inputs.mAdditionalPriority, 0.5f);
 			}
 			else
 			{
@@ -1897,11 +1942,11 @@ F32 LLViewerFetchedTexture::calcDecodePriority()
 			}
 		}
 
-		if (mAdditionalDecodePriority > 0.f)
+		if (inputs.mAdditionalPriority > 0.f)
 		{
 			// Priority range += 1,000,000.f-9,000,000.f
 			F32 additional = PRIORITY_ADDITIONAL_FACTOR *
-							 (1.0 + mAdditionalDecodePriority *
+							 (1.0 + inputs.mAdditionalPriority *
 							  MAX_ADDITIONAL_LEVEL_FOR_PRIORITY);
 			if (large_enough)
 			{
@@ -1948,6 +1993,7 @@ void LLViewerFetchedTexture::updateVirtualSize()
 		addTextureStats(0.f, false);	// Reset
 	}
 
+	F32 pixel_area = 0.f;
 	for (U32 ch = 0; ch < LLRender::NUM_TEXTURE_CHANNELS; ++ch)
 	{
 		U32 count = mNumFaces[ch];
@@ -1967,13 +2013,30 @@ void LLViewerFetchedTexture::updateVirtualSize()
 				LLDrawable* drawable = facep->getDrawable();
 				if (drawable && drawable->isRecentlyVisible())
 				{
-					addTextureStats(facep->getVirtualSize());
+					F32 vsize = facep->getVirtualSize();
+					pixel_area += vsize;
+					addTextureStats(vsize);
 					setAdditionalDecodePriority(facep->getImportanceToCamera());
 				}
 			}
 		}
 	}
 
+	// Importance for the residency manager: it follows the pixel area while
+	// the texture is seen, and is halved every IMPORTANCE_HALF_LIFE seconds
+	// otherwise.
+	constexpr F32 IMPORTANCE_HALF_LIFE = 10.f;
+	F32 elapsed = sCurrentTime - mImportanceUpdateTime;
+	mImportanceUpdateTime = sCurrentTime;
+	if (pixel_area < mImportance && elapsed > 0.f)
+	{
+		pixel_area = llmax(pixel_area,
+						   mImportance *
+						   powf(0.5f, elapsed / IMPORTANCE_HALF_LIFE));
+	}
+	mImportance = pixel_area;
+	mStatsVirtualSize = mMaxVirtualSize;
+
 	if (mMaxVirtualSizeResetCounter > 0)
 	{
 		--mMaxVirtualSizeResetCounter;
@@ -1982,7 +2045,7 @@ void LLViewerFetchedTexture::updateVirtualSize()
 	reorganizeVolumeList();
 }
 
-S32 LLViewerFetchedTexture::getCurrentDiscardLevelForFetching()
+S32 LLViewerFetchedTexture::getCurrentDiscardLevelForFetching() const
 {
 	S32 current_discard = getDiscardLevel();
 	if (mForceToSaveRawImage)
@@ -2061,6 +2124,8 @@ bool LLViewerFetchedTexture::updateFetch()
 														   fetch_discard,
 														   mRawImage,
 														   mAuxRawImage,
+														   mCompressedImage,
+														   mAlphaInfo,
 														   mLastHttpGetStatus);
 		if (mRawImage.notNull())
 		{
@@ -2907,6 +2972,9 @@ LLImageRaw* LLViewerFetchedTexture::reloadRawImage(S8 discard_level)
 
 void LLViewerFetchedTexture::destroyRawImage()
 {
+	mCompressedImage = NULL;
+	mAlphaInfo = NULL;
+
 	if (mAuxRawImage.notNull())
 	{
 		--sAuxCount;
@@ -3315,6 +3383,7 @@ void LLViewerLODTexture::processTextureStats()
 			discard_level += sDesiredDiscardBias;
 			discard_level *= sDesiredDiscardScale; // scale
 			discard_level += sCameraMovingDiscardBias;
+			discard_level += mResidencyDiscard;
 		}
 		discard_level = floorf(discard_level);
 
@@ -3394,6 +3463,24 @@ bool LLViewerLODTexture::scaleDown()
 	return false;
 }
 
+//virtual
+bool LLViewerLODTexture::downsampleForResidency()
+{
+	constexpr S8 MAX_RESIDENCY_DISCARD = 3;
+	if (mBoostLevel >= LLGLTexture::BOOST_SCULPTED || mForceToSaveRawImage ||
+		!scaleDown())
+	{
+		return false;
+	}
+	if (mResidencyDiscard < MAX_RESIDENCY_DISCARD)
+	{
+		++mResidencyDiscard;
+	}
+	// Make sure the next desired discard level gets recomputed.
+	mCalculatedDiscardLevel = -1.f;
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // LLViewerMediaTexture
 //-----------------------------------------------------------------------------
@@ -3443,6 +3530,23 @@ void LLViewerMediaTexture::cleanUpClass()
 	sMediaMap.clear();
 }
 
+//static
+S64 LLViewerMediaTexture::getTotalTextureMemory()
+{
+	S64 total = 0;
+	for (media_map_t::const_iterator iter = sMediaMap.begin(),
+									 end = sMediaMap.end();
+		 iter != end; ++iter)
+	{
+		LLViewerMediaTexture* mediap = iter->second.get();
+		if (mediap && mediap->hasGLTexture())
+		{
+			total += mediap->getTextureMemory();
+		}
+	}
+	return total;
+}
+
 //static
 LLViewerMediaTexture* LLViewerMediaTexture::findMediaTexture(const LLUUID& media_id)
 {
@@ -48,6 +48,8 @@
 
 #define BYTES2MEGABYTES(x) ((x) >> 20)
 
+class LLImageAlphaInfo;
+class LLImageBC;
 class LLImageGL;
 class LLImageRaw;
 class LLMessageSystem;
@@ -275,6 +277,34 @@ enum FTType
 
 const std::string& fttype_to_string(const FTType& fttype);
 
+// Inputs of the decode priority computation, packed in a small POD structure
+// so that the priorities of all the fetched textures may be computed in a
+// parallel pass over a flat array (see
+// LLViewerTextureList::updateImagesPriorities()). HB
+struct LLTexturePriorityInputs
+{
+	F32		mMaxVirtualSize;
+	// Returned as is while the texture is waiting for its creation.
+	F32		mDecodePriority;
+	// In/out: the computation may raise it.
+	F32		mAdditionalPriority;
+	S32		mTexelsPerImage;
+	S32		mCurrentDiscard;
+	S32		mDesiredDiscard;
+	S32		mCachedRawDiscard;
+	S32		mMaxDiscard;
+	S32		mMinDiscard;
+	S32		mBoostLevel;
+	bool	mNeedsCreateTexture;
+	bool	mFullyLoaded;
+	bool	mMissingOrDeleted;
+	bool	mJustBound;
+	bool	mCachedRawImageReady;
+	// Set when the virtual size grew a lot since the last texture stats
+	// processing, meaning the desired discard level is likely stale.
+	bool	mStaleStats;
+};
+
 //
 // Textures are managed in gTextureList. Raw image data is fetched from remote
 // or local cache but the raw image this texture pointing to is fixed.
@@ -352,6 +382,18 @@ public:
 	virtual void processTextureStats();
 	F32 calcDecodePriority();
 
+	// Packs the inputs of the decode priority computation. Only reads the
+	// texture, so it may be called from worker threads while the main thread
+	// waits for them.
+	void getPriorityInputs(LLTexturePriorityInputs& inputs) const;
+	// Pure function, safe to call from any thread.
+	static F32 computeDecodePriority(LLTexturePriorityInputs& inputs);
+
+	// Index in LLViewerTextureList::mPriorityTextures, or -1. ONLY set it
+	// from LLViewerTextureList.
+	LL_INLINE S32 getPriorityIndex() const					{ return mPriorityIndex; }
+	LL_INLINE void setPriorityIndex(S32 index)				{ mPriorityIndex = index; }
+
 	LL_INLINE bool needsAux() const							{ return mNeedsAux; }
 
 	// Host we think might have this image, used for baked av textures.
@@ -409,6 +451,18 @@ public:
 	LL_INLINE bool isDeletionCandidate()					{ return mTextureState == DELETION_CANDIDATE; }
 	LL_INLINE bool getUseDiscard() const					{ return mUseMipMaps && !mDontDiscard; }
 
+	// Residency manager support. The importance follows the total pixel area
+	// covered on screen by the faces using this texture, and decays while it
+	// is not seen any more. HB
+	LL_INLINE F32 getImportance() const						{ return mImportance; }
+	LL_INLINE S8 getResidencyDiscard() const				{ return mResidencyDiscard; }
+	LL_INLINE void clearResidencyDiscard()					{ mResidencyDiscard = 0; }
+	// Drops the GL texture resolution down to the one of the cached raw image
+	// and prevents the texture from being fetched back at its former
+	// resolution till clearResidencyDiscard() is called. Returns true on
+	// success.
+	LL_INLINE virtual bool downsampleForResidency()			{ return false; }
+
 	void setForSculpt();
 	LL_INLINE bool forSculpt() const						{ return mForSculpt; }
 	LL_INLINE bool isForSculptOnly() const					{ return mForSculpt && !mNeedsGLTexture; }
@@ -450,7 +504,7 @@ public:
 
 protected:
 	void switchToCachedImage() override;
-	S32 getCurrentDiscardLevelForFetching();
+	S32 getCurrentDiscardLevelForFetching() const;
 
 private:
 	void init(bool firstinit);
@@ -532,6 +586,12 @@ protected:
 	// Used ONLY for cloth meshes right now.  Make SURE you know what you're
 	// doing if you use it for anything else! - djs
 	LLPointer<LLImageRaw>	mAuxRawImage;
+	// Block-compressed version of mRawImage, as provided by the fetcher when
+	// enabled, and only kept till the GL texture gets created.
+	LLPointer<LLImageBC>	mCompressedImage;
+	// Alpha channel analysis of mRawImage, as done by the image decoder, and
+	// only kept till the GL texture gets created.
+	LLPointer<LLImageAlphaInfo>	mAlphaInfo;
 	LLPointer<LLImageRaw>	mSavedRawImage;
 	// A small version of the copy of the raw image (<= 64 * 64)
 	LLPointer<LLImageRaw>	mCachedRawImage;
@@ -543,6 +603,17 @@ protected:
 	F32						mLastReferencedSavedRawImageTime;
 	F32						mKeptSavedRawImageTime;
 
+	// Residency manager data
+	F32						mImportance;
+	F32						mImportanceUpdateTime;
+	// Extra discard levels imposed by the residency manager
+	S8						mResidencyDiscard;
+
+	// Parallel decode priorities pass data
+	S32						mPriorityIndex;
+	// Virtual size at the last updateVirtualSize() call.
+	F32						mStatsVirtualSize;
+
 	// Timing
 	// Last time a packet was received.
 	F32						mLastPacketTime;
@@ -620,6 +691,8 @@ public:
 	void processTextureStats() override;
 	bool isUpdateFrozen();
 
+	bool downsampleForResidency() override;
+
 private:
 	void init(bool firstinit);
 	bool scaleDown();
@@ -674,6 +747,9 @@ public:
 	static LLViewerMediaTexture* findMediaTexture(const LLUUID& media_id);
 	static void removeMediaImplFromTexture(const LLUUID& media_id);
 
+	// Returns the GL memory used by all media textures, in bytes.
+	static S64 getTotalTextureMemory();
+
 private:
 	void switchTexture(U32 ch, LLFace* facep);
 	bool findFaces();
@@ -33,6 +33,7 @@
 #include "llviewerprecompiledheaders.h"
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <utility>
 
 #include "llviewertexturelist.h"
@@ -51,6 +52,7 @@
 #include "llmessage.h"
 #include "llsdserialize.h"
 #include "llsys.h"
+#include "llthreadpool.h"
 #include "llxmltree.h"
 
 #include "llagent.h"
@@ -92,9 +94,13 @@ LLViewerTextureList::LLViewerTextureList()
 :	mForceResetTextureStats(false),
 	mMaxResidentTexMemInMegaBytes(0),
 	mMaxTotalTextureMemInMegaBytes(0),
+	mResidencyEvictions(0),
+	mResidencyDownsamples(0),
+	mResidencyRawFreed(0),
 	mInitialized(false),
 	mFlushOldImages(false)
 {
+	memset(mResidencyUsage, 0, sizeof(mResidencyUsage));
 }
 
 void LLViewerTextureList::init()
@@ -420,6 +426,7 @@ void LLViewerTextureList::shutdown()
 #endif
 
 	mUUIDMap.clear();
+	mPriorityTextures.clear();
 
 	mImageList.clear();
 
@@ -826,7 +833,11 @@ void LLViewerTextureList::addImage(LLViewerFetchedTexture* new_image)
 	++sNumImages;
 
 	addImageToList(new_image);
-	mUUIDMap.emplace(image_id, new_image);
+	if (mUUIDMap.emplace(image_id, new_image).second)
+	{
+		new_image->setPriorityIndex(mPriorityTextures.size());
+		mPriorityTextures.push_back(new_image);
+	}
 }
 
 void LLViewerTextureList::deleteImage(LLViewerFetchedTexture* image)
@@ -843,6 +854,16 @@ void LLViewerTextureList::deleteImage(LLViewerFetchedTexture* image)
 					<< " was not in the UUIDs list !" << llendl;
 			llassert(false);
 		}
+		S32 index = image->getPriorityIndex();
+		if (index >= 0 && index < (S32)mPriorityTextures.size() &&
+			mPriorityTextures[index] == image)
+		{
+			LLViewerFetchedTexture* last = mPriorityTextures.back();
+			mPriorityTextures[index] = last;
+			last->setPriorityIndex(index);
+			mPriorityTextures.pop_back();
+			image->setPriorityIndex(-1);
+		}
 		--sNumImages;
 		removeImageFromList(image);
 	}
@@ -879,6 +900,8 @@ void LLViewerTextureList::updateImages(F32 max_time)
 	max_time = llmax(max_time, min_time);
 
 	updateImagesDecodePriorities();
+	updateImagesPriorities();
+	updateImagesResidency();
 
 	max_time -= updateImagesFetchTextures(max_time);
 	max_time = llmax(max_time, min_time);
@@ -1022,6 +1045,9 @@ void LLViewerTextureList::updateImagesDecodePriorities()
 			  (F32)timeout /
 			  (1.f + LLViewerTexture::sDesiredDiscardBias * 0.5f));
 
+	static LLCachedControl<bool> parallel_priorities(gSavedSettings,
+													 "TextureParallelPriorities");
+
 	uuid_map_t::iterator iter = mUUIDMap.upper_bound(mLastUpdateUUID);
 	while ((update_counter-- > 0 || (mFlushOldImages && map_size-- > 0)) &&
 		   !mUUIDMap.empty())
@@ -1101,6 +1127,10 @@ void LLViewerTextureList::updateImagesDecodePriorities()
 		if (update_counter >= 0)
 		{
 			imagep->processTextureStats();
+			if (parallel_priorities)
+			{
+				continue;	// Done in updateImagesPriorities()
+			}
 			F32 old_priority = imagep->getDecodePriority();
 			F32 old_priority_test = llmax(old_priority, 0.f);
 			F32 decode_priority = imagep->calcDecodePriority();
@@ -1120,6 +1150,300 @@ void LLViewerTextureList::updateImagesDecodePriorities()
 	mFlushOldImages = false;
 }
 
+// Recomputes the decode priority of all the fetched textures. Their inputs are
+// first packed into a flat array and the priorities computed from it, by
+// chunks, in the threads pool; the results are then applied on the main
+// thread, which is the only one allowed to reorder mImageList. The textures
+// which virtual size grew a lot since their last stats update (typically, the
+// ones which just became visible) get their stats processed right away, so
+// that they do not have to wait for the time-sliced loop in
+// updateImagesDecodePriorities() to reach them. HB
+void LLViewerTextureList::updateImagesPriorities()
+{
+	static LLCachedControl<bool> parallel_priorities(gSavedSettings,
+													 "TextureParallelPriorities");
+	if (!parallel_priorities)
+	{
+		return;
+	}
+
+	LL_FAST_TIMER(FTM_IMAGE_PRIORITIES);
+
+	U32 count = mPriorityTextures.size();
+	if (!count)
+	{
+		return;
+	}
+	mPriorityInputs.resize(count);
+	mPriorityResults.resize(count);
+
+	constexpr U32 CHUNK_SIZE = 512;
+	U32 chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	auto compute_chunk = [this, count](U32 chunk)
+	{
+		U32 end = llmin(count, (chunk + 1) * CHUNK_SIZE);
+		for (U32 i = chunk * CHUNK_SIZE; i < end; ++i)
+		{
+			LLTexturePriorityInputs& inputs = mPriorityInputs[i];
+			mPriorityTextures[i]->getPriorityInputs(inputs);
+			mPriorityResults[i] =
+				LLViewerFetchedTexture::computeDecodePriority(inputs);
+		}
+	};
+	if (chunks > 1 && gThreadPoolp && gThreadPoolp->getSize())
+	{
+		gThreadPoolp->parallelFor(chunks, compute_chunk);
+	}
+	else
+	{
+		for (U32 chunk = 0; chunk < chunks; ++chunk)
+		{
+			compute_chunk(chunk);
+		}
+	}
+
+	// Cap the number of stale stats updates per frame, since
+	// processTextureStats() is not cheap.
+	constexpr U32 MAX_STATS_UPDATES = 256;
+	U32 stats_updates = 0;
+	for (U32 i = 0; i < count; ++i)
+	{
+		LLViewerFetchedTexture* imagep = mPriorityTextures[i];
+		if (!imagep->isInImageList() || imagep->isDeleted() ||
+			imagep->isDeletionCandidate())
+		{
+			continue;
+		}
+#if LL_FAST_TEX_CACHE
+		if (imagep->isInFastCacheList())
+		{
+			continue;	// Wait for loading from the fast cache.
+		}
+#endif
+		F32 decode_priority;
+		if (mPriorityInputs[i].mStaleStats &&
+			stats_updates < MAX_STATS_UPDATES)
+		{
+			++stats_updates;
+			imagep->processTextureStats();
+			decode_priority = imagep->calcDecodePriority();
+		}
+		else
+		{
+			const LLTexturePriorityInputs& inputs = mPriorityInputs[i];
+			imagep->setAdditionalDecodePriority(inputs.mAdditionalPriority);
+			decode_priority = mPriorityResults[i];
+		}
+		F32 old_priority_test = llmax(imagep->getDecodePriority(), 0.f);
+		F32 decode_priority_test = llmax(decode_priority, 0.f);
+		// Ignore < 20% difference
+		if (decode_priority_test < old_priority_test * .8f ||
+			decode_priority_test > old_priority_test * 1.25f)
+		{
+			// Keep a reference while the image is out of mImageList (it is
+			// also held by mUUIDMap, but better safe than sorry).
+			LLPointer<LLViewerFetchedTexture> holder = imagep;
+			mImageList.erase(holder);
+			imagep->setDecodePriority(decode_priority);
+			mImageList.emplace(std::move(holder));
+		}
+	}
+}
+
+// Texture residency manager: keeps the GL memory used by textures within the
+// budget derived from the TextureMemory setting, and the memory used by the
+// saved raw images within TextureRawMemoryBudget, by evicting or downsampling
+// the least important textures first. The importance of each texture is
+// maintained by LLViewerFetchedTexture::updateVirtualSize() from the pixel
+// area of its faces, and is further aged here with the time elapsed since the
+// texture was last drawn. HB
+void LLViewerTextureList::updateImagesResidency()
+{
+	LL_FAST_TIMER(FTM_IMAGE_RESIDENCY);
+
+	constexpr F32 RESIDENCY_UPDATE_INTERVAL = 0.25f;	// In seconds
+	if (mResidencyTimer.getElapsedTimeF32() < RESIDENCY_UPDATE_INTERVAL)
+	{
+		return;
+	}
+	mResidencyTimer.reset();
+
+	static LLCachedControl<bool> enabled(gSavedSettings,
+										 "TextureResidencyManager");
+	static LLCachedControl<U32> raw_budget_mb(gSavedSettings,
+											  "TextureRawMemoryBudget");
+	const S64 vram_budget = (S64)mMaxTotalTextureMemInMegaBytes << 20;
+	const S64 vram_used = LLImageGL::sGlobalTextureMemoryInBytes;
+	const S64 raw_budget = (S64)raw_budget_mb << 20;
+	const S64 raw_used = LLImageRaw::sGlobalRawMemory;
+	bool over_vram = enabled && vram_budget > 0 && vram_used > vram_budget;
+	bool over_raw = enabled && raw_budget > 0 && raw_used > raw_budget;
+	// Once well within both budgets again, allow downsampled textures to get
+	// back to their full resolution. A zero budget means no limit.
+	bool relax = !enabled ||
+				 ((vram_budget <= 0 || vram_used < vram_budget * 17 / 20) &&
+				  (raw_budget <= 0 || raw_used < raw_budget * 17 / 20));
+
+	struct Candidate
+	{
+		LL_INLINE Candidate(F32 score, LLViewerFetchedTexture* imagep)
+		:	mScore(score),
+			mImagep(imagep)
+		{
+		}
+
+		F32						mScore;
+		// Raw pointer: mImageList holds a reference, and no image is removed
+		// from the latter during this method.
+		LLViewerFetchedTexture*	mImagep;
+	};
+	static std::vector<Candidate> candidates;
+	candidates.clear();
+
+	memset(mResidencyUsage, 0, sizeof(mResidencyUsage));
+	mResidencyUsage[RESIDENCY_MEDIA] =
+		LLViewerMediaTexture::getTotalTextureMemory();
+
+	for (priority_list_t::iterator iter = mImageList.begin(),
+								   end = mImageList.end();
+		 iter != end; ++iter)
+	{
+		LLViewerFetchedTexture* imagep = *iter;
+		if (relax && imagep->getResidencyDiscard())
+		{
+			imagep->clearResidencyDiscard();
+		}
+		if (!imagep->hasGLTexture())
+		{
+			continue;
+		}
+
+		S32 boost = imagep->getBoostLevel();
+		U32 category = RESIDENCY_WORLD;
+		switch (boost)
+		{
+			case LLGLTexture::BOOST_AVATAR_BAKED:
+			case LLGLTexture::BOOST_AVATAR:
+			case LLGLTexture::BOOST_AVATAR_BAKED_SELF:
+			case LLGLTexture::BOOST_AVATAR_SELF:
+				category = RESIDENCY_AVATARS;
+				break;
+
+			case LLGLTexture::BOOST_HUD:
+			case LLGLTexture::BOOST_ICON:
+			case LLGLTexture::BOOST_UI:
+			case LLGLTexture::BOOST_PREVIEW:
+			case LLGLTexture::BOOST_MAP:
+			case LLGLTexture::BOOST_MAP_VISIBLE:
+				category = RESIDENCY_UI;
+				break;
+
+			default:
+				break;
+		}
+		mResidencyUsage[category] += imagep->getTextureMemory();
+
+		// Never evict or downsample the textures needed by the UI or for
+		// baking our avatar, or the do-not-discard ones.
+		if ((!over_vram && !over_raw) || boost >= LLGLTexture::BOOST_HIGH ||
+			imagep->getDontDiscard() || imagep->forSculpt())
+		{
+			continue;
+		}
+
+		// The importance halves every 5 seconds while the texture is not
+		// drawn, and avatar textures are worth more than world ones.
+		constexpr F32 LRU_HALF_LIFE = 5.f;
+		F32 score = imagep->getImportance() + 1.f;
+		if (!imagep->isJustBound())
+		{
+			score *= powf(0.5f, imagep->getTimePassedSinceLastBound() /
+								LRU_HALF_LIFE);
+		}
+		if (category == RESIDENCY_AVATARS)
+		{
+			score *= 4.f;
+		}
+		candidates.emplace_back(score, imagep);
+	}
+
+	if (candidates.empty())
+	{
+		return;
+	}
+
+	// Min-heap on the score: the least important textures come first.
+	auto more_important = [](const Candidate& a, const Candidate& b)
+	{
+		return a.mScore > b.mScore;
+	};
+
+	if (over_vram)
+	{
+		// Go down a little below the budget, so that we do not evict a few
+		// textures at each update.
+		S64 to_free = vram_used - vram_budget * 9 / 10;
+		std::vector<Candidate>::iterator heap_end = candidates.end();
+		std::make_heap(candidates.begin(), heap_end, more_important);
+		while (to_free > 0 && heap_end != candidates.begin())
+		{
+			std::pop_heap(candidates.begin(), heap_end, more_important);
+			LLViewerFetchedTexture* imagep = (--heap_end)->mImagep;
+			S32 mem = imagep->getTextureMemory();
+			if (mem <= 0)
+			{
+				continue;
+			}
+			if (!imagep->getBoundRecently())
+			{
+				// Not drawn for a while: evict it. It will get fetched back
+				// (from the cache) when needed again.
+				imagep->destroyTexture();
+				S32 freed = mem - imagep->getTextureMemory();
+				if (freed > 0)
+				{
+					to_free -= freed;
+					++mResidencyEvictions;
+				}
+			}
+			else if (imagep->downsampleForResidency())
+			{
+				// The new GL texture is created later, from the cached raw
+				// image, which is at most a quarter of the size.
+				to_free -= mem * 3 / 4;
+				++mResidencyDownsamples;
+			}
+		}
+	}
+
+	if (over_raw)
+	{
+		S64 to_free = raw_used - raw_budget * 9 / 10;
+		std::vector<Candidate>::iterator heap_end =
+			std::partition(candidates.begin(), candidates.end(),
+						   [](const Candidate& c)
+						   {
+								return c.mImagep->hasSavedRawImage() &&
+									   !c.mImagep->hasCallbacks();
+						   });
+		std::make_heap(candidates.begin(), heap_end, more_important);
+		while (to_free > 0 && heap_end != candidates.begin())
+		{
+			std::pop_heap(candidates.begin(), heap_end, more_important);
+			LLViewerFetchedTexture* imagep = (--heap_end)->mImagep;
+			S64 before = LLImageRaw::sGlobalRawMemory;
+			// Note: this is a no-op for images which must be kept for a while.
+			imagep->destroySavedRawImage();
+			if (!imagep->hasSavedRawImage())
+			{
+				to_free -= llmax(before - (S64)LLImageRaw::sGlobalRawMemory,
+								 (S64)1);
+				++mResidencyRawFreed;
+			}
+		}
+	}
+}
+
 // Created GL textures for all textures that need them (images which have been
 // decoded, but have not been pushed into GL).
 F32 LLViewerTextureList::updateImagesCreateTextures(F32 max_time)
@@ -1131,6 +1455,13 @@ F32 LLViewerTextureList::updateImagesCreateTextures(F32 max_time)
 
 	LL_FAST_TIMER(FTM_IMAGE_CREATE);
 
+	// Budget for the amount of texture data uploaded to the GPU, so that a
+	// burst of decoded textures does not cause a frame rate hiccup. HB
+	static LLCachedControl<U32> upload_budget(gSavedSettings,
+											  "RenderTextureUploadBudget");
+	U64 max_bytes = (U64)upload_budget * 1024;
+	U64 start_bytes = LLImageGL::sUploadedBytes;
+
 	LLTimer create_timer;
 
 	image_list_t::iterator enditer = mCreateTextureList.begin();
@@ -1142,7 +1473,8 @@ F32 LLViewerTextureList::updateImagesCreateTextures(F32 max_time)
 		enditer = iter;
 		LLViewerFetchedTexture* imagep = *curiter;
 		imagep->createTexture();
-		if (create_timer.getElapsedTimeF32() > max_time)
+		if (create_timer.getElapsedTimeF32() > max_time ||
+			(max_bytes && LLImageGL::sUploadedBytes - start_bytes > max_bytes))
 		{
 			break;
 		}
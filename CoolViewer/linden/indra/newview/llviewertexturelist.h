@@ -109,6 +109,27 @@ public:
 	LL_INLINE S32 getMaxTotalTextureMem() const	{ return mMaxTotalTextureMemInMegaBytes; }
 	LL_INLINE S32 getNumImages()				{ return mImageList.size(); }
 
+	// Texture categories for the residency manager statistics
+	enum EResidencyCategory : U32
+	{
+		RESIDENCY_AVATARS,
+		RESIDENCY_WORLD,
+		RESIDENCY_UI,
+		RESIDENCY_MEDIA,
+		RESIDENCY_COUNT
+	};
+	// GL memory used by the textures of 'category', in bytes.
+	LL_INLINE S64 getResidencyUsage(U32 category) const
+	{
+		return category < RESIDENCY_COUNT ? mResidencyUsage[category] : 0;
+	}
+	LL_INLINE U32 getResidencyEvictions() const	{ return mResidencyEvictions; }
+	LL_INLINE U32 getResidencyDownsamples() const
+	{
+		return mResidencyDownsamples;
+	}
+	LL_INLINE U32 getResidencyRawFreed() const	{ return mResidencyRawFreed; }
+
 	void updateMaxResidentTexMem(S32 mem);
 
 	void doPrefetchImages();
@@ -125,6 +146,8 @@ public:
 
 private:
 	void updateImagesDecodePriorities();
+	void updateImagesPriorities();
+	void updateImagesResidency();
 	F32  updateImagesCreateTextures(F32 max_time);
 	F32  updateImagesFetchTextures(F32 max_time);
 	void updateImagesUpdateStats();
@@ -197,6 +220,13 @@ private:
 					 LLViewerFetchedTexture::Compare> priority_list_t;
 	priority_list_t		mImageList;
 
+	// Flat arrays used by updateImagesPriorities(). mPriorityTextures holds
+	// the same textures as mUUIDMap (which keeps them referenced), and each
+	// texture knows its index in it, so that it may be swap-removed. HB
+	std::vector<LLViewerFetchedTexture*>	mPriorityTextures;
+	std::vector<LLTexturePriorityInputs>	mPriorityInputs;
+	std::vector<F32>						mPriorityResults;
+
 #if LL_FAST_TEX_CACHE
 	typedef std::deque<LLPointer<LLViewerFetchedTexture> > fast_cache_queue_t;
 	fast_cache_queue_t	mFastCacheQueue;
@@ -208,6 +238,13 @@ private:
 	S32					mMaxResidentTexMemInMegaBytes;
 	S32					mMaxTotalTextureMemInMegaBytes;
 
+	// Residency manager data
+	LLFrameTimer		mResidencyTimer;
+	S64					mResidencyUsage[RESIDENCY_COUNT];
+	U32					mResidencyEvictions;
+	U32					mResidencyDownsamples;
+	U32					mResidencyRawFreed;
+
 	// Texture fetching parameters, based on debug settings and possibly on
 	// last TP/login time and camera speed.
 	F32					mUpdateHighPriority;
@@ -47,6 +47,7 @@
 #include "llconsole.h"
 #include "lldir.h"
 #include "llfontfreetype.h"
+#include "llimagebc.h"
 #include "llimagebmp.h"
 #include "llimagegl.h"
 #include "llimagej2c.h"
@@ -66,6 +67,7 @@
 #include "llagent.h"
 #include "llappviewer.h"
 #include "llchatbar.h"
+#include "llcontrolhandles.h"
 #include "lldebugview.h"
 #include "lldrawable.h"
 #include "lldrawpoolalpha.h"
@@ -95,6 +97,7 @@
 #include "llpanellogin.h"
 #include "llpanelworldmap.h"
 #include "llpipeline.h"
+#include "llprefetchpredictor.h"
 #include "llprogressview.h"
 //MK
 #include "mkrlinterface.h"
@@ -127,6 +130,7 @@
 #include "llviewermenu.h"
 #include "llviewermessage.h"				// send_sound_trigger()
 #include "llviewerobjectlist.h"
+#include "llvieweroctree.h"
 #include "llviewerparcelmgr.h"
 #include "llviewerregion.h"
 #include "llviewershadermgr.h"
@@ -544,6 +548,10 @@ class LLDebugText
             llformat("%d texture binds", LLImageGL::sBindCount));
         ypos += mIncY;
 
+        addText(xpos, ypos,
+            llformat("%d shader binds", LLGLSLShader::sBindCount));
+        ypos += mIncY;
+
         addText(xpos, ypos,
             llformat("%d unique textures", LLImageGL::sUniqueCount));
         ypos += mIncY;
@@ -578,6 +586,12 @@ class LLDebugText
         ypos += mIncY;
         gPipeline.mTextureMatrixOps = 0;
 
+        addText(xpos, ypos,
+            llformat("%d draw calls saved by multi-draw batches",
+              gPipeline.mDrawCallsSaved));
+        ypos += mIncY;
+        gPipeline.mDrawCallsSaved = 0;
+
         addText(xpos, ypos,
             llformat("%d/%d nodes visible", gPipeline.mNumVisibleNodes,
               LLSpatialGroup::sNodeCount));
@@ -618,10 +632,87 @@ class LLDebugText
                 LLMeshRepository::sCacheBytesRead / MEGABYTE,
                 LLMeshRepository::sCacheBytesWritten / MEGABYTE));
           ypos += mIncY;
+
+          U32 reads = LLMeshRepository::sCacheReads;
+          addText(xpos, ypos,
+              llformat("%d mesh cache reads (%d pending), %.3fms average",
+                reads, (S32)LLMeshRepoThread::sActiveCacheReads,
+                reads ? LLMeshRepository::sCacheReadTime / (1000.f * reads)
+                      : 0.f));
+          ypos += mIncY;
+        }
+
+        addText(xpos, ypos,
+            llformat("%d UI child lookups (%d indexed), %d names compared",
+              LLView::sChildLookups, LLView::sChildIndexHits,
+              LLView::sChildLookupCost));
+        ypos += mIncY;
+        LLView::resetChildLookupStats();
+
+        addText(xpos, ypos,
+            llformat("%d UI draw calls (%d saved), %d UI vertices",
+              LLRender::sUICalls, LLRender::sUIBatchedCalls,
+              LLRender::sUIVerts));
+        ypos += mIncY;
+        LLRender::sUICalls = LLRender::sUIBatchedCalls =
+          LLRender::sUIVerts = 0;
+
+        addText(xpos, ypos,
+            llformat("%d/%d text runs cache hits/misses",
+              LLFontGL::sTextRunsHits, LLFontGL::sTextRunsMisses));
+        ypos += mIncY;
+        LLFontGL::sTextRunsHits = LLFontGL::sTextRunsMisses = 0;
+
+        addText(xpos, ypos,
+            llformat("%d octree boxes batch-checked, %d bounds snapshots rebuilt, %d entries refreshed",
+              LLViewerOctreeBounds::sBoxesTested,
+              LLViewerOctreeBounds::sRebuilds,
+              LLViewerOctreeBounds::sRefreshes));
+        ypos += mIncY;
+        LLViewerOctreeBounds::sBoxesTested = LLViewerOctreeBounds::sRebuilds =
+          LLViewerOctreeBounds::sRefreshes = 0;
+
+        addText(xpos, ypos,
+            llformat("%d octree nodes pooled in %d slabs",
+              LLOctreeNodePool<LLViewerOctreeEntry>::sNodes.CurrentValue(),
+              LLOctreeNodePool<LLViewerOctreeEntry>::sSlabs.CurrentValue()));
+        ypos += mIncY;
+
+        addText(xpos, ypos,
+            llformat("%d rigged octree rebuilds avoided, %d refits",
+              LLRiggedVolume::sOctreeRebuildsAvoided,
+              LLRiggedVolume::sOctreeRefits));
+        ypos += mIncY;
+
+        if (LLVertexBuffer::hasStreamRing())
+        {
+          addText(xpos, ypos,
+              llformat("%.1f KB streamed via the ring buffers",
+                (F32)LLStreamRing::sBytesStreamed / 1024.f));
+          ypos += mIncY;
+        }
+        LLStreamRing::sBytesStreamed = 0;
+
+        // LLImageGL::sUploadedBytes is never reset, since it is also used
+        // for the textures upload budget.
+        static U64 last_uploaded_bytes = 0;
+        addText(xpos, ypos,
+            llformat("%.1f KB of texture data uploaded",
+              (F32)(LLImageGL::sUploadedBytes - last_uploaded_bytes) /
+              1024.f));
+        ypos += mIncY;
+        last_uploaded_bytes = LLImageGL::sUploadedBytes;
+
+        if (LLImageBC::sEnabled)
+        {
+          addText(xpos, ypos,
+              llformat("%d textures block-compressed, %d from cache",
+                (S32)LLImageBC::sEncodedCount, (S32)LLImageBC::sCacheHits));
+          ypos += mIncY;
         }
 
         LLVertexBuffer::sBindCount = LLImageGL::sBindCount =
-          LLVertexBuffer::sSetCount =
+          LLGLSLShader::sBindCount = LLVertexBuffer::sSetCount =
           LLImageGL::sUniqueCount =
           gPipeline.mNumVisibleNodes =
           LLPipeline::sVisibleLightCount = 0;
@@ -1038,6 +1129,7 @@ LLViewerWindow::LLViewerWindow(const std::string& title, S32 x, S32 y,
   {
     gSavedSettings.setBool("RenderVBOEnable", false);
   }
+  LLVertexBuffer::sUseStreamRing = gSavedSettings.getBool("RenderUseStreamRing");
   LLVertexBuffer::initClass(gSavedSettings.getBool("RenderVBOEnable"),
       gSavedSettings.getBool("RenderVBOMappingDisable"));
   llinfos << "LLVertexBuffer initialization done." << llendl;
@@ -1644,6 +1736,9 @@ void LLViewerWindow::shutdownGL()
   LLWearableList::getInstance()->cleanup();
   llinfos << "Wearables cleaned up" << llendl;
 
+  // Release the prefetched textures before the textures list shuts down
+  LLPrefetchPredictor::cleanup();
+
   gTextureList.shutdown();
   stop_glerror();
   llinfos << "Texture list shut down" << llendl;
@@ -1952,6 +2047,10 @@ void LLViewerWindow::draw()
 
   gUIProgram.bind();
 
+  static LLCachedControl<bool> ui_batching(gSavedSettings,
+      "RenderUIBatching");
+  gGL.setUIBatching(ui_batching);
+
   gGL.pushMatrix();
   LLUI::pushMatrix();
   {
@@ -2031,6 +2130,8 @@ void LLViewerWindow::draw()
   LLUI::popMatrix();
   gGL.popMatrix();
 
+  gGL.setUIBatching(false);
+
   gUIProgram.unbind();
 
   stop_glerror();
@@ -2039,7 +2140,7 @@ void LLViewerWindow::draw()
 bool focus_chatbar_if_needed()
 {
   if (!gChatBarp || gFocusMgr.childHasKeyboardFocus(gChatBarp) ||
-      gAgent.cameraMouselook() || !gSavedSettings.getBool("AutoFocusChat"))
+      gAgent.cameraMouselook() || !LLCtrl::AutoFocusChat())
   {
     return false;
   }
@@ -2155,7 +2256,7 @@ bool LLViewerWindow::handleKey(KEY key, MASK mask)
     {
       if (gChatBarp->hasTextEditor() ||
           gChatBarp->getCurrentChat().empty() ||
-          gSavedSettings.getBool("ArrowKeysMoveAvatar"))
+          LLCtrl::ArrowKeysMoveAvatar())
       {
         switch (key)
         {
@@ -66,6 +66,7 @@
 #include "llappearancemgr.h"
 #include "llappviewer.h"				// For gFrameCount
 #include "llavatartracker.h"			// For LLAvatarTracker::isAgentFriend()
+#include "llcontrolhandles.h"
 #include "lldrawpoolavatar.h"
 #include "llemote.h"
 #include "llfirstuse.h"
@@ -5068,7 +5069,7 @@ bool LLVOAvatar::processSingleAnimationStateChange(const LLUUID& anim_id,
 
 	if (anim_id == ANIM_AGENT_TYPE)
 	{
-		if (gAudiop && gSavedSettings.getBool("UISndTypingEnable"))
+		if (gAudiop && LLCtrl::UISndTypingEnable())
 		{
 			LLVector3d char_pos_global =
 				gAgent.getPosGlobalFromAgent(getCharacterPosition());
@@ -5256,6 +5257,7 @@ LLVOAvatar::rtf_cache_it_t LLVOAvatar::initRiggedMatrixCache(const LLMeshSkinInf
 
 	// Stamp the cache entry with the current frame number
 	rigmatp->mFrameNumber = gFrameCount;
+	rigmatp->mBoundValid = false;
 
 	// Fill-up the matrix
 
@@ -5298,6 +5300,24 @@ const LLMatrix4a* LLVOAvatar::getRiggedMatrix4a(const LLMeshSkinInfo* skin,
 	return initRiggedMatrixCache(skin, count)->second->mMatrix4a;
 }
 
+const LLMatrix4a* LLVOAvatar::getBoundRiggedMatrix4a(const LLMeshSkinInfo* skin,
+													 U32& count)
+{
+	RiggedMatrix* rigmatp = initRiggedMatrixCache(skin, count)->second.get();
+	if (!rigmatp->mBoundValid)
+	{
+		rigmatp->mBoundValid = true;
+		LLMatrix4a bind_shape_matrix;
+		bind_shape_matrix.loadu(skin->mBindShapeMatrix);
+		for (U32 i = 0; i < count; ++i)
+		{
+			rigmatp->mBoundMatrix4a[i].matMul(bind_shape_matrix,
+											  rigmatp->mMatrix4a[i]);
+		}
+	}
+	return rigmatp->mBoundMatrix4a;
+}
+
 // If viewer object is a rigged mesh, set the mesh id and return true.
 // Otherwise, null out the id and return false.
 //static
@@ -865,6 +865,12 @@ public:
 	const F32* getRiggedMatrix(const LLMeshSkinInfo* skin, U32& count);
 	const LLMatrix4a* getRiggedMatrix4a(const LLMeshSkinInfo* skin,
 										U32& count);
+	// Same as getRiggedMatrix4a(), but with the bind shape matrix of the
+	// mesh pre-multiplied, so that software skinning only needs one affine
+	// transform per vertex. Like the former, the palette is cached per mesh
+	// and per frame, and therefore shared by all the attachments using it.
+	const LLMatrix4a* getBoundRiggedMatrix4a(const LLMeshSkinInfo* skin,
+											 U32& count);
 
 protected:
 	void refreshAttachmentBakes();
@@ -879,9 +885,12 @@ private:
 	{
 	public:
 		alignas(16) LLMatrix4a	mMatrix4a[LL_MAX_JOINTS_PER_MESH_OBJECT];
+		// Only computed on demand, see getBoundRiggedMatrix4a()
+		alignas(16) LLMatrix4a	mBoundMatrix4a[LL_MAX_JOINTS_PER_MESH_OBJECT];
 		F32						mMatrix[LL_MAX_JOINTS_PER_MESH_OBJECT * 12];
 		U32						mCount;
 		U32						mFrameNumber;
+		bool					mBoundValid;
 	};
 	typedef fast_hmap<LLUUID, LLPointer<RiggedMatrix> > rig_tf_cache_t;
 	typedef rig_tf_cache_t::iterator rtf_cache_it_t;
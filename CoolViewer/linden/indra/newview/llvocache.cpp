@@ -37,7 +37,10 @@
 #include "lldir.h"
 #include "lldiriterator.h"
 #include "llfasttimer.h"
+#include "llpartdata.h"
+#include "llprimitive.h"
 #include "llregionhandle.h"
+#include "llvolumemessage.h"
 
 #include "llagent.h"
 #include "llappviewer.h"		// For gFrame*
@@ -340,6 +343,137 @@ LLDataPackerBinaryBuffer* LLVOCacheEntry::getDP()
 	return mDP.getBufferSize() ? &mDP : NULL;
 }
 
+// Note: this must be kept in sync with the OUT_FULL_CACHED update parsing in
+// LLViewerObject::processUpdateMessage() and LLVOVolume::processUpdateMessage()
+bool LLVOCacheEntry::getAssetIDs(uuid_list_t& texture_ids,
+								 LLVolumeParams& mesh_params) const
+{
+	S32 buffer_size = mDP.getBufferSize();
+	if (!mBuffer || buffer_size <= 0)
+	{
+		return false;
+	}
+	// Use our own data packer, so to not disturb mDP. Note that we cannot
+	// overflow 'scratch' since the data packer limits all sizes to the ones of
+	// the buffer it parses.
+	LLDataPackerBinaryBuffer dp(mBuffer, buffer_size);
+	std::vector<U8> scratch(buffer_size);
+
+	LLUUID id;
+	U32 u32;
+	U8 pcode;
+	if (!dp.unpackUUID(id, "ID") || !dp.unpackU32(u32, "LocalID") ||
+		!dp.unpackU8(pcode, "PCode") || pcode != LL_PCODE_VOLUME)
+	{
+		return false;
+	}
+
+	U8 u8;
+	LLVector3 vec;
+	U32 flags;
+	dp.unpackU32(u32, "CRC");
+	dp.unpackU8(u8, "Material");
+	dp.unpackU8(u8, "ClickAction");
+	dp.unpackVector3(vec, "Scale");
+	dp.unpackVector3(vec, "Pos");
+	dp.unpackVector3(vec, "Rot");
+	dp.unpackU32(flags, "SpecialCode");
+	dp.unpackUUID(id, "Owner");
+	if (flags & 0x80)
+	{
+		dp.unpackVector3(vec, "Omega");
+	}
+	if (flags & 0x20)
+	{
+		dp.unpackU32(u32, "ParentID");
+	}
+	S32 size;
+	if (flags & 0x2)
+	{
+		dp.unpackU8(u8, "TreeData");
+	}
+	else if (flags & 0x1)
+	{
+		dp.unpackU32(u32, "ScratchPadSize");
+		dp.unpackBinaryData(scratch.data(), size, "PartData");
+	}
+	std::string str;
+	if (flags & 0x4)
+	{
+		dp.unpackString(str, "Text");
+		dp.unpackBinaryDataFixed(scratch.data(), 4, "Color");
+	}
+	if (flags & 0x200)
+	{
+		dp.unpackString(str, "MediaURL");
+	}
+	if (flags & 0x8)
+	{
+		LLPartSysData psys;
+		psys.unpackLegacy(dp);
+	}
+
+	LLUUID sculpt_id;
+	U8 sculpt_type = 0;
+	U8 num_parameters = 0;
+	dp.unpackU8(num_parameters, "num_params");
+	for (U8 param = 0; param < num_parameters; ++param)
+	{
+		U16 param_type;
+		if (!dp.unpackU16(param_type, "param_type") ||
+			!dp.unpackBinaryData(scratch.data(), size, "param_data"))
+		{
+			return false;
+		}
+		if (param_type == LLNetworkData::PARAMS_SCULPT)
+		{
+			LLSculptParams sculpt_params;
+			LLDataPackerBinaryBuffer dp2(scratch.data(), size);
+			if (sculpt_params.unpack(dp2))
+			{
+				sculpt_id = sculpt_params.getSculptTexture();
+				sculpt_type = sculpt_params.getSculptType();
+			}
+		}
+	}
+
+	if (flags & 0x10)
+	{
+		F32 f32;
+		dp.unpackUUID(id, "SoundUUID");
+		dp.unpackF32(f32, "SoundGain");
+		dp.unpackU8(u8, "SoundFlags");
+		dp.unpackF32(f32, "SoundRadius");
+	}
+	if (flags & 0x100)
+	{
+		dp.unpackString(str, "NV");
+	}
+
+	LLVolumeParams volume_params;
+	if (!LLVolumeMessage::unpackVolumeParams(&volume_params, dp) ||
+		!LLPrimitive::unpackTEImageIDs(dp, texture_ids))
+	{
+		return false;
+	}
+
+	if (sculpt_id.notNull())
+	{
+		if ((sculpt_type & LL_SCULPT_TYPE_MASK) == LL_SCULPT_TYPE_MESH)
+		{
+			volume_params.setSculptID(sculpt_id, sculpt_type);
+			mesh_params = volume_params;
+		}
+		else
+		{
+			// Sculpt maps are textures
+			texture_ids.emplace(sculpt_id);
+		}
+	}
+
+	return true;
+}
+
 void LLVOCacheEntry::dump() const
 {
 	llinfos << "local " << mLocalID << " crc " << mCRC << " hits " << mHitCount
@@ -151,6 +151,14 @@ public:
 	void dump() const;
 	bool writeToFile(LLFile* outfile) const;
 	LLDataPackerBinaryBuffer* getDP();
+
+	// Extracts the Ids of the textures used by the cached object, as well as
+	// its mesh parameters, if any (else 'mesh_params' sculpt Id is left null),
+	// by parsing the cached update data without instantiating the object.
+	// Used by LLPrefetchPredictor. Returns false for non-volume objects or on
+	// malformed data.
+	bool getAssetIDs(uuid_list_t& texture_ids,
+					 LLVolumeParams& mesh_params) const;
 	void recordHit()										{ ++mHitCount; }
 	LL_INLINE void recordDupe()								{ ++mDupeCount; }
 
@@ -188,6 +196,8 @@ public:
 	typedef std::set<LLVOCacheEntry*> vocache_entry_set_t;
 	typedef std::set<LLVOCacheEntry*, CompareVOCacheEntry> vocache_entry_priority_list_t;
 
+	LL_INLINE const vocache_entry_set_t& getChildren() const	{ return mChildrenList; }
+
 private:
 	void updateParentBoundingInfo(const LLVOCacheEntry* child);
 
@@ -50,6 +50,7 @@
 #include "llpluginclassmedia.h"		// For code in the mediaEvent handler
 #include "llprimitive.h"
 #include "llsdutil.h"
+#include "llthreadpool.h"
 #include "llvolume.h"
 #include "llvolumemessage.h"
 #include "llvolumemgr.h"
@@ -117,6 +118,8 @@ LLFace** LLVolumeGeometryManager::sNormFaces = NULL;
 LLFace** LLVolumeGeometryManager::sSpecFaces = NULL;
 LLFace** LLVolumeGeometryManager::sNormSpecFaces = NULL;
 LLFace** LLVolumeGeometryManager::sAlphaFaces = NULL;
+LLFace::geom_jobs_t LLVolumeGeometryManager::sGeomJobs;
+std::vector<LLPointer<LLVertexBuffer> > LLVolumeGeometryManager::sGeomJobsBuffers;
 
 // Implementation class of LLMediaDataClientObject. See llmediadataclient.h
 class LLMediaDataClientObjectImpl final : public LLMediaDataClientObject
@@ -1514,6 +1517,7 @@ void LLVOVolume::sculpt()
 	}
 }
 
+//static
 S32 LLVOVolume::computeLODDetail(F32 distance, F32 radius, F32 lod_factor)
 {
 	if (LLPipeline::sDynamicLOD)
@@ -4594,6 +4598,7 @@ bool LLVOVolume::lineSegmentIntersect(const LLVector4a& start,
 		return false;
 	}
 
+	LLRiggedVolume* rigged_volume = NULL;
 	bool transform = true;
 	if (mDrawable->isState(LLDrawable::RIGGED))
 	{
@@ -4602,7 +4607,7 @@ bool LLVOVolume::lineSegmentIntersect(const LLVector4a& start,
 			 LLFloaterTools::isVisible()))
 		{
 			updateRiggedVolume(true);
-			volume = mRiggedVolume;
+			volume = rigged_volume = mRiggedVolume.get();
 			transform = false;
 		}
 		else
@@ -4675,6 +4680,10 @@ bool LLVOVolume::lineSegmentIntersect(const LLVector4a& start,
 			continue;
 		}
 
+		if (rigged_volume)
+		{
+			rigged_volume->updateOctree(i);
+		}
 		face_hit = volume->lineSegmentIntersect(local_start, local_end, i,
 												&p, &tc, &n, &tn);
 		if (face_hit < 0 || face_hit >= num_faces)
@@ -4836,6 +4845,9 @@ void LLVOVolume::updateRiggedVolume(bool force_update)
 	mRiggedVolume->update(skin, avatar, volume);
 }
 
+U32 LLRiggedVolume::sOctreeRebuildsAvoided = 0;
+U32 LLRiggedVolume::sOctreeRefits = 0;
+
 void LLRiggedVolume::update(const LLMeshSkinInfo* skin, LLVOAvatar* avatar,
 							const LLVolume* volume)
 {
@@ -4866,66 +4878,110 @@ void LLRiggedVolume::update(const LLMeshSkinInfo* skin, LLVOAvatar* avatar,
 		return;
 	}
 
-	// Build matrix palette
+	// Build matrix palette, with the bind shape matrix pre-applied
 	U32 count = 0;
-	const LLMatrix4a* mat = avatar->getRiggedMatrix4a(skin, count);
+	const LLMatrix4a* mat = avatar->getBoundRiggedMatrix4a(skin, count);
 
-	LLVector4a t, dst, size;
-	LLMatrix4a final_mat, bind_shape_matrix;
-	bind_shape_matrix.loadu(skin->mBindShapeMatrix);
+	// Collect the faces to skin; the weights checking is done here since it
+	// may log warnings.
+	static std::vector<S32> faces;
+	faces.clear();
 	for (S32 i = 0, count = volume->getNumVolumeFaces(); i < count; ++i)
 	{
 		const LLVolumeFace& vol_face = volume->getVolumeFace(i);
+		const LLVolumeFace& dst_face = mVolumeFaces[i];
+		if (vol_face.mWeights && dst_face.mPositions && dst_face.mExtents &&
+			dst_face.mNumVertices > 0)
+		{
+			LLSkinningUtil::checkSkinWeights(vol_face.mWeights,
+											 dst_face.mNumVertices, skin);
+			faces.push_back(i);
+		}
+	}
 
+	// Skin the faces and update their bounding box. Each face only touches
+	// its own data, so this may be done in parallel.
+	auto skin_face = [&](U32 n)
+	{
+		S32 i = faces[n];
+		const LLVolumeFace& vol_face = volume->getVolumeFace(i);
 		LLVolumeFace& dst_face = mVolumeFaces[i];
-
-		LLVector4a* weight = vol_face.mWeights;
-		if (!weight) continue;
-
-		LLSkinningUtil::checkSkinWeights(weight, dst_face.mNumVertices, skin);
-
 		LLVector4a* pos = dst_face.mPositions;
-		if (pos && dst_face.mExtents)
-		{
-			for (S32 j = 0; j < dst_face.mNumVertices; ++j)
-			{
-				LLSkinningUtil::getPerVertexSkinMatrix(weight[j], mat,
-													   final_mat);
-				LLVector4a& v = vol_face.mPositions[j];
-				bind_shape_matrix.affineTransform(v, t);
-				final_mat.affineTransform(t, dst);
-				pos[j] = dst;
-			}
+		LLSkinningUtil::skinVertices(mat, vol_face.mWeights,
+									 vol_face.mPositions, NULL,
+									 dst_face.mNumVertices, pos, NULL);
 
-			// Update bounding box
-			LLVector4a& min = dst_face.mExtents[0];
-			LLVector4a& max = dst_face.mExtents[1];
+		LLVector4a& min = dst_face.mExtents[0];
+		LLVector4a& max = dst_face.mExtents[1];
+		min = max = pos[0];
+		for (S32 j = 1; j < dst_face.mNumVertices; ++j)
+		{
+			min.setMin(min, pos[j]);
+			max.setMax(max, pos[j]);
+		}
+		dst_face.mCenter->setAdd(min, max);
+		dst_face.mCenter->mul(0.5f);
+	};
 
-			min = pos[0];
-			max = pos[1];
+	U32 num_faces = faces.size();
+	static LLCachedControl<bool> parallel(gSavedSettings,
+										  "RenderParallelSkinning");
+	if (num_faces > 1 && parallel && gThreadPoolp &&
+		gThreadPoolp->getSize())
+	{
+		gThreadPoolp->parallelFor(num_faces, skin_face);
+	}
+	else
+	{
+		for (U32 n = 0; n < num_faces; ++n)
+		{
+			skin_face(n);
+		}
+	}
 
-			for (S32 j = 1; j < dst_face.mNumVertices; ++j)
-			{
-				min.setMin(min, pos[j]);
-				max.setMax(max, pos[j]);
-			}
+	// Defer the octrees update till they are actually needed for picking.
+	U32 faces_count = mVolumeFaces.size();
+	if (mOctreeDirty.size() != faces_count)
+	{
+		mOctreeDirty.resize(faces_count);
+		mOctreeRefits.resize(faces_count);
+	}
+	for (U32 n = 0; n < num_faces; ++n)
+	{
+		mOctreeDirty[faces[n]] = true;
+	}
+	sOctreeRebuildsAvoided += num_faces;
+}
 
-			dst_face.mCenter->setAdd(dst_face.mExtents[0],
-									 dst_face.mExtents[1]);
-			dst_face.mCenter->mul(0.5f);
+void LLRiggedVolume::updateOctree(S32 i)
+{
+	if (i < 0 || i >= (S32)mOctreeDirty.size() || !mOctreeDirty[i])
+	{
+		return;
+	}
+	mOctreeDirty[i] = false;
 
-			{
-				LL_FAST_TIMER(FTM_RIGGED_OCTREE);
-				delete dst_face.mOctree;
-				dst_face.mOctree = NULL;
+	// Number of successive refits after which the octree gets rebuilt, since
+	// it is not re-partitioned on refit.
+	constexpr U8 MAX_REFITS = 32;
 
-				size.setSub(dst_face.mExtents[1], dst_face.mExtents[0]);
-				size.splat(size.getLength3().getF32() * 0.5f);
+	LL_FAST_TIMER(FTM_RIGGED_OCTREE);
 
-				dst_face.createOctree(1.f);
-			}
-		}
+	LLVolumeFace& face = mVolumeFaces[i];
+	if (face.mOctree && mOctreeRefits[i] < MAX_REFITS)
+	{
+		face.refitOctree();
+		++mOctreeRefits[i];
+		++sOctreeRefits;
+		return;
 	}
+
+	delete face.mOctree;
+	face.mOctree = NULL;
+	face.createOctree(1.f);
+	mOctreeRefits[i] = 0;
+	// This one could not be avoided...
+	--sOctreeRebuildsAvoided;
 }
 
 U32 LLVOVolume::getPartitionType() const
@@ -6042,6 +6098,9 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 	genDrawInfo(group, spec_mask, sSpecFaces, spec_count);
 	genDrawInfo(group, normspec_mask, sNormSpecFaces, normspec_count);
 
+	// Fill and flush the new buffers
+	runGeometryJobs();
+
 	if (!LLPipeline::sDelayVBUpdate)
 	{
 		// Drawables have been rebuilt, clear rebuild status
@@ -6095,6 +6154,8 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 
 	S32 num_mapped_vertex_buffer = LLVertexBuffer::sMappedCount;
 
+	LLFace::geom_jobs_t* jobs = getGeometryJobs();
+
 	constexpr U32 MAX_BUFFER_COUNT = 4096;
 	LLVertexBuffer* locked_buffer[MAX_BUFFER_COUNT];
 
@@ -6142,7 +6203,7 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 			if (!face->getGeometryVolume(*volume, face->getTEOffset(),
 										 vobj->getRelativeXform(),
 										 vobj->getRelativeXformInvTrans(),
-										 face->getGeomIndex()))
+										 face->getGeomIndex(), false, jobs))
 			{
 				// Something gone wrong with the vertex buffer accounting,
 				// rebuild this group
@@ -6164,6 +6225,9 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 		drawablep->clearState(LLDrawable::REBUILD_ALL);
 	}
 
+	// Fill the locked buffers before flushing them
+	runGeometryJobs();
+
 	for (LLVertexBuffer** iter = locked_buffer,
 					   ** end = locked_buffer + buffer_count;
 		 iter != end; ++iter)
@@ -6254,6 +6318,8 @@ void LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask,
 
 	U32 buffer_usage = group->mBufferUsage;
 
+	LLFace::geom_jobs_t* jobs = getGeometryJobs();
+
 #if LL_DARWIN
 	// *HACK: from Leslie:
 	// Disable VBO usage for alpha on macOS because it kills the framerate due
@@ -6588,7 +6654,7 @@ void LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask,
 				if (!facep->getGeometryVolume(*volume, te_idx,
 											  vobj->getRelativeXform(),
 											  vobj->getRelativeXformInvTrans(),
-											  index_offset, true))
+											  index_offset, true, jobs))
 				{
 					llwarns << "Failed to get geometry for face !" << llendl;
 				}
@@ -6987,7 +7053,14 @@ void LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask,
 
 		if (buffer.notNull())
 		{
-			buffer->flush();
+			if (jobs)
+			{
+				deferGeometryFlush(buffer);
+			}
+			else
+			{
+				buffer->flush();
+			}
 		}
 	}
 
@@ -6996,6 +7069,36 @@ void LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask,
 	group->mBufferMap[mask].swap(buffer_map[mask]);
 }
 
+//static
+LLFace::geom_jobs_t* LLVolumeGeometryManager::getGeometryJobs()
+{
+	static LLCachedControl<bool> parallel(gSavedSettings,
+										  "RenderParallelGeometry");
+	return parallel && gThreadPoolp && gThreadPoolp->getSize() ? &sGeomJobs
+															   : NULL;
+}
+
+//static
+void LLVolumeGeometryManager::runGeometryJobs()
+{
+	U32 count = sGeomJobs.size();
+	if (count == 1)
+	{
+		sGeomJobs[0]();
+	}
+	else if (count)
+	{
+		gThreadPoolp->parallelFor(count, [](U32 i) { sGeomJobs[i](); });
+	}
+	sGeomJobs.clear();
+
+	for (U32 i = 0, buffers = sGeomJobsBuffers.size(); i < buffers; ++i)
+	{
+		sGeomJobsBuffers[i]->flush();
+	}
+	sGeomJobsBuffers.clear();
+}
+
 //virtual
 void LLVolumeGeometryManager::addGeometryCount(LLSpatialGroup* group,
 											   U32& vertex_count,
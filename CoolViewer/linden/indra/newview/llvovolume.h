@@ -70,6 +70,21 @@ public:
 
 	void update(const LLMeshSkinInfo* skin, LLVOAvatar* avatar,
 				const LLVolume* src_volume);
+
+	// The faces octrees are only needed for picking, so update() merely flags
+	// them as dirty, and this method must be called before using the octree
+	// of face 'i'. It refits the existing octree when possible, and only
+	// rebuilds it when missing or after too many refits.
+	void updateOctree(S32 i);
+
+private:
+	std::vector<bool>	mOctreeDirty;
+	std::vector<U8>		mOctreeRefits;
+
+public:
+	// Statistics for the debug info display
+	static U32			sOctreeRebuildsAvoided;
+	static U32			sOctreeRefits;
 };
 
 // Base class for implementations of the volume - Primitive, Flexible Object,
@@ -423,8 +438,10 @@ public:
 	// picking/LOD/distance updates
 	void clearRiggedVolume();
 
+	// Also used by LLPrefetchPredictor for not yet instantiated objects.
+	static S32 computeLODDetail(F32 distance, F32 radius, F32 lod_factor);
+
 protected:
-	S32	computeLODDetail(F32 distance, F32 radius, F32 lod_factor);
 	bool calcLOD();
 	LLFace* addFace(S32 face_index);
 
@@ -0,0 +1,124 @@
+#!/usr/bin/env python
+# @file generate_control_handles.py
+# @brief Generates a C++ header of typed accessors for the debug settings
+#		 declared in app_settings/settings.xml.
+#
+# Released under the GPL (v2 or later, at your convenience) License:
+# http://www.gnu.org/copyleft/gpl.html
+#
+# Usage: generate_control_handles.py <settings.xml> <output header>
+#
+# Each setting "Foo" of type T gets an inline accessor LLCtrl::Foo() returning
+# a const reference to its cached value. The accessor holds a function-local
+# static LLCachedControl<T>, so the (name) lookup only happens on the first
+# call and any further read is a single indirection. Since only the accessors
+# actually called get instantiated, the generated header costs nothing for the
+# settings not used by the including code, while a misspelt setting name or a
+# wrong type becomes a compile-time error instead of a run-time warning.
+# The output file is only rewritten when its contents changed, to avoid
+# needless recompilations.
+
+from __future__ import print_function
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ElementTree
+
+TYPES = {
+	'Boolean': 'bool',
+	'U32': 'U32',
+	'S32': 'S32',
+	'F32': 'F32',
+	'String': 'std::string',
+	'Vector3': 'LLVector3',
+	'Vector3D': 'LLVector3d',
+	'Rect': 'LLRect',
+	'Color4': 'LLColor4',
+	'Color3': 'LLColor3',
+	'Color4u': 'LLColor4U',
+	'LLSD': 'LLSD',
+}
+
+IDENTIFIER = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+
+def parse_settings(filename):
+	root = ElementTree.parse(filename).getroot()
+	top_map = root.find('map')
+	if top_map is None:
+		raise ValueError('%s is not a LLSD settings file' % filename)
+	controls = []
+	children = list(top_map)
+	for i in range(0, len(children) - 1, 2):
+		key, value = children[i], children[i + 1]
+		if key.tag != 'key' or value.tag != 'map':
+			continue
+		name = key.text
+		fields = list(value)
+		type_name = None
+		# Note: do not assume well-formed key/value pairs here, since the LLSD
+		# parser in the viewer is tolerant with missing keys.
+		for j in range(0, len(fields) - 1):
+			if fields[j].tag == 'key' and fields[j].text == 'Type':
+				type_name = fields[j + 1].text
+				break
+		if type_name not in TYPES:
+			print('Skipping control %s of unknown type %s' % (name, type_name),
+				  file=sys.stderr)
+			continue
+		if not IDENTIFIER.match(name):
+			print('Skipping control with invalid identifier: %s' % name,
+				  file=sys.stderr)
+			continue
+		controls.append((name, TYPES[type_name]))
+	return controls
+
+def generate_header(controls):
+	lines = [
+		'// Generated by scripts/generate_control_handles.py from',
+		'// app_settings/settings.xml: do not edit.',
+		'',
+		'#ifndef LL_LLCONTROLHANDLES_H',
+		'#define LL_LLCONTROLHANDLES_H',
+		'',
+		'#include "llcolor3.h"',
+		'#include "llcolor4.h"',
+		'#include "llcolor4u.h"',
+		'#include "llrect.h"',
+		'#include "llvector3.h"',
+		'#include "llvector3d.h"',
+		'',
+		'#include "llviewercontrol.h"',
+		'',
+		'namespace LLCtrl',
+		'{',
+	]
+	for name, ctype in sorted(controls):
+		lines.append('\tLL_INLINE const %s& %s()' % (ctype, name))
+		lines.append('\t{')
+		lines.append('\t\tstatic LLCachedControl<%s> ctrl(gSavedSettings, "%s");'
+					 % (ctype, name))
+		lines.append('\t\treturn ctrl;')
+		lines.append('\t}')
+		lines.append('')
+	lines.append('}')
+	lines.append('')
+	lines.append('#endif	// LL_LLCONTROLHANDLES_H')
+	return '\n'.join(lines) + '\n'
+
+def main(argv):
+	if len(argv) != 3:
+		print('Usage: %s <settings.xml> <output header>' % argv[0],
+			  file=sys.stderr)
+		return 1
+	contents = generate_header(parse_settings(argv[1]))
+	if os.path.exists(argv[2]):
+		with open(argv[2], 'r') as f:
+			if f.read() == contents:
+				return 0
+	with open(argv[2], 'w') as f:
+		f.write(contents)
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main(sys.argv))